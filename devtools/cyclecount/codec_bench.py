@@ -0,0 +1,678 @@
+#!/usr/bin/env python3
+"""Cycles-per-byte benchmark: LZ77 (LzssDecodeVram) vs LZ4 (lz4Decode).
+
+Converts PNG images with gfx4snes three times (plain, -z, -Z), then runs
+the real decoder sources from lib/source/ on a small 65816 interpreter and
+reports cycles per uncompressed byte. Instruction costs come from
+cyclecount.py's tables, taken conditional branches add their +1 cycle and
+MVN costs 7 cycles per byte, so the numbers share cyclecount's model (CPU
+cycles, no memory-speed or DMA stall accounting). The DMA of
+lz4DecodeVram is charged 1 cycle per byte (8 master clocks, one SlowROM
+CPU cycle).
+
+Every decoded buffer is compared against the uncompressed .pic, so the
+benchmark doubles as a round-trip test of both encoders and decoders.
+
+Usage:
+    python3 devtools/cyclecount/codec_bench.py                  # default images
+    python3 devtools/cyclecount/codec_bench.py a.png b.png      # your images
+    python3 devtools/cyclecount/codec_bench.py --flags "-s 8 -o 4 -u 4" a.png
+    python3 devtools/cyclecount/codec_bench.py --json
+
+Exit status is 1 if a decoder output does not match the source data.
+"""
+
+import os
+import re
+import sys
+import json
+import shutil
+import argparse
+import subprocess
+import tempfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import cyclecount  # noqa: E402
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+
+DEFAULT_IMAGES = [
+    'examples/graphics/backgrounds/mode1_lz77/res/opensnes.png',
+    'examples/graphics/backgrounds/continuous_scroll/res/BG1.png',
+    'examples/maps/tiled/res/tileslevel1.png',
+]
+DEFAULT_FLAGS = '-s 8 -o 16 -u 16 -p -m'
+
+# Where the harness places things (LzssDecodeVram only reads bank $00 ROM)
+SRC_ADDR = 0x008000
+DEST_ADDR = 0x7F0000
+STACK_TOP = 0x1FFF
+RETURN_SENTINEL = 0xFFFFFF
+
+# DP layout of templates/crt0.asm's .registers section
+DP_REGISTERS = ['tcc__r0', 'tcc__r0h', 'tcc__r1', 'tcc__r1h', 'tcc__r2', 'tcc__r2h',
+                'tcc__r3', 'tcc__r3h', 'tcc__r4', 'tcc__r4h', 'tcc__r5', 'tcc__r5h',
+                'tcc__r9', 'tcc__r9h', 'tcc__r10', 'tcc__r10h']
+
+BRANCHES = {'bcc': ('c', 0), 'bcs': ('c', 1), 'beq': ('z', 1), 'bne': ('z', 0),
+            'bpl': ('n', 0), 'bmi': ('n', 1), 'bvc': ('v', 0), 'bvs': ('v', 1),
+            'blt': ('c', 0), 'bge': ('c', 1)}
+
+
+class SimError(Exception):
+    pass
+
+
+# ---------------------------------------------------------------------------
+# Source loader: WLA-DX subset used by the decoders
+# ---------------------------------------------------------------------------
+
+class Program:
+    """Instructions, labels and RAM symbols of one .asm file."""
+
+    def __init__(self, filename, ram_base=0x7E2000):
+        self.insns = []          # (mnemonic, size_hint, operand, raw)
+        self.labels = {}         # name -> instruction index
+        self.anon = []           # (index, '+'/'++'/'-', ...)
+        self.symbols = {name: 2 * i for i, name in enumerate(DP_REGISTERS)}
+        ram = ram_base
+        in_ram = False
+
+        with open(filename) as f:
+            for line in f:
+                text = line.split(';')[0].rstrip()
+                if not text.strip():
+                    continue
+                stripped = text.strip()
+                upper = stripped.upper()
+
+                if upper.startswith('.RAMSECTION'):
+                    in_ram = True
+                    continue
+                if upper.startswith('.ENDS'):
+                    in_ram = False
+                    continue
+                if in_ram:
+                    m = re.match(r'(\w+):?\s+(DSB|DSW|DB|DW)\s*(\S*)', stripped, re.IGNORECASE)
+                    if m:
+                        kind, count = m.group(2).upper(), m.group(3)
+                        size = {'DB': 1, 'DW': 2}.get(kind)
+                        if size is None:
+                            size = int(self.eval(count)) * (2 if kind == 'DSW' else 1)
+                        self.symbols[m.group(1)] = ram
+                        ram += size
+                    continue
+
+                m = re.match(r'\.EQU\s+(\w+)\s+(.+)$', stripped, re.IGNORECASE)
+                if m:
+                    self.symbols[m.group(1)] = self.eval(m.group(2))
+                    continue
+                if stripped.startswith('.'):
+                    continue
+
+                # Global label at column 0
+                m = re.match(r'^([A-Za-z_]\w*):(.*)$', text)
+                if m:
+                    self.labels[m.group(1)] = len(self.insns)
+                    stripped = m.group(2).strip()
+                    if not stripped:
+                        continue
+                # @local or anonymous (+, ++, -) label, optionally followed by code
+                m = re.match(r'^(@\w+|[+\-]+):?(\s+.*)?$', stripped)
+                if m:
+                    name = m.group(1)
+                    if name.startswith('@'):
+                        self.labels[name] = len(self.insns)
+                    else:
+                        self.anon.append((len(self.insns), name))
+                    stripped = (m.group(2) or '').strip()
+                    if not stripped:
+                        continue
+
+                parts = stripped.split(None, 1)
+                mnemonic = parts[0].lower()
+                operand = parts[1].replace(' ', '') if len(parts) > 1 else ''
+                hint = None
+                if '.' in mnemonic:
+                    mnemonic, hint = mnemonic.rsplit('.', 1)
+                self.insns.append((mnemonic, hint, operand, stripped))
+
+    def eval(self, expr):
+        expr = expr.strip()
+        if expr.startswith(':'):
+            return self.eval(expr[1:]) >> 16
+
+        def sym(m):
+            name = m.group(0)
+            if name not in self.symbols:
+                raise SimError('unknown symbol %s' % name)
+            return str(self.symbols[name])
+
+        py = re.sub(r'\$([0-9A-Fa-f]+)', r'0x\1', expr)
+        py = re.sub(r'%([01]+)', r'0b\1', py)
+        py = re.sub(r'(?<![0-9A-Za-z_])[A-Za-z_]\w*', sym, py)
+        if not re.match(r'^[0-9a-fA-FxXbB+\-*/()<> ]+$', py):
+            raise SimError('cannot evaluate %r' % expr)
+        return int(eval(py.replace('/', '//')))
+
+    def branch_target(self, index, operand):
+        if operand in self.labels:
+            return self.labels[operand]
+        if re.match(r'^\++$', operand):
+            for pos, name in self.anon:
+                if pos > index and name == operand:
+                    return pos
+        elif re.match(r'^-+$', operand):
+            for pos, name in reversed(self.anon):
+                if pos <= index and name == operand:
+                    return pos
+        raise SimError('unresolved branch target %r' % operand)
+
+
+# ---------------------------------------------------------------------------
+# Machine
+# ---------------------------------------------------------------------------
+
+class Machine:
+    def __init__(self, program):
+        self.prog = program
+        self.wram = bytearray(0x20000)
+        self.rom = bytearray(0x10000)        # bank $00
+        self.vram = bytearray(0x10000)
+        self.io = {}
+        self.vaddr = 0
+        self.vlatch = 0
+        self.a = self.x = self.y = 0
+        self.s = STACK_TOP
+        self.db = 0
+        self.p = {'n': 0, 'v': 0, 'm': 0, 'x': 0, 'z': 0, 'c': 0, 'i': 0}
+        self.cycles = 0
+        self.ret_stack = []
+
+    # -- memory ----------------------------------------------------------
+    def _wram_index(self, addr):
+        bank, off = addr >> 16, addr & 0xFFFF
+        if bank in (0x7E, 0x7F):
+            return ((bank - 0x7E) << 16) | off
+        if (bank < 0x40 or 0x80 <= bank < 0xC0) and off < 0x2000:
+            return off
+        return None
+
+    def read8(self, addr):
+        addr &= 0xFFFFFF
+        i = self._wram_index(addr)
+        if i is not None:
+            return self.wram[i]
+        bank, off = addr >> 16, addr & 0xFFFF
+        if bank == 0 and off >= 0x8000:
+            return self.rom[off]
+        if bank == 0 and off == 0x2139:
+            val = self.vlatch & 0xFF
+            if not self.io.get(0x2115, 0) & 0x80:
+                self._vram_advance()
+            return val
+        if bank == 0 and off == 0x213A:
+            val = self.vlatch >> 8
+            if self.io.get(0x2115, 0) & 0x80:
+                self._vram_advance()
+            return val
+        raise SimError('read from unmapped $%06X' % addr)
+
+    def write8(self, addr, val):
+        addr &= 0xFFFFFF
+        val &= 0xFF
+        i = self._wram_index(addr)
+        if i is not None:
+            self.wram[i] = val
+            return
+        bank, off = addr >> 16, addr & 0xFFFF
+        if bank != 0 or not (0x2100 <= off < 0x2200 or 0x4200 <= off < 0x4400):
+            raise SimError('write to unmapped $%06X' % addr)
+        self.io[off] = val
+        if off in (0x2116, 0x2117):
+            self.vaddr = self.io.get(0x2116, 0) | (self.io.get(0x2117, 0) << 8)
+            self._vram_prefetch()
+        elif off in (0x2118, 0x2119):
+            w = (self.vaddr & 0x7FFF) * 2
+            self.vram[w + (off - 0x2118)] = val
+            if bool(self.io.get(0x2115, 0) & 0x80) == (off == 0x2119):
+                self.vaddr = (self.vaddr + 1) & 0xFFFF
+        elif off == 0x420B:
+            self._dma(val)
+
+    def _vram_prefetch(self):
+        w = (self.vaddr & 0x7FFF) * 2
+        self.vlatch = self.vram[w] | (self.vram[w + 1] << 8)
+
+    def _vram_advance(self):
+        self._vram_prefetch()
+        self.vaddr = (self.vaddr + 1) & 0xFFFF
+
+    def _dma(self, channels):
+        for ch in range(8):
+            if not channels & (1 << ch):
+                continue
+            base = 0x4300 + ch * 0x10
+            reg = lambda n: self.io.get(base + n, 0)   # noqa: E731
+            if reg(0) != 0x01 or reg(1) != 0x18:
+                raise SimError('DMA mode %02X/%02X not modelled' % (reg(0), reg(1)))
+            src = reg(2) | (reg(3) << 8) | (reg(4) << 16)
+            size = (reg(5) | (reg(6) << 8)) or 0x10000
+            for n in range(size):
+                self.write8(0x002118 + (n & 1), self.read8(src + n))
+            self.cycles += size
+
+    def read(self, addr, wide):
+        val = self.read8(addr)
+        if wide:
+            val |= self.read8(addr + 1) << 8
+        return val
+
+    def write(self, addr, val, wide):
+        self.write8(addr, val)
+        if wide:
+            self.write8(addr + 1, val >> 8)
+
+    def push8(self, val):
+        self.write8(self.s, val)
+        self.s = (self.s - 1) & 0xFFFF
+
+    def pull8(self):
+        self.s = (self.s + 1) & 0xFFFF
+        return self.read8(self.s)
+
+    def push16(self, val):
+        self.push8(val >> 8)
+        self.push8(val)
+
+    def pull16(self):
+        lo = self.pull8()
+        return lo | (self.pull8() << 8)
+
+    # -- registers ---------------------------------------------------------
+    @property
+    def m8(self):
+        return self.p['m'] == 1
+
+    @property
+    def x8(self):
+        return self.p['x'] == 1
+
+    def get_a(self):
+        return self.a & (0xFF if self.m8 else 0xFFFF)
+
+    def set_a(self, val):
+        if self.m8:
+            self.a = (self.a & 0xFF00) | (val & 0xFF)
+        else:
+            self.a = val & 0xFFFF
+
+    def set_nz(self, val, wide):
+        mask, sign = (0xFFFF, 0x8000) if wide else (0xFF, 0x80)
+        self.p['z'] = int(val & mask == 0)
+        self.p['n'] = int(bool(val & sign))
+
+    def p_byte(self):
+        bits = 'c z i - x m v n'.split()
+        val = 0
+        for n, f in enumerate(bits):
+            if f != '-':
+                val |= self.p[f] << n
+        return val
+
+    def set_p(self, val):
+        for n, f in enumerate('c z i - x m v n'.split()):
+            if f != '-':
+                self.p[f] = (val >> n) & 1
+        if self.x8:
+            self.x &= 0xFF
+            self.y &= 0xFF
+
+    # -- addressing --------------------------------------------------------
+    def ea(self, mode, value):
+        """Effective 24-bit address for a memory operand."""
+        dbank = self.db << 16
+        if mode == 'dp':
+            return value & 0xFFFF
+        if mode == 'dpx':
+            return (value + self.x) & 0xFFFF
+        if mode == 'abs':
+            return dbank | (value & 0xFFFF)
+        if mode == 'abx':
+            return (dbank | (value & 0xFFFF)) + self.x
+        if mode == 'aby':
+            return (dbank | (value & 0xFFFF)) + self.y
+        if mode == 'abl':
+            return value & 0xFFFFFF
+        if mode == 'alx':
+            return (value & 0xFFFFFF) + self.x
+        if mode == 'sr':
+            return (self.s + value) & 0xFFFF
+        if mode in ('dli', 'dly'):
+            ptr = self.read(value, True) | (self.read8(value + 2) << 16)
+            return ptr + (self.y if mode == 'dly' else 0)
+        if mode in ('dpi', 'diy'):
+            return (dbank | self.read(value, True)) + (self.y if mode == 'diy' else 0)
+        raise SimError('addressing mode %s not modelled' % mode)
+
+    # -- execution ---------------------------------------------------------
+    def call(self, func, args):
+        """Run func(args) like a cc65816 caller would. args: [(value, bytes)]."""
+        for value, size in args:
+            if size == 4:
+                self.push16(value >> 16)
+            self.push16(value & 0xFFFF)
+        self.push8(RETURN_SENTINEL >> 16)
+        self.push16(RETURN_SENTINEL & 0xFFFF)
+        self.set_p(0)
+        pc = self.prog.labels[func]
+        steps = 0
+        while pc is not None:
+            pc = self.step(pc)
+            steps += 1
+            if steps > 50000000:
+                raise SimError('runaway in %s' % func)
+        return self.a
+
+    def operand_value(self, mnemonic, mode, operand):
+        expr = operand
+        if mode == 'imm':
+            expr = operand[1:]
+        elif mode in ('dli', 'dly'):
+            expr = operand.split(']')[0][1:]
+        elif mode in ('dpi', 'diy', 'dix', 'sry'):
+            expr = re.sub(r'[()]', '', operand).split(',')[0]
+        elif ',' in operand:
+            expr = operand.rsplit(',', 1)[0]
+        return self.prog.eval(expr)
+
+    def step(self, pc):
+        mnemonic, hint, operand, raw = self.prog.insns[pc]
+        mode = cyclecount.parse_addressing_mode(mnemonic, operand, hint)
+        self.cycles += cyclecount.get_cycles(mnemonic, mode, self.p['m'], self.p['x'])
+        nxt = pc + 1
+        m = mnemonic
+        wide_a = not self.m8
+        wide_x = not self.x8
+
+        if m in BRANCHES:
+            flag, want = BRANCHES[m]
+            if self.p[flag] == want:
+                self.cycles += 1
+                return self.prog.branch_target(pc, operand)
+            return nxt
+        if m in ('bra', 'jmp'):
+            return self.prog.branch_target(pc, operand)
+        if m == 'jsr':
+            self.push16(0)
+            self.ret_stack.append(nxt)
+            return self.prog.branch_target(pc, operand)
+        if m == 'rts':
+            self.pull16()
+            return self.ret_stack.pop()
+        if m == 'rtl':
+            lo = self.pull16()
+            bank = self.pull8()
+            if (bank << 16 | lo) != RETURN_SENTINEL:
+                raise SimError('rtl to an unknown caller')
+            return None
+        if m == 'jsl':
+            if operand in self.prog.labels:
+                raise SimError('jsl to code label %s not modelled' % operand)
+            self._run_stub(self.prog.eval(operand))
+            return nxt
+
+        val = None
+        if mode == 'imm':
+            val = self.operand_value(m, mode, operand)
+        addr = None
+        if mode not in ('imm', 'imp', 'acc', 'rel'):
+            addr = self.ea(mode, self.operand_value(m, mode, operand))
+
+        if m == 'lda':
+            v = val if addr is None else self.read(addr, wide_a)
+            self.set_a(v)
+            self.set_nz(self.get_a(), wide_a)
+        elif m in ('ldx', 'ldy'):
+            v = val if addr is None else self.read(addr, wide_x)
+            v &= 0xFFFF if wide_x else 0xFF
+            setattr(self, m[2], v)
+            self.set_nz(v, wide_x)
+        elif m == 'sta':
+            self.write(addr, self.get_a(), wide_a)
+        elif m == 'stz':
+            self.write(addr, 0, wide_a)
+        elif m in ('stx', 'sty'):
+            self.write(addr, getattr(self, m[2]), wide_x)
+        elif m in ('and', 'ora', 'eor'):
+            v = val if addr is None else self.read(addr, wide_a)
+            r = {'and': lambda a, b: a & b, 'ora': lambda a, b: a | b,
+                 'eor': lambda a, b: a ^ b}[m](self.get_a(), v)
+            self.set_a(r)
+            self.set_nz(r, wide_a)
+        elif m in ('adc', 'sbc'):
+            v = val if addr is None else self.read(addr, wide_a)
+            mask = 0xFFFF if wide_a else 0xFF
+            if m == 'sbc':
+                v = ~v & mask
+            a = self.get_a()
+            r = a + v + self.p['c']
+            sign = 0x8000 if wide_a else 0x80
+            self.p['v'] = int(bool(~(a ^ v) & (a ^ r) & sign))
+            self.p['c'] = int(r > mask)
+            self.set_a(r & mask)
+            self.set_nz(r, wide_a)
+        elif m in ('cmp', 'cpx', 'cpy'):
+            wide = wide_a if m == 'cmp' else wide_x
+            reg = self.get_a() if m == 'cmp' else getattr(self, m[2])
+            v = val if addr is None else self.read(addr, wide)
+            mask = 0xFFFF if wide else 0xFF
+            r = (reg - (v & mask)) & 0x1FFFF
+            self.p['c'] = int(reg >= (v & mask))
+            self.set_nz(r, wide)
+        elif m in ('inc', 'dec', 'asl', 'lsr', 'rol', 'ror'):
+            mask = 0xFFFF if wide_a else 0xFF
+            v = self.get_a() if addr is None else self.read(addr, wide_a)
+            if m == 'inc':
+                r = (v + 1) & mask
+            elif m == 'dec':
+                r = (v - 1) & mask
+            elif m == 'asl':
+                self.p['c'] = int(bool(v & (mask + 1) >> 1))
+                r = (v << 1) & mask
+            elif m == 'lsr':
+                self.p['c'] = v & 1
+                r = v >> 1
+            elif m == 'rol':
+                c = self.p['c']
+                self.p['c'] = int(bool(v & (mask + 1) >> 1))
+                r = ((v << 1) | c) & mask
+            else:
+                c = self.p['c']
+                self.p['c'] = v & 1
+                r = (v >> 1) | (c * ((mask + 1) >> 1))
+            if addr is None:
+                self.set_a(r)
+            else:
+                self.write(addr, r, wide_a)
+            self.set_nz(r, wide_a)
+        elif m in ('inx', 'iny', 'dex', 'dey'):
+            mask = 0xFFFF if wide_x else 0xFF
+            reg = m[2]
+            r = (getattr(self, reg) + (1 if m[0] == 'i' else -1)) & mask
+            setattr(self, reg, r)
+            self.set_nz(r, wide_x)
+        elif m in ('tax', 'tay'):
+            r = self.a & (0xFFFF if wide_x else 0xFF)
+            setattr(self, m[2], r)
+            self.set_nz(r, wide_x)
+        elif m in ('txa', 'tya'):
+            self.set_a(getattr(self, m[1]))
+            self.set_nz(self.get_a(), wide_a)
+        elif m == 'xba':
+            self.a = ((self.a >> 8) | (self.a << 8)) & 0xFFFF
+            self.set_nz(self.a & 0xFF, False)
+        elif m in ('sec', 'clc'):
+            self.p['c'] = int(m == 'sec')
+        elif m in ('sei', 'cli'):
+            self.p['i'] = int(m == 'sei')
+        elif m in ('rep', 'sep'):
+            bits = val
+            cur = self.p_byte()
+            self.set_p(cur & ~bits if m == 'rep' else cur | bits)
+        elif m == 'php':
+            self.push8(self.p_byte())
+        elif m == 'plp':
+            self.set_p(self.pull8())
+        elif m == 'phb':
+            self.push8(self.db)
+        elif m == 'plb':
+            self.db = self.pull8()
+        elif m == 'pha':
+            if wide_a:
+                self.push16(self.a)
+            else:
+                self.push8(self.a)
+        elif m == 'pla':
+            self.set_a(self.pull16() if wide_a else self.pull8())
+            self.set_nz(self.get_a(), wide_a)
+        elif m in ('phx', 'phy'):
+            v = getattr(self, m[2])
+            if wide_x:
+                self.push16(v)
+            else:
+                self.push8(v)
+        elif m in ('plx', 'ply'):
+            v = self.pull16() if wide_x else self.pull8()
+            setattr(self, m[2], v)
+            self.set_nz(v, wide_x)
+        else:
+            raise SimError('instruction not modelled: %s' % raw)
+        return nxt
+
+    def _run_stub(self, target):
+        """Execute a patched `mvn dest,src ; rtl` stub living in WRAM."""
+        op, dest, src, ret = (self.read8(target + n) for n in range(4))
+        if op != 0x54 or ret != 0x6B:
+            raise SimError('unexpected stub bytes at $%06X' % target)
+        count = (self.a & 0xFFFF) + 1
+        for _ in range(count):
+            self.write8((dest << 16) | self.y, self.read8((src << 16) | self.x))
+            self.x = (self.x + 1) & 0xFFFF
+            self.y = (self.y + 1) & 0xFFFF
+        self.a = 0xFFFF
+        self.db = dest
+        self.cycles += 7 * count + cyclecount.get_cycles('rtl', 'imp', 0, 0)
+
+
+# ---------------------------------------------------------------------------
+# Benchmark driver
+# ---------------------------------------------------------------------------
+
+def find_gfx4snes(explicit):
+    for path in (explicit, os.path.join(ROOT, 'bin', 'gfx4snes'),
+                 os.path.join(ROOT, 'tools', 'gfx4snes', 'gfx4snes')):
+        if path and os.path.isfile(path) and os.access(path, os.X_OK):
+            return path
+    sys.exit('gfx4snes not found: build it (make -C tools/gfx4snes) or pass --gfx4snes')
+
+
+def convert(gfx4snes, png, flags, extra, workdir):
+    os.makedirs(workdir, exist_ok=True)
+    dst = os.path.join(workdir, 'img.png')
+    shutil.copy(png, dst)
+    cmd = [gfx4snes, '-q'] + flags.split() + extra + ['-i', dst]
+    res = subprocess.run(cmd, capture_output=True, text=True)
+    pic = os.path.join(workdir, 'img.pic')
+    if res.returncode != 0 or not os.path.isfile(pic):
+        return None
+    with open(pic, 'rb') as f:
+        return f.read()
+
+
+def run_lzss(data, expected):
+    m = Machine(Program(os.path.join(ROOT, 'lib', 'source', 'lzss.asm')))
+    m.rom[SRC_ADDR & 0xFFFF:(SRC_ADDR & 0xFFFF) + len(data)] = data
+    m.call('LzssDecodeVram', [(SRC_ADDR, 4), (0x0000, 2)])
+    return m.cycles, bytes(m.vram[:len(expected)]) == expected
+
+
+def run_lz4(data, expected, vram):
+    m = Machine(Program(os.path.join(ROOT, 'lib', 'source', 'lz4.asm')))
+    m.rom[SRC_ADDR & 0xFFFF:(SRC_ADDR & 0xFFFF) + len(data)] = data
+    if vram:
+        size = m.call('lz4DecodeVram', [(SRC_ADDR, 4), (DEST_ADDR, 4), (0x0000, 2)])
+        out = bytes(m.vram[:len(expected)])
+    else:
+        size = m.call('lz4Decode', [(SRC_ADDR, 4), (DEST_ADDR, 4)])
+        off = DEST_ADDR - 0x7E0000
+        out = bytes(m.wram[off:off + len(expected)])
+    return m.cycles, size == len(expected) and out == expected
+
+
+def bench_image(gfx4snes, png, flags, tmp):
+    name = os.path.relpath(png, ROOT) if os.path.isabs(png) else png
+    raw = convert(gfx4snes, png, flags, [], os.path.join(tmp, 'raw'))
+    lz77 = convert(gfx4snes, png, flags, ['-z'], os.path.join(tmp, 'lz77'))
+    lz4 = convert(gfx4snes, png, flags, ['-Z'], os.path.join(tmp, 'lz4'))
+    if raw is None or lz77 is None or lz4 is None:
+        return {'image': name, 'error': 'gfx4snes conversion failed'}
+    if max(len(lz77), len(lz4)) > 0x8000:
+        return {'image': name, 'error': 'compressed data larger than 32 KB'}
+
+    lzss_cycles, lzss_ok = run_lzss(lz77, raw)
+    lz4_cycles, lz4_ok = run_lz4(lz4, raw, vram=False)
+    lz4v_cycles, lz4v_ok = run_lz4(lz4, raw, vram=True)
+    return {
+        'image': name,
+        'bytes': len(raw),
+        'lz77_bytes': len(lz77),
+        'lz4_bytes': len(lz4),
+        'lzss_vram_cycles': lzss_cycles,
+        'lz4_wram_cycles': lz4_cycles,
+        'lz4_vram_cycles': lz4v_cycles,
+        'ok': lzss_ok and lz4_ok and lz4v_ok,
+    }
+
+
+def print_table(results):
+    print('%-48s %6s %6s %6s %9s %9s %9s %6s' % (
+        'image', 'bytes', 'lz77', 'lz4', 'LZSS c/B', 'LZ4 c/B', 'LZ4+DMA', 'speed'))
+    for r in results:
+        if 'error' in r:
+            print('%-48s %s' % (r['image'], r['error']))
+            continue
+        n = r['bytes']
+        print('%-48s %6d %6d %6d %9.1f %9.1f %9.1f %5.1fx%s' % (
+            r['image'][-48:], n, r['lz77_bytes'], r['lz4_bytes'],
+            r['lzss_vram_cycles'] / n, r['lz4_wram_cycles'] / n,
+            r['lz4_vram_cycles'] / n,
+            r['lzss_vram_cycles'] / r['lz4_vram_cycles'],
+            '' if r['ok'] else '  MISMATCH'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('images', nargs='*', help='PNG files (default: a few example backgrounds)')
+    parser.add_argument('--flags', default=DEFAULT_FLAGS, help='gfx4snes conversion flags')
+    parser.add_argument('--gfx4snes', help='gfx4snes binary')
+    parser.add_argument('--json', action='store_true', help='JSON output')
+    args = parser.parse_args()
+
+    gfx4snes = find_gfx4snes(args.gfx4snes)
+    images = args.images or [os.path.join(ROOT, p) for p in DEFAULT_IMAGES]
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        for n, png in enumerate(images):
+            results.append(bench_image(gfx4snes, png, args.flags, os.path.join(tmp, str(n))))
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+    else:
+        print_table(results)
+    return 0 if all(r.get('ok', True) for r in results) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Cycle cost of the HDMA wave animation (hdmaWaveScroll).
+
+Runs the real lib/source/hdma.asm on the mode7_bench.py interpreter and
+reports, for a few amplitude/frequency pairs, the cycles of the period
+table build (paid once per amplitude or frequency change) and of a frame
+(the table pointer move hdmaWaveUpdate() does every frame). c/row is the
+build cost per computed row once the 224-row block copy is taken out:
+times 224, it is what recomputing every row each frame would cost.
+
+Every frame's 224-row window is checked against a Python model of the
+per-frame table hdmaWaveUpdate() used to rebuild (fillWaveTable in
+hdma.c), at the phase rounded down to a multiple of 2^k (frequency =
+2^k * odd): the benchmark doubles as a test of the scroll.
+
+Usage:
+    python3 devtools/cyclecount/hdma_bench.py
+    python3 devtools/cyclecount/hdma_bench.py --json
+
+Exit status is 1 if a window does not match the model.
+"""
+
+import os
+import re
+import sys
+import json
+import argparse
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import cyclecount  # noqa: E402
+from codec_bench import ROOT, Program, SimError  # noqa: E402
+from mode7_bench import Mode7Machine  # noqa: E402
+
+SOURCE = os.path.join(ROOT, 'lib', 'source', 'hdma.asm')
+TABLE_SOURCE = os.path.join(ROOT, 'lib', 'source', 'hdma.c')
+SINE_ADDR = 0x00C000
+RAM_BASE = 0x000200         # the wave RAMSECTIONs are bank $00 (< $2000)
+CHANNEL = 6
+LINES = 224
+FRAMES = 64
+
+# (amplitude, frequency, speed)
+CASES = [
+    (8, 4, 2),
+    (4, 4, 1),
+    (16, 8, 3),
+    (12, 3, 2),
+    (60, 16, 4),
+    (24, 1, 1),
+    (255, 6, 2),
+]
+
+
+def sine_quarter():
+    """The 64 values of hdma_sine_quarter[] in hdma.c."""
+    with open(TABLE_SOURCE) as f:
+        text = f.read()
+    m = re.search(r'hdma_sine_quarter\[64\]\s*=\s*\{([^}]*)\}', text)
+    if not m:
+        raise SimError('hdma_sine_quarter not found in hdma.c')
+    data = [int(v) for v in m.group(1).replace('\n', ' ').split(',') if v.strip()]
+    if len(data) != 64:
+        raise SimError('hdma_sine_quarter: %d entries' % len(data))
+    return data
+
+
+def old_table(frame, amplitude, frequency, quarter):
+    """fillWaveTable(): 224 rows of [$81][offset lo][offset hi]."""
+    out = bytearray()
+    angle = frame
+    for _ in range(LINES):
+        if angle < 64:
+            s = quarter[angle]
+        elif angle < 128:
+            s = quarter[127 - angle]
+        elif angle < 192:
+            s = -quarter[angle - 128]
+        else:
+            s = -quarter[255 - angle]
+        offset = (s * amplitude + 128) >> 8
+        out += bytes([0x81]) + (offset & 0xFFFF).to_bytes(2, 'little')
+        angle = (angle + frequency) & 0xFF
+    return bytes(out)
+
+
+class HdmaMachine(Mode7Machine):
+    """Mode7Machine plus `bit #imm` and `mvn` (7 cycles per byte)."""
+
+    def step(self, pc):
+        mnemonic, hint, operand, raw = self.prog.insns[pc]
+        if mnemonic == 'bit' and operand.startswith('#'):
+            self.cycles += cyclecount.get_cycles('bit', 'imm', self.p['m'], self.p['x'])
+            mask = 0xFF if self.m8 else 0xFFFF
+            self.p['z'] = int((self.get_a() & self.prog.eval(operand[1:]) & mask) == 0)
+            return pc + 1
+        if mnemonic == 'mvn':
+            dest, src = (self.prog.eval(v) for v in operand.split(','))
+            count = (self.a & 0xFFFF) + 1
+            for _ in range(count):
+                self.write8((dest << 16) | self.y, self.read8((src << 16) | self.x))
+                self.x, self.y = (self.x + 1) & 0xFFFF, (self.y + 1) & 0xFFFF
+            self.cycles += 7 * count
+            self.a, self.db = 0xFFFF, dest
+            return pc + 1
+        return super().step(pc)
+
+
+class Bench:
+    def __init__(self):
+        self.quarter = sine_quarter()
+        self.prog = Program(SOURCE, ram_base=RAM_BASE)
+        self.prog.symbols['hdma_sine_quarter'] = SINE_ADDR
+        self.m = HdmaMachine(self.prog)
+        off = SINE_ADDR & 0xFFFF
+        self.m.rom[off:off + 64] = bytes(self.quarter)
+        self.sym = self.prog.symbols
+
+    def set8(self, name, value):
+        self.m.write8(self.sym[name], value)
+
+    def get8(self, name):
+        return self.m.read8(self.sym[name])
+
+    def update(self):
+        """hdmaWaveUpdate(), wave mode: advance the phase, then scroll."""
+        self.set8('hdma_wave_frame', (self.get8('hdma_wave_frame') + self.get8('hdma_wave_speed')) & 0xFF)
+        self.m.cycles = 0
+        self.m.call('hdmaWaveScroll', [])
+        return self.m.cycles
+
+    def window(self):
+        base = self.m.io.get(0x4302 + 16 * CHANNEL, 0) | (self.m.io.get(0x4303 + 16 * CHANNEL, 0) << 8)
+        return bytes(self.m.read8(base + n) for n in range(3 * LINES))
+
+    def run(self, amplitude, frequency, speed):
+        self.set8('hdma_wave_channel', CHANNEL)
+        self.set8('hdma_wave_amplitude', amplitude)
+        self.set8('hdma_wave_frequency', frequency)
+        self.set8('hdma_wave_speed', speed)
+        self.set8('hdma_wave_frame', 0)
+        self.set8('hdma_wave_built', 0)
+        step = frequency & -frequency
+        rows = 256 // step + LINES
+
+        build = self.update()
+        ok = True
+        frames = []
+        for _ in range(FRAMES):
+            frame = self.get8('hdma_wave_frame')
+            want = old_table(frame & ~(step - 1) & 0xFF, amplitude, frequency, self.quarter)
+            ok &= self.window() == want
+            frames.append(self.update())
+        end = self.sym['hdma_table_a'] + 3 * rows
+        ok &= self.m.read8(end) == 0 and end < self.sym['hdma_wave_tail'] + 95
+
+        return {
+            'amplitude': amplitude, 'frequency': frequency, 'speed': speed,
+            'period_rows': 256 // step,
+            'build_cycles': build,
+            'cycles_per_period_row': round((build - 7 * 3 * LINES) / (256 // step), 1),
+            'frame_cycles': max(frames),
+            'ok': ok,
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--json', action='store_true', help='JSON output')
+    args = parser.parse_args()
+
+    bench = Bench()
+    results = [bench.run(*case) for case in CASES]
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+    else:
+        print('%4s %5s %5s %6s %8s %6s %6s' % ('amp', 'freq', 'speed', 'period', 'build', 'c/row', 'frame'))
+        for r in results:
+            print('%4d %5d %5d %6d %8d %6s %6d%s' % (
+                r['amplitude'], r['frequency'], r['speed'], r['period_rows'], r['build_cycles'],
+                r['cycles_per_period_row'], r['frame_cycles'], '' if r['ok'] else '  MISMATCH'))
+    return 0 if all(r['ok'] for r in results) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,276 @@
+#!/usr/bin/env python3
+"""Cycle cost of mode7PerspectiveUpdate (per-scanline Mode 7 matrix tables).
+
+Runs the real lib/source/mode7_perspective.asm on codec_bench.py's 65816
+interpreter, extended with the direct page register and the CPU
+multiplier/divider ($4202-$4206 -> $4214-$4217), and reports the cycles of
+one table build for a few camera settings, plus the cost of a call that
+finds nothing changed.
+
+Each built buffer is checked against a Python model of the same integer
+math, and the ground rows against the floating-point projection
+(256 * height * trig / d): the benchmark doubles as a test of the builder.
+
+Usage:
+    python3 devtools/cyclecount/mode7_bench.py
+    python3 devtools/cyclecount/mode7_bench.py --json
+
+Exit status is 1 if a table does not match the model.
+"""
+
+import os
+import sys
+import json
+import math
+import argparse
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import cyclecount  # noqa: E402
+from codec_bench import ROOT, Program, Machine, SimError  # noqa: E402
+
+SOURCE = os.path.join(ROOT, 'lib', 'source', 'mode7_perspective.asm')
+TABLE_SOURCE = os.path.join(ROOT, 'lib', 'source', 'mode7.asm')
+SINCOS_ADDR = 0x00C000
+LINES = 224
+
+# (height, pitch, yaw)
+CASES = [
+    (64, 0, 0),
+    (64, 0, 40),
+    (64, 16, 40),
+    (128, 16, 200),
+    (32, 32, 96),
+    (255, 48, 170),
+    (64, 64, 10),
+]
+
+
+def sincos_table():
+    """The .db bytes following m7_sincos_table: in mode7.asm."""
+    data, inside = [], False
+    with open(TABLE_SOURCE) as f:
+        for line in f:
+            text = line.split(';')[0].strip()
+            if text.startswith('m7_sincos_table:'):
+                inside = True
+                continue
+            if inside:
+                if not text:
+                    continue
+                if not text.lower().startswith('.db'):
+                    break
+                data += [int(v.strip().lstrip('$'), 16) for v in text[3:].split(',')]
+    if len(data) != 256:
+        raise SimError('m7_sincos_table: %d entries' % len(data))
+    return data
+
+
+class Mode7Machine(Machine):
+    """Machine with a direct page register and the CPU math unit."""
+
+    def __init__(self, program):
+        super().__init__(program)
+        self.d = 0
+        self.math = {}
+
+    def ea(self, mode, value):
+        if mode in ('dp', 'dpx', 'dli', 'dly', 'dpi', 'diy'):
+            value = (value + self.d) & 0xFFFF
+            if mode == 'dpx':
+                return (value + self.x) & 0xFFFF
+            if mode == 'dp':
+                return value
+            return super().ea(mode, value)
+        return super().ea(mode, value)
+
+    def read8(self, addr):
+        addr &= 0xFFFFFF
+        if 0x4214 <= addr <= 0x4217:
+            return self.math.get(addr, 0)
+        return super().read8(addr)
+
+    def write8(self, addr, val):
+        super().write8(addr, val)
+        addr &= 0xFFFFFF
+        io = self.io
+        if addr == 0x4203:
+            product = io.get(0x4202, 0) * (val & 0xFF)
+            self.math[0x4216], self.math[0x4217] = product & 0xFF, product >> 8
+        elif addr == 0x4206:
+            dividend = io.get(0x4204, 0) | (io.get(0x4205, 0) << 8)
+            divisor = val & 0xFF
+            q, r = (dividend // divisor, dividend % divisor) if divisor else (0xFFFF, dividend)
+            self.math[0x4214], self.math[0x4215] = q & 0xFF, q >> 8
+            self.math[0x4216], self.math[0x4217] = r & 0xFF, r >> 8
+
+    def step(self, pc):
+        mnemonic, hint, operand, raw = self.prog.insns[pc]
+        if mnemonic == 'pea':
+            mode = cyclecount.parse_addressing_mode(mnemonic, operand, hint)
+            self.cycles += cyclecount.get_cycles(mnemonic, mode, self.p['m'], self.p['x'])
+            self.push16(self.prog.eval(operand) & 0xFFFF)
+            return pc + 1
+        if mnemonic in ('phd', 'pld', 'tcd', 'tdc', 'nop'):
+            self.cycles += cyclecount.get_cycles(mnemonic, 'imp', self.p['m'], self.p['x'])
+            if mnemonic == 'phd':
+                self.push16(self.d)
+            elif mnemonic == 'pld':
+                self.d = self.pull16()
+                self.set_nz(self.d, True)
+            elif mnemonic == 'tcd':
+                self.d = self.a & 0xFFFF
+            elif mnemonic == 'tdc':
+                self.a = self.d
+            return pc + 1
+        return super().step(pc)
+
+
+def model(height, pitch, yaw, sc):
+    """The builder's integer math: (horizon, centre, [(a, b, c)] per row)."""
+    pitch = min(pitch, 64)
+
+    def s8(v):
+        return v - 256 if v >= 128 else v
+
+    sy, cy = s8(sc[yaw]), s8(sc[(yaw + 64) & 255])
+    sp, cp = sc[pitch], sc[(pitch + 64) & 255]
+    ka, kb = 2 * height * abs(cy), 2 * height * abs(sy)
+    step = 2 * cp
+    d0 = 256 * sp - 224 * cp + 128
+    if d0 >= 512:
+        horizon = 0
+    else:
+        horizon = min(LINES, (512 - d0 + step - 1) // step)
+    centre = 112 + (128 * (127 - sp)) // cp if cp else 112
+    rows = []
+    d = d0 + horizon * step
+    for _ in range(horizon, LINES):
+        n = d >> 8
+        a, c = ka // n, kb // n
+        a = -a if cy < 0 else a
+        c = -c if sy < 0 else c
+        rows.append((a, -c, c))
+        d += step
+    return horizon, centre, rows
+
+
+def expected_tables(horizon, rows):
+    """Bytes of the M7A/M7D, M7B and M7C tables for a model result."""
+    tables = [bytearray(), bytearray(), bytearray()]
+    left = horizon
+    while left:
+        n = min(left, 127)
+        for t in tables:
+            t += bytes([n, 0, 0])
+        left -= n
+    pos = 0
+    while pos < len(rows):
+        n = min(len(rows) - pos, 127)
+        for t in tables:
+            t.append(0x80 | n)
+        for a, b, c in rows[pos:pos + n]:
+            for t, v in zip(tables, (a, b, c)):
+                t += (v & 0xFFFF).to_bytes(2, 'little')
+        pos += n
+    for t in tables:
+        t.append(0)
+    return tables
+
+
+def check_projection(height, pitch, yaw, horizon, rows):
+    """Largest relative error of |A| against 256 * height * |cos yaw| / d.
+
+    Rows less than 8 lines from the horizon are skipped: there the 8-bit
+    sin/cos table alone moves d by more than half a line.
+    """
+    worst = 0
+    c = abs(math.cos(yaw * math.pi / 128))
+    p = min(pitch, 64) * math.pi / 128
+    for n, (a, _, _) in enumerate(rows):
+        y = horizon + n
+        d = 128 * math.sin(p) + (y - 112) * math.cos(p)
+        if d < 8:
+            continue
+        ideal = 256 * height * c / d
+        worst = max(worst, abs(abs(a) - ideal) / max(ideal, 1))
+    return worst
+
+
+class Bench:
+    def __init__(self):
+        self.sc = sincos_table()
+        self.prog = Program(SOURCE)
+        self.prog.symbols['m7_sincos_table'] = SINCOS_ADDR
+        for name in ('m7p_channels', 'hdmaSetupBank', 'hdmaEnable', 'hdmaDisable'):
+            self.prog.symbols.setdefault(name, 0)
+        self.m = Mode7Machine(self.prog)
+        off = SINCOS_ADDR & 0xFFFF
+        self.m.rom[off:off + 256] = bytes(self.sc)
+        self.sym = self.prog.symbols
+        # What mode7PerspectiveInit leaves behind (its HDMA calls are not modelled)
+        self.m.write8(self.sym['m7p_dirty'], 1)
+
+    def word(self, name):
+        return self.m.read(self.sym[name], True)
+
+    def call_update(self, height, pitch, yaw):
+        self.m.cycles = 0
+        self.m.call('mode7PerspectiveUpdate', [(height, 2), (pitch, 2), (yaw, 2)])
+        return self.m.cycles
+
+    def show(self):
+        """mode7PerspectiveSetCamera's buffer swap, without the registers."""
+        if self.m.read8(self.sym['m7p_pending']):
+            self.m.write8(self.sym['m7p_pending'], 0)
+            self.m.write(self.sym['m7p_front'], self.word('m7p_front') ^ self.sym['M7P_BUF'], True)
+
+    def built_tables(self, size):
+        base = self.sym['m7p_ad'] + (self.word('m7p_front') ^ self.sym['M7P_BUF'])
+        table = self.sym['M7P_TABLE']
+        return [bytes(self.m.read8(base + i * table + n) for n in range(size))
+                for i in range(3)]
+
+    def run(self, height, pitch, yaw):
+        cycles = self.call_update(height, pitch, yaw)
+        horizon, centre, rows = model(height, pitch, yaw, self.sc)
+        want = expected_tables(horizon, rows)
+        got = self.built_tables(len(want[0]))
+        ok = (got == [bytes(t) for t in want]
+              and self.word('m7p_next_horizon') == horizon
+              and self.word('m7p_next_centre') == centre)
+        idle = self.call_update(height, pitch, yaw)
+        self.show()
+        return {
+            'height': height, 'pitch': pitch, 'yaw': yaw,
+            'ground_rows': len(rows),
+            'cycles': cycles,
+            'cycles_per_row': round(cycles / len(rows), 1) if rows else None,
+            'unchanged_cycles': idle,
+            'projection_error': round(check_projection(height, pitch, yaw, horizon, rows), 4),
+            'ok': ok,
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--json', action='store_true', help='JSON output')
+    args = parser.parse_args()
+
+    bench = Bench()
+    results = [bench.run(*case) for case in CASES]
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+    else:
+        print('%6s %5s %4s %6s %8s %8s %9s %7s' % (
+            'height', 'pitch', 'yaw', 'rows', 'cycles', 'c/row', 'unchanged', 'error'))
+        for r in results:
+            print('%6d %5d %4d %6d %8d %8s %9d %6.1f%%%s' % (
+                r['height'], r['pitch'], r['yaw'], r['ground_rows'], r['cycles'],
+                r['cycles_per_row'], r['unchanged_cycles'], 100 * r['projection_error'],
+                '' if r['ok'] else '  MISMATCH'))
+    return 0 if all(r['ok'] for r in results) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
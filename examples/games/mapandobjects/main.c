@@ -22,6 +22,7 @@
  * @par SNES Concepts
  * - Map engine: tile scrolling with mapLoad/mapUpdate/mapVblank pipeline
  * - Object engine: entity registration, spawn from map data, update callbacks
+ * - Object grid: one objCollidPairs() query for all Mario/Goomba contacts
  * - Dynamic sprite engine: automatic VRAM tile allocation for animated sprites
  * - Multiple sprite palettes via CGRAM bank indexing
  * - SC_64x32 tilemap for horizontal scrolling levels
@@ -31,6 +32,7 @@
  * - Mario walks and jumps through a scrolling level
  * - Goombas walk back and forth, reversing at obstacles
  * - Koopa Troopas patrol with distinct movement patterns
+ * - Landing on a Goomba removes it (objCollidPairs() on the object grid)
  * - Camera scrolls to follow Mario's position
  * - All entities animate independently with the dynamic sprite engine
  *
@@ -81,6 +83,21 @@ extern void objRegisterTypes(void);
  */
 u16 nbobjects;
 
+/** @brief Object type numbers, as registered by objRegisterTypes() */
+#define TYPE_MARIO  0
+#define TYPE_GOOMBA 1
+
+/**
+ * @brief Pair callback: Mario landing on a Goomba stomps it.
+ *
+ * A killed object is no longer drawn, so its sprite disappears at the
+ * end of the frame.
+ */
+static void mariohitsgoomba(u16 mario, u16 goomba) {
+    if (marioyvel > 0)
+        objKill(goomba);
+}
+
 /**
  * @brief Main entry point -- scrolling platformer with map and object engines.
  *
@@ -121,8 +138,9 @@ int main(void) {
         oamDynamicInit(&dyn_cfg);
     }
 
-    /* Object engine */
+    /* Object engine, with the grid for objCollidPairs() */
     objInitEngine();
+    objGridEnable(1);
 
     /* Register object type callbacks (ASM for correct bank bytes) */
     nbobjects = 1; /* mario is always object 0 */
@@ -140,6 +158,7 @@ int main(void) {
     while (1) {
         mapUpdate();
         objUpdateAll();
+        objCollidPairs(TYPE_MARIO, TYPE_GOOMBA, mariohitsgoomba);
 
         WaitForVBlank();
         mapVblank();
@@ -19,6 +19,7 @@ extern u16 nbobjects;
 u16 pad0;
 u16 marioid;
 u16 mariox, marioy;
+s16 marioyvel;
 u8 mariofidx, marioflp, flip;
 
 static void mariowalk(void) {
@@ -124,6 +125,7 @@ void marioupdate(u16 idx) {
     /* Read updated position from workspace (24-bit: xpos[0]=frac, [1]=low, [2]=high) */
     mariox = objWorkspace.xpos[1] | (objWorkspace.xpos[2] << 8);
     marioy = objWorkspace.ypos[1] | (objWorkspace.ypos[2] << 8);
+    marioyvel = objWorkspace.yvel; /* > 0 while falling, for stomps */
 
     oambuffer[0].oamx = mariox - x_pos;
     oambuffer[0].oamy = marioy - y_pos;
@@ -3,6 +3,8 @@
 
 #include <snes.h>
 
+extern s16 marioyvel;
+
 void marioinit(u16 xp, u16 yp, u16 type, u16 minx, u16 maxx);
 void marioupdate(u16 idx);
 
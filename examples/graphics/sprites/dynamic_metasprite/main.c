@@ -128,8 +128,9 @@ void drawText(void) {
  * @brief Reinitialize sprite engine and upload all tiles during force blank.
  *
  * Uses force blank for a glitch-free OBJSEL switch. The current
- * configuration can enqueue >7 entries (config 2 hits 10), and the NMI
- * auto-flush hook drains 7 per VBlank, so `oamDynamicDrainQueue` loops
+ * configuration can enqueue more than one VBlank's upload budget, and the
+ * NMI auto-flush hook drains the queue budget by budget, so
+ * `oamDynamicDrainQueue` loops
  * `WaitForVBlank()` until the queue is empty before we release force
  * blank. NMI suppresses the end-frame "hide stale sprites" path during
  * the drain so the just-queued sprites are not pushed off-screen.
@@ -37,6 +37,14 @@
 .DEFINE OB_SCR_YLR_CHK      -64
 .DEFINE OB_SCR_YRR_CHK      288
 
+.DEFINE OB_GRID_CELL        32                  ; collision grid cell, pixels
+.DEFINE OB_GRID_COLS        12                  ; (OB_SCR_XRR_CHK - OB_SCR_XLR_CHK) / 32
+.DEFINE OB_GRID_ROWS        11                  ; (OB_SCR_YRR_CHK - OB_SCR_YLR_CHK) / 32
+.DEFINE OB_GRID_CELLS       (OB_GRID_COLS*OB_GRID_ROWS)
+.DEFINE OB_GRID_END         $FFFF
+
+.DEFINE OB_SLEEP_COLS       64                  ; sleeping objects, one list per 256-pixel column
+
 .DEFINE OB_SCR_XLE_CHK      -32
 .DEFINE OB_SCR_XRI_CHK      256
 .DEFINE OB_SCR_YLE_CHK      -32
@@ -142,6 +150,7 @@ objtokill       DB                          ; set to 1 to kill current object
 
 objbuffers      INSTANCEOF t_objs OB_MAX    ; object struct array (80 * 64 = 5120 bytes)
 objactives      DSW OB_TYPE_MAX             ; active object list heads
+objsleeplists   DSW OB_SLEEP_COLS           ; sleeping object list heads (must follow objactives)
 
 objfctinit      DSB 4*OB_TYPE_MAX           ; init function pointers
 objfctupd       DSB 4*OB_TYPE_MAX           ; update function pointers
@@ -168,6 +177,58 @@ objtmp2         DW
 objtmp3         DW
 objtmp4         DW
 
+objgridhead     DSW OB_GRID_CELLS           ; collision grid: first object (index*2) per cell
+objgridstamp    DSW OB_GRID_CELLS           ; objgridbuild that filled the cell
+objgridnext     DSW OB_MAX                  ; next object in the same cell (or large list)
+objgridtype     DSW OB_MAX                  ; object type, OB_GRID_END once killed
+objgridleft     DSW OB_MAX                  ; hitbox in world pixels, edges inclusive
+objgridright    DSW OB_MAX
+objgridtop      DSW OB_MAX
+objgridbottom   DSW OB_MAX
+objgridlist     DSW OB_MAX                  ; objects filed this frame (index*2)
+objgridcount    DW                          ; bytes used in objgridlist
+objgridlarge    DW                          ; objects larger than a cell
+objgridbuild    DW                          ; objUpdateAll pass number, never 0
+objgridx0       DW                          ; world position of cell (0,0)
+objgridy0       DW
+objgridon       DB                          ; 1 = objUpdateAll fills the grid
+
+objgridtype1    DW                          ; objCollidPairs state
+objgridtype2    DW
+objgridpairs    DW
+objgridi        DW
+objgrida        DW
+objgridb        DW
+objgridcx       DW
+objgridcx0      DW
+objgridcx1      DW
+objgridcy       DW
+objgridcy1      DW
+objgridtmp      DW
+
+objsleepin      DSW OB_MAX                  ; objactives offset of the object's sleep list, OB_NULL if awake
+objlinkidx      DW                          ; _oiunlink / _oilink object index
+objlinkhead     DW                          ; objactives offset of its list
+objtieron       DB                          ; 1 = objUpdateAll applies activity tiers
+objtiermargin   DW                          ; reduced-rate band width, pixels
+objtiermask     DW                          ; band update period - 1
+objsleepdist    DW                          ; sleep distance beyond the band, 0 = never sleep
+objframe        DW                          ; objUpdateAll pass counter (band stagger)
+objbandx        DW                          ; band, world position and size
+objbandy        DW
+objbandw        DW
+objbandh        DW
+objsleepx       DW                          ; objects outside this area fall asleep
+objsleepy       DW
+objsleepw       DW                          ; 0 = never sleep
+objsleeph       DW
+objwakex        DW                          ; sleeping objects inside this area wake up
+objwakey        DW
+objwakew        DW
+objwakeh        DW
+objwakecol      DW                          ; sleep list being scanned (objactives offset)
+objwakeend      DW
+
 .ENDS
 
 ;==============================================================================
@@ -295,7 +356,7 @@ _oieR2:
     sta objbuffers.1.next,x
     stz objunused
 
-    ldx #(2*(OB_TYPE_MAX-1))
+    ldx #(2*(OB_TYPE_MAX+OB_SLEEP_COLS-1))  ; active and sleep lists
 _oieR3:
     sta objactives,x
     dex
@@ -303,6 +364,13 @@ _oieR3:
     bne _oieR3
     sta objactives,x
 
+    ldx #(2*(OB_MAX-1))
+_oieR5:
+    sta objsleepin,x
+    dex
+    dex
+    bpl _oieR5
+
     stz.w objnewid
     stz.w objgetid
 
@@ -316,6 +384,28 @@ _oieR3:
     lda #FRICTION
     sta objfriction
 
+    ; Collision grid: off, empty, no cell stamped
+    stz objgridbuild
+    stz objgridcount
+    ldx #(2*(OB_GRID_CELLS-1))
+_oieR4:
+    stz objgridstamp,x
+    dex
+    dex
+    bpl _oieR4
+
+    ; Activity tiers: off
+    stz objtiermargin
+    stz objtiermask
+    stz objsleepdist
+    stz objsleepw
+    stz objframe
+
+    sep #$20
+    stz objgridon
+    stz objtieron
+    rep #$20
+
     ply
     plx
     plb
@@ -347,6 +437,78 @@ objInitGravity:
 
     rtl
 
+;------------------------------------------------------------------------------
+; void objSetActivityTiers(u16 margin, u8 rate, u16 sleepdist)
+; cproc L-to-R: sleepdist(p3) SP+10, rate(p2) SP+12, margin(p1) SP+14
+;------------------------------------------------------------------------------
+objSetActivityTiers:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$7e
+    pha
+    plb
+
+    rep #$20
+    lda 14,s                                ; margin (param 1)
+    sta objtiermargin
+    asl a
+    pha
+    clc
+    adc.w #OB_SCR_XRR_CHK-OB_SCR_XLR_CHK
+    sta objbandw
+    pla
+    clc
+    adc.w #OB_SCR_YRR_CHK-OB_SCR_YLR_CHK
+    sta objbandh
+
+    lda 12,s                                ; rate (param 2)
+    and #$00ff
+    bne _oiat1
+    inc a
+_oiat1:
+    dec a
+    sta objtiermask
+
+    lda 10,s                                ; sleepdist (param 3)
+    sta objsleepdist
+    beq _oiat2
+    asl a
+    pha
+    clc
+    adc objbandw
+    sta objsleepw
+    pla
+    clc
+    adc objbandh
+    sta objsleeph
+    bra _oiat3
+
+_oiat2:
+    stz objsleepw
+    jsr _oiwakeall                          ; no sleeping: back to the update lists
+
+_oiat3:
+    sep #$20
+    stz objtieron
+    rep #$20
+    lda 14,s
+    ora 10,s
+    beq _oiat4
+    sep #$20
+    inc objtieron
+
+_oiat4:
+    ply
+    plx
+    plb
+    plp
+    rtl
+
 ;------------------------------------------------------------------------------
 ; void objInitFunctions(u8 objtype, void *initfct, void *updfct, void *reffct)
 ; Stack: 5 6-9 10-13 14-16
@@ -609,66 +771,11 @@ _oik1:
     tax
     sta.l objptr
 
-    lda objbuffers.1.prev,x
-
-    cmp #OB_NULL
-    bne _oik2
-
-    sep #$20
-    lda objbuffers.1.type,x
-    rep #$20
+    lda 10,s
     and #$00ff
-    asl a
-    tay
-    lda objbuffers.1.next,x
-    sta objactives,y
-
-    cmp #OB_NULL
-    beq _oik3
-
-    asl a
-    asl a
-    asl a
-    asl a
-    asl a
-    asl a
-    tax
-    lda #OB_NULL
-    sta objbuffers.1.prev,x
-    bra _oik3
-
-_oik2:
-    lda objbuffers.1.next,x
-    tay
-    lda objbuffers.1.prev,x
-    asl a
-    asl a
-    asl a
-    asl a
-    asl a
-    asl a
-    tax
-    tya
-    sta objbuffers.1.next,x
-
-    cmp #OB_NULL
-    beq _oik3
-
-    ldx.w objptr
-    lda objbuffers.1.prev,x
-    tay
-    lda objbuffers.1.next,x
-    asl a
-    asl a
-    asl a
-    asl a
-    asl a
-    asl a
-    tax
-    tya
-    sta objbuffers.1.prev,x
+    sta objlinkidx
+    jsr _oiunlink                           ; out of its active or sleep list
 
-_oik3:
     ldx.w objptr
     lda objunused
     sta objbuffers.1.next,x
@@ -676,6 +783,13 @@ _oik3:
     and #$00ff
     sta objunused
 
+    asl a
+    tay
+    lda #OB_GRID_END
+    sta objgridtype,y                       ; drop from collision grid queries
+    lda #OB_NULL
+    sta objsleepin,y
+
     ldy #4
 _oik4:
     stz objbuffers.1.type,x
@@ -745,7 +859,7 @@ _oikal2:
 _oikal3:
     iny
     iny
-    cpy #OB_TYPE_MAX*2
+    cpy #(OB_TYPE_MAX+OB_SLEEP_COLS)*2      ; sleeping objects too
     bne _oikal1
 
     stz.w objnewid
@@ -803,6 +917,41 @@ objUpdateAll:
 
     stz objneedrefresh
 
+    lda objgridon
+    beq _oiual0
+    jsl objGridBegin
+_oiual0:
+
+    ; --- ACTIVITY TIERS: place the band, wake objects near the camera ---
+    lda objtieron
+    beq _oiual01
+    rep #$20
+    inc objframe
+    lda.l x_pos
+    clc
+    adc.w #OB_SCR_XLR_CHK
+    sec
+    sbc objtiermargin
+    sta objbandx
+    lda.l y_pos
+    clc
+    adc.w #OB_SCR_YLR_CHK
+    sec
+    sbc objtiermargin
+    sta objbandy
+    lda objsleepw
+    beq _oiual01
+    lda objbandx
+    sec
+    sbc objsleepdist
+    sta objsleepx
+    lda objbandy
+    sec
+    sbc objsleepdist
+    sta objsleepy
+    jsr _oiwake
+_oiual01:
+
     rep #$20
     ldx #$0000
 
@@ -846,7 +995,7 @@ _oiual3y:
     bcs _oiual32
 
 _oiual3y1:
-    jmp _oial4
+    brl _oiutier                            ; outside the update area
 
 _oiual32:
     lda objbuffers.1.xpos+1,x
@@ -930,7 +1079,13 @@ _oiual321:
 
     sep #$20
     lda.l objtokill
+    bne _oial41
+
+    ; --- BROADPHASE: file the object in the collision grid ---
+    lda objgridon
     beq _oial4
+    jsl objGridInsert
+    bra _oial4
 
 _oial41:
     rep #$20
@@ -1082,6 +1237,317 @@ _oiraend:
     plp
     rtl
 
+;------------------------------------------------------------------------------
+; objUpdateAll, object outside the update area (X = offset, next on stack):
+; update it every objtiermask+1 frames in the band, put it to sleep beyond
+; objsleepdist, otherwise leave it frozen
+;------------------------------------------------------------------------------
+_oiutier:
+    sep #$20
+    lda objtieron
+    bne _oiut0
+    brl _oial4
+
+_oiut0:
+    rep #$20
+    lda objbuffers.1.xpos+1,x
+    sec
+    sbc objbandx
+    cmp objbandw
+    bcs _oiut2
+    lda objbuffers.1.ypos+1,x
+    sec
+    sbc objbandy
+    cmp objbandh
+    bcs _oiut2
+
+    lda objframe                            ; staggered by object index
+    clc
+    adc objcidx
+    and objtiermask
+    beq _oiut1
+    brl _oial4
+_oiut1:
+    brl _oiual3sy1                          ; off-screen update
+
+_oiut2:
+    lda objsleepw
+    beq _oiut3
+    lda objbuffers.1.xpos+1,x
+    sec
+    sbc objsleepx
+    cmp objsleepw
+    bcs _oiut4
+    lda objbuffers.1.ypos+1,x
+    sec
+    sbc objsleepy
+    cmp objsleeph
+    bcs _oiut4
+_oiut3:
+    brl _oial4
+
+_oiut4:
+    lda objcidx
+    sta objlinkidx
+    jsr _oiunlink
+    lda objbuffers.1.xpos+1,x
+    jsr _oisleepcol
+    jsr _oilink
+    lda objcidx
+    asl a
+    tay
+    lda objlinkhead
+    sta objsleepin,y
+
+    sep #$20
+    lda objbuffers.1.onscreen,x
+    beq _oiut5
+    stz objbuffers.1.onscreen,x
+    lda objneedrefresh
+    bne _oiut5
+    lda #1
+    sta objneedrefresh
+    jsr objOamRefreshAll
+_oiut5:
+    brl _oial4
+
+;------------------------------------------------------------------------------
+; _oiwake - internal: move sleeping objects inside the wake area (the band
+; grown by objsleepdist / 2) back to their update lists
+;------------------------------------------------------------------------------
+_oiwake:
+    lda objsleepdist
+    lsr a
+    sta objwakecol                          ; half distance (scratch)
+    lda objbandx
+    sec
+    sbc objwakecol
+    sta objwakex
+    lda objbandy
+    sec
+    sbc objwakecol
+    sta objwakey
+    lda objwakecol
+    asl a
+    pha
+    clc
+    adc objbandw
+    sta objwakew
+    pla
+    clc
+    adc objbandh
+    sta objwakeh
+
+    lda objwakex
+    clc
+    adc objwakew
+    dec a
+    jsr _oisleepcol
+    sta objwakeend
+    lda objwakex
+    jsr _oisleepcol
+    sta objwakecol
+
+_oiwk1:
+    ldy objwakecol
+    lda objactives,y
+_oiwk2:
+    cmp #OB_NULL
+    beq _oiwk4
+    sta objlinkidx
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    tax
+    lda objbuffers.1.next,x
+    pha
+
+    lda objbuffers.1.xpos+1,x
+    sec
+    sbc objwakex
+    cmp objwakew
+    bcs _oiwk3
+    lda objbuffers.1.ypos+1,x
+    sec
+    sbc objwakey
+    cmp objwakeh
+    bcs _oiwk3
+    jsr _oiwakeone
+
+_oiwk3:
+    pla
+    bra _oiwk2
+
+_oiwk4:
+    lda objwakecol
+    cmp objwakeend
+    beq _oiwk5
+    inc a
+    inc a
+    sta objwakecol
+    bra _oiwk1
+
+_oiwk5:
+    rts
+
+;------------------------------------------------------------------------------
+; _oiwakeall - internal: wake every sleeping object
+;------------------------------------------------------------------------------
+_oiwakeall:
+    lda #OB_TYPE_MAX*2
+    sta objwakecol
+
+_oiwa1:
+    ldy objwakecol
+    lda objactives,y
+    cmp #OB_NULL
+    beq _oiwa2
+    sta objlinkidx
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    tax
+    jsr _oiwakeone
+    bra _oiwa1
+
+_oiwa2:
+    lda objwakecol
+    inc a
+    inc a
+    sta objwakecol
+    cmp #(OB_TYPE_MAX+OB_SLEEP_COLS)*2
+    bne _oiwa1
+    rts
+
+;------------------------------------------------------------------------------
+; _oiwakeone - internal: move sleeping object objlinkidx (offset X) to the
+; head of its type's update list
+;------------------------------------------------------------------------------
+_oiwakeone:
+    jsr _oiunlink
+    sep #$20
+    lda objbuffers.1.type,x
+    rep #$20
+    and #$00ff
+    asl a
+    jsr _oilink
+    lda objlinkidx
+    asl a
+    tay
+    lda #OB_NULL
+    sta objsleepin,y
+    rts
+
+;------------------------------------------------------------------------------
+; _oisleepcol - internal: A = world X -> A = objactives offset of the sleep
+; list for that column (negative X in the first, far X in the last)
+;------------------------------------------------------------------------------
+_oisleepcol:
+    cmp #$8000
+    bcc _oisc1
+    lda #0
+_oisc1:
+    xba
+    and #$00ff
+    cmp #OB_SLEEP_COLS
+    bcc _oisc2
+    lda #OB_SLEEP_COLS-1
+_oisc2:
+    asl a
+    clc
+    adc #OB_TYPE_MAX*2
+    rts
+
+;------------------------------------------------------------------------------
+; _oiunlink - internal: remove object objlinkidx (offset X) from the list it
+; is in: a sleep list if objsleepin says so, else objactives[type].
+; Keeps X; sets objlinkhead.
+;------------------------------------------------------------------------------
+_oiunlink:
+    lda objlinkidx
+    asl a
+    tay
+    lda objsleepin,y
+    cmp #OB_NULL
+    bne _oiul1
+    sep #$20
+    lda objbuffers.1.type,x
+    rep #$20
+    and #$00ff
+    asl a
+_oiul1:
+    sta objlinkhead
+
+    lda objbuffers.1.prev,x
+    cmp #OB_NULL
+    bne _oiul2
+    ldy objlinkhead
+    lda objbuffers.1.next,x
+    sta objactives,y
+    bra _oiul3
+
+_oiul2:
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    tay
+    lda objbuffers.1.next,x
+    sta objbuffers.1.next,y
+
+_oiul3:
+    lda objbuffers.1.next,x
+    cmp #OB_NULL
+    beq _oiul4
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    tay
+    lda objbuffers.1.prev,x
+    sta objbuffers.1.prev,y
+
+_oiul4:
+    rts
+
+;------------------------------------------------------------------------------
+; _oilink - internal: insert object objlinkidx (offset X) at the head of the
+; list at objactives offset A. Keeps X; sets objlinkhead.
+;------------------------------------------------------------------------------
+_oilink:
+    sta objlinkhead
+    tay
+    lda #OB_NULL
+    sta objbuffers.1.prev,x
+    lda objactives,y
+    sta objbuffers.1.next,x
+    cmp #OB_NULL
+    beq _oilk1
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    tay
+    lda objlinkidx
+    sta objbuffers.1.prev,y
+_oilk1:
+    ldy objlinkhead
+    lda objlinkidx
+    sta objactives,y
+    rts
+
 .ENDS
 
 ;==============================================================================
@@ -3122,3 +3588,410 @@ _oicmsend:
     rtl
 
 .ENDS
+
+;==============================================================================
+; CODE SECTION 7 - Collision grid (object-vs-object broadphase)
+;==============================================================================
+;
+; When enabled, objUpdateAll files every object it updated in a grid of
+; 32x32-pixel cells covering the update area (-64..320 x -64..288 around
+; the camera), and caches its hitbox in world pixels. objCollidPairs then
+; tests an object only against the objects filed in the cells its hitbox
+; touches, plus the column to the left and the row above, where an object
+; up to one cell in size can start. Objects larger than a cell go in one
+; list that every query scans.
+;
+; Cells are stamped with the pass number (objgridbuild) instead of being
+; cleared each frame. Objects are linked by index*2 through objgridnext.
+;==============================================================================
+
+.SECTION ".objects7_text" SUPERFREE
+
+.accu 16
+.index 16
+.16bit
+
+;------------------------------------------------------------------------------
+; void objGridEnable(u8 enable)
+;------------------------------------------------------------------------------
+objGridEnable:
+    php
+    sep #$20
+    lda 5,s                                 ; enable
+    sta.l objgridon
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; objGridBegin - internal: empty the grid (objUpdateAll, DB = $7E)
+;------------------------------------------------------------------------------
+objGridBegin:
+    php
+    rep #$20
+
+    inc objgridbuild                        ; new pass: every stamp is stale
+    bne _ogb1
+    inc objgridbuild                        ; 0 is the "never filled" stamp
+_ogb1:
+    stz objgridcount
+    lda #OB_GRID_END
+    sta objgridlarge
+
+    lda.l x_pos
+    clc
+    adc.w #OB_SCR_XLR_CHK
+    sta objgridx0
+    lda.l y_pos
+    clc
+    adc.w #OB_SCR_YLR_CHK
+    sta objgridy0
+
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; objGridInsert - internal: file the current object (objUpdateAll, DB = $7E)
+; X = object offset in objbuffers, objcidx = its index. X/Y preserved.
+;------------------------------------------------------------------------------
+objGridInsert:
+    php
+    phx
+    phy
+    rep #$30
+
+    lda objcidx
+    asl a
+    tay                                     ; Y = index * 2
+
+    ; Hitbox, negative edges clamped to 0 (as objCollidObj)
+    lda objbuffers.1.xpos+1,x
+    clc
+    adc objbuffers.1.xofs,x
+    bpl _ogi1
+    lda #$0000
+_ogi1:
+    sta objgridleft,y
+    clc
+    adc objbuffers.1.width,x
+    sta objgridright,y
+
+    lda objbuffers.1.ypos+1,x
+    clc
+    adc objbuffers.1.yofs,x
+    bpl _ogi2
+    lda #$0000
+_ogi2:
+    sta objgridtop,y
+    clc
+    adc objbuffers.1.height,x
+    sta objgridbottom,y
+
+    lda objbuffers.1.type,x
+    and #$00ff
+    sta objgridtype,y
+
+    lda objbuffers.1.width,x
+    cmp #OB_GRID_CELL+1
+    bcs _ogilarge
+    lda objbuffers.1.height,x
+    cmp #OB_GRID_CELL+1
+    bcs _ogilarge
+
+    ; Cell of the top-left corner
+    lda objgridleft,y
+    jsr _ogcol
+    asl a
+    sta objgridtmp
+    lda objgridtop,y
+    jsr _ogrow
+    jsr _ogrowofs
+    clc
+    adc objgridtmp
+    tax                                     ; X = cell * 2
+
+    lda objgridstamp,x
+    cmp objgridbuild
+    beq _ogi3
+    lda objgridbuild                        ; first object in the cell this pass
+    sta objgridstamp,x
+    lda #OB_GRID_END
+    bra _ogi4
+_ogi3:
+    lda objgridhead,x
+_ogi4:
+    sta objgridnext,y
+    tya
+    sta objgridhead,x
+    bra _ogi5
+
+_ogilarge:
+    lda objgridlarge
+    sta objgridnext,y
+    sty objgridlarge
+
+_ogi5:
+    tya
+    ldx objgridcount
+    sta objgridlist,x
+    inx
+    inx
+    stx objgridcount
+
+    ply
+    plx
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; _ogcol / _ogrow - internal: grid column / row of a world X / Y in A,
+; clamped to the grid. _ogrowofs: row -> byte offset of its first cell.
+;------------------------------------------------------------------------------
+_ogcol:
+    sec
+    sbc objgridx0
+    bpl _ogc1
+    lda #$0000
+_ogc1:
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    cmp #OB_GRID_COLS
+    bcc _ogc2
+    lda #OB_GRID_COLS-1
+_ogc2:
+    rts
+
+_ogrow:
+    sec
+    sbc objgridy0
+    bpl _ogr1
+    lda #$0000
+_ogr1:
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    cmp #OB_GRID_ROWS
+    bcc _ogr2
+    lda #OB_GRID_ROWS-1
+_ogr2:
+    rts
+
+_ogrowofs:
+    asl a
+    asl a
+    asl a
+    sta objgridcy                           ; row * 8 (scratch)
+    asl a
+    clc
+    adc objgridcy                           ; row * 24 = row * OB_GRID_COLS * 2
+    rts
+
+;------------------------------------------------------------------------------
+; u16 objCollidPairs(u8 type1, u8 type2, void *fct)
+; cproc L-to-R: fct(p3) SP+10 (bank SP+12), type2(p2) SP+14, type1(p1) SP+16
+;
+; Calls fct(handle1, handle2) for each overlapping pair (type1, type2) among
+; the objects filed by the last objUpdateAll. Same-type pairs are reported
+; once. Returns the number of pairs.
+;------------------------------------------------------------------------------
+objCollidPairs:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$7e
+    pha
+    plb
+
+    rep #$30
+    lda 10,s                                ; fct (param 3), low 16 bits
+    sta objfctcall
+    lda 12,s                                ; fct bank
+    and #$00ff
+    sta objfctcallh
+    lda 16,s                                ; type1 (param 1)
+    and #$00ff
+    sta objgridtype1
+    lda 14,s                                ; type2 (param 2)
+    and #$00ff
+    sta objgridtype2
+    stz objgridpairs
+    stz objgridi
+
+_ogp1:
+    ldx objgridi
+    cpx objgridcount
+    bne _ogp2
+    brl _ogpend
+_ogp2:
+    inx
+    inx
+    stx objgridi
+    ldy objgridlist-2,x                     ; Y = first object (index * 2)
+    lda objgridtype,y
+    cmp objgridtype1
+    bne _ogp1
+    sty objgrida
+
+    ; Cells from (col(left) - 1, row(top) - 1) to (col(right), row(bottom))
+    lda objgridleft,y
+    jsr _ogcol
+    dec a
+    bpl _ogp3
+    lda #$0000
+_ogp3:
+    asl a
+    sta objgridcx0
+    lda objgridright,y
+    jsr _ogcol
+    asl a
+    sta objgridcx1
+    lda objgridbottom,y
+    jsr _ogrow
+    jsr _ogrowofs
+    sta objgridcy1
+    lda objgridtop,y
+    jsr _ogrow
+    dec a
+    bpl _ogp4
+    lda #$0000
+_ogp4:
+    jsr _ogrowofs
+    sta objgridcy                           ; first row
+
+_ogprow:
+    lda objgridcx0
+    sta objgridcx
+_ogpcell:
+    lda objgridcy
+    clc
+    adc objgridcx
+    tax
+    lda objgridstamp,x
+    cmp objgridbuild
+    bne _ogpnext
+    lda objgridhead,x
+    jsr _ogscan
+    bcs _ogp1                               ; first object was killed
+_ogpnext:
+    lda objgridcx
+    cmp objgridcx1
+    beq _ogpnextrow
+    inc a
+    inc a
+    sta objgridcx
+    bra _ogpcell
+_ogpnextrow:
+    lda objgridcy
+    cmp objgridcy1
+    beq _ogplarge
+    clc
+    adc #OB_GRID_COLS*2
+    sta objgridcy
+    bra _ogprow
+
+_ogplarge:
+    lda objgridlarge
+    jsr _ogscan
+    brl _ogp1
+
+_ogpend:
+    lda objgridpairs
+
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; _ogscan - internal: test objgrida against the list starting at A
+; Returns carry set if the callback killed objgrida.
+;------------------------------------------------------------------------------
+_ogscan:
+    cmp #OB_GRID_END
+    bne _ogs1
+    clc
+    rts
+_ogs1:
+    tax                                     ; X = second object (index * 2)
+    stx objgridb
+    ldy objgrida
+
+    lda objgridtype,x
+    cmp objgridtype2
+    bne _ogsnext
+    lda objgridtype1
+    cmp objgridtype2
+    bne _ogs2
+    cpx objgrida                            ; same type: only pairs with B after A
+    bcc _ogsnext
+    beq _ogsnext
+
+_ogs2:
+    ; Overlap, edges inclusive (as objCollidObj)
+    lda objgridright,x
+    cmp objgridleft,y
+    bcc _ogsnext
+    lda objgridright,y
+    cmp objgridleft,x
+    bcc _ogsnext
+    lda objgridbottom,x
+    cmp objgridtop,y
+    bcc _ogsnext
+    lda objgridbottom,y
+    cmp objgridtop,x
+    bcc _ogsnext
+
+    inc objgridpairs
+    tya
+    jsr _oghandle
+    pha                                     ; handle1
+    lda objgridb
+    jsr _oghandle
+    pha                                     ; handle2
+    sep #$20
+    jsl jslcallfct
+    rep #$30
+    pla
+    pla
+
+    ldy objgrida
+    lda objgridtype,y
+    cmp #OB_GRID_END
+    bne _ogsnext
+    sec
+    rts
+
+_ogsnext:
+    ldx objgridb
+    lda objgridnext,x
+    bra _ogscan
+
+;------------------------------------------------------------------------------
+; _oghandle - internal: index * 2 in A -> handle (nID << 8 | index) in A
+;------------------------------------------------------------------------------
+_oghandle:
+    lsr a
+    sta objgridtmp                          ; index
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    tax
+    lda objbuffers.1.nID,x
+    and #$00ff
+    xba
+    ora objgridtmp
+    rts
+
+.ENDS
@@ -0,0 +1,598 @@
+;==============================================================================
+; OpenSNES Object Pool
+;==============================================================================
+;
+; Structure-of-arrays store for many small, simple objects (bullets, sparks,
+; swarms). Hot fields live in parallel arrays in Bank $00, so C reads them
+; directly: no workspace copy, no 64-byte record, no index*64.
+;
+; Every type owns a fixed run of slots, reserved by poolSetType(). Live
+; objects of a type are kept packed at the start of its run (poolKill moves
+; the last one into the hole), so poolUpdateAll() makes a single call per
+; type: update(first, count), and the callback loops over its own slots.
+;
+; Handles stay valid while objects move: pool_slot maps handle -> slot and
+; pool_id maps slot -> handle.
+;
+; License: MIT
+;
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+;------------------------------------------------------------------------------
+; Constants
+;------------------------------------------------------------------------------
+
+.DEFINE POOL_MAX            64
+.DEFINE POOL_TYPE_MAX       16
+.DEFINE POOL_NULL           $FFFF
+.DEFINE POOL_DEAD           $FF                 ; pool_slot of a free handle
+
+;------------------------------------------------------------------------------
+; RAM - Bank $00 (C-accessible)
+;------------------------------------------------------------------------------
+
+.RAMSECTION ".objpool_bank00" BANK 0 SLOT 1
+
+pool_x          DSW POOL_MAX                ; X position, pixels
+pool_y          DSW POOL_MAX                ; Y position, pixels
+pool_xvel       DSW POOL_MAX                ; X velocity, 8.8 pixels per frame
+pool_yvel       DSW POOL_MAX                ; Y velocity, 8.8 pixels per frame
+pool_xsub       DSB POOL_MAX                ; X position fraction (1/256 pixel)
+pool_ysub       DSB POOL_MAX                ; Y position fraction
+pool_type       DSB POOL_MAX                ; object type
+pool_flags      DSB POOL_MAX                ; game-defined, 0 at poolNew
+pool_id         DSB POOL_MAX                ; handle of the object in the slot
+
+pool_slot       DSB POOL_MAX                ; slot of each handle, POOL_DEAD if free
+pool_free       DSB POOL_MAX                ; stack of free handles
+pool_freecount  DW                          ; entries in pool_free
+
+pool_first      DSW POOL_TYPE_MAX           ; first slot of each type
+pool_cap        DSW POOL_TYPE_MAX           ; slots reserved (0 = type not set)
+pool_count      DSW POOL_TYPE_MAX           ; live objects
+pool_upd        DSW POOL_TYPE_MAX           ; update function, low 16 bits
+pool_updbank    DSW POOL_TYPE_MAX           ; update function bank ($00:0000 = none)
+pool_next       DW                          ; first slot not yet reserved
+
+pool_fct        DW                          ; function called by _opcall
+pool_fctbank    DW                          ; its bank
+pool_t          DW                          ; poolUpdateAll: type * 2
+pool_left       DW                          ; poolMove: objects left
+pool_hole       DW                          ; poolKill: slot being freed
+pool_tmp        DW
+
+.ENDS
+
+.SECTION ".objpool_text" SUPERFREE
+
+;------------------------------------------------------------------------------
+; void poolInit(void)
+;------------------------------------------------------------------------------
+poolInit:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$00
+    pha
+    plb
+
+    rep #$30
+    ldx #(POOL_TYPE_MAX-1)*2
+_opi1:
+    stz pool_first.w,x
+    stz pool_cap.w,x
+    stz pool_count.w,x
+    stz pool_upd.w,x
+    stz pool_updbank.w,x
+    dex
+    dex
+    bpl _opi1
+    stz pool_next.w
+
+    ; Free stack holds POOL_MAX-1 .. 0, so handle 0 is given out first
+    lda #POOL_MAX
+    sta pool_freecount.w
+    sep #$20
+    ldx #0
+    lda #POOL_MAX-1
+_opi2:
+    sta pool_free.w,x
+    xba
+    lda #POOL_DEAD
+    sta pool_slot.w,x
+    xba
+    inx
+    dec a
+    bpl _opi2
+
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 poolSetType(u8 type, u8 capacity, PoolUpdateFunction update)
+; cproc L-to-R: update(p3) SP+10 (bank SP+12), capacity(p2) SP+14,
+;               type(p1) SP+16
+;
+; Reserves the next `capacity` slots for the type and returns the first one,
+; or POOL_NULL. A type already set keeps its slots; only update changes.
+;------------------------------------------------------------------------------
+poolSetType:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$00
+    pha
+    plb
+
+    rep #$30
+    lda 16,s                                ; type (param 1)
+    and #$00ff
+    cmp #POOL_TYPE_MAX
+    bcs _opstnull
+    asl a
+    tax
+
+    lda 10,s                                ; update (param 3), low 16 bits
+    sta pool_upd.w,x
+    lda 12,s                                ; update bank
+    and #$00ff
+    sta pool_updbank.w,x
+    lda pool_cap.w,x
+    bne _opstdone
+
+    lda 14,s                                ; capacity (param 2)
+    and #$00ff
+    beq _opstnull
+    sta pool_cap.w,x
+    clc
+    adc pool_next.w
+    cmp #POOL_MAX+1
+    bcs _opstfull
+    ldy pool_next.w
+    sta pool_next.w
+    tya
+    sta pool_first.w,x
+    stz pool_count.w,x
+
+_opstdone:
+    lda pool_first.w,x
+    bra _opstend
+
+_opstfull:
+    stz pool_cap.w,x
+_opstnull:
+    lda #POOL_NULL
+
+_opstend:
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 poolNew(u8 type, u16 x, u16 y)
+; cproc L-to-R: y(p3) SP+10, x(p2) SP+12, type(p1) SP+14
+;
+; Appends an object at rest to its type's batch. Returns its handle, or
+; POOL_NULL if the batch is full or the type was never set.
+;------------------------------------------------------------------------------
+poolNew:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$00
+    pha
+    plb
+
+    rep #$30
+    lda 14,s                                ; type (param 1)
+    and #$00ff
+    cmp #POOL_TYPE_MAX
+    bcs _opnnull
+    asl a
+    tax
+    lda pool_count.w,x
+    cmp pool_cap.w,x
+    bcs _opnnull
+    inc a
+    sta pool_count.w,x
+    dec a
+    clc
+    adc pool_first.w,x
+    tay                                     ; Y = slot
+
+    ; Reserved slots never exceed POOL_MAX, so a handle is always free here
+    lda pool_freecount.w
+    dec a
+    sta pool_freecount.w
+    tax
+    lda pool_free.w,x
+    and #$00ff
+    tax                                     ; X = handle
+
+    sep #$20
+    tya
+    sta pool_slot.w,x
+    txa
+    sta pool_id.w,y
+    lda 14,s
+    sta pool_type.w,y
+    lda #0
+    sta pool_xsub.w,y
+    sta pool_ysub.w,y
+    sta pool_flags.w,y
+
+    rep #$20
+    tya
+    asl a
+    tay
+    lda 12,s                                ; x (param 2)
+    sta pool_x.w,y
+    lda 10,s                                ; y (param 3)
+    sta pool_y.w,y
+    lda #0
+    sta pool_xvel.w,y
+    sta pool_yvel.w,y
+    txa
+    bra _opnend
+
+_opnnull:
+    lda #POOL_NULL
+
+_opnend:
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; void poolKill(u16 handle)
+; cproc: handle(p1) SP+10
+;
+; Frees the handle and moves the last object of the batch into the slot.
+; Handles that are out of range or already free are ignored.
+;------------------------------------------------------------------------------
+poolKill:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$00
+    pha
+    plb
+
+    rep #$30
+    lda 10,s                                ; handle (param 1)
+    cmp #POOL_MAX
+    bcs _opkend
+    tax
+    lda pool_slot.w,x
+    and #$00ff
+    cmp #POOL_MAX
+    bcs _opkend
+    sta pool_hole.w
+
+    ; Release the handle
+    ldy pool_freecount.w
+    sep #$20
+    lda #POOL_DEAD
+    sta pool_slot.w,x
+    txa
+    sta pool_free.w,y
+    rep #$20
+    iny
+    sty pool_freecount.w
+
+    ; Shrink the batch; Y = its last slot
+    ldx pool_hole.w
+    lda pool_type.w,x
+    and #$00ff
+    asl a
+    tay
+    lda pool_count.w,y
+    dec a
+    sta pool_count.w,y
+    clc
+    adc pool_first.w,y
+    cmp pool_hole.w
+    beq _opkend                             ; it was the last one: nothing moves
+    tay
+
+    ; Move slot Y into slot X (pool_type is the same in a batch)
+    sep #$20
+    lda pool_xsub.w,y
+    sta pool_xsub.w,x
+    lda pool_ysub.w,y
+    sta pool_ysub.w,x
+    lda pool_flags.w,y
+    sta pool_flags.w,x
+    lda pool_id.w,y
+    sta pool_id.w,x
+    rep #$20
+    and #$00ff
+    phy
+    tay                                     ; Y = handle of the moved object
+    sep #$20
+    txa
+    sta pool_slot.w,y
+    rep #$20
+    ply
+
+    txa
+    asl a
+    tax
+    tya
+    asl a
+    tay
+    lda pool_x.w,y
+    sta pool_x.w,x
+    lda pool_y.w,y
+    sta pool_y.w,x
+    lda pool_xvel.w,y
+    sta pool_xvel.w,x
+    lda pool_yvel.w,y
+    sta pool_yvel.w,x
+
+_opkend:
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 poolSlot(u16 handle)
+; cproc: handle(p1) SP+10
+;
+; Returns the current slot of the handle, or POOL_NULL if it is free.
+;------------------------------------------------------------------------------
+poolSlot:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$00
+    pha
+    plb
+
+    rep #$30
+    lda 10,s                                ; handle (param 1)
+    cmp #POOL_MAX
+    bcs _opsnull
+    tax
+    lda pool_slot.w,x
+    and #$00ff
+    cmp #POOL_MAX
+    bcc _opsend
+
+_opsnull:
+    lda #POOL_NULL
+
+_opsend:
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 poolCount(u8 type)
+; cproc: type(p1) SP+10
+;------------------------------------------------------------------------------
+poolCount:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$00
+    pha
+    plb
+
+    rep #$30
+    lda 10,s                                ; type (param 1)
+    and #$00ff
+    cmp #POOL_TYPE_MAX
+    bcs _opczero
+    asl a
+    tax
+    lda pool_count.w,x
+    bra _opcend
+
+_opczero:
+    lda #0
+
+_opcend:
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; void poolMove(u8 type)
+; cproc: type(p1) SP+10
+;
+; Adds velocity to position for every object of the type (8.8 velocity into
+; pixel + fraction position), in one pass over the arrays.
+;------------------------------------------------------------------------------
+poolMove:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$00
+    pha
+    plb
+
+    rep #$30
+    lda 10,s                                ; type (param 1)
+    and #$00ff
+    cmp #POOL_TYPE_MAX
+    bcs _opmend
+    asl a
+    tax
+    lda pool_count.w,x
+    beq _opmend
+    sta pool_left.w
+    lda pool_first.w,x
+    tay                                     ; Y = slot (byte arrays)
+    asl a
+    tax                                     ; X = slot * 2 (word arrays)
+
+_opm1:
+    lda pool_xvel.w,x
+    xba
+    and #$00ff
+    eor #$0080
+    sec
+    sbc #$0080
+    sta pool_tmp.w                          ; whole pixels, sign-extended
+    sep #$20
+    lda pool_xvel.w,x                       ; fraction
+    clc
+    adc pool_xsub.w,y
+    sta pool_xsub.w,y
+    rep #$20
+    lda pool_x.w,x
+    adc pool_tmp.w
+    sta pool_x.w,x
+
+    lda pool_yvel.w,x
+    xba
+    and #$00ff
+    eor #$0080
+    sec
+    sbc #$0080
+    sta pool_tmp.w
+    sep #$20
+    lda pool_yvel.w,x
+    clc
+    adc pool_ysub.w,y
+    sta pool_ysub.w,y
+    rep #$20
+    lda pool_y.w,x
+    adc pool_tmp.w
+    sta pool_y.w,x
+
+    inx
+    inx
+    iny
+    dec pool_left.w
+    bne _opm1
+
+_opmend:
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; void poolUpdateAll(void)
+;
+; Calls update(first, count) once for each type with live objects, in type
+; order. The count is taken before the call: objects a callback creates in
+; its own batch wait for the next frame.
+;------------------------------------------------------------------------------
+poolUpdateAll:
+    php
+    phb
+
+    phx
+    phy
+
+    sep #$20
+    lda #$00
+    pha
+    plb
+
+    rep #$30
+    stz pool_t.w
+
+_opu1:
+    ldx pool_t.w
+    lda pool_count.w,x
+    beq _opu2
+    lda pool_updbank.w,x
+    sta pool_fctbank.w
+    ora pool_upd.w,x
+    beq _opu2
+    lda pool_upd.w,x
+    sta pool_fct.w
+
+    lda pool_first.w,x
+    pha
+    lda pool_count.w,x
+    pha
+    jsl _opcall
+    rep #$30
+    pla
+    pla
+
+_opu2:
+    lda pool_t.w
+    inc a
+    inc a
+    sta pool_t.w
+    cmp #POOL_TYPE_MAX*2
+    bne _opu1
+
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; Long call to the C function in pool_fct
+;------------------------------------------------------------------------------
+_opcall:
+    sep #$20
+    lda.l pool_fctbank
+    pha
+    rep #$20
+    lda.l pool_fct
+    dec a
+    pha
+    rtl
+
+.ENDS
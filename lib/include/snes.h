@@ -13,6 +13,7 @@
  * - `<snes/sram.h>` — battery-backed save RAM
  * - `<snes/collision.h>` — bounding-box collision
  * - `<snes/lzss.h>` — LZSS decompression to VRAM
+ * - `<snes/lz4.h>` — fast LZ4-style decompression to WRAM / VRAM
  * - `<snes/gameloop.h>` — gameloop framework opt-in
  * - `<snes/asset.h>` — typed background / tileset bundles
  * - `<snes/scene.h>` — push/pop scene stack
@@ -133,9 +134,11 @@
  *   #include <snes/sram.h>      // battery-backed save RAM
  *   #include <snes/collision.h> // bounding-box collision
  *   #include <snes/lzss.h>      // LZSS decompression to VRAM
+ *   #include <snes/lz4.h>       // fast LZ4-style decompression to WRAM / VRAM
  *   #include <snes/gameloop.h>  // gameloop framework opt-in
  *   #include <snes/asset.h>     // typed BgAsset / GfxAsset bundles
  *   #include <snes/scene.h>     // push/pop scene stack
+ *   #include <snes/irq.h>       // raster IRQ scheduler, per-scanline callbacks
  */
 
 #endif /* OPENSNES_H */
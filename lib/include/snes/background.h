@@ -216,4 +216,73 @@ void bgInitTileSetData(u8 bgNumber, u8 *tileSource, u16 tileSize, u16 vramAddr);
 #define bgClearTilemap(vramAddr, fillTile, sizeBytes) \
     dmaFillVRAM((u16)(fillTile), (u16)(vramAddr), (u16)(sizeBytes))
 
+/*============================================================================
+ * Shadow Tilemaps
+ *============================================================================*/
+
+/** @brief Number of shadow tilemap slots flushed by the NMI handler */
+#define BG_SHADOW_SLOTS  4
+
+/** @brief Slot used by the text module (textInit attaches tilemapBuffer) */
+#define BG_SHADOW_TEXT   0
+
+/**
+ * @brief Attach a WRAM shadow copy of a 32x32 tilemap to a flush slot
+ *
+ * The NMI handler copies the rows you mark dirty from @p buffer to VRAM
+ * during the next VBlank, so the tilemap can be edited at any time
+ * without forced blank. Each slot has its own VRAM target and dirty rows;
+ * several layers (HUD on BG3, dialog box on BG2, ...) can be buffered at
+ * once.
+ *
+ * Slots are flushed in order, slot 0 first. When the per-VBlank DMA budget
+ * (dmaSetVBlankBudget()) is spent, the remaining slots keep their dirty
+ * rows for the next VBlank — put the layer that must never lag in the
+ * lowest slot. Slot 0 is used by the text module; a slot that starts
+ * flushing always finishes in the same VBlank.
+ *
+ * @param slot Slot number (0 to BG_SHADOW_SLOTS-1)
+ * @param buffer 2048-byte buffer in bank $00 WRAM (a C global)
+ * @param vramAddr VRAM word address of the tilemap
+ *
+ * @code
+ * u8 dialogMap[2048];
+ *
+ * bgShadowAttach(1, dialogMap, 0x1000);     // BG2 tilemap at $1000
+ * dialogMap[(5 * 32 + 4) * 2] = 0x21;       // edit row 5
+ * bgShadowMarkRow(1, 5);                    // sent next VBlank
+ * @endcode
+ *
+ * @note Attaching does not flush; call bgShadowMarkAll() to upload the
+ *       whole buffer.
+ */
+void bgShadowAttach(u8 slot, u8 *buffer, u16 vramAddr);
+
+/**
+ * @brief Stop flushing a shadow tilemap slot
+ *
+ * Pending dirty rows are dropped.
+ *
+ * @param slot Slot number (0 to BG_SHADOW_SLOTS-1)
+ */
+void bgShadowDetach(u8 slot);
+
+/**
+ * @brief Mark one row of a shadow tilemap for the next VBlank
+ *
+ * Only dirty rows are sent (64 bytes each); adjacent dirty rows are merged
+ * into a single DMA.
+ *
+ * @param slot Slot number (0 to BG_SHADOW_SLOTS-1)
+ * @param row Tilemap row (0-31)
+ */
+void bgShadowMarkRow(u8 slot, u8 row);
+
+/**
+ * @brief Mark a whole shadow tilemap for the next VBlank (2048 bytes)
+ *
+ * @param slot Slot number (0 to BG_SHADOW_SLOTS-1)
+ */
+void bgShadowMarkAll(u8 slot);
+
 #endif /* OPENSNES_BACKGROUND_H */
@@ -10,6 +10,7 @@
  * - Rectangle vs rectangle (AABB) collision
  * - Point vs rectangle collision
  * - Tile-based collision for platformers
+ * - Swept (moving) rectangle vs rectangle and vs tilemap
  * - Bounding box helpers
  *
  * ## Usage Example
@@ -58,6 +59,36 @@ typedef struct {
     u16 height;     /**< Height in pixels */
 } Rect;
 
+/**
+ * @brief Result of a swept collision test
+ *
+ * The normal points back against the motion on each axis that was
+ * blocked: moving right into a wall gives normalX = -1.
+ */
+typedef struct {
+    s16 x;          /**< Position reached: left edge X */
+    s16 y;          /**< Position reached: top edge Y */
+    u16 time;       /**< Time of impact, 0 to COLLIDE_TIME_ONE (8.8 fixed point) */
+    s8 normalX;     /**< -1 / 1 if stopped by a side facing left / right, else 0 */
+    s8 normalY;     /**< -1 / 1 if stopped by a side facing up / down, else 0 */
+} SweepHit;
+
+/*============================================================================
+ * Constants
+ *============================================================================*/
+
+/** @brief SweepHit time of the whole motion (no hit), 1.0 in 8.8 fixed point */
+#define COLLIDE_TIME_ONE    0x0100
+
+/** @brief Largest motion per axis of one sweep; longer moves are clamped */
+#define COLLIDE_SWEEP_MAX   4095
+
+/** @brief collideMoveTile(): the X motion was blocked */
+#define COLLIDE_HIT_X       0x01
+
+/** @brief collideMoveTile(): the Y motion was blocked */
+#define COLLIDE_HIT_Y       0x02
+
 /*============================================================================
  * Rectangle Collision Functions
  *============================================================================*/
@@ -183,6 +214,87 @@ u8 collideTileEx(s16 px, s16 py, u8 *tilemap, u16 mapWidth, u8 tileSize);
  */
 u8 collideRectTile(Rect *r, u8 *tilemap, u16 mapWidth);
 
+/*============================================================================
+ * Swept Collision Functions
+ *
+ * The static tests above only see where an object ends up, so one that
+ * moves more than its own size in a frame can tunnel through a thin wall.
+ * A sweep follows the whole motion in one call: the tilemap version walks
+ * the tile boundaries the rectangle crosses, in order, and only tests the
+ * column or row of tiles it enters (8x8 tiles, no division per tile).
+ *============================================================================*/
+
+/**
+ * @brief Move a rectangle against another one
+ *
+ * Finds when a, moving by (dx, dy), first overlaps the still b. Touching
+ * edges do not count.
+ *
+ * @param a   Moving rectangle, at its starting position
+ * @param dx  X motion in pixels
+ * @param dy  Y motion in pixels
+ * @param b   Still rectangle (move it by the opposite of its own motion
+ *            first for two moving ones)
+ * @param hit Contact position, time and normal; the end position and
+ *            COLLIDE_TIME_ONE if there is no hit
+ * @return 1 on contact (time 0 and no normal if they already overlap),
+ *         0 otherwise
+ *
+ * @code
+ * SweepHit hit;
+ * if (collideSweepRect(&bullet, bvx, bvy, &enemy, &hit)) {
+ *     explode(hit.x, hit.y);
+ * }
+ * @endcode
+ */
+u8 collideSweepRect(Rect *a, s16 dx, s16 dy, Rect *b, SweepHit *hit);
+
+/**
+ * @brief Move a rectangle through a tilemap until it meets a solid tile
+ *
+ * Tiles the rectangle overlaps at its starting position are ignored.
+ * Tiles off the map are solid. When the rectangle enters a column and a
+ * row of tiles at the same instant and only the tile in the corner is
+ * solid, both normals are set.
+ *
+ * @param r         Moving rectangle (at least 1x1), at its starting position
+ * @param dx        X motion in pixels
+ * @param dy        Y motion in pixels
+ * @param tilemap   Collision tilemap (1 byte per 8x8 tile, nonzero = solid)
+ * @param mapWidth  Width of tilemap in tiles
+ * @param mapHeight Height of tilemap in tiles
+ * @param hit       Position touching the tile, time and normal; the end
+ *                  position and COLLIDE_TIME_ONE if there is no hit
+ * @return 1 if a solid tile stopped the motion, 0 otherwise
+ */
+u8 collideSweepTile(Rect *r, s16 dx, s16 dy, u8 *tilemap, u16 mapWidth,
+                    u16 mapHeight, SweepHit *hit);
+
+/**
+ * @brief Move a rectangle through a tilemap, sliding along walls
+ *
+ * Sweeps the motion with collideSweepTile() and, on a hit, sweeps what is
+ * left of it along the axis that was not blocked. Updates r->x and r->y.
+ *
+ * @param r         Rectangle to move
+ * @param dx        X motion in pixels
+ * @param dy        Y motion in pixels
+ * @param tilemap   Collision tilemap (1 byte per 8x8 tile, nonzero = solid)
+ * @param mapWidth  Width of tilemap in tiles
+ * @param mapHeight Height of tilemap in tiles
+ * @return COLLIDE_HIT_X and/or COLLIDE_HIT_Y for the blocked axes
+ *
+ * @code
+ * // A dash of 24 pixels per frame cannot skip a wall one tile thick
+ * Rect player = { px, py, 16, 16 };
+ * u8 blocked = collideMoveTile(&player, vx, vy, level, 32, 28);
+ * if (blocked & COLLIDE_HIT_Y) vy = 0;
+ * px = player.x;
+ * py = player.y;
+ * @endcode
+ */
+u8 collideMoveTile(Rect *r, s16 dx, s16 dy, u8 *tilemap, u16 mapWidth, u16 mapHeight);
+
 /*============================================================================
  * Helper Functions
  *============================================================================*/
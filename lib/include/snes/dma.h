@@ -194,4 +194,148 @@ void dmaCopyOam(u8 *source, u16 size);
  */
 void dmaTransfer(u8 channel, u8 mode, u8 srcBank, u16 srcAddr, u8 destReg, u16 size);
 
+/*============================================================================
+ * VBlank Budget
+ *============================================================================*/
+
+/**
+ * @brief Default per-VBlank DMA budget in bytes
+ *
+ * Shared by every NMI transfer: OAM (544), the shadow tilemap flush,
+ * dynamic sprite uploads and the DMA queue. Matches the ~4 KB practical
+ * limit.
+ */
+#define DMA_VBLANK_BUDGET 4096
+
+/**
+ * @brief Set the per-VBlank DMA byte budget
+ *
+ * The NMI handler charges every transfer it makes to the current VBlank.
+ * Budgeted stages (shadow tilemaps after the first dirty one, the DMA
+ * queue) stop once the budget is spent and carry the rest over to the
+ * next VBlank. Lower it if the NMI overruns VBlank (e.g. heavy HDMA
+ * setup in the VBlank callback); raise it with an extended VBlank.
+ *
+ * @param bytes Budget in bytes (default DMA_VBLANK_BUDGET)
+ */
+void dmaSetVBlankBudget(u16 bytes);
+
+/**
+ * @brief Get the bytes DMA'd by the NMI handler in the last VBlank
+ *
+ * Useful for tuning: read it right after WaitForVBlank().
+ *
+ * @return Bytes transferred by the NMI handler so far in this frame
+ */
+u16 dmaGetVBlankBytes(void);
+
+/*============================================================================
+ * VBlank DMA Queue (module: dma_queue)
+ *============================================================================*/
+
+/**
+ * @brief Number of transfers the queue can hold
+ *
+ * One ring slot is always kept empty, so at most DMA_QUEUE_SIZE - 1
+ * transfers can be pending at once.
+ */
+#define DMA_QUEUE_SIZE 16
+
+/** @brief Default per-VBlank DMA budget (same as DMA_VBLANK_BUDGET) */
+#define DMA_QUEUE_DEFAULT_BUDGET DMA_VBLANK_BUDGET
+
+/**
+ * @brief Initialize the VBlank DMA queue
+ *
+ * Empties the queue and registers it with the NMI handler. Call once
+ * after consoleInit(); calling it again drops every pending transfer.
+ *
+ * Add `dma_queue` to LIB_MODULES to use the queue.
+ */
+void dmaQueueInit(void);
+
+/**
+ * @brief Queue a VRAM transfer for the next VBlank
+ *
+ * Safe to call at any time, including during active display. The NMI
+ * handler performs the transfer once the fixed VBlank work (OAM, tilemap,
+ * dynamic sprites) has been charged to the frame budget
+ * (dmaSetVBlankBudget()). Transfers run in the order they were queued; one
+ * that does not fit in what is left of the budget is sent in part and
+ * finished in the following VBlanks.
+ *
+ * @param src Source address (any bank; must not cross a bank boundary)
+ * @param vramAddr Destination word address in VRAM
+ * @param size Number of bytes (1-65535)
+ * @return 1 if queued, 0 if the queue is full or size is 0
+ *
+ * @warning The source data must stay valid until the transfer has run
+ * (check dmaQueuePending()). Queue from ROM or from a buffer you do not
+ * overwrite before the next VBlank.
+ *
+ * @code
+ * dmaQueueInit();
+ * dmaQueueVram(level_tiles, 0x2000, level_tiles_end - level_tiles);
+ * dmaQueueCGram(level_pal, 16, 32);
+ * WaitForVBlank();   // both land during this VBlank (budget permitting)
+ * @endcode
+ */
+u8 dmaQueueVram(const void *src, u16 vramAddr, u16 size);
+
+/**
+ * @brief Queue a CGRAM (palette) transfer for the next VBlank
+ *
+ * @param src Source address (any bank)
+ * @param startColor First color index (0-255)
+ * @param size Number of bytes (2 per color)
+ * @return 1 if queued, 0 if the queue is full or size is 0
+ */
+u8 dmaQueueCGram(const void *src, u16 startColor, u16 size);
+
+/**
+ * @brief Queue an OAM transfer for the next VBlank
+ *
+ * Runs after the NMI's own OAM upload. That upload happens only on frames
+ * where the OAM buffer was flagged for transfer, and it sends only the
+ * active window set by oamSetActiveCount(): the low-table bytes of sprites
+ * 0 to count-1 and the high-table bytes that go with them. Queued bytes
+ * inside that window last until the next upload overwrites them with the
+ * shadow buffer. Bytes outside it are never rewritten by the NMI and stay
+ * in OAM until you change them.
+ *
+ * @param src Source address (any bank)
+ * @param oamAddr OAM word address (0-255 for the main table, 256 for the
+ *                high table)
+ * @param size Number of bytes
+ * @return 1 if queued, 0 if the queue is full or size is 0
+ */
+u8 dmaQueueOam(const void *src, u16 oamAddr, u16 size);
+
+/**
+ * @brief Set the per-VBlank DMA byte budget
+ *
+ * Same as dmaSetVBlankBudget(): the queue spends what the NMI's own
+ * transfers leave of the shared VBlank budget.
+ *
+ * @param bytes Budget in bytes (default DMA_QUEUE_DEFAULT_BUDGET)
+ */
+void dmaQueueSetBudget(u16 bytes);
+
+/**
+ * @brief Get the number of transfers not yet completed
+ *
+ * @return Pending transfers, including one that is partially sent
+ */
+u16 dmaQueuePending(void);
+
+/**
+ * @brief Get how many VBlanks ended with queued work left over
+ *
+ * A counter that keeps climbing while streaming means the budget is too
+ * small for the load; the queue is still correct, just late.
+ *
+ * @return Deferred VBlank count since dmaQueueInit() (wraps at 65535)
+ */
+u16 dmaQueueDeferredCount(void);
+
 #endif /* OPENSNES_DMA_H */
@@ -254,6 +254,39 @@ void hdmaSetup(u8 channel, u8 mode, u8 destReg, const void *table);
  */
 void hdmaSetupBank(u8 channel, u8 mode, u8 destReg, const void *table, u8 bank);
 
+/**
+ * @brief Set up an indirect HDMA channel
+ *
+ * Table entries hold an address instead of the data: 1 byte line count,
+ * then the 16-bit address of the entry's data (1-4 bytes, per mode) in
+ * dataBank. One small table of pointers can then select among a few
+ * shared values, and changing a value never touches the table.
+ *
+ * The HDMA_INDIRECT bit is added to mode. Like hdmaSetup(), the channel
+ * is not enabled.
+ *
+ * @param channel  HDMA channel (1-6)
+ * @param mode     Transfer mode (HDMA_MODE_*)
+ * @param destReg  Destination B-bus register (low byte of $21xx address)
+ * @param table    Pointer table in ROM or RAM (bank taken from the pointer)
+ * @param dataBank Bank of the data the entries point to ($7E for WRAM)
+ *
+ * @code
+ * // Backdrop color: sky over sea, 2 entries (7 bytes)
+ * u8 sky[4] = { 0, 0, 0x00, 0x7C };   // CGADD 0, CGDATA $7C00
+ * u8 sea[4] = { 0, 0, 0xE0, 0x03 };   // CGADD 0, CGDATA $03E0
+ * u8 split[7];
+ *
+ * hdmaRunBegin(split, HDMA_MODE_2REG_2X | HDMA_INDIRECT);
+ * hdmaRunAdd(sky, 100);
+ * hdmaRunAdd(sea, 124);
+ * hdmaRunEnd();
+ * hdmaSetupIndirect(HDMA_CHANNEL_5, HDMA_MODE_2REG_2X, HDMA_DEST_CGADD, split, 0x7E);
+ * hdmaEnable(1 << HDMA_CHANNEL_5);
+ * @endcode
+ */
+void hdmaSetupIndirect(u8 channel, u8 mode, u8 destReg, const void *table, u8 dataBank);
+
 /**
  * @brief Enable HDMA channel(s)
  *
@@ -348,6 +381,49 @@ void hdmaGradient(u8 channel, const void *colorTable);
  */
 void hdmaWindowShape(u8 channel, const void *windowTable);
 
+/*============================================================================
+ * Run-length Table Builder
+ *============================================================================*/
+
+/**
+ * @brief Start building a run-length HDMA table
+ *
+ * Consecutive lines with the same value share one non-repeat entry: the
+ * data is written once and held, up to 127 lines per entry. A gradient
+ * that changes every few lines, or a screen split into a few bands, fits
+ * in tens of bytes instead of one entry per line, cheap enough to rebuild
+ * every frame.
+ *
+ * Non-repeat entries suit registers that keep their value (COLDATA,
+ * INIDISP, CGRAM via CGADD, window positions, scroll registers). Per-line
+ * data that changes on every line still needs one entry per line.
+ *
+ * @param table Buffer for the table; worst case 1 + (1 + data size) bytes
+ *              per hdmaRunAdd() call (one more entry per 127 lines)
+ * @param mode  Transfer mode (HDMA_MODE_*), OR HDMA_INDIRECT for a table
+ *              of data addresses (see hdmaSetupIndirect())
+ */
+void hdmaRunBegin(u8 *table, u8 mode);
+
+/**
+ * @brief Append lines holding one value
+ *
+ * Merged into the previous entry when the value is the same.
+ *
+ * @param data  Direct mode: the value's bytes (1, 2 or 4 per mode).
+ *              Indirect mode: the value's address, stored in the table
+ *              (low 16 bits; the bank is the channel's data bank)
+ * @param lines Number of scanlines (1-255)
+ */
+void hdmaRunAdd(const void *data, u8 lines);
+
+/**
+ * @brief Terminate the table
+ *
+ * @return Table size in bytes, end marker included
+ */
+u16 hdmaRunEnd(void);
+
 /*============================================================================
  * HDMA Wave Effect Functions
  *============================================================================*/
@@ -392,6 +468,14 @@ void hdmaWaveH(u8 channel, u8 bg, u8 amplitude, u8 frequency);
  * Call this once per frame (after WaitForVBlank) to animate
  * the wave effect. Updates the HDMA table with new wave values.
  *
+ * The wave (hdmaWaveH) keeps one precomputed period in RAM and only moves
+ * the HDMA table pointer, about 160 cycles a frame. Changing amplitude or
+ * frequency rebuilds the period on the next call (7k-32k cycles, longest
+ * for odd frequencies). The phase moves in steps of the largest power of
+ * two dividing the frequency, so with frequency 4 a speed below 4 animates
+ * every few frames. Ripple mode and frequency 0 recompute all 224 lines
+ * each frame.
+ *
  * @note Only needed if wave effects are active
  */
 void hdmaWaveUpdate(void);
@@ -0,0 +1,126 @@
+/**
+ * @file irq.h
+ * @brief Raster IRQ scheduler — per-scanline callbacks
+ *
+ * Runs C (or asm) callbacks at chosen screen positions every frame, for
+ * effects HDMA cannot express: a status bar in another BG mode, a mid-frame
+ * palette or VRAM pointer switch, a second scroll region.
+ *
+ * Entries are (scanline, H position, callback) triples kept sorted in screen
+ * order. Each H/V timer IRQ runs one entry and programs the timer for the
+ * next, so the chain costs one IRQ per entry and nothing in the NMI.
+ *
+ * ## Usage
+ *
+ * @code
+ * #include <snes/irq.h>
+ *
+ * void statusBar(void) {
+ *     REG_BGMODE = 1;
+ *     REG_BG1VOFS = 0;
+ *     REG_BG1VOFS = 0;
+ * }
+ *
+ * void playfield(void) {
+ *     REG_BGMODE = 3;
+ * }
+ *
+ * irqInit();
+ * irqAdd(0, IRQ_HPOS_NONE, playfield);
+ * irqAdd(192, IRQ_HPOS_NONE, statusBar);
+ * irqEnable();
+ * @endcode
+ *
+ * Add `irq` to LIB_MODULES.
+ *
+ * ## Timing
+ *
+ * A callback starts about 70 CPU cycles (roughly a third of a scanline)
+ * after the timer fires, with 16-bit A/X/Y, DB = $7E, its own direct page
+ * and IRQs masked. For a clean split, program the line before the change
+ * or give an H position near the right edge (around 250) so the writes
+ * land in HBlank. irqGetCost() reports how long each entry took, measured
+ * from its programmed position to the return of the callback.
+ *
+ * A callback that runs past the position of the next entry makes that
+ * entry run immediately after it, late, rather than one frame later.
+ *
+ * @note The scheduler owns NMITIMEN ($4200) while enabled and keeps NMI and
+ *       auto-joypad on. Writes of REG_NMITIMEN elsewhere (nmiSet()) turn
+ *       the timer IRQ off until the next irqEnable() or irqAdd().
+ * @note Callbacks share the H/V counter latch: a profileGetScanline()
+ *       interrupted by an entry may read a wrong line.
+ *
+ * @author OpenSNES Team
+ * @copyright MIT License
+ */
+
+#ifndef OPENSNES_IRQ_H
+#define OPENSNES_IRQ_H
+
+#include <snes/types.h>
+
+/** @brief Maximum number of scheduled entries (must match irq.asm) */
+#define IRQ_MAX_ENTRIES 16
+
+/** @brief irqAdd() H position: fire at the start of the line (V-IRQ only) */
+#define IRQ_HPOS_NONE 0xFFFF
+
+/** @brief Raster IRQ callback, any bank */
+typedef void (*IrqCallback)(void);
+
+/**
+ * @brief Install the scheduler as the IRQ handler
+ *
+ * Empties the table and leaves the scheduler disabled. Call once after
+ * consoleInit(); calling it again drops every entry.
+ */
+void irqInit(void);
+
+/**
+ * @brief Schedule a callback at a screen position, every frame
+ *
+ * Entries on the same line run in H order. Adding an entry while the
+ * scheduler runs re-arms the chain from the current line: entries above
+ * it wait for the next frame.
+ *
+ * @param scanline Line 0-261 (0-311 PAL); 225+ is VBlank
+ * @param hpos     H position 0-339, or IRQ_HPOS_NONE
+ * @param callback Function to call
+ * @return 1 on success, 0 if the table already holds IRQ_MAX_ENTRIES
+ */
+u16 irqAdd(u16 scanline, u16 hpos, IrqCallback callback);
+
+/**
+ * @brief Remove every entry (the timer IRQ stops until the next irqAdd())
+ */
+void irqClear(void);
+
+/**
+ * @brief Start running the table (from the current line onward)
+ *
+ * Also clears the CPU's interrupt-disable flag, which the reset code
+ * leaves set.
+ */
+void irqEnable(void);
+
+/**
+ * @brief Stop the timer IRQ; the table is kept
+ */
+void irqDisable(void);
+
+/**
+ * @brief Time taken by an entry the last time it ran
+ *
+ * @param index Entry number in screen order (0 = topmost)
+ * @return Dots (4 master cycles each, 340 per scanline) from the entry's
+ *         programmed position to the return of its callback, including the
+ *         dispatch overhead; 0 if it has not run yet or index is out of range,
+ *         0xFFFF if it took longer than 65535 dots (about 193 scanlines)
+ *
+ * Safe to call with the scheduler running: the end position is read with
+ * IRQs masked for a few cycles, so it always comes from a single run.
+ */
+u16 irqGetCost(u16 index);
+
+#endif /* OPENSNES_IRQ_H */
@@ -0,0 +1,79 @@
+/**
+ * @file lz4.h
+ * @brief Fast LZ4-style decompression to WRAM / VRAM
+ *
+ * Companion decoder for `gfx4snes -Z`. The format keeps LZ77's idea but
+ * drops the per-byte flag bits: every sequence is a byte-aligned token
+ * followed by a literal run and a back-reference, and both are copied with
+ * MVN. Decoding costs about 18 cycles per output byte against about 90
+ * for LzssDecodeVram(), for output roughly 10-20% larger
+ * (devtools/cyclecount/codec_bench.py measures both).
+ *
+ * ## Format
+ *
+ * - Tag byte: 0x40
+ * - 3-byte little-endian uncompressed data length (64 KB max)
+ * - Token: high nibble literal count, low nibble match length - 4
+ *   (15 = extension bytes follow)
+ * - Literals, then a 2-byte backward distance (none after the last run)
+ *
+ * This is not the `lz4` command-line tool's frame format.
+ *
+ * ## Usage
+ *
+ * @code
+ * extern u8 level_tiles_lz4[];
+ * extern u8 staging[];   // WRAM buffer, declared in asm
+ *
+ * // Straight into WRAM (any time, display on)
+ * lz4Decode(level_tiles_lz4, staging);
+ *
+ * // Into VRAM through the staging buffer, during forced blank
+ * REG_INIDISP = 0x80;
+ * lz4DecodeVram(level_tiles_lz4, staging, 0x0000);
+ * REG_INIDISP = 0x0F;
+ * @endcode
+ *
+ * With the display on, decode with lz4Decode() and hand the buffer to
+ * dmaQueueVram() instead of calling lz4DecodeVram().
+ *
+ * @author OpenSNES Team
+ * @copyright MIT License
+ */
+
+#ifndef OPENSNES_LZ4_H
+#define OPENSNES_LZ4_H
+
+#include <snes/types.h>
+
+/**
+ * @brief Decompress LZ4-style data into WRAM
+ *
+ * @param source Compressed data (tag byte 0x40), any bank. The stream
+ *               must not cross a bank boundary.
+ * @param dest WRAM buffer for the whole uncompressed asset, any WRAM bank.
+ *             It must not cross or end exactly at a bank boundary.
+ * @return Uncompressed size in bytes, or 0 if the tag byte is not 0x40
+ *
+ * @note About 7 cycles per byte for copied runs plus a fixed cost per
+ *       sequence. Interrupts stay enabled.
+ */
+u16 lz4Decode(const u8 *source, u8 *dest);
+
+/**
+ * @brief Decompress LZ4-style data to VRAM through a WRAM staging buffer
+ *
+ * Runs lz4Decode() into @p staging, then uploads the result with one DMA
+ * on channel 0.
+ *
+ * @param source Compressed data (tag byte 0x40), any bank
+ * @param staging WRAM buffer big enough for the uncompressed asset
+ * @param vramAddr VRAM word address of the first byte
+ * @return Uncompressed size in bytes, or 0 if the tag byte is not 0x40
+ *         (VRAM is then left untouched)
+ *
+ * @warning The DMA needs forced blank or VBlank, like dmaCopyVram().
+ */
+u16 lz4DecodeVram(const u8 *source, u8 *staging, u16 vramAddr);
+
+#endif /* OPENSNES_LZ4_H */
@@ -27,6 +27,26 @@
  *          LzssDecodeVram disables interrupts internally, so call it
  *          during force blank for safety.
  *
+ * ## Streaming with the display on
+ *
+ * lzssStreamBegin() / lzssStreamStep() decode into a WRAM staging buffer
+ * a bounded number of bytes per call and hand the result to the VBlank
+ * DMA queue (`dma_queue` module, linked automatically). No forced blank,
+ * no PPU reads, bounded CPU cost per frame:
+ *
+ * @code
+ * extern u8 level_tiles_lz[];
+ * extern u8 staging[];   // 8 KB RAMSECTION in bank $7F, declared in asm
+ *
+ * dmaQueueInit();
+ * lzssStreamBegin(level_tiles_lz, staging, 0x2000);
+ * while (lzssStreamStep(1024)) {
+ *     updateGame();
+ *     WaitForVBlank();
+ * }
+ * while (dmaQueuePending()) WaitForVBlank();   // last run uploaded
+ * @endcode
+ *
  * @author OpenSNES Team (ported from PVSnesLib by Alekmaul)
  * @copyright zlib License
  */
@@ -52,4 +72,47 @@
  */
 void LzssDecodeVram(u8 *source, u16 address);
 
+/** @brief lzssStreamBegin() vramAddr: decode to the staging buffer only */
+#define LZSS_NO_VRAM 0xFFFF
+
+/**
+ * @brief Start an incremental LZ77 decode into a WRAM staging buffer
+ *
+ * Only one stream can be active at a time; calling this again restarts.
+ * Nothing is decoded until lzssStreamStep().
+ *
+ * @param source LZ77-compressed data (tag byte 0x10), any bank. The
+ *               stream may cross a bank boundary.
+ * @param staging WRAM buffer for the whole uncompressed asset (any WRAM
+ *                bank; must not cross a bank boundary). Back-references
+ *                are read from here, so keep it intact until the stream
+ *                ends and its data has been uploaded.
+ * @param vramAddr VRAM word address the asset is uploaded to through the
+ *                 DMA queue, or LZSS_NO_VRAM to only fill the buffer
+ * @return Uncompressed size in bytes, or 0 if the tag byte is not 0x1x
+ *
+ * @note The size field is 24-bit in the format; only assets up to 64 KB
+ *       are supported.
+ */
+u16 lzssStreamBegin(const u8 *source, u8 *staging, u16 vramAddr);
+
+/**
+ * @brief Decode the next part of the active stream
+ *
+ * Decodes at most @p maxBytes bytes, then queues every decoded run not
+ * yet queued with dmaQueueVram() (whole VRAM words only until the last
+ * run). If the DMA queue is full the run is retried on the next call.
+ * Safe with the display on and interrupts enabled.
+ *
+ * @param maxBytes Output bytes to produce in this call — the CPU budget
+ *                 (roughly 30 to 60 cycles per byte)
+ * @return Work left (bytes to decode plus bytes not yet queued); 0 once
+ *         the whole asset is decoded and queued
+ *
+ * @note Queued data reaches VRAM during the following VBlanks, within the
+ *       frame budget; wait for dmaQueuePending() to reach 0 before using
+ *       the tiles. dmaQueueInit() must have been called.
+ */
+u16 lzssStreamStep(u16 maxBytes);
+
 #endif /* OPENSNES_LZSS_H */
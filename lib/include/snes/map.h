@@ -2,9 +2,10 @@
  * @file map.h
  * @brief Scrolling tilemap engine for Mode 1 backgrounds
  *
- * Provides hardware-efficient tilemap streaming using metatiles (8x8 pixel blocks).
- * Supports horizontal and vertical scrolling with incremental VRAM updates
- * during VBlank.
+ * Provides hardware-efficient tilemap streaming using metatiles of 8x8,
+ * 16x16 or 32x32 pixels. Supports horizontal and vertical scrolling with
+ * incremental VRAM updates during VBlank, on up to three layers (BG1-BG3)
+ * at once.
  *
  * ## Usage
  *
@@ -34,6 +35,118 @@
  *
  * @note Map engine uses VRAM address $6800 for the tilemap by default.
  *
+ * ## Parallax layers
+ *
+ * mapLoad() sets up layer 0. Layers 1 and 2 are loaded with mapLoadLayer()
+ * onto any BG, each with its own map, metatile definitions and SC_64x32
+ * tilemap. Add `map_layers` to LIB_MODULES to use them; it holds their
+ * contexts and 4.5 KB of buffers, which single-layer games do not pay
+ * for. A layer follows the camera (x_pos, y_pos) scaled by its scroll
+ * rate, so a background at half speed only needs a map about half as
+ * wide. The same mapUpdate() / mapVblank() pair then streams every layer:
+ *
+ * @code
+ * mapLoad(&mapfront, &frontdef, &frontatt);              // layer 0 on BG1
+ * bgSetMapPtr(1, 0x6000, SC_64x32);
+ * mapSetLayerRate(1, MAP_RATE(1, 2), MAP_RATE(1, 2));    // half speed
+ * mapLoadLayer(1, 1, 0x6000, &mapback, &backdef);        // layer 1 on BG2
+ * @endcode
+ *
+ * mapVblank() shares one byte budget per frame between the layers
+ * (mapSetVBlankBudget()). A column costs 64 bytes, a row 128. The first
+ * upload of a frame always goes; a layer that does not fit keeps its
+ * previous scroll position and catches up on a later frame, so the
+ * picture never shows a half-updated edge.
+ *
+ * The SC_64x32 tilemap holds up to 64 map columns: the 33 on screen and
+ * a margin. mapUpdate() fills the margin on the side the layer last
+ * scrolled to, up to 31 columns ahead, and mapVblank() uploads those
+ * columns only with budget to spare. Rows cover every column held, so
+ * the margin survives vertical scrolling. A layer that moves within the
+ * columns held needs no new column; otherwise it streams up to 4 columns
+ * and 4 rows (MAP_STEP_MAX pixels per axis) in the frame they come into
+ * view.
+ *
+ * A bigger move is caught up over several frames within the budget: the
+ * missing columns (up to 28, or the whole view after a jump or a
+ * vertical move past MAP_STEP_MAX) go to tilemap columns the screen does
+ * not show, and the layer keeps its old scroll position until the last
+ * of them, its rows and the new scroll values go up together. At the
+ * default budget a jump takes 3 frames instead of one 2112-byte upload.
+ * There is no vertical margin: the tilemap has 32 rows for 29 on screen,
+ * and SC_64x64 tilemaps are not supported.
+ *
+ * ## Map format
+ *
+ * A map starts with three words: width in pixels, height in pixels and
+ * the size of the entries in bytes, followed by one word per metatile,
+ * row by row. Bits 14-15 of the height word give the metatile size
+ * (MAP_HDR_MT16, MAP_HDR_MT32; 0 = 8x8):
+ *
+ * - 8x8: an entry is `vh----mmmmmmmmmm`, a definition index plus flips,
+ *   and each definition is one tilemap entry.
+ * - 16x16 / 32x32: an entry is a definition index (bits 0-9). Each
+ *   definition holds 4 / 16 tilemap entries row by row, flips included.
+ *   A map needs 4 / 16 times fewer entries, and a scrolled column or row
+ *   reads one entry per 2 / 4 tiles. Tile properties (tilesprop) are per
+ *   metatile.
+ *
+ * `tmx2snes -s 16` (or `-s 32`) writes maps and definitions in this form.
+ *
+ * ## Chunked maps
+ *
+ * With MAP_HDR_CHUNK set in the height word, the map entries (8x8
+ * metatiles only) are cut into chunks of 16x16 entries, each compressed in
+ * the lz4 module's format. The third header word is then the size of the
+ * chunk data, which starts with one word per chunk, row by row: the
+ * offset of its stream from the start of that table. Identical chunks
+ * share one stream.
+ *
+ * Chunked maps need the `map_chunk` module (add it to LIB_MODULES; it
+ * pulls in `lz4`) and one mapChunkInit() call before mapLoad(); without
+ * them the engine reads the map as plain entries. map_chunk decompresses
+ * chunks on demand into a ring of MAP_CHUNK_SLOTS WRAM slots shared by
+ * all layers, keyed by chunk address, and looks the cache up once per
+ * chunk a column or row crosses. Tile lookups (mapGetMetaTile(),
+ * mapGetMetaTilesProp()) decompress into one extra slot of their own, so
+ * they never evict a chunk the layers draw from.
+ *
+ * A chunked map may be up to 1023 rows tall instead of 256 and usually
+ * takes a fraction of the ROM. mapChunkHitCount() / mapChunkMissCount()
+ * tell how well the cache holds up. `tmx2snes -c` writes this form. The
+ * chunk data must not cross a ROM bank.
+ *
+ * ## Solidity bitmap
+ *
+ * mapSolidBuild() packs layer 0 into one bit per map entry, set when the
+ * entry's tile property has T_SOLID's high byte, with a table of row
+ * offsets. The mapSolid*() queries read it instead of the map and the
+ * property table: a point is one bit test, and a span of a row tests 8
+ * entries per byte. Add `map_solid` to LIB_MODULES to use it; the bitmap
+ * has its own RAM and is only built on request, so games without it pay
+ * nothing.
+ *
+ * @code
+ * mapLoad(level_map, level_tiles, level_props);
+ * mapSolidBuild();
+ *
+ * // An object up to one entry tall and wide, moving right by dx: stop
+ * // against the first wall its right edge meets
+ * u16 hit = mapSolidScanX(py, px + PW - 1, px + PW - 1 + dx);
+ * if (hit != MAP_SOLID_NONE) px = hit - PW; else px += dx;
+ *
+ * // Falling by dy: land on the first solid entry under the feet
+ * hit = mapSolidScanY(px, py + PH - 1, py + PH - 1 + dy);
+ * if (hit != MAP_SOLID_NONE) py = hit - PH; else py += dy;
+ * @endcode
+ *
+ * The bitmap holds MAP_SOLID_BYTES bytes, rows padded to 16 entries:
+ * 256 x 128 entries, for instance. A bigger map gets none (mapSolidBuild()
+ * returns 0), and until a bitmap is built every query reports solid.
+ * mapLoad() drops the bitmap, so call mapSolidBuild() again after each
+ * mapLoad(). T_PLATE, ladders and slopes are not solid here; use
+ * mapGetMetaTilesProp() for them.
+ *
  * ## Attribution
  *
  * Based on: PVSnesLib map engine by Alekmaul
@@ -108,6 +221,54 @@
 /** @brief Scroll BG2 instead of BG1 (VRAM address is still $6800) */
 #define MAP_OPT_BG2    0x02
 
+/*============================================================================
+ * Map Header
+ *============================================================================*/
+
+/** @brief Height word flag: 16x16 metatiles */
+#define MAP_HDR_MT16   0x4000
+
+/** @brief Height word flag: 32x32 metatiles */
+#define MAP_HDR_MT32   0x8000
+
+/** @brief Height word flag: chunked, compressed map (see Chunked maps) */
+#define MAP_HDR_CHUNK  0x2000
+
+/** @brief Map entries per chunk side */
+#define MAP_CHUNK_SIZE 16
+
+/** @brief Decompressed chunks kept in WRAM for the layers (plus one for lookups) */
+#define MAP_CHUNK_SLOTS 8
+
+/*============================================================================
+ * Layers
+ *============================================================================*/
+
+/** @brief Number of scrolling layers (0 = the mapLoad() layer) */
+#define MAP_LAYERS     3
+
+/** @brief Scroll rate of a layer that moves with the camera (8.8 fixed point) */
+#define MAP_RATE_1X    0x0100
+
+/** @brief Scroll rate num/den of the camera speed, e.g. MAP_RATE(1, 2) */
+#define MAP_RATE(num, den) ((u16)(((u32)(num) << 8) / (den)))
+
+/** @brief Default map bytes per VBlank (see mapSetVBlankBudget()) */
+#define MAP_VBLANK_BUDGET 1024
+
+/** @brief Largest move per frame and axis (pixels) uploaded in the same frame */
+#define MAP_STEP_MAX   32
+
+/*============================================================================
+ * Solidity Bitmap
+ *============================================================================*/
+
+/** @brief Size of the layer 0 solidity bitmap (1 bit per map entry) */
+#define MAP_SOLID_BYTES 4096
+
+/** @brief mapSolidScanX() / mapSolidScanY(): no solid entry on the way */
+#define MAP_SOLID_NONE  0xFFFF
+
 /*============================================================================
  * Exported Variables
  *============================================================================*/
@@ -122,9 +283,11 @@ extern u16 y_pos;
 
 /* --- Bank $7E SLOT 2 (NOT C-accessible, ASM-only) --- */
 /* The map engine's bulk data lives in Bank $7E:
- *   metatiles[4096]     — metatile definitions (4 tile entries per metatile)
+ *   metatiles[4096]     — 8x8 metatile definitions of layer 0
  *   metatilesprop[2048] — tile collision properties
- *   bg_L1[2048]         — BG1 tilemap buffer
+ *   mapbgbuf[2048]      — tilemap buffer of layer 0 (map_layers has
+ *                         maplayerbuf[2*2048] for layers 1 and 2)
+ *   mapchunkbuf[4608]   — decompressed chunks of chunked maps (map_chunk)
  *   mapadrrowlut[1024]  — row address lookup table
  * These are managed internally by mapLoad/mapUpdate/mapVblank.
  * C code accesses map data through mapGetMetaTile/mapGetMetaTilesProp.
@@ -142,28 +305,131 @@ extern u16 y_pos;
  * After this call, the tilemap is ready — no separate mapVblank() needed
  * before setScreenOn().
  *
- * @param layer1map  Address of map data (format: u16 width, u16 height, u16 pad, then tile indices)
- * @param layertiles Address of metatile definitions (4 tiles per metatile, max 512 metatiles)
- * @param tilesprop  Address of tile property data (collision types)
+ * @param layer1map  Address of map data (see Map format)
+ * @param layertiles Address of metatile definitions: up to 512 8x8 ones,
+ *                   copied to WRAM, or up to 1024 16x16 / 32x32 ones,
+ *                   read in place
+ * @param tilesprop  Address of tile property data (collision types, one
+ *                   per metatile)
  *
  * @note Must be called during forced blank (screen off). The function
  *       writes directly to VRAM via DMA.
+ * @note Resets the engine: layers 1 and 2 are turned off, every layer's
+ *       scroll rate goes back to MAP_RATE_1X and the VBlank budget to
+ *       MAP_VBLANK_BUDGET.
+ * @note The object engine's tile collision assumes an 8x8, unchunked
+ *       layer 0. mapGetMetaTile() / mapGetMetaTilesProp() handle every
+ *       format.
+ * @note Empties the chunk cache and resets its counters (map_chunk).
+ * @note Drops any solidity bitmap: mapSolidReady() returns 0 until
+ *       mapSolidBuild() runs for the new map.
+ * @note 16x16 / 32x32 maps are limited to 256 rows of metatiles.
  */
 void mapLoad(u8 *layer1map, u8 *layertiles, u8 *tilesprop);
 
+/**
+ * @brief Load an extra scrolling layer and flush it to VRAM
+ *
+ * The layer's position is the camera (x_pos, y_pos) scaled by its scroll
+ * rate, clamped to its map. Collision queries (mapGetMetaTile(),
+ * mapGetMetaTilesProp()) always use layer 0.
+ *
+ * @param layer      Layer number, 1 to MAP_LAYERS-1; other values are
+ *                   ignored (layer 0 is loaded by mapLoad())
+ * @param bg         Background scrolled by the layer (0-2 = BG1-BG3)
+ * @param vramAddr   VRAM word address of the layer's SC_64x32 tilemap
+ * @param layermap   Map data, same format as mapLoad()
+ * @param layertiles Metatile definitions, read in place (any bank)
+ *
+ * @note Call after mapLoad() and mapSetLayerRate(), during forced blank.
+ *       Requires the map_layers module.
+ */
+void mapLoadLayer(u8 layer, u8 bg, u16 vramAddr, u8 *layermap, u8 *layertiles);
+
+/**
+ * @brief Set how fast a layer scrolls relative to the camera
+ *
+ * Rates are 8.8 fixed point: MAP_RATE_1X (0x0100) follows the camera,
+ * 0x0080 scrolls at half speed, 0 keeps the layer still.
+ *
+ * @param layer Layer number (0 to MAP_LAYERS-1)
+ * @param ratex Horizontal rate
+ * @param ratey Vertical rate
+ *
+ * @note Takes effect on the next mapUpdate(). Set it before mapLoadLayer()
+ *       so the layer is drawn at the right place from the start.
+ */
+void mapSetLayerRate(u8 layer, u16 ratex, u16 ratey);
+
+/**
+ * @brief Set the bytes mapVblank() may upload per frame, all layers together
+ *
+ * The budget is also capped by what the NMI left of the shared VBlank
+ * budget (dmaSetVBlankBudget()), and map uploads are charged to it.
+ *
+ * @param bytes Budget in bytes (default MAP_VBLANK_BUDGET)
+ */
+void mapSetVBlankBudget(u16 bytes);
+
+/**
+ * @brief Number of layer uploads mapVblank() has postponed
+ *
+ * A layer that is postponed often lags the camera by a frame and falls
+ * into multi-frame catch-ups; raise the budget if this climbs steadily.
+ *
+ * @return Postponed layer uploads since mapLoad() (wraps at 65535)
+ */
+u16 mapDeferredCount(void);
+
+/**
+ * @brief Enable chunked maps
+ *
+ * Hooks the chunk cache into the map engine and empties it. Call once,
+ * before the first mapLoad() or mapLoadLayer() of a chunked map.
+ * Requires the `map_chunk` module.
+ */
+void mapChunkInit(void);
+
+/**
+ * @brief Number of chunk lookups served by the chunk cache
+ *
+ * Requires the `map_chunk` module.
+ *
+ * @return Cache hits since mapLoad() (wraps at 65535)
+ */
+u16 mapChunkHitCount(void);
+
+/**
+ * @brief Number of chunks decompressed into the chunk cache
+ *
+ * A miss count that climbs every frame means the layers' visible chunks
+ * do not fit in MAP_CHUNK_SLOTS.
+ * Requires the `map_chunk` module.
+ *
+ * @return Cache misses since mapLoad() (wraps at 65535)
+ */
+u16 mapChunkMissCount(void);
+
 /**
  * @brief Update map scroll buffers based on camera position
  *
  * Call once per frame in the main loop. Builds horizontal/vertical
- * update buffers when the camera crosses tile boundaries.
+ * update buffers of every loaded layer when it crosses tile boundaries:
+ * one row per tile crossed and one column per tile the tilemap does not
+ * hold yet, up to MAP_STEP_MAX pixels per axis, then prefetch columns
+ * ahead of the camera. A bigger move starts a catch-up that the next
+ * mapVblank() calls upload. A layer whose previous update or catch-up
+ * is still waiting for mapVblank() is left alone until it has been
+ * uploaded.
  */
 void mapUpdate(void);
 
 /**
  * @brief Transfer map updates to VRAM
  *
- * Performs DMA transfers of scroll update buffers during VBlank.
- * Also updates BG scroll registers.
+ * Performs DMA transfers of scroll update buffers during VBlank, layer by
+ * layer within the budget set by mapSetVBlankBudget(). Also updates the
+ * BG scroll registers of every layer it uploaded.
  *
  * @note Must be called during VBlank (after WaitForVBlank).
  */
@@ -181,16 +447,16 @@ void mapVblank(void);
 void mapUpdateCamera(u16 xpos, u16 ypos);
 
 /**
- * @brief Get metatile index at map coordinates
+ * @brief Get metatile index at map coordinates (layer 0)
  *
  * @param xpos X coordinate in map pixels
  * @param ypos Y coordinate in map pixels
- * @return Metatile index (0-511)
+ * @return Metatile index (0-1023) of the 8x8, 16x16 or 32x32 block
  */
 u16 mapGetMetaTile(u16 xpos, u16 ypos);
 
 /**
- * @brief Get tile collision property at map coordinates
+ * @brief Get tile collision property at map coordinates (layer 0)
  *
  * @param xpos X coordinate in map pixels
  * @param ypos Y coordinate in map pixels
@@ -198,6 +464,79 @@ u16 mapGetMetaTile(u16 xpos, u16 ypos);
  */
 u16 mapGetMetaTilesProp(u16 xpos, u16 ypos);
 
+/**
+ * @brief Build the solidity bitmap of layer 0
+ *
+ * Walks the whole map loaded by the last mapLoad(), about 50 cycles per
+ * map entry (1.6M for a full MAP_SOLID_BYTES bitmap), so call it while
+ * loading a level, not during play. Requires the `map_solid` module.
+ *
+ * @return Map entries per bitmap row, or 0 if no map is loaded or it is
+ *         too big (more than MAP_SOLID_BYTES or 512 rows)
+ */
+u16 mapSolidBuild(void);
+
+/**
+ * @brief Test the solidity bitmap at map coordinates (layer 0)
+ *
+ * @param xpos X coordinate in map pixels
+ * @param ypos Y coordinate in map pixels
+ * @return 1 if the map entry there is solid or outside the map, else 0
+ */
+u16 mapSolidAt(u16 xpos, u16 ypos);
+
+/**
+ * @brief First solid map entry along a row (layer 0)
+ *
+ * Walks the row of ypos from the entry of x0 to the entry of x1, to the
+ * right or to the left, 8 entries per byte. Entries outside the map count
+ * as solid: a negative x1 (as s16) stops at the left edge and returns the
+ * entry just past it, at minus one entry size.
+ *
+ * @param ypos Y coordinate of the row in map pixels
+ * @param x0   Starting X coordinate in map pixels
+ * @param x1   Last X coordinate tested, either side of x0
+ * @return Left pixel of the first solid entry met, or MAP_SOLID_NONE
+ */
+u16 mapSolidScanX(u16 ypos, u16 x0, u16 x1);
+
+/**
+ * @brief First solid map entry along a column (layer 0)
+ *
+ * Walks the column of xpos from the entry of y0 to the entry of y1, down
+ * or up, one bit test per entry. Entries outside the map count as solid:
+ * a negative y1 (as s16) stops at the top edge and returns the entry just
+ * above it, at minus one entry size.
+ *
+ * @param xpos X coordinate of the column in map pixels
+ * @param y0   Starting Y coordinate in map pixels
+ * @param y1   Last Y coordinate tested, either side of y0
+ * @return Top pixel of the first solid entry met, or MAP_SOLID_NONE
+ */
+u16 mapSolidScanY(u16 xpos, u16 y0, u16 y1);
+
+/**
+ * @brief Check that a rectangle overlaps no solid map entry (layer 0)
+ *
+ * @param xpos Left edge in map pixels
+ * @param ypos Top edge in map pixels
+ * @param w    Width in pixels
+ * @param h    Height in pixels
+ * @return 1 if free (or empty), 0 if it touches a solid entry or leaves
+ *         the map
+ */
+u16 mapSolidRectFree(u16 xpos, u16 ypos, u16 w, u16 h);
+
+/**
+ * @brief Check that mapSolidBuild() built the solidity bitmap
+ *
+ * mapLoad() drops the bitmap, so this returns 0 after loading another map
+ * until mapSolidBuild() runs again.
+ *
+ * @return Map entries per bitmap row, or 0 if there is no bitmap
+ */
+u16 mapSolidReady(void);
+
 /**
  * @brief Set map engine options
  *
@@ -190,6 +190,91 @@ void mode7SetMatrix(s16 a, s16 b, s16 c, s16 d);
  */
 void mode7SetSettings(u8 settings);
 
+/*============================================================================
+ * Perspective (mode7_perspective module)
+ *
+ * A ground plane seen from a camera at a height, pitched down toward a
+ * horizon: one M7A-M7D matrix per scanline, written by four HDMA channels
+ * from double-buffered tables in WRAM. Add `mode7_perspective` to
+ * LIB_MODULES (it pulls in `mode7` and `hdma`).
+ *
+ * @code
+ * mode7Init();
+ * mode7PerspectiveInit(HDMA_CHANNEL_1);   // channels 1-4
+ *
+ * while (1) {
+ *     WaitForVBlank();
+ *     mode7PerspectiveSetCamera(camX, camY);
+ *     // ... game logic ...
+ *     mode7PerspectiveUpdate(height, pitch, yaw);
+ * }
+ * @endcode
+ *
+ * Rows above the horizon are drawn with a zero matrix (one flat colour, the
+ * texel under the camera): cover them with a window, a colour-math
+ * gradient or an irq split to another BG mode at
+ * mode7PerspectiveGetHorizon().
+ *
+ * @note A build costs about 142 CPU cycles per ground row: 15.8k cycles at
+ *       pitch 0, 31.4k when the ground fills the screen (measured by
+ *       devtools/cyclecount/mode7_bench.py). It only runs when height,
+ *       pitch or yaw changed.
+ * @note While the tables are shown, mode7SetAngle(), mode7Rotate() and
+ *       mode7Transform() are overwritten every line, and the PPU multiplier
+ *       ($211B/$211C -> $2134) returns garbage during the active display.
+ *============================================================================*/
+
+/**
+ * @brief Start per-scanline perspective on four HDMA channels
+ *
+ * Points channels channel..channel+3 at the M7A, M7B, M7C and M7D tables
+ * (through hdmaSetupBank()) and enables them. Nothing is drawn until the
+ * first mode7PerspectiveUpdate() / mode7PerspectiveSetCamera() pair.
+ *
+ * @param channel First channel, 1-3 (channel 0 is the general DMA channel,
+ *                channel 7 the NMI's OAM transfer). Other values are ignored.
+ */
+void mode7PerspectiveInit(u8 channel);
+
+/**
+ * @brief Build the tables for a camera, into the hidden buffer
+ *
+ * Returns at once when the three values match the last build. The new
+ * tables are shown by the next mode7PerspectiveSetCamera().
+ *
+ * @param height Camera height above the plane, in texels (1-255)
+ * @param pitch  Angle below the horizontal, 0-64 (64 = straight down, larger
+ *               values are clamped). 0 puts the horizon on line 112, 16 around
+ *               line 60.
+ * @param yaw    Heading, 0-255 for a full turn (same sense as mode7SetAngle())
+ */
+void mode7PerspectiveUpdate(u8 height, u8 pitch, u8 yaw);
+
+/**
+ * @brief Place the camera and show the last built tables
+ *
+ * Writes M7X/M7Y and the Mode 7 scroll so that plane point (x, y) sits on
+ * screen column 128 of the matrix centre row, which is below the screen
+ * for shallow pitches. Call in VBlank (right after WaitForVBlank()), every
+ * frame the camera moves.
+ *
+ * @param x Plane X under the camera (0-1023)
+ * @param y Plane Y under the camera (0-1023)
+ */
+void mode7PerspectiveSetCamera(s16 x, s16 y);
+
+/**
+ * @brief First scanline of the ground in the shown tables
+ *
+ * @return Line 0-224 (224: no ground on screen)
+ */
+u16 mode7PerspectiveGetHorizon(void);
+
+/**
+ * @brief Disable the four perspective HDMA channels
+ */
+void mode7PerspectiveStop(void);
+
 /*============================================================================
  * Mode 7 Settings Constants
  *============================================================================*/
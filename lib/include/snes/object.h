@@ -14,6 +14,7 @@
  * - Map collision detection (with optional slope support)
  * - Fixed-point position and velocity
  * - Object-to-object collision detection
+ * - Optional activity tiers: reduced-rate updates and sleep away from the camera
  *
  * ## Workspace Pattern
  *
@@ -242,10 +243,39 @@ void objLoadObjects(u8 *sourceO);
  *
  * Iterates through all active objects. For each object within the
  * "virtual screen" (-64 to 320 X, -64 to 288 Y), calls the type's
- * update function with objWorkspace pre-populated.
+ * update function with objWorkspace pre-populated. Objects outside it are
+ * frozen, or handled by the tiers set with objSetActivityTiers().
  */
 void objUpdateAll(void);
 
+/**
+ * @brief Set how objUpdateAll() treats objects away from the camera
+ *
+ * Three tiers around the update area (-64 to 320 X, -64 to 288 Y):
+ * - a band `margin` pixels wide around it, where objects are updated one
+ *   frame in `rate`, staggered by object index so they do not all run on
+ *   the same frame;
+ * - beyond the band, objects are frozen as without tiers;
+ * - more than `sleepdist` pixels beyond the band, objects fall asleep:
+ *   they leave the update lists for a list per 256-pixel column of the
+ *   level and cost nothing per frame. Only the columns near the camera are
+ *   checked, and an object wakes up once the camera brings it within
+ *   `sleepdist / 2` of the band.
+ *
+ * With many objects placed by objLoadObjects(), the per-frame cost then
+ * follows what is near the camera rather than the size of the level.
+ * Off by default; objSetActivityTiers(0, 1, 0) turns it off again and
+ * wakes every sleeping object.
+ *
+ * @param margin    Reduced-rate band width, pixels (0 = no band)
+ * @param rate      Band update period in frames, a power of two (1-128)
+ * @param sleepdist Sleep distance beyond the band, pixels (0 = never sleep)
+ *
+ * @note Assumes world positions below 32768; sleeping objects past
+ *       x = 16383 share the last column.
+ */
+void objSetActivityTiers(u16 margin, u8 rate, u16 sleepdist);
+
 /**
  * @brief Refresh sprites for all on-screen objects
  *
@@ -297,6 +327,63 @@ void objCollidMap1D(u16 objhandle);
  */
 u16 objCollidObj(u16 objhandle1, u16 objhandle2);
 
+/**
+ * @brief Pair callback for objCollidPairs()
+ *
+ * @param objhandle1 Object of the first type, as returned by objNew()
+ *                   (pass to objKill(); `& 0xFF` is the raw index)
+ * @param objhandle2 Object of the second type
+ */
+typedef void (*ObjPairFunction)(u16 objhandle1, u16 objhandle2);
+
+/**
+ * @brief Enable the object-vs-object collision grid
+ *
+ * While enabled, objUpdateAll() files each object it updates (those in the
+ * update area) in a grid of 32x32-pixel cells around the camera, with its
+ * hitbox (xpos + xofs, width, height) as it is after its update callback.
+ * objCollidPairs() then only tests objects that share or border a cell.
+ * Costs about 300 cycles per updated object; off by default.
+ *
+ * @param enable 1 to fill the grid in objUpdateAll(), 0 to stop
+ */
+void objGridEnable(u8 enable);
+
+/**
+ * @brief Find every overlapping pair of two object types
+ *
+ * Replaces an objCollidObj() call per pair ("every bullet against every
+ * enemy") with one grid query: each object of type1 is tested only against
+ * the type2 objects filed near it by the last objUpdateAll(). Uses the same
+ * overlap test as objCollidObj(), edges inclusive. With type1 == type2,
+ * each pair is reported once.
+ *
+ * Call after objUpdateAll() (grid enabled with objGridEnable()), outside
+ * object callbacks. The callback may kill either object: a killed object is
+ * not reported again. Objects created or moved after objUpdateAll() are
+ * not seen until the next frame.
+ *
+ * @param type1 Type of the first object of each pair
+ * @param type2 Type of the second object
+ * @param fct   Called as fct(objhandle1, objhandle2) for each overlap
+ * @return Number of pairs found
+ *
+ * @code
+ * void bulletHitsEnemy(u16 bullet, u16 enemy) {
+ *     objKill(bullet);
+ *     objKill(enemy);
+ * }
+ *
+ * objGridEnable(1);
+ * while (1) {
+ *     objUpdateAll();
+ *     objCollidPairs(TYPE_BULLET, TYPE_ENEMY, bulletHitsEnemy);
+ *     WaitForVBlank();
+ * }
+ * @endcode
+ */
+u16 objCollidPairs(u8 type1, u8 type2, ObjPairFunction fct);
+
 /**
  * @brief Update object position from velocity
  *
@@ -0,0 +1,170 @@
+/**
+ * @file objpool.h
+ * @brief Structure-of-arrays object pool with one update call per type (CONTRIB module)
+ *
+ * @note This is a contrib module, not core SDK. The implementation lives in
+ *       `lib/contrib/objpool.asm` and is not transitively included by `<snes.h>`.
+ *       Examples that use it must `#include <snes/objpool.h>` explicitly and
+ *       list `objpool` in their Makefile's `LIB_MODULES`. See
+ *       `lib/contrib/README.md` for the policy.
+ *
+ * A lighter store than the object engine (`<snes/object.h>`) for many small
+ * objects: bullets, sparks, swarms. The hot fields (position, velocity, type,
+ * flags) live in parallel arrays in Bank $00 that C reads and writes in
+ * place, so there is no workspace copy and no 64-byte record per object.
+ *
+ * Each type owns a fixed run of slots (poolSetType()), and its live objects
+ * stay packed at the start of that run. poolUpdateAll() therefore calls each
+ * type's update function once, with the range of slots to process, instead
+ * of once per object. With 60 objects alive that removes about 60 long calls
+ * and 120 block copies of 64 bytes per frame (over 1 000 cycles per object
+ * in objUpdateAll()).
+ *
+ * Objects move between slots when another object of their type dies. Keep
+ * the handle returned by poolNew() to find an object later (poolSlot()).
+ *
+ * @code
+ * #include <snes.h>
+ * #include <snes/objpool.h>
+ *
+ * #define TYPE_BULLET 0
+ *
+ * void bulletUpdate(u16 first, u16 count) {
+ *     u16 i = first + count;
+ *     poolMove(TYPE_BULLET);
+ *     while (i-- > first) {          // backwards: poolKill() is then safe
+ *         if (pool_y[i] > 240) {
+ *             poolKill(pool_id[i]);
+ *         }
+ *     }
+ * }
+ *
+ * poolInit();
+ * poolSetType(TYPE_BULLET, 32, bulletUpdate);
+ * u16 b = poolNew(TYPE_BULLET, 120, 200);
+ * pool_yvel[poolSlot(b)] = -0x0280;  // 2.5 pixels per frame, upward
+ *
+ * while (1) {
+ *     poolUpdateAll();
+ *     WaitForVBlank();
+ * }
+ * @endcode
+ */
+
+#ifndef OPENSNES_OBJPOOL_H
+#define OPENSNES_OBJPOOL_H
+
+#include <snes/types.h>
+
+/*============================================================================
+ * Constants
+ *============================================================================*/
+
+/** @brief Number of slots shared by all types (must match objpool.asm) */
+#define POOL_MAX            64
+
+/** @brief Number of types (must match objpool.asm) */
+#define POOL_TYPE_MAX       16
+
+/** @brief Returned by poolSetType(), poolNew() and poolSlot() on failure */
+#define POOL_NULL           0xFFFF
+
+/*============================================================================
+ * Exported Variables (Bank $00, indexed by slot)
+ *============================================================================*/
+
+extern u16 pool_x[POOL_MAX];     /**< X position, pixels */
+extern u16 pool_y[POOL_MAX];     /**< Y position, pixels */
+extern s16 pool_xvel[POOL_MAX];  /**< X velocity, 8.8 pixels per frame */
+extern s16 pool_yvel[POOL_MAX];  /**< Y velocity, 8.8 pixels per frame */
+extern u8 pool_xsub[POOL_MAX];   /**< X position fraction (1/256 pixel) */
+extern u8 pool_ysub[POOL_MAX];   /**< Y position fraction */
+extern u8 pool_type[POOL_MAX];   /**< Object type (read-only) */
+extern u8 pool_flags[POOL_MAX];  /**< Game-defined, 0 when created */
+extern u8 pool_id[POOL_MAX];     /**< Handle of the object in the slot (read-only) */
+
+/*============================================================================
+ * Functions
+ *============================================================================*/
+
+/**
+ * @brief Update callback of a type
+ *
+ * @param first First slot of the type
+ * @param count Live objects, in slots first .. first + count - 1
+ */
+typedef void (*PoolUpdateFunction)(u16 first, u16 count);
+
+/**
+ * @brief Empty the pool and forget every type
+ */
+void poolInit(void);
+
+/**
+ * @brief Reserve slots for a type and set its update function
+ *
+ * Types take consecutive runs of the POOL_MAX slots in the order they are
+ * set. Setting a type again only replaces its update function.
+ *
+ * @param type     Type (0 to POOL_TYPE_MAX - 1)
+ * @param capacity Most objects of the type alive at once
+ * @param update   Called by poolUpdateAll(), or NULL
+ * @return First slot of the type, or POOL_NULL if fewer than capacity
+ *         slots are left
+ */
+u16 poolSetType(u8 type, u8 capacity, PoolUpdateFunction update);
+
+/**
+ * @brief Create an object
+ *
+ * The object gets the slot after the last live object of its type, with
+ * zero velocity, fraction and flags.
+ *
+ * @param type Type, set with poolSetType()
+ * @param x    X position, pixels
+ * @param y    Y position, pixels
+ * @return Handle (0 to POOL_MAX - 1), or POOL_NULL if the type is full
+ */
+u16 poolNew(u8 type, u16 x, u16 y);
+
+/**
+ * @brief Destroy an object
+ *
+ * The last object of the same type moves into the freed slot. Inside an
+ * update callback, walk the slots from the last one down so that object has
+ * already been processed. Free or invalid handles are ignored.
+ *
+ * @param handle Handle from poolNew() (or pool_id[slot])
+ */
+void poolKill(u16 handle);
+
+/**
+ * @brief Current slot of an object
+ *
+ * @param handle Handle from poolNew()
+ * @return Slot, or POOL_NULL if the object was destroyed
+ */
+u16 poolSlot(u16 handle);
+
+/**
+ * @brief Number of live objects of a type
+ */
+u16 poolCount(u8 type);
+
+/**
+ * @brief Add velocity to position for every object of a type
+ *
+ * One pass over the arrays in assembly, about 140 cycles per object.
+ */
+void poolMove(u8 type);
+
+/**
+ * @brief Call each type's update function once
+ *
+ * Types are processed in order, skipping those with no live object or no
+ * function. Objects a callback creates in its own type are updated from the
+ * next call.
+ */
+void poolUpdateAll(void);
+
+#endif /* OPENSNES_OBJPOOL_H */
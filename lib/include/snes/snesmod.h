@@ -117,7 +117,8 @@ void snesmodSetSoundbank(u8 bank);
  * @brief Load a module from the soundbank
  *
  * Loads module data and all associated samples to SPC RAM.
- * This is a blocking operation that may take multiple frames.
+ * This is a blocking operation that may take multiple frames: data moves
+ * at 3 bytes per APU handshake, about 55 KB per second.
  *
  * @param moduleId Module ID from soundbank.h
  *
@@ -127,6 +128,59 @@ void snesmodSetSoundbank(u8 bank);
  */
 void snesmodLoadModule(u16 moduleId);
 
+/** @brief snesmodLoadModuleAsync() startPosition that leaves playback stopped */
+#define SNESMOD_LOAD_NO_PLAY 0xFFFF
+
+/**
+ * @brief Load a module in the background, a slice per snesmodProcess() call
+ *
+ * Announces the load and returns at once. Each snesmodProcess() call then
+ * sends at most snesmodSetLoadBudget() bytes, so the game keeps running
+ * while a 50 KB module goes in over a few seconds. When the last sample is
+ * in, playback starts from @p startPosition.
+ *
+ * The SPC is inside its load routine for the whole time: the previous
+ * module is silent, and sound effects, streaming and other commands wait
+ * in the queue until the load is done. Calling snesmodLoadModule(),
+ * snesmodLoadEffect(), snesmodFlush() or snesmodAllocateSoundRegion()
+ * during a load first completes it (blocking).
+ *
+ * The queue is not drained during a load and holds 83 commands; any
+ * queued past that are dropped, not delivered late.
+ *
+ * @param moduleId      Module ID from soundbank.h
+ * @param startPosition Position to play from when done, or
+ *                      SNESMOD_LOAD_NO_PLAY
+ *
+ * @code
+ * snesmodLoadModuleAsync(MOD_LEVEL2_MUSIC, 0);
+ * while (snesmodLoadRemaining()) {
+ *     WaitForVBlank();
+ *     snesmodProcess();
+ *     // ... animate the loading screen
+ * }
+ * @endcode
+ */
+void snesmodLoadModuleAsync(u16 moduleId, u16 startPosition);
+
+/**
+ * @brief Bytes left to upload in a snesmodLoadModuleAsync() load
+ *
+ * @return 0 when no load is in progress, non-zero while one runs
+ */
+u16 snesmodLoadRemaining(void);
+
+/**
+ * @brief Set how many bytes snesmodProcess() uploads per call during a load
+ *
+ * Each byte costs about 18 microseconds of busy-waiting on the SPC, so the
+ * default of 384 bytes takes roughly 7 ms of the frame. Values below 3 are
+ * raised to 3 (one handshake).
+ *
+ * @param bytes Upload budget per snesmodProcess() call
+ */
+void snesmodSetLoadBudget(u16 bytes);
+
 /**
  * @brief Start module playback
  *
@@ -261,7 +315,8 @@ void snesmodFadeVolume(u8 targetVolume, u8 speed);
  *
  * @warning This function MUST be called every frame!
  *
- * Processes the command queue and handles streaming.
+ * Processes the command queue and handles streaming. While a
+ * snesmodLoadModuleAsync() load runs, it sends the next slice of it instead.
  * Failure to call this regularly will cause:
  * - Audio stuttering and dropouts
  * - Command buffer overflow
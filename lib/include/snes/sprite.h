@@ -115,8 +115,16 @@
 /** @brief Maximum sprites in VRAM upload queue */
 #define OBJ_QUEUELIST_SIZE  128
 
-/** @brief Maximum sprite transfers per frame (7 sprites * 6 bytes each) */
-#define MAXSPRTRF   (7 * 6)
+/**
+ * @brief Default dynamic sprite upload budget, in bytes per VBlank
+ *
+ * Enough for 4 32x32, 16 16x16 or 64 8x8 sprites (512 / 128 / 32 bytes
+ * each). Change it with oamDynamicSetVramBudget().
+ */
+#define OAM_DYN_VRAM_BUDGET 2048
+
+/** @brief oamrefresh value that queues the upload ahead of normal requests */
+#define OAM_REFRESH_PRIORITY    2
 
 /*============================================================================
  * Sprite Lookup Tables (for dynamic sprite management)
@@ -190,10 +198,10 @@ typedef struct {
     s16 oamy;           /**< 2-3: Y position on screen */
     u16 oamframeid;     /**< 4-5: Frame index in sprite sheet */
     u8 oamattribute;    /**< 6: Attributes (vhoopppc) - flip, priority, palette, tile high bit */
-    u8 oamrefresh;      /**< 7: Set to 1 to request VRAM upload of graphics */
+    u8 oamrefresh;      /**< 7: Set to 1 to request VRAM upload of graphics (OAM_REFRESH_PRIORITY to jump the queue) */
     u16 oamgfxaddr;     /**< 8-9: Low 16-bit address of graphics data */
     u8 oamgfxbank;      /**< 10: Bank byte of graphics address */
-    u8 _pad;            /**< 11: Padding byte */
+    u8 oamcacheslot;    /**< 11: Slot cache hint, owned by the engine */
     u16 _reserved1;     /**< 12-13: Padding for 16-byte alignment */
     u16 _reserved2;     /**< 14-15: Padding for 16-byte alignment */
 } t_sprites;
@@ -442,6 +450,66 @@ void oamUpdate(void);
  */
 void oamClear(void);
 
+/**
+ * @brief Limit the OAM DMA to sprites 0 to count-1
+ *
+ * The NMI normally sends all 544 bytes of OAM. With an active count it
+ * only sends the used prefix: count * 4 low-table bytes plus the
+ * (count + 3) / 4 high-table bytes that go with them, e.g. 170 bytes
+ * instead of 544 for a shmup drawing 40 sprites.
+ *
+ * Sprites from @p count up are hidden when the window shrinks and are never
+ * sent afterwards, so writing them has no visible effect. Keep sprite IDs
+ * packed from 0.
+ *
+ * @param count Sprites in use (0-128, default 128)
+ */
+void oamSetActiveCount(u8 count);
+
+/**
+ * @brief Enable or disable double-buffered OAM
+ *
+ * When enabled, WaitForVBlank() copies the active window of the OAM buffer
+ * to a second 544-byte WRAM buffer (MVN, 7 cycles per byte, before VBlank)
+ * and the NMI DMAs from that copy, so sprite writes never race the
+ * transfer and VBlank time is not spent on the copy.
+ *
+ * @param enable 1 to enable, 0 to DMA straight from the OAM buffer (default)
+ *
+ * Lives in the `sprite_double` module with its front buffer; add it to
+ * LIB_MODULES to use this (it pulls in `sprite`).
+ *
+ * @note The dynamic sprite engine hides its unused sprites from the NMI,
+ *       after the copy; keep double buffering off when using it.
+ */
+void oamSetDoubleBuffer(u8 enable);
+
+/**
+ * @brief Frames that had more than 32 sprites on some scanline
+ *
+ * Counted by the NMI from the PPU's range-over flag ($213E bit 6): on
+ * those frames the highest-numbered sprites of the crowded lines were
+ * dropped. Cheap enough to leave on; use it to tune sprite budgets.
+ *
+ * @return Frames counted since boot or oamResetOverflowCounters()
+ */
+u16 oamGetRangeOverFrames(void);
+
+/**
+ * @brief Frames that had more than 34 sprite tiles (8x1 slivers) on a line
+ *
+ * Counted from the PPU's time-over flag ($213E bit 7). Large sprites hit
+ * this limit before the 32-sprite one.
+ *
+ * @return Frames counted since boot or oamResetOverflowCounters()
+ */
+u16 oamGetTimeOverFrames(void);
+
+/**
+ * @brief Reset both sprite line overflow counters to 0
+ */
+void oamResetOverflowCounters(void);
+
 /*============================================================================
  * Metasprites
  *============================================================================*/
@@ -545,6 +613,147 @@ u8 oamDrawMetaFlip(u8 startId, s16 x, s16 y, const MetaspriteItem *meta,
                    u16 baseTile, u8 basePalette, u8 size,
                    u8 flipX, u8 flipY, u8 width, u8 height);
 
+/*============================================================================
+ * Depth-Sorted Metasprite Batch
+ *============================================================================*/
+
+/** @brief Metasprite draw calls oamBatchAdd() can queue per frame */
+#define OAM_BATCH_MAX 32
+
+/**
+ * @brief Start a frame of batched metasprite drawing
+ *
+ * The batch renderer (module `sprite_batch`) collects the frame's
+ * metasprites with oamBatchAdd(), sorts them by a depth key and writes
+ * them to OAM in one assembly loop in oamBatchDraw(): no per-sprite
+ * oamSet() / oamSetSize() calls, and objects in front overlap the ones
+ * behind them.
+ *
+ * @param firstId First OAM ID the batch may use, rounded up to a multiple
+ *                of 4. IDs below it stay free for fixed sprites. Use the
+ *                same value every frame.
+ *
+ * @code
+ * oamBatchBegin(4);                  // sprites 0-3: player, fixed
+ * for (i = 0; i < enemy_count; i++) {
+ *     // Feet Y as depth key: lower on screen = in front
+ *     oamBatchAdd(ex[i], ey[i], (u8)(ey[i] + 32), enemy_meta, 0, 2, OBJ_LARGE);
+ * }
+ * oamBatchDraw();
+ * WaitForVBlank();
+ * @endcode
+ */
+void oamBatchBegin(u8 firstId);
+
+/**
+ * @brief Queue a metasprite for oamBatchDraw()
+ *
+ * @param x X position of the metasprite origin
+ * @param y Y position of the metasprite origin
+ * @param key Depth key: higher keys are drawn in front. Sorted in steps
+ *            of 8 (32 buckets); order inside a step is not defined.
+ * @param meta Metasprite data (MetaspriteItem[], METASPR_TERM-terminated).
+ *             Must stay valid until oamBatchDraw().
+ * @param baseTile Added to each item's tile
+ * @param basePalette Palette for items whose palette bits are 0
+ * @param size OBJ_SMALL or OBJ_LARGE for every item
+ *
+ * @return 1 if queued, 0 if OAM_BATCH_MAX calls are already queued
+ */
+u8 oamBatchAdd(s16 x, s16 y, u8 key, const MetaspriteItem *meta,
+               u16 baseTile, u8 basePalette, u8 size);
+
+/**
+ * @brief Sort the queued metasprites and write them to OAM
+ *
+ * Items are placed in consecutive IDs from the oamBatchBegin() ID on,
+ * highest key first, skipping items that are completely off-screen.
+ * IDs the previous oamBatchDraw() used and this one does not are hidden.
+ * Stops at sprite 127.
+ *
+ * @return Number of hardware sprites written
+ */
+u8 oamBatchDraw(void);
+
+/*============================================================================
+ * Sprite Multiplexing (Priority Rotation)
+ *============================================================================*/
+
+/**
+ * @brief Returned by oamRotateNext() when the rotating range is full
+ */
+#define OAM_ROTATE_FULL 0xFF
+
+/**
+ * @brief Set up the rotating OAM range
+ *
+ * When more than 32 sprites share a scanline, the PPU drops the ones with
+ * the highest OAM IDs. With fixed IDs the same objects vanish every frame.
+ * The rotating allocator hands out IDs from [firstId, firstId + count) in
+ * a different order each frame, so the dropout moves between objects and
+ * shows as flicker instead.
+ *
+ * IDs below @p firstId are not touched: give fixed low IDs to sprites that
+ * must never drop (player, cursor).
+ *
+ * @param firstId First OAM ID of the range
+ * @param count Number of IDs in the range (clamped to 128 - firstId)
+ * @param stride Rotation step per frame; 0 = half the sprites drawn
+ *               last frame, which alternates the front and back halves
+ *
+ * @note Lower OAM IDs are also drawn on top, so overlapping sprites in the
+ *       range change stacking order from frame to frame.
+ */
+void oamRotateInit(u8 firstId, u8 count, u8 stride);
+
+/**
+ * @brief Start a frame of rotating allocation
+ *
+ * Advances the rotation and forgets last frame's IDs. Call once per frame
+ * before the first oamRotateNext().
+ */
+void oamRotateBegin(void);
+
+/**
+ * @brief Allocate the next OAM ID of the rotating range
+ *
+ * Request IDs in the same object order every frame; the rotation is
+ * applied over the previous frame's sprite count.
+ *
+ * @return OAM ID for oamSet() and friends, or OAM_ROTATE_FULL
+ *
+ * @code
+ * oamRotateBegin();
+ * for (i = 0; i < bullet_count; i++) {
+ *     id = oamRotateNext();
+ *     if (id == OAM_ROTATE_FULL) break;
+ *     oamSet(id, bullet_x[i], bullet_y[i], BULLET_TILE, 1, 2, 0);
+ * }
+ * oamRotateEnd();
+ * @endcode
+ */
+u8 oamRotateNext(void);
+
+/**
+ * @brief Draw a metasprite with IDs from the rotating range
+ *
+ * Same item handling as oamDrawMeta(), one oamRotateNext() per on-screen
+ * item.
+ *
+ * @return Number of hardware sprites drawn (stops early when full)
+ */
+u8 oamRotateDrawMeta(s16 x, s16 y, const MetaspriteItem *meta,
+                     u16 baseTile, u8 basePalette, u8 size);
+
+/**
+ * @brief Finish a frame of rotating allocation
+ *
+ * Hides the IDs of the range that were visible before but were not
+ * allocated this frame. Call after the last oamRotateNext() and before
+ * WaitForVBlank().
+ */
+void oamRotateEnd(void);
+
 /*============================================================================
  * Dynamic Sprite Engine
  *============================================================================*/
@@ -622,9 +831,10 @@ void oamDynamicDraw(u16 id);
  *
  * Called once during init, after queueing the starting frame via
  * `oamDynamicDraw` / `oamMetaDrawDyn`, and **before** `setScreenOn`. The
- * NMI auto-flush hook drains up to 7 queue entries per VBlank, so init
- * sequences that enqueue more than that (typical for metasprites with
- * many sub-sprites) need several VBlanks to complete. This helper loops
+ * NMI auto-flush hook uploads at most the oamDynamicSetVramBudget() bytes
+ * per VBlank, so init sequences that enqueue more than that (typical for
+ * metasprites with many sub-sprites) need several VBlanks to complete.
+ * This helper loops
  * `WaitForVBlank()` until the queue is empty and tells the NMI hook to
  * skip the end-of-frame "hide stale sprites" step during the drain so
  * the just-drawn sprites are not pushed off-screen between waits.
@@ -642,6 +852,66 @@ void oamDynamicDraw(u16 id);
  */
 void oamDynamicDrainQueue(void);
 
+/**
+ * @brief Set the dynamic sprite upload budget
+ *
+ * The NMI hook uploads queued sprite graphics oldest first until the next
+ * entry would exceed @p bytes; the rest waits for the next VBlank. Each
+ * entry costs its real size (32x32 = 512, 16x16 = 128, 8x8 = 32 bytes),
+ * so small sprites are no longer held to the count that suits large ones.
+ * The uploads are charged to the shared VBlank budget
+ * (dmaSetVBlankBudget()) and never take more than what is left of it.
+ * One entry always goes per VBlank, even with a budget of 0.
+ *
+ * Sprites drawn with `oamrefresh = OAM_REFRESH_PRIORITY` are queued ahead
+ * of the normal ones (e.g. the player's animation frame over enemies).
+ * When the queue is full (OBJ_QUEUELIST_SIZE entries), the draw leaves
+ * oamrefresh set and queues the upload on a later frame.
+ *
+ * @param bytes Upload bytes per VBlank (default OAM_DYN_VRAM_BUDGET).
+ *              oamDynamicInit() restores the default.
+ */
+void oamDynamicSetVramBudget(u16 bytes);
+
+/**
+ * @brief Number of VBlanks that ended with sprite uploads still queued
+ *
+ * Counts since oamDynamicInit(). A steadily rising value means frames
+ * request more graphics than the budget allows: animations then show a
+ * stale frame for one or more VBlanks.
+ */
+u16 oamDynamicDeferredCount(void);
+
+/**
+ * @brief Share uploaded frames between sprites (VRAM slot cache)
+ *
+ * Without the cache every drawn sprite owns a VRAM slot, in draw order,
+ * and `oamrefresh` uploads its frame even when another sprite already
+ * shows it. With the cache on, the engine keys each slot on the frame's
+ * source address (gfx bank and address) instead:
+ *
+ * - a sprite whose frame is already in a slot points its OAM tile ID at
+ *   it, with no upload;
+ * - a new frame takes an empty slot, or the least recently drawn one
+ *   that no sprite uses this frame, and is queued for upload.
+ *
+ * Ten enemies on the same walk cycle then cost one upload per animation
+ * frame instead of ten, and `oamrefresh` is no longer needed to announce
+ * frame changes (OAM_REFRESH_PRIORITY still moves a miss to the front of
+ * the queue). The pools are the slots from `slotLargeInit` /
+ * `slotSmallInit` up to the end of the size's region (16 32x32, 64 16x16
+ * or 128 8x8 slots). A sprite drawn when every slot is in use by other
+ * frames this frame, or whose new frame finds the upload queue full, is
+ * skipped that frame.
+ *
+ * The cache assumes the bytes at a source address never change. Call
+ * again after rewriting sprite graphics in RAM to drop resident frames.
+ *
+ * @param enable 1 to use the cache, 0 for draw-order slots. Either way
+ *               the cache starts empty. oamDynamicInit() turns it off.
+ */
+void oamDynamicCacheEnable(u8 enable);
+
 /*============================================================================
  * Dynamic Metasprite Engine
  *============================================================================*/
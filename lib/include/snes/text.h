@@ -175,14 +175,15 @@ void textClearRect(u8 x, u8 y, u8 w, u8 h);
  *
  * As of chantier T.4 every text writer (`textPutChar`, `textPrint`,
  * `textPrintAt`, `textPrintU16`, `textPrintHex`, `textClear`,
- * `textClearRect`) sets the dirty flag itself, so the NMI handler
- * always flushes the tilemap on the next VBlank without an explicit
- * call.
+ * `textClearRect`) marks the rows it touched as dirty, so the NMI
+ * handler flushes them on the next VBlank without an explicit call.
+ * Only dirty rows are sent (64 bytes per row, adjacent rows merged
+ * into one DMA), not the whole 2 KB buffer.
  *
  * Keep using this only when you wrote to `tilemapBuffer` directly,
  * outside of the `text*` API — for example, if you patched a tile
- * by hand for a custom UI element. Calling it redundantly after a
- * regular `textPrint*` is a no-op.
+ * by hand for a custom UI element. It marks every row dirty, so the
+ * next VBlank sends the full 2 KB; avoid calling it every frame.
  */
 void textFlush(void);
 
@@ -27,6 +27,27 @@ extern u16 bg_scroll_x[4]; /* Defined in crt0.asm .system RAMSECTION */
 extern u16 bg_scroll_y[4]; /* Synced to hardware by NMI handler */
 extern volatile u8 bg_scroll_dirty; /* Bitmask: bit 0-3 = BG1-4 dirty */
 
+/* Shadow tilemap slots, defined in crt0.asm ".tilemap_shadow" RAMSECTION
+ * and flushed by the NMI handler (tilemapFlushNmi) slot 0 first. */
+typedef struct {
+    u16 vram_addr;      /* VRAM word address of the tilemap */
+    u16 src_addr;       /* Buffer address in bank $00 WRAM, 0 = unused */
+    u16 dirty_rows[2];  /* Bit n = row n needs DMA */
+} BgShadowSlot;
+
+extern BgShadowSlot tilemap_shadow[BG_SHADOW_SLOTS];
+extern volatile u8 tilemap_update_flag;
+
+/*
+ * Row number to bitmask lookup (rows 0-15 / 16-31 share it).
+ * The cc65816 compiler does not support variable-count left shifts
+ * (1 << variable), so we use a lookup table instead.
+ */
+static const u16 row_bit[16] = {
+    0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080,
+    0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000, 0x8000
+};
+
 /*============================================================================
  * Scrolling Functions
  *============================================================================*/
@@ -166,3 +187,34 @@ void bgInitTileSetData(u8 bgNumber, u8 *tileSource, u16 tileSize, u16 vramAddr)
         bgSetGfxPtr(bgNumber, vramAddr);
     }
 }
+
+/*============================================================================
+ * Shadow Tilemaps
+ *============================================================================*/
+
+void bgShadowAttach(u8 slot, u8 *buffer, u16 vramAddr) {
+    BgShadowSlot *s = &tilemap_shadow[slot];
+    s->vram_addr = vramAddr;
+    s->dirty_rows[0] = 0;
+    s->dirty_rows[1] = 0;
+    s->src_addr = (u16)buffer;
+}
+
+void bgShadowDetach(u8 slot) {
+    BgShadowSlot *s = &tilemap_shadow[slot];
+    s->src_addr = 0;
+    s->dirty_rows[0] = 0;
+    s->dirty_rows[1] = 0;
+}
+
+void bgShadowMarkRow(u8 slot, u8 row) {
+    tilemap_shadow[slot].dirty_rows[(row >> 4) & 1] |= row_bit[row & 15];
+    tilemap_update_flag = 1;
+}
+
+void bgShadowMarkAll(u8 slot) {
+    BgShadowSlot *s = &tilemap_shadow[slot];
+    s->dirty_rows[0] = 0xFFFF;
+    s->dirty_rows[1] = 0xFFFF;
+    tilemap_update_flag = 1;
+}
@@ -23,6 +23,9 @@
 /* Bit-shift for 32x32 tile size (log2(32) = 5) */
 #define TILE_SHIFT_32       5
 
+/* Sweeps: pixel offset of a position inside its 8x8 tile */
+#define TILE_MASK_8         7
+
 /*============================================================================
  * Rectangle Collision Functions
  *============================================================================*/
@@ -182,6 +185,382 @@ u8 collideRectTile(Rect *r, u8 *tilemap, u16 mapWidth) {
     return 0;
 }
 
+/*============================================================================
+ * Swept Collision Functions
+ *============================================================================*/
+
+/* One axis of a tile sweep. The rect starts overlapping the next column
+ * (row) of tiles once it has moved more than `dist` pixels on this axis;
+ * the other axis has then moved `off` + `frac` / `speed` pixels. Each
+ * further tile adds 8 to dist and stepOff + stepFrac / speed to off, so
+ * the walk needs no division after the setup (a Bresenham line between
+ * tile boundaries). */
+typedef struct {
+    u16 speed;      /* |motion| on this axis */
+    u16 dist;       /* Displacement at which the next tile is entered */
+    s16 cell;       /* That column (row) */
+    u16 off;        /* Other axis' displacement at that point, rounded down */
+    u16 frac;       /* ... and the remainder, over speed */
+    u16 stepOff;    /* Other axis' displacement per tile */
+    u16 stepFrac;
+} SweepAxis;
+
+/* floor(a * b / c) and its remainder, without a 32-bit product.
+ * b <= COLLIDE_SWEEP_MAX, c != 0. */
+static u16 sweepMulDiv(u16 a, u16 b, u16 c, u16 *rem) {
+    u16 q = 0;
+    u16 r = 0;
+    u16 bit = (COLLIDE_SWEEP_MAX + 1) >> 1;
+
+    while (bit) {
+        q = q << 1;
+        r = r << 1;
+        while (r >= c) {
+            r = r - c;
+            q = q + 1;
+        }
+        if (b & bit) {
+            r = r + a;
+            while (r >= c) {
+                r = r - c;
+                q = q + 1;
+            }
+        }
+        bit = bit >> 1;
+    }
+
+    *rem = r;
+    return q;
+}
+
+static s16 sweepClamp(s16 d) {
+    if (d > COLLIDE_SWEEP_MAX) return COLLIDE_SWEEP_MAX;
+    if (d < -COLLIDE_SWEEP_MAX) return -COLLIDE_SWEEP_MAX;
+    return d;
+}
+
+static u16 sweepAbs(s16 d) {
+    if (d < 0) return (u16)(0 - d);
+    return (u16)d;
+}
+
+/* pos moved by dist pixels in the direction of d */
+static s16 sweepMove(s16 pos, s16 d, u16 dist) {
+    if (d < 0) return pos - (s16)dist;
+    return pos + (s16)dist;
+}
+
+static void sweepAxisInit(SweepAxis *ax, s16 pos, u16 size, s16 d, u16 other) {
+    s16 lead;
+
+    ax->speed = sweepAbs(d);
+    if (d > 0) {
+        lead = pos + (s16)size - 1;
+        ax->cell = (lead >> TILE_SHIFT_8) + 1;
+        ax->dist = TILE_MASK_8 - (lead & TILE_MASK_8);
+    } else {
+        ax->cell = (pos >> TILE_SHIFT_8) - 1;
+        ax->dist = pos & TILE_MASK_8;
+    }
+
+    ax->off = 0;
+    ax->frac = 0;
+    ax->stepOff = 0;
+    ax->stepFrac = 0;
+    if (ax->speed != 0 && other != 0) {
+        ax->off = sweepMulDiv(ax->dist, other, ax->speed, &ax->frac);
+        ax->stepOff = sweepMulDiv(TILE_SIZE_DEFAULT, other, ax->speed, &ax->stepFrac);
+    }
+}
+
+static void sweepAxisStep(SweepAxis *ax, s16 d) {
+    ax->dist = ax->dist + TILE_SIZE_DEFAULT;
+    if (d < 0) {
+        ax->cell = ax->cell - 1;
+    } else {
+        ax->cell = ax->cell + 1;
+    }
+    ax->off = ax->off + ax->stepOff;
+    ax->frac = ax->frac + ax->stepFrac;
+    if (ax->frac >= ax->speed) {
+        ax->frac = ax->frac - ax->speed;
+        ax->off = ax->off + 1;
+    }
+}
+
+/* Tiles covered on one axis by a rect at pos + size, moved by off + frac
+ * (frac != 0: a fraction of a pixel further) in the direction of d */
+static void sweepSpan(s16 pos, u16 size, s16 d, u16 off, u16 frac, s16 *first, s16 *last) {
+    s16 lo, hi;
+
+    lo = sweepMove(pos, d, off);
+    hi = lo + (s16)size - 1;
+    if (frac != 0) {
+        if (d < 0) {
+            lo = lo - 1;
+        } else {
+            hi = hi + 1;
+        }
+    }
+
+    *first = (lo < 0) ? -1 : (lo >> TILE_SHIFT_8);
+    *last = hi >> TILE_SHIFT_8;
+}
+
+/* Map row whose offset in the tilemap is known. Rows visited by a sweep
+ * are near each other, so moving the cursor costs a few additions where
+ * row * mapWidth would cost a multiply per tile boundary. */
+typedef struct {
+    s16 row;
+    u16 offset;     /* row * width */
+    u16 width;
+} SweepRows;
+
+static u16 sweepRowOffset(SweepRows *rows, s16 row) {
+    while (rows->row < row) {
+        rows->offset = rows->offset + rows->width;
+        rows->row++;
+    }
+    while (rows->row > row) {
+        rows->offset = rows->offset - rows->width;
+        rows->row--;
+    }
+    return rows->offset;
+}
+
+/* Nonzero if a tile of columns col0..col1, rows row0..row1 is solid or
+ * off the map */
+static u8 sweepTiles(s16 col0, s16 row0, s16 col1, s16 row1,
+                     u8 *tilemap, SweepRows *rows, u16 mapHeight) {
+    u16 offset;
+    s16 col;
+
+    if (col0 < 0 || row0 < 0) return 1;
+    if ((u16)col1 >= rows->width || (u16)row1 >= mapHeight) return 1;
+
+    offset = sweepRowOffset(rows, row0);
+    while (row0 <= row1) {
+        for (col = col0; col <= col1; col++) {
+            if (tilemap[offset + (u16)col]) return 1;
+        }
+        offset = offset + rows->width;
+        row0++;
+    }
+
+    return 0;
+}
+
+u8 collideSweepTile(Rect *r, s16 dx, s16 dy, u8 *tilemap, u16 mapWidth,
+                    u16 mapHeight, SweepHit *hit) {
+    SweepAxis ax, ay;
+    SweepRows rows;
+    s16 first, last;
+    u16 rem;
+    u8 useX, useY, hitX, hitY;
+
+    dx = sweepClamp(dx);
+    dy = sweepClamp(dy);
+    hit->normalX = 0;
+    hit->normalY = 0;
+
+    /* Starting off the map: blocked where it stands */
+    if (r->x < 0 || r->y < 0) {
+        hit->x = r->x;
+        hit->y = r->y;
+        hit->time = 0;
+        return 1;
+    }
+
+    sweepAxisInit(&ax, r->x, r->width, dx, sweepAbs(dy));
+    sweepAxisInit(&ay, r->y, r->height, dy, sweepAbs(dx));
+    rows.row = r->y >> TILE_SHIFT_8;
+    rows.offset = (u16)rows.row * mapWidth;
+    rows.width = mapWidth;
+
+    /* Visit the tile boundaries in the order the rect crosses them and
+     * test only the column or row of tiles it enters */
+    while (1) {
+        useX = (ax.dist < ax.speed);
+        useY = (ay.dist < ay.speed);
+        if (!useX && !useY) break;
+
+        if (useX && useY) {
+            if (ax.off < ay.dist) {
+                useY = 0;                       /* Column first */
+            } else if (ax.off != ay.dist || ax.frac != 0) {
+                useX = 0;                       /* Row first */
+            }                                   /* Else both at once */
+        }
+
+        hitX = 0;
+        hitY = 0;
+        if (useX) {
+            sweepSpan(r->y, r->height, dy, ax.off, ax.frac, &first, &last);
+            hitX = sweepTiles(ax.cell, first, ax.cell, last, tilemap, &rows, mapHeight);
+        }
+        if (useY) {
+            sweepSpan(r->x, r->width, dx, ay.off, ay.frac, &first, &last);
+            hitY = sweepTiles(first, ay.cell, last, ay.cell, tilemap, &rows, mapHeight);
+        }
+        if (useX && useY && !hitX && !hitY) {
+            /* Only the diagonal tile: a corner, reported on both axes */
+            hitX = sweepTiles(ax.cell, ay.cell, ax.cell, ay.cell, tilemap, &rows, mapHeight);
+            hitY = hitX;
+        }
+
+        if (hitX || hitY) {
+            if (useX) {
+                hit->x = sweepMove(r->x, dx, ax.dist);
+                hit->y = sweepMove(r->y, dy, ax.off);
+                hit->time = sweepMulDiv(ax.dist, COLLIDE_TIME_ONE, ax.speed, &rem);
+            } else {
+                hit->x = sweepMove(r->x, dx, ay.off);
+                hit->y = sweepMove(r->y, dy, ay.dist);
+                hit->time = sweepMulDiv(ay.dist, COLLIDE_TIME_ONE, ay.speed, &rem);
+            }
+            if (hitX) hit->normalX = (dx < 0) ? 1 : -1;
+            if (hitY) hit->normalY = (dy < 0) ? 1 : -1;
+            return 1;
+        }
+
+        if (useX) sweepAxisStep(&ax, dx);
+        if (useY) sweepAxisStep(&ay, dy);
+    }
+
+    hit->x = r->x + dx;
+    hit->y = r->y + dy;
+    hit->time = COLLIDE_TIME_ONE;
+    return 0;
+}
+
+u8 collideMoveTile(Rect *r, s16 dx, s16 dy, u8 *tilemap, u16 mapWidth, u16 mapHeight) {
+    SweepHit hit;
+    s16 targetX, targetY;
+    u8 blocked = 0;
+    u8 pass;
+
+    targetX = r->x + sweepClamp(dx);
+    targetY = r->y + sweepClamp(dy);
+
+    /* A hit stops one axis; the second sweep moves along the other */
+    for (pass = 0; pass < 2; pass++) {
+        if (!collideSweepTile(r, dx, dy, tilemap, mapWidth, mapHeight, &hit)) {
+            r->x = hit.x;
+            r->y = hit.y;
+            break;
+        }
+        r->x = hit.x;
+        r->y = hit.y;
+        if (hit.normalX == 0 && hit.normalY == 0) break;
+
+        if (hit.normalX) {
+            blocked |= COLLIDE_HIT_X;
+            dx = 0;
+        } else {
+            dx = targetX - r->x;
+        }
+        if (hit.normalY) {
+            blocked |= COLLIDE_HIT_Y;
+            dy = 0;
+        } else {
+            dy = targetY - r->y;
+        }
+        if (dx == 0 && dy == 0) break;
+    }
+
+    return blocked;
+}
+
+/* Displacements along the motion between which a (pos, size) overlaps
+ * (bpos, bsize) on one axis: enter < 0 if it already does. 0 if that
+ * never happens within |d|. */
+static u8 sweepInterval(s16 pos, u16 size, s16 d, s16 bpos, u16 bsize,
+                        s16 *enter, s16 *leave) {
+    if (d > 0) {
+        *enter = bpos - (pos + (s16)size);
+        *leave = bpos + (s16)bsize - pos;
+    } else if (d < 0) {
+        *enter = pos - (bpos + (s16)bsize);
+        *leave = pos + (s16)size - bpos;
+    } else {
+        if (pos >= bpos + (s16)bsize || pos + (s16)size <= bpos) return 0;
+        *enter = -1;
+        *leave = COLLIDE_SWEEP_MAX + 1;
+        return 1;
+    }
+
+    if (*leave <= 0) return 0;              /* Behind, or moving away */
+    if (*enter >= 0 && (u16)*enter >= sweepAbs(d)) return 0;  /* Out of reach */
+    return 1;
+}
+
+u8 collideSweepRect(Rect *a, s16 dx, s16 dy, Rect *b, SweepHit *hit) {
+    s16 enterX, leaveX, enterY, leaveY;
+    u16 speedX, speedY, off, rem;
+    u8 axis;
+
+    dx = sweepClamp(dx);
+    dy = sweepClamp(dy);
+    speedX = sweepAbs(dx);
+    speedY = sweepAbs(dy);
+    hit->x = a->x + dx;
+    hit->y = a->y + dy;
+    hit->time = COLLIDE_TIME_ONE;
+    hit->normalX = 0;
+    hit->normalY = 0;
+
+    if (!sweepInterval(a->x, a->width, dx, b->x, b->width, &enterX, &leaveX)) return 0;
+    if (!sweepInterval(a->y, a->height, dy, b->y, b->height, &enterY, &leaveY)) return 0;
+
+    /* Already overlapping: see collideRectEx() */
+    if (enterX < 0 && enterY < 0) {
+        hit->x = a->x;
+        hit->y = a->y;
+        hit->time = 0;
+        return 1;
+    }
+
+    /* The later of the two entries is the contact (1 = X, 2 = Y, 3 = both) */
+    if (enterY < 0) {
+        axis = 1;
+    } else if (enterX < 0) {
+        axis = 2;
+    } else {
+        off = sweepMulDiv((u16)enterX, speedY, speedX, &rem);
+        if (off < (u16)enterY) {
+            axis = 2;
+        } else if (off == (u16)enterY && rem == 0) {
+            axis = 3;
+        } else {
+            axis = 1;
+        }
+    }
+
+    if (axis == 1) {
+        off = sweepMulDiv((u16)enterX, speedY, speedX, &rem);
+        if (speedY != 0 && off >= (u16)leaveY) return 0;    /* Y side passed by then */
+        hit->x = sweepMove(a->x, dx, (u16)enterX);
+        hit->y = sweepMove(a->y, dy, off);
+        hit->time = sweepMulDiv((u16)enterX, COLLIDE_TIME_ONE, speedX, &rem);
+        hit->normalX = (dx < 0) ? 1 : -1;
+    } else if (axis == 2) {
+        off = sweepMulDiv((u16)enterY, speedX, speedY, &rem);
+        if (speedX != 0 && off >= (u16)leaveX) return 0;
+        hit->x = sweepMove(a->x, dx, off);
+        hit->y = sweepMove(a->y, dy, (u16)enterY);
+        hit->time = sweepMulDiv((u16)enterY, COLLIDE_TIME_ONE, speedY, &rem);
+        hit->normalY = (dy < 0) ? 1 : -1;
+    } else {
+        hit->x = sweepMove(a->x, dx, (u16)enterX);
+        hit->y = sweepMove(a->y, dy, (u16)enterY);
+        hit->time = sweepMulDiv((u16)enterX, COLLIDE_TIME_ONE, speedX, &rem);
+        hit->normalX = (dx < 0) ? 1 : -1;
+        hit->normalY = (dy < 0) ? 1 : -1;
+    }
+
+    return 1;
+}
+
 /*============================================================================
  * Helper Functions
  *============================================================================*/
@@ -71,3 +71,20 @@ void dmaTransfer(u8 channel, u8 mode, u8 srcBank, u16 srcAddr, u8 destReg, u16 s
     /* Start DMA on specified channel */
     REG_MDMAEN = (1 << channel);
 }
+
+/*============================================================================
+ * VBlank Budget
+ *============================================================================*/
+
+/* Defined in crt0.asm .system RAMSECTION. vblank_dma_bytes is zeroed at
+ * the start of each NMI and bumped by every NMI-side transfer. */
+extern u16 vblank_dma_budget;
+extern u16 vblank_dma_bytes;
+
+void dmaSetVBlankBudget(u16 bytes) {
+    vblank_dma_budget = bytes;
+}
+
+u16 dmaGetVBlankBytes(void) {
+    return vblank_dma_bytes;
+}
@@ -0,0 +1,371 @@
+;==============================================================================
+; OpenSNES VBlank DMA Queue
+;==============================================================================
+;
+; Lets the main thread queue VRAM / CGRAM / OAM transfers at any time; the
+; NMI handler drains them during the next VBlank through dma_queue_hook.
+;
+; Budget: the drain only spends what is left of vblank_dma_budget after the
+; fixed NMI transfers (OAM, tilemap, dynamic sprites) have charged their
+; bytes to vblank_dma_bytes. Whatever does not fit rolls over to the next
+; VBlank. Transfers are strictly FIFO (tiles queued before the tilemap that
+; uses them always land first). An entry larger than what is left of the
+; budget is sent in part; the rest goes first in the next VBlank.
+;
+; All transfers use DMA channel 7, which the NMI already owns for the OAM
+; DMA. HDMA channels are left untouched.
+;
+; The drain only runs while the main thread is parked in WaitForVBlank
+; (the NMI lag path skips every hook), so enqueue and drain never race.
+;
+; Author: OpenSNES Team
+; License: MIT
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+;------------------------------------------------------------------------------
+; Constants
+;------------------------------------------------------------------------------
+
+.EQU DMAQ_ENTRIES           16          ; must match DMA_QUEUE_SIZE in dma.h
+.EQU DMAQ_ENTRY_SIZE        8
+.EQU DMAQ_RING_MASK         DMAQ_ENTRIES*DMAQ_ENTRY_SIZE-1
+
+; Ring entry layout (8 bytes)
+.EQU DMAQ_SRC               0           ; u16 source offset
+.EQU DMAQ_BANK              2           ; u8  source bank
+.EQU DMAQ_KIND              3           ; u8  destination (DMAQ_KIND_*)
+.EQU DMAQ_SIZE              4           ; u16 bytes still to send
+.EQU DMAQ_DEST              6           ; u16 VRAM word / CGRAM color / OAM word
+
+.EQU DMAQ_KIND_VRAM         0
+.EQU DMAQ_KIND_CGRAM        1
+.EQU DMAQ_KIND_OAM          2
+
+;------------------------------------------------------------------------------
+; RAM (bank $00 mirror — reachable with DB=$00 from both NMI and C callers)
+;------------------------------------------------------------------------------
+
+.RAMSECTION ".dma_queue_ram" BANK 0 SLOT 1
+    dma_queue_ring:       dsb DMAQ_ENTRIES*DMAQ_ENTRY_SIZE
+    dma_queue_head:       dsb 2         ; Consumer offset (NMI)
+    dma_queue_tail:       dsb 2         ; Producer offset (main thread)
+    dma_queue_deferred:   dsb 2         ; VBlanks that ended with work left
+.ENDS
+
+.SECTION ".dma_queue_text" SUPERFREE
+
+;------------------------------------------------------------------------------
+; void dmaQueueInit(void)
+;
+; Empties the queue and registers dmaQueueNmiFlush with the NMI handler.
+; Safe to call again at any time (e.g. on a scene change) to drop
+; everything still queued.
+;------------------------------------------------------------------------------
+dmaQueueInit:
+    php
+    rep #$20
+    .ACCU 16
+    lda #$0000
+    sta.l dma_queue_head
+    sta.l dma_queue_tail
+    sta.l dma_queue_deferred
+
+    ; Register the drain with the NMI handler. No race with the NMI: hooks
+    ; only run while the main thread waits in WaitForVBlank.
+    lda #dmaQueueNmiFlush
+    sta.l dma_queue_hook
+    sep #$20
+    .ACCU 8
+    lda #:dmaQueueNmiFlush
+    sta.l dma_queue_hook+2
+
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; void dmaQueueSetBudget(u16 bytes)
+;
+; Same as dmaSetVBlankBudget: the queue shares the NMI's VBlank budget.
+;------------------------------------------------------------------------------
+dmaQueueSetBudget:
+    php
+    rep #$20
+    .ACCU 16
+    lda 5,s                 ; bytes
+    sta.l vblank_dma_budget
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 dmaQueuePending(void)
+;
+; Returns the number of queued (or partially sent) transfers.
+;------------------------------------------------------------------------------
+dmaQueuePending:
+    rep #$20
+    .ACCU 16
+    lda.l dma_queue_tail
+    sec
+    sbc.l dma_queue_head
+    and #DMAQ_RING_MASK
+    lsr a                   ; / DMAQ_ENTRY_SIZE
+    lsr a
+    lsr a
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 dmaQueueDeferredCount(void)
+;
+; Returns how many VBlanks ended with queued work rolled over to the next
+; one. A steadily climbing value means the budget is too small for the
+; streaming load.
+;------------------------------------------------------------------------------
+dmaQueueDeferredCount:
+    rep #$20
+    .ACCU 16
+    lda.l dma_queue_deferred
+    rtl
+
+;------------------------------------------------------------------------------
+; u8 dmaQueueVram(const void *src, u16 vramAddr, u16 size)
+; u8 dmaQueueCGram(const void *src, u16 startColor, u16 size)
+; u8 dmaQueueOam(const void *src, u16 oamAddr, u16 size)
+;
+; Stack layout (after PHP), identical for the three entry points:
+;   5-6,s  = size
+;   7-8,s  = destination (VRAM word / CGRAM color / OAM word address)
+;   9-10,s = src low 16
+;   11,s   = src bank byte (Kl high half low byte)
+;   12,s   = pad
+;
+; Returns 1 when queued, 0 when the ring is full or size is 0.
+;------------------------------------------------------------------------------
+dmaQueueVram:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda #DMAQ_KIND_VRAM
+    bra _dmaq_push
+
+dmaQueueCGram:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda #DMAQ_KIND_CGRAM
+    bra _dmaq_push
+
+dmaQueueOam:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda #DMAQ_KIND_OAM
+
+_dmaq_push:
+    .ACCU 16
+    .INDEX 16
+    tay                     ; Y = destination kind
+    lda 5,s                 ; transfer size
+    beq _dmaq_reject        ; DAS=0 would mean 64 KB — refuse
+
+    lda.l dma_queue_tail
+    tax                     ; X = free slot
+    clc
+    adc #DMAQ_ENTRY_SIZE
+    and #DMAQ_RING_MASK
+    cmp.l dma_queue_head
+    beq _dmaq_reject        ; Ring full (one slot always kept empty)
+
+    lda 5,s                 ; transfer size
+    sta.l dma_queue_ring+DMAQ_SIZE,x
+    lda 7,s                 ; destination address
+    sta.l dma_queue_ring+DMAQ_DEST,x
+    lda 9,s                 ; source low 16
+    sta.l dma_queue_ring+DMAQ_SRC,x
+    tya
+    xba                     ; kind → high byte
+    sep #$20
+    .ACCU 8
+    lda 11,s                ; source bank byte
+    rep #$20
+    .ACCU 16
+    sta.l dma_queue_ring+DMAQ_BANK,x    ; bank + kind in one store
+
+    ; Publish the entry only once it is complete
+    txa
+    clc
+    adc #DMAQ_ENTRY_SIZE
+    and #DMAQ_RING_MASK
+    sta.l dma_queue_tail
+
+    plp
+    lda #$0001
+    rtl
+
+_dmaq_reject:
+    plp
+    lda #$0000
+    rtl
+
+.ENDS
+
+;==============================================================================
+; dmaQueueNmiFlush
+;==============================================================================
+; Indirect-long-callable target for the NMI handler's dma_queue_hook.
+;
+; IN:  DB = $00, D = tcc__nmi_registers (dp 0-3 used as scratch), any P
+; OUT: P restored
+;
+; Scratch:
+;   dp 0-1 = bytes left in this VBlank's budget
+;   dp 2-3 = size of the chunk being sent
+;==============================================================================
+
+.SECTION ".dma_queue_nmi" SUPERFREE
+
+dmaQueueNmiFlush:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+
+    ldx.w dma_queue_head
+    cpx.w dma_queue_tail
+    bne +
+    jmp _dqf_done               ; Nothing queued
++
+    ; left = budget - bytes already spent by OAM/tilemap/sprites
+    lda.w vblank_dma_budget
+    sec
+    sbc.w vblank_dma_bytes
+    bcc _dqf_defer              ; Budget already overspent
+    beq _dqf_defer
+    sta.b 0
+
+_dqf_loop:
+    lda.w dma_queue_ring+DMAQ_SIZE,x
+    cmp.b 0
+    bcc _dqf_send               ; size < left → whole entry fits
+    beq _dqf_send               ; size == left → exact fit
+
+    ; Doesn't fit what is left: send what does and keep the rest at the
+    ; head. Waiting for a whole VBlank would stall an entry sized between
+    ; the budget left after the fixed NMI transfers and the full budget
+    ; forever, along with everything queued behind it.
+    lda.b 0
+    and #$FFFE                  ; Keep word-sized destinations aligned
+    beq _dqf_defer
+
+_dqf_send:
+    sta.b 2                     ; chunk
+    sta.w $4375                 ; DMA size
+    lda.w dma_queue_ring+DMAQ_SRC,x
+    sta.w $4372                 ; Source address
+    sep #$20
+    .ACCU 8
+    lda.w dma_queue_ring+DMAQ_BANK,x
+    sta.w $4374                 ; Source bank
+
+    lda.w dma_queue_ring+DMAQ_KIND,x
+    beq _dqf_vram
+    dec a
+    beq _dqf_cgram
+
+    ; OAM: word address, 1-register write to OAMDATA ($2104)
+    rep #$20
+    .ACCU 16
+    lda.w dma_queue_ring+DMAQ_DEST,x
+    sta.w $2102                 ; OAMADDL/H
+    lda #$0400
+    bra _dqf_start
+
+_dqf_cgram:
+    .ACCU 8
+    lda.w dma_queue_ring+DMAQ_DEST,x
+    sta.w $2121                 ; CGADD
+    rep #$20
+    .ACCU 16
+    lda #$2200                  ; Mode 0, B-bus $2122 (CGDATA)
+    bra _dqf_start
+
+_dqf_vram:
+    .ACCU 8
+    lda #$80
+    sta.w $2115                 ; VMAIN: increment after high byte
+    rep #$20
+    .ACCU 16
+    lda.w dma_queue_ring+DMAQ_DEST,x
+    sta.w $2116                 ; VMADDL/H
+    lda #$1801                  ; Mode 1, B-bus $2118 (VMDATAL/H)
+
+_dqf_start:
+    .ACCU 16
+    sta.w $4370                 ; DMAP7 + BBAD7
+    sep #$20
+    .ACCU 8
+    lda #$80
+    sta.w $420B                 ; Start DMA channel 7
+    rep #$20
+    .ACCU 16
+
+    ; Charge the chunk to this VBlank
+    lda.b 0
+    sec
+    sbc.b 2
+    sta.b 0
+    lda.w vblank_dma_bytes
+    clc
+    adc.b 2
+    sta.w vblank_dma_bytes
+
+    ; Advance the entry; retire it once fully sent
+    lda.w dma_queue_ring+DMAQ_SIZE,x
+    sec
+    sbc.b 2
+    beq _dqf_retire
+    sta.w dma_queue_ring+DMAQ_SIZE,x
+    lda.w dma_queue_ring+DMAQ_SRC,x
+    clc
+    adc.b 2
+    sta.w dma_queue_ring+DMAQ_SRC,x
+    lda.b 2
+    lsr a                       ; Destinations count words (VRAM/CGRAM/OAM)
+    clc
+    adc.w dma_queue_ring+DMAQ_DEST,x
+    sta.w dma_queue_ring+DMAQ_DEST,x
+    bra _dqf_defer              ; Split entry ⇒ budget is exhausted
+
+_dqf_retire:
+    txa
+    clc
+    adc #DMAQ_ENTRY_SIZE
+    and #DMAQ_RING_MASK
+    tax
+    stx.w dma_queue_head
+    cpx.w dma_queue_tail
+    beq _dqf_done               ; Queue empty
+    lda.b 0
+    beq _dqf_defer              ; Budget spent, work left
+    jmp _dqf_loop
+
+_dqf_defer:
+    inc.w dma_queue_deferred
+
+_dqf_done:
+    plp
+    rtl
+
+.ENDS
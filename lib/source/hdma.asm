@@ -198,6 +198,71 @@ hdmaSetupBank:
     plp
     rtl
 
+;------------------------------------------------------------------------------
+; void hdmaSetupIndirect(u8 channel, u8 mode, u8 destReg, const void *table,
+;                        u8 dataBank)
+;
+; Indirect HDMA: table entries are [line count][address lo][address hi] and
+; the channel reads each entry's data from dataBank:address. DMAP gets the
+; indirect bit ($40), A1T/A1B the table (bank from the pointer), DASB
+; ($43x7) the data bank.
+;
+; Stack layout (after PHP): same as hdmaSetupBank, with dataBank at 5,s
+;   5-6,s   = dataBank (rightmost, u8 in 16-bit slot)
+;   7-8,s   = table low 16
+;   9,s     = table bank byte
+;   10,s    = pad
+;   11-12,s = destReg
+;   13-14,s = mode
+;   15-16,s = channel (leftmost)
+;------------------------------------------------------------------------------
+hdmaSetupIndirect:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+
+    sep #$20
+    .ACCU 8
+    lda 15,s                ; channel (8-bit)
+    cmp #8
+    bcs @hdmaSetupIndirect_done
+
+    rep #$20
+    .ACCU 16
+    and #$00FF
+    asl a
+    asl a
+    asl a
+    asl a                   ; channel * 16
+    clc
+    adc #$4300
+    tax                     ; X = register base ($43x0)
+
+    sep #$20
+    .ACCU 8
+    lda 13,s                ; mode
+    ora #$40                ; indirect addressing
+    sta.l $0000,x           ; $43x0 = DMAP
+    lda 11,s                ; destReg
+    sta.l $0001,x           ; $43x1 = BBAD
+
+    rep #$20
+    .ACCU 16
+    lda 7,s                 ; table low 16
+    sta.l $0002,x           ; $43x2-$43x3 = A1TL/A1TH
+
+    sep #$20
+    .ACCU 8
+    lda 9,s                 ; table bank byte (from the pointer)
+    sta.l $0004,x           ; $43x4 = A1B
+    lda 5,s                 ; data bank
+    sta.l $0007,x           ; $43x7 = DASB
+
+@hdmaSetupIndirect_done:
+    plp
+    rtl
+
 ;------------------------------------------------------------------------------
 ; void hdmaEnable(u8 channelMask)
 ;
@@ -325,6 +390,234 @@ hdmaSetTable:
     plp
     rtl
 
+;------------------------------------------------------------------------------
+; void hdmaWaveScroll(void)
+;
+; Wave-mode step of hdmaWaveUpdate(). hdma_table_a onward holds one period
+; of the wave plus 224 rows, row j = [$81][offset(j * frequency)], so every
+; window of 224 rows is contiguous and starting the table q rows in shows
+; phase q * frequency. A frame then costs one table pointer write; the
+; period is rebuilt only when amplitude or frequency change.
+;
+; With frequency = 2^k * odd the period is 256 >> k rows and phase F is
+; shown from row q = (F >> k) * odd^-1 mod period: the same picture the
+; per-frame rebuild drew, with F rounded down to a multiple of 2^k.
+;
+; Called by hdmaWaveUpdate() after it advanced hdma_wave_frame; frequency
+; must be non-zero (0 is a whole-layer sway, kept on the per-frame path).
+;------------------------------------------------------------------------------
+hdmaWaveScroll:
+    php
+    phb
+    rep #$10
+    .INDEX 16
+    sep #$20
+    .ACCU 8
+    pea $0000
+    plb
+    plb                     ; DB = $00: wave state, tables and math registers
+
+    lda hdma_wave_built
+    beq @build
+    lda hdma_wave_amplitude
+    cmp hdma_wave_built_amp
+    bne @build
+    lda hdma_wave_frequency
+    cmp hdma_wave_built_freq
+    beq @scroll
+@build:
+    jsr hdma_wave_build
+
+@scroll:
+    ; q = (frame >> k) * odd^-1, low bits kept by the period mask
+    lda hdma_wave_frame
+    ldx hdma_wave_shift
+    beq @shifted
+@shift:
+    lsr a
+    dex
+    bne @shift
+@shifted:
+    sta $4202
+    lda hdma_wave_inverse
+    sta $4203               ; 8 cycles: the channel base is computed meanwhile
+
+    rep #$20
+    .ACCU 16
+    lda hdma_wave_channel
+    and #$00FF
+    asl a
+    asl a
+    asl a
+    asl a
+    clc
+    adc #$4300
+    tax
+
+    lda $4216
+    and hdma_wave_rows
+    sta hdma_wave_end       ; free outside a build
+    asl a
+    adc hdma_wave_end       ; q * 3 (carry clear: q < 256)
+    adc #hdma_table_a
+    sta.l $0002,x           ; A1T: taken at the start of the next frame
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; hdma_wave_build - fill the period table (internal, from hdmaWaveScroll)
+;
+; In: A 8-bit, X/Y 16-bit, DB = $00. Computes the period (64 rows at
+; frequency 4, 256 for an odd one) and block-copies the 224 rows after it,
+; once per amplitude/frequency change. The rows are rewritten in place, so
+; a change can show one torn frame.
+;------------------------------------------------------------------------------
+hdma_wave_build:
+    lda hdma_wave_amplitude
+    sta hdma_wave_built_amp
+    lda hdma_wave_frequency
+    sta hdma_wave_built_freq
+
+    ; frequency = 2^k * odd
+    ldx #0
+@strip:
+    lsr a
+    bcs @odd
+    inx
+    bra @strip
+@odd:
+    rol a                   ; carry = 1: restore the odd part
+    stx hdma_wave_shift
+    sta hdma_wave_odd
+    sta hdma_wave_inverse
+
+    ; Period mask = (256 >> k) - 1
+    lda #$FF
+    cpx #0
+    beq @masked
+@mask:
+    lsr a
+    dex
+    bne @mask
+@masked:
+    sta hdma_wave_rows
+    stz hdma_wave_rows+1
+
+    ; odd^-1 mod 256 by Newton: x = x * (2 - odd * x), 3 -> 6 -> 12 bits
+    ldy #2
+@newton:
+    lda hdma_wave_odd
+    sta $4202
+    lda hdma_wave_inverse
+    sta $4203
+    nop
+    nop
+    nop
+    nop
+    lda #2
+    sec
+    sbc $4216               ; 2 - odd * x
+    xba
+    lda hdma_wave_inverse
+    sta $4202
+    xba
+    sta $4203
+    nop
+    nop
+    nop
+    nop
+    lda $4216
+    sta hdma_wave_inverse
+    dey
+    bne @newton
+
+    ; Rows 0 .. period - 1
+    rep #$20
+    .ACCU 16
+    lda hdma_wave_rows
+    inc a
+    sta hdma_wave_end
+    asl a
+    adc hdma_wave_end
+    sta hdma_wave_end       ; period * 3
+    sep #$20
+    .ACCU 8
+
+    lda hdma_wave_amplitude
+    sta $4202               ; WRMPYA holds the amplitude for the whole fill
+    stz hdma_wave_angle
+    ldy #0
+@row:
+    ; |sin| index: angle & 63, mirrored in the 2nd and 4th quarters
+    rep #$20
+    .ACCU 16
+    lda hdma_wave_angle
+    bit #$0040
+    beq @rising
+    eor #$003F
+@rising:
+    and #$003F
+    tax
+    sep #$20
+    .ACCU 8
+    lda.l hdma_sine_quarter,x
+    sta $4203               ; amplitude * |sin|
+    lda #$81
+    sta hdma_table_a,y      ; repeat mode, 1 line
+    lda hdma_wave_angle     ; N = sign half of the period
+    rep #$20
+    .ACCU 16
+    bmi @negative
+    lda $4216
+    clc
+    adc #128                ; (x + 128) >> 8, as hdmaWaveUpdate rounds
+    xba
+    and #$00FF
+    bra @store
+@negative:
+    lda $4216
+    clc
+    adc #127                ; (-x + 128) >> 8 = -((x + 127) >> 8)
+    xba
+    and #$00FF
+    eor #$FFFF
+    inc a
+@store:
+    sta hdma_table_a+1,y
+    iny
+    iny
+    iny
+    sep #$20
+    .ACCU 8
+    lda hdma_wave_angle
+    clc
+    adc hdma_wave_frequency
+    sta hdma_wave_angle
+    cpy hdma_wave_end
+    bne @row
+
+    ; Rows period .. period + 223 repeat rows 0 .. 223. The forward copy
+    ; overlaps its source when the period is shorter than 224 rows and
+    ; then re-reads rows it just wrote, which is the same repetition.
+    rep #$20
+    .ACCU 16
+    tya
+    clc
+    adc #hdma_table_a
+    tay                     ; destination: row period
+    ldx #hdma_table_a       ; source: row 0
+    lda #224*3-1            ; 224 rows
+    mvn $00,$00             ; 7 cycles per byte, DB stays $00
+    sep #$20
+    .ACCU 8
+    lda #0
+    sta $0000,y             ; end marker after row period + 223
+    lda #1
+    sta hdma_wave_built
+    rts
+
 .ENDS
 
 ;------------------------------------------------------------------------------
@@ -340,12 +633,16 @@ hdmaSetTable:
 ; Tables use 1-scanline resolution: 224 entries * 3 bytes + 1 = 673 bytes
 ; Format per entry: [0x81 = repeat 1 line] [scroll_lo] [scroll_hi]
 ;
+; Wave mode uses the whole section as one table of up to 256 + 224 rows
+; (hdmaWaveScroll); ripple mode uses the two halves as double buffers.
+;
 ; Tables in bank $00 RAM (< $2000) — C pointers can write directly.
 ; Bank $00:$0000-$1FFF mirrors bank $7E:$0000-$1FFF (same WRAM).
 ;------------------------------------------------------------------------------
 .RAMSECTION ".hdma_wave_tables" BANK 0 SLOT 1
     hdma_table_a:         dsb 673    ; Wave buffer A (224 * 3 + 1)
     hdma_table_b:         dsb 673    ; Wave buffer B (224 * 3 + 1)
+    hdma_wave_tail:       dsb 95     ; Wave period table: (256 + 224) * 3 + 1
 .ENDS
 
 .RAMSECTION ".hdma_brightness" BANK 0 SLOT 1
@@ -372,4 +669,13 @@ hdmaSetTable:
     hdma_wave_dest_reg:   dsb 1      ; Destination register (BG1HOFS, etc.)
     hdma_wave_mode:       dsb 1      ; 0 = wave, 1 = ripple
     hdma_iris_buffer:     dsb 1      ; 0 = iris buffer A active, 1 = buffer B
+    hdma_wave_built:      dsb 1      ; 1 = period table matches built_amp/freq
+    hdma_wave_built_amp:  dsb 1      ; Amplitude of the period table
+    hdma_wave_built_freq: dsb 1      ; Frequency of the period table
+    hdma_wave_odd:        dsb 1      ; Odd part of the frequency
+    hdma_wave_inverse:    dsb 1      ; Its inverse mod 256
+    hdma_wave_angle:      dsb 1      ; Build: angle of the current row
+    hdma_wave_shift:      dsw 1      ; k: frequency = 2^k * odd
+    hdma_wave_rows:       dsw 1      ; Period in rows - 1 (mask)
+    hdma_wave_end:        dsw 1      ; Build: end offset; scroll: scratch
 .ENDS
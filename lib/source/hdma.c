@@ -77,11 +77,12 @@ void hdmaWindowShape(u8 channel, const void *windowTable) {
 /*
  * Local 64-entry quarter-wave sine table (8.8 fixed-point, 0-255).
  * Avoids dependency on the math module. Full period = 256 entries.
- * sine_quarter[i] = round(255 * sin(i * pi / 128)) for i in [0..63].
+ * hdma_sine_quarter[i] = round(255 * sin(i * pi / 128)) for i in [0..63].
  * The peak is 255 (not 256) so the table fits in u8 without truncation;
  * the 1/256 precision loss at sin(90°) is imperceptible for HDMA effects.
+ * Also read by hdmaWaveScroll (hdma.asm) to build the wave period table.
  */
-static const u8 sine_quarter[64] = {
+const u8 hdma_sine_quarter[64] = {
       0,   6,  13,  19,  25,  31,  37,  44,
      50,  56,  62,  68,  74,  80,  86,  92,
      98, 103, 109, 115, 120, 126, 131, 136,
@@ -97,16 +98,16 @@ static s16 hdmaSin(u8 angle) {
     u8 idx;
     s16 val;
     if (angle < SINE_QUARTER_SIZE) {
-        val = (s16)sine_quarter[angle];
+        val = (s16)hdma_sine_quarter[angle];
     } else if (angle < SINE_HALF_PERIOD) {
         idx = (u8)(SINE_HALF_PERIOD - 1 - angle);
-        val = (s16)sine_quarter[idx];
+        val = (s16)hdma_sine_quarter[idx];
     } else if (angle < SINE_3Q_PERIOD) {
         idx = (u8)(angle - SINE_HALF_PERIOD);
-        val = (s16)(-(s16)sine_quarter[idx]);
+        val = (s16)(-(s16)hdma_sine_quarter[idx]);
     } else {
         idx = (u8)(255 - angle);
-        val = (s16)(-(s16)sine_quarter[idx]);
+        val = (s16)(-(s16)hdma_sine_quarter[idx]);
     }
     return val;
 }
@@ -128,6 +129,10 @@ extern u8 hdma_wave_enabled;
 extern u8 hdma_wave_speed;
 extern u8 hdma_wave_dest_reg;
 extern u8 hdma_wave_mode;
+extern u8 hdma_wave_built;
+
+/* Wave mode per-frame step (hdma.asm): period table + pointer move */
+extern void hdmaWaveScroll(void);
 
 /* Number of 4-line chunks for gradient effects: 224 / 4 = 56 */
 #define WAVE_CHUNKS 56
@@ -187,6 +192,7 @@ void hdmaWaveInit(void) {
     hdma_wave_speed = 2;
     hdma_wave_dest_reg = HDMA_DEST_BG1HOFS;
     hdma_wave_mode = 0;
+    hdma_wave_built = 0;
 
     /* Initialize both buffers with flat scroll (no wave) */
     fillWaveTable((u8 *)hdma_table_a, 0, 0, 0);
@@ -210,6 +216,7 @@ void hdmaWaveH(u8 channel, u8 bg, u8 amplitude, u8 frequency) {
     hdma_wave_frequency = frequency;
     hdma_wave_dest_reg = destReg;
     hdma_wave_mode = 0;
+    hdma_wave_built = 0;
 
     hdma_table_a[0] = 0x00;
     hdma_active_buffer = 0;
@@ -225,9 +232,17 @@ void hdmaWaveUpdate(void) {
     /* Advance animation frame based on speed */
     hdma_wave_frame = (u8)(hdma_wave_frame + hdma_wave_speed);
 
+    /* Wave: one precomputed period, animated by moving the table pointer.
+     * Rebuilt by hdmaWaveScroll only when amplitude or frequency change. */
+    if (hdma_wave_mode == 0 && hdma_wave_frequency != 0) {
+        hdmaWaveScroll();
+        return;
+    }
+
     {
-        /* Both wave and ripple: double-buffered bank $00 RAM tables */
+        /* Ripple (and frequency 0): double-buffered bank $00 RAM tables */
         u8 *update_buf;
+        hdma_wave_built = 0;
         if (hdma_active_buffer == 0) {
             update_buf = (u8 *)hdma_table_b;
         } else {
@@ -258,6 +273,7 @@ void hdmaWaveStop(void) {
     /* Disable HDMA channel */
     hdmaDisable(channel_mask[hdma_wave_channel]);
     hdma_wave_enabled = 0;
+    hdma_wave_built = 0;  /* callers may reuse hdma_table_a */
 
     /* Reset BG scroll offset to 0 so the wave doesn't leave the
      * background shifted after stopping. Write both low and high bytes. */
@@ -269,6 +285,75 @@ void hdmaWaveStop(void) {
  * here via address-taking for fn-pointer fallback. */
 void (*const __opensnes_force_emit_hdmaWaveSetSpeed)(u8) = hdmaWaveSetSpeed;
 
+/*============================================================================
+ * Run-length Table Builder
+ *
+ * Non-repeat entries write their data once and hold it for up to 127
+ * lines, so consecutive lines with the same value share one entry:
+ * [count][data] (direct) or [count][address lo][address hi] (indirect).
+ *============================================================================*/
+
+/* Data bytes per entry for each transfer mode (DMAP bits 0-2) */
+static const u8 mode_size[8] = { 1, 2, 2, 4, 4, 4, 2, 4 };
+
+static u8 *run_start;   /* First byte of the table being built */
+static u8 *run_next;    /* Next free byte */
+static u8 *run_entry;   /* Line-count byte of the last entry, 0 = none */
+static u8 run_size;     /* Data bytes per entry */
+static u8 run_indirect; /* 1 = entries hold the data address */
+
+void hdmaRunBegin(u8 *table, u8 mode) {
+    run_start = table;
+    run_next = table;
+    run_entry = 0;
+    run_indirect = (u8)((mode & HDMA_INDIRECT) ? 1 : 0);
+    run_size = run_indirect ? 2 : mode_size[mode & 0x07];
+}
+
+void hdmaRunAdd(const void *data, u8 lines) {
+    const u8 *src;
+    u8 address[2];
+    u8 i, n;
+
+    if (run_indirect) {
+        u16 a = (u16)data;
+        address[0] = (u8)(a & 0xFF);
+        address[1] = (u8)(a >> 8);
+        src = address;
+    } else {
+        src = (const u8 *)data;
+    }
+
+    /* Same value as the last entry: lengthen it */
+    if (run_entry) {
+        for (i = 0; i < run_size; i++) {
+            if (run_entry[1 + i] != src[i]) break;
+        }
+        if (i == run_size) {
+            n = (u8)(127 - *run_entry);
+            if (n > lines) n = lines;
+            *run_entry = (u8)(*run_entry + n);
+            lines = (u8)(lines - n);
+        }
+    }
+
+    /* New entries, 127 lines at most each */
+    while (lines) {
+        n = (lines > 127) ? 127 : lines;
+        run_entry = run_next;
+        *run_next++ = n;
+        for (i = 0; i < run_size; i++) {
+            *run_next++ = src[i];
+        }
+        lines = (u8)(lines - n);
+    }
+}
+
+u16 hdmaRunEnd(void) {
+    *run_next = 0x00;  /* End marker */
+    return (u16)(run_next - run_start) + 1;
+}
+
 /*============================================================================
  * HDMA Effect Helpers
  *
@@ -282,24 +367,19 @@ void (*const __opensnes_force_emit_hdmaWaveSetSpeed)(u8) = hdmaWaveSetSpeed;
 void hdmaBrightnessGradient(u8 channel, u8 topBrightness, u8 bottomBrightness) {
     u16 i;
     u8 top, bot;
-    u8 *p;
 
     top = topBrightness & 0x0F;
     bot = bottomBrightness & 0x0F;
 
-    /* Write directly to bank $00 RAM table (below $2000) */
-    p = (u8 *)hdma_brightness_table;
-
-    /* 56 chunks of 4 scanlines, non-repeat mode.
-     * Each entry: linecount (4), brightness value.
-     * INIDISP is latched — value persists until next HDMA write. */
+    /* 56 chunks of 4 scanlines, non-repeat mode: INIDISP is latched, so
+     * chunks with the same level merge into one entry (16 levels at most). */
+    hdmaRunBegin(hdma_brightness_table, HDMA_MODE_1REG);
     for (i = 0; i < WAVE_CHUNKS; i++) {
         u8 line = (u8)((i << 2) + 2);
         u8 bright = (u8)(top + (((s16)bot - (s16)top) * line) / 223);
-        *p++ = 4;       /* 4 scanlines per chunk */
-        *p++ = bright;  /* INIDISP value (0-15) */
+        hdmaRunAdd(&bright, 4);
     }
-    *p = 0x00;  /* End marker */
+    hdmaRunEnd();
 
     hdmaSetupBank(channel, HDMA_MODE_1REG, HDMA_DEST_INIDISP, hdma_brightness_table, 0x00);
     hdmaEnable(channel_mask[channel]);
@@ -327,11 +407,16 @@ void hdmaColorGradient(u8 channel, u8 colorIndex, u16 topColor, u16 bottomColor)
     botG = (s16)((bottomColor >> 5) & 0x1F);
     botB = (s16)((bottomColor >> 10) & 0x1F);
 
-    u8 *p = (u8 *)hdma_color_table;
+    u8 entry[4];
+
+    entry[0] = colorIndex;                  /* CGADD low */
+    entry[1] = 0x00;                        /* CGADD high */
 
     /* 56 chunks of 4 scanlines each = 224 scanlines.
      * Mode 2REG_2X to CGADD ($2121): writes CGADD, CGADD, CGDATA, CGDATA.
-     * Non-repeat: write once per group, color latches until next write. */
+     * Non-repeat: write once per group, color latches until next write,
+     * so chunks with the same color merge into one entry. */
+    hdmaRunBegin(hdma_color_table, HDMA_MODE_2REG_2X);
     for (i = 0; i < WAVE_CHUNKS; i++) {
         s16 line = (s16)((i << 2) + 2);
         u8 r = (u8)(topR + ((botR - topR) * line) / 223);
@@ -339,13 +424,11 @@ void hdmaColorGradient(u8 channel, u8 colorIndex, u16 topColor, u16 bottomColor)
         u8 b = (u8)(topB + ((botB - topB) * line) / 223);
         u16 color = (u16)(((u16)b << 10) | ((u16)g << 5) | (u16)r);
 
-        *p++ = 4;                          /* 4 scanlines, non-repeat */
-        *p++ = colorIndex;                  /* CGADD low */
-        *p++ = 0x00;                        /* CGADD high */
-        *p++ = (u8)(color & 0xFF);          /* CGDATA low */
-        *p++ = (u8)((color >> 8) & 0xFF);   /* CGDATA high */
+        entry[2] = (u8)(color & 0xFF);          /* CGDATA low */
+        entry[3] = (u8)((color >> 8) & 0xFF);   /* CGDATA high */
+        hdmaRunAdd(entry, 4);
     }
-    *p = 0x00;  /* End marker */
+    hdmaRunEnd();
 
     hdmaSetupBank(channel, HDMA_MODE_2REG_2X, HDMA_DEST_CGADD, hdma_color_table, 0x00);
     hdmaEnable(channel_mask[channel]);
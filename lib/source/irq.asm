@@ -0,0 +1,537 @@
+;==============================================================================
+; OpenSNES Raster IRQ Scheduler
+;==============================================================================
+;
+; A sorted table of (scanline, H position, callback) entries, run once per
+; frame by chaining H/V timer IRQs: each IRQ runs one entry, then programs
+; VTIME/HTIME for the next one. After the last entry the timer is pointed
+; back at the first, so the chain needs nothing from the NMI.
+;
+; Entries are kept as parallel word arrays indexed by entry*2, in screen
+; order (line, then H position). irq_cur is the offset of the entry the
+; timer is armed for.
+;
+; If a callback runs past the position of the next entry, that entry runs
+; straight away instead of waiting a frame for the timer to match again.
+;
+; Author: OpenSNES Team
+; License: MIT
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+;------------------------------------------------------------------------------
+; Constants
+;------------------------------------------------------------------------------
+
+.EQU IRQ_ENTRIES            16          ; must match IRQ_MAX_ENTRIES in irq.h
+.EQU IRQ_HPOS_NONE          $FFFF       ; V-IRQ only (IRQ_HPOS_NONE in irq.h)
+
+.EQU IRQ_MODE_OFF           $81         ; NMITIMEN: NMI + auto-joypad
+.EQU IRQ_MODE_V             $A1         ; ... + V-IRQ
+.EQU IRQ_MODE_HV            $B1         ; ... + H/V-IRQ
+
+.EQU REG_SLHV               $002137     ; Latch H/V counters
+.EQU REG_OPHCT              $00213C     ; H counter (low, then bit 8)
+.EQU REG_OPVCT              $00213D     ; V counter (low, then bit 8)
+.EQU REG_STAT78             $00213F     ; Resets the counter flip-flops
+.EQU REG_NMITIMEN           $004200
+.EQU REG_HTIMEL             $004207
+.EQU REG_VTIMEL             $004209
+.EQU REG_TIMEUP             $004211
+
+;------------------------------------------------------------------------------
+; RAM (bank $00 — also reachable through the $7E mirror the handler runs with)
+;------------------------------------------------------------------------------
+
+.RAMSECTION ".irq_ram" BANK 0 SLOT 1
+    irq_line:       dsb IRQ_ENTRIES*2   ; VTIME
+    irq_hpos:       dsb IRQ_ENTRIES*2   ; HTIME (0 for V-only entries)
+    irq_fn:         dsb IRQ_ENTRIES*2   ; Callback, low 16
+    irq_bm:         dsb IRQ_ENTRIES*2   ; Callback bank | NMITIMEN mode << 8
+    irq_end_v:      dsb IRQ_ENTRIES*2   ; Counters when the callback returned
+    irq_end_h:      dsb IRQ_ENTRIES*2
+    irq_count:      dsb 2               ; Entries * 2
+    irq_cur:        dsb 2               ; Armed entry * 2
+    irq_on:         dsb 2               ; irqEnable / irqDisable
+    irq_tmp:        dsb 2
+    irq_pos_v:      dsb 2               ; Beam position latched by irq_now
+    irq_pos_h:      dsb 2
+    irq_call:       dsb 4               ; Armed callback (24-bit) + mode
+.ENDS
+
+; Direct page for callbacks, same layout as .registers (see crt0's
+; tcc__nmi_registers): C callbacks must not touch the interrupted code's
+; tcc__r* slots.
+.RAMSECTION ".irq_registers" BANK 0 SLOT 1 ALIGN $0100
+    irq_registers:  dsb 48
+.ENDS
+
+.SECTION ".irq_text" SUPERFREE
+
+.accu 16
+.index 16
+.16bit
+
+;------------------------------------------------------------------------------
+; irqDispatch - IRQ handler (IrqHandler jumps here through irq_hook)
+;------------------------------------------------------------------------------
+; About 70 cycles from the IRQ to the first instruction of the callback.
+; Callbacks run with 16-bit A/X/Y, DB = $7E, D = irq_registers and
+; interrupts disabled; the NMI can still preempt them.
+;------------------------------------------------------------------------------
+irqDispatch:
+    rep #$38
+    .ACCU 16
+    .INDEX 16
+    pha
+    phx
+    phy
+    phd
+    phb
+    lda #irq_registers
+    tcd
+    pea $7E7E
+    plb
+    plb
+
+@run:
+    lda.l REG_TIMEUP                ; Acknowledge (reads $4212 too, harmless)
+    phk
+    pea @back-1
+    jml [irq_call]                  ; Reads the pointer from bank $00
+@back:
+
+    ; Cost readout: counters as the callback returns
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    ldx.w irq_cur
+    sep #$20
+    .ACCU 8
+    lda.l REG_SLHV
+    lda.l REG_OPHCT
+    sta.w irq_end_h,x
+    lda.l REG_OPHCT
+    and #$01
+    sta.w irq_end_h+1,x
+    lda.l REG_OPVCT
+    sta.w irq_end_v,x
+    lda.l REG_OPVCT
+    and #$01
+    sta.w irq_end_v+1,x
+    lda.l REG_STAT78
+    rep #$20
+    .ACCU 16
+
+    ; Chain to the next entry, or back to the first for the next frame
+    inx
+    inx
+    cpx.w irq_count
+    bcc @next
+    ldx #0
+    jsr irq_arm
+    bra @exit
+
+@next:
+    jsr irq_arm
+    jsr irq_now                     ; After arming: the beam may have moved on
+    lda.w irq_pos_v                 ; Already past the next entry?
+    cmp.w irq_line,x
+    bcc @exit
+    bne @run
+    lda.w irq_pos_h
+    cmp.w irq_hpos,x
+    bcs @run
+
+@exit:
+    plb
+    pld
+    ply
+    plx
+    pla
+    rti
+
+;------------------------------------------------------------------------------
+; irq_arm - Program the timer for entry X (offset)
+;------------------------------------------------------------------------------
+; IN: 16-bit A/X, DB = $00 or $7E
+;------------------------------------------------------------------------------
+irq_arm:
+    stx.w irq_cur
+    lda.w irq_line,x
+    sta.l REG_VTIMEL
+    lda.w irq_hpos,x
+    sta.l REG_HTIMEL
+    lda.w irq_fn,x
+    sta.w irq_call
+    lda.w irq_bm,x
+    sta.w irq_call+2                ; Bank, and the mode in the pad byte
+    sep #$20
+    .ACCU 8
+    xba
+    sta.l REG_NMITIMEN
+    rep #$20
+    .ACCU 16
+    rts
+
+;------------------------------------------------------------------------------
+; irq_now - Latch the beam position into irq_pos_v (line) and irq_pos_h
+;------------------------------------------------------------------------------
+; IN: 16-bit A/X, DB = $00 or $7E. X is preserved.
+;------------------------------------------------------------------------------
+irq_now:
+    sep #$20
+    .ACCU 8
+    lda.l REG_SLHV
+    lda.l REG_OPHCT
+    sta.w irq_pos_h
+    lda.l REG_OPHCT
+    and #$01
+    sta.w irq_pos_h+1
+    lda.l REG_OPVCT
+    sta.w irq_pos_v
+    lda.l REG_OPVCT
+    and #$01
+    sta.w irq_pos_v+1
+    lda.l REG_STAT78
+    rep #$20
+    .ACCU 16
+    rts
+
+;------------------------------------------------------------------------------
+; irq_restart - Arm the first entry below the current line
+;------------------------------------------------------------------------------
+; Entries above it wait for the next frame. Disables the timer IRQ when the
+; scheduler is off or the table is empty.
+; IN: 16-bit A/X, DB = $00, interrupts disabled
+;------------------------------------------------------------------------------
+irq_restart:
+    lda.w irq_on
+    beq @off
+    ldx.w irq_count
+    beq @off
+
+    jsr irq_now
+    ldx #0
+-:  lda.w irq_line,x
+    cmp.w irq_pos_v
+    beq +
+    bcs @found
++:  inx
+    inx
+    cpx.w irq_count
+    bcc -
+    ldx #0                          ; All above: first entry, next frame
+
+@found:
+    lda.l REG_TIMEUP                ; Drop a stale flag
+    jmp irq_arm
+
+@off:
+    sep #$20
+    .ACCU 8
+    lda #IRQ_MODE_OFF
+    sta.l REG_NMITIMEN
+    lda.l REG_TIMEUP
+    rep #$20
+    .ACCU 16
+    rts
+
+;------------------------------------------------------------------------------
+; void irqInit(void)
+;
+; Empties the table, turns the scheduler off and installs irqDispatch as
+; the IRQ handler.
+;------------------------------------------------------------------------------
+irqInit:
+    php
+    phb
+    sei
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    pea $0000
+    plb
+    plb
+
+    stz.w irq_count
+    stz.w irq_cur
+    stz.w irq_on
+    jsr irq_restart
+
+    lda #irqDispatch
+    sta.w irq_hook
+    sep #$20
+    .ACCU 8
+    lda #:irqDispatch
+    sta.w irq_hook+2
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 irqAdd(u16 scanline, u16 hpos, IrqCallback callback)
+;
+; Inserts an entry in screen order. Returns 0 if the table is full.
+; Stack after PHP + PHB + JSL:
+;   6-7,s   = callback low 16
+;   8,s     = callback bank
+;   10-11,s = hpos (IRQ_HPOS_NONE = start of the line)
+;   12-13,s = scanline
+;------------------------------------------------------------------------------
+irqAdd:
+    php
+    phb
+    sei
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    pea $0000
+    plb
+    plb
+
+    ldx.w irq_count
+    cpx #IRQ_ENTRIES*2
+    bcc +
+    lda #0
+    plb
+    plp
+    rtl
+
++:  lda 10,s                        ; V-only entries sort at H 0
+    cmp #IRQ_HPOS_NONE
+    bne +
+    lda #0
++:  sta.w irq_tmp                   ; Sort key H
+
+    ; Shift the entries after the new one up by one
+-:  cpx #0
+    beq @insert
+    lda.w irq_line-2,x
+    cmp 12,s
+    bcc @insert
+    bne +
+    lda.w irq_hpos-2,x
+    cmp.w irq_tmp
+    bcc @insert
+    beq @insert
++:  lda.w irq_line-2,x
+    sta.w irq_line,x
+    lda.w irq_hpos-2,x
+    sta.w irq_hpos,x
+    lda.w irq_fn-2,x
+    sta.w irq_fn,x
+    lda.w irq_bm-2,x
+    sta.w irq_bm,x
+    lda.w irq_end_v-2,x
+    sta.w irq_end_v,x
+    lda.w irq_end_h-2,x
+    sta.w irq_end_h,x
+    dex
+    dex
+    bra -
+
+@insert:
+    lda 12,s
+    sta.w irq_line,x
+    sta.w irq_end_v,x               ; Cost 0 until it runs
+    lda.w irq_tmp
+    sta.w irq_hpos,x
+    sta.w irq_end_h,x
+    lda 6,s
+    sta.w irq_fn,x
+    lda 10,s
+    cmp #IRQ_HPOS_NONE
+    lda 8,s
+    and #$00FF
+    bcc @hv                         ; H position given: H/V-IRQ
+    ora #IRQ_MODE_V<<8
+    bra @mode
+@hv:
+    ora #IRQ_MODE_HV<<8
+@mode:
+    sta.w irq_bm,x
+
+    lda.w irq_count
+    ina
+    ina
+    sta.w irq_count
+    jsr irq_restart
+
+    lda #1
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; void irqClear(void)
+;------------------------------------------------------------------------------
+irqClear:
+    php
+    phb
+    sei
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    pea $0000
+    plb
+    plb
+
+    stz.w irq_count
+    jsr irq_restart
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; void irqEnable(void)
+;------------------------------------------------------------------------------
+irqEnable:
+    php
+    phb
+    sei
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    pea $0000
+    plb
+    plb
+
+    lda #1
+    sta.w irq_on
+    jsr irq_restart
+
+    plb
+    plp
+    cli                             ; Reset leaves I set; nothing else clears it
+    rtl
+
+;------------------------------------------------------------------------------
+; void irqDisable(void)
+;------------------------------------------------------------------------------
+irqDisable:
+    php
+    phb
+    sei
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    pea $0000
+    plb
+    plb
+
+    stz.w irq_on
+    jsr irq_restart
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 irqGetCost(u16 index)
+;
+; Dots (4 master cycles, 340 per line) from entry `index`'s programmed
+; position to the return of its callback, the last time it ran. Entries are
+; numbered in screen order. 0 for an entry that has not run yet; $FFFF when
+; the cost does not fit 16 bits (past 65535 dots, about 193 lines).
+; Stack after PHP + JSL: 5-6,s = index
+;------------------------------------------------------------------------------
+irqGetCost:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda 5,s
+    asl a
+    cmp.l irq_count
+    bcc +
+    lda #0
+    plp
+    rtl
+
++:  tax
+    php                             ; The handler writes the pair as each
+    sei                             ; callback returns: read it in one go
+    lda.l irq_end_h,x
+    tay
+    lda.l irq_end_v,x
+    plp
+    phy                             ; 1-2,s = end dot
+    sec                             ; Lines
+    sbc.l irq_line,x
+    bcs @lines
+    sta.l irq_tmp                   ; Ended in the next frame
+    sep #$20
+    .ACCU 8
+    lda.l REG_STAT78
+    rep #$20
+    .ACCU 16
+    and #$0010                      ; PAL
+    beq +
+    lda #312-262
++:  clc
+    adc #262
+    adc.l irq_tmp
+
+@lines:
+    cmp #193
+    bcc @mul
+    bne @saturate                   ; 194 lines and up never fit 16 bits
+    lda #193*340-65536              ; 193 lines wrap past $FFFF once:
+    clc                             ; only a borrow from H brings them back
+    adc 1,s
+    sec
+    sbc.l irq_hpos,x
+    bcc @done
+    bra @saturate
+
+@mul:
+    asl a                           ; * 340 = 4 + 16 + 64 + 256
+    asl a
+    sta.l irq_tmp
+    asl a
+    asl a
+    tay
+    clc
+    adc.l irq_tmp
+    sta.l irq_tmp
+    tya
+    asl a
+    asl a
+    tay
+    clc
+    adc.l irq_tmp
+    sta.l irq_tmp
+    tya
+    asl a
+    asl a
+    clc
+    adc.l irq_tmp
+    clc                             ; + dots
+    adc 1,s
+    bcc +
+    sbc.l irq_hpos,x                ; Carried: C = 1, plain subtract
+    bcc @done                       ; Back under $10000
+@saturate:
+    lda #$FFFF
+    bra @done
++:  sec
+    sbc.l irq_hpos,x
+
+@done:
+    ply                             ; Drop the end dot
+    plp
+    rtl
+
+.ENDS
@@ -0,0 +1,269 @@
+;==============================================================================
+; OpenSNES LZ4-style Decompression
+;==============================================================================
+;
+; Decoder for the byte-aligned block format written by `gfx4snes -Z`
+; (tools/gfx4snes/src/lz4.c has the full format description):
+;
+;   tag $40, 3-byte little-endian uncompressed size (up to 64 KB)
+;   token: high nibble literal count, low nibble match length - 4
+;          (15 = extension bytes follow, 255 means add and continue)
+;   literals, then a 2-byte backward distance (omitted after the last run)
+;
+; Unlike LzssDecodeVram there are no flag bits and no PPU reads: the output
+; goes to WRAM and both literal runs and matches are copied with MVN
+; (7 cycles per byte). The MVN bank operands are patched into two tiny
+; stubs in WRAM, since the source and destination banks are only known at
+; run time. MVN copies forward one byte at a time, so overlapping matches
+; (distance < length) repeat their pattern like a byte loop would.
+;
+; devtools/cyclecount/codec_bench.py measures cycles per byte against the
+; LZ77 decoder.
+;
+; Author: OpenSNES Team
+; License: MIT
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+.EQU LZ4_TAG            $40
+.EQU LZ4_MIN_MATCH      4
+
+.EQU OP_MVN             $54
+.EQU OP_RTL             $6B
+
+;------------------------------------------------------------------------------
+; MVN stubs (bank $7E, executed through JSL)
+;------------------------------------------------------------------------------
+.RAMSECTION ".lz4_state" BANK $7E SLOT 2
+
+lz4_mvn_lit     DSB 4   ; mvn dest,source : rtl — literal runs
+lz4_mvn_match   DSB 4   ; mvn dest,dest   : rtl — back-references
+
+.ENDS
+
+.SECTION ".lz4_text" SUPERFREE
+
+;------------------------------------------------------------------------------
+; u16 lz4Decode(const u8 *source, u8 *dest)
+;
+; Stack layout (after PHP + PHB):
+;   6-7,s   = dest LOW
+;   8,s     = dest bank byte
+;   9,s     = pad
+;   10-11,s = source LOW
+;   12,s    = source bank byte
+;   13,s    = pad
+;
+; Returns the uncompressed size, or 0 if the tag byte is not $40.
+;------------------------------------------------------------------------------
+lz4Decode:
+    php
+    phb
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda 8,s                         ; dest bank byte
+    sta.b tcc__r1h
+    lda 12,s                        ; source bank byte
+    sta.b tcc__r0h
+    lda 10,s                        ; source LOW
+    tax
+    lda 6,s                         ; dest LOW
+    tay
+    jsr _lz4_decode
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 lz4DecodeVram(const u8 *source, u8 *staging, u16 vramAddr)
+;
+; lz4Decode into the staging buffer, then one DMA (channel 0) of the whole
+; result to VRAM. Forced blank / VBlank only, like dmaCopyVram.
+;
+; Stack layout (after PHP + PHB):
+;   6-7,s   = vramAddr
+;   8-9,s   = staging LOW
+;   10,s    = staging bank byte
+;   11,s    = pad
+;   12-13,s = source LOW
+;   14,s    = source bank byte
+;   15,s    = pad
+;------------------------------------------------------------------------------
+lz4DecodeVram:
+    php
+    phb
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda 10,s                        ; staging bank byte
+    sta.b tcc__r1h
+    lda 14,s                        ; source bank byte
+    sta.b tcc__r0h
+    lda 12,s                        ; source LOW
+    tax
+    lda 8,s                         ; staging LOW
+    tay
+    jsr _lz4_decode
+    cmp #0
+    beq _lz4v_exit                  ; Bad tag: VRAM untouched
+
+    sta.l $4305                     ; DMA size
+    lda 6,s                         ; vramAddr
+    sta.l $2116                     ; VMADDL/H
+    lda 8,s                         ; staging LOW
+    sta.l $4302                     ; DMA source address
+    lda #$1801                      ; Mode 1, B-bus $2118 (VMDATAL/H)
+    sta.l $4300
+    sep #$20
+    .ACCU 8
+    lda 10,s                        ; staging bank byte
+    sta.l $4304                     ; DMA source bank
+    lda #$80
+    sta.l $2115                     ; VMAIN: increment after high byte
+    lda #$01
+    sta.l $420B                     ; Start DMA channel 0
+    rep #$20
+    .ACCU 16
+    lda.b tcc__r2                   ; Uncompressed size
+_lz4v_exit:
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; _lz4_decode — shared decoder body
+;
+; IN:  A/X/Y 16-bit, X = source LOW, Y = dest LOW,
+;      tcc__r0h = source bank, tcc__r1h = dest bank (low bytes)
+; OUT: A = uncompressed size (0 = bad tag), DB = source bank
+;
+; DP usage (main thread, D = 0):
+;   tcc__r1 = dest LOW         tcc__r2 = size      tcc__r3 = dest end
+;   tcc__r4 = token, then the saved stream position during a match
+;   tcc__r5 = match distance   tcc__r9/r10 = length extension scratch
+;------------------------------------------------------------------------------
+_lz4_decode:
+    .ACCU 16
+    .INDEX 16
+    sty.b tcc__r1
+    sep #$20
+    .ACCU 8
+    lda #OP_MVN
+    sta.l lz4_mvn_lit
+    sta.l lz4_mvn_match
+    lda #OP_RTL
+    sta.l lz4_mvn_lit+3
+    sta.l lz4_mvn_match+3
+    lda.b tcc__r1h                  ; MVN operands: destination bank first
+    sta.l lz4_mvn_lit+1
+    sta.l lz4_mvn_match+1
+    sta.l lz4_mvn_match+2
+    lda.b tcc__r0h
+    sta.l lz4_mvn_lit+2
+    pha
+    plb                             ; DB = source bank: the stream is read with abs,x
+
+    lda.w $0000,x                   ; Tag byte
+    cmp #LZ4_TAG
+    beq +
+    rep #$20
+    .ACCU 16
+    lda #0
+    rts
++
+    .ACCU 8
+    rep #$20
+    .ACCU 16
+    lda.w $0001,x                   ; Uncompressed size (low 16 of 24 bits)
+    sta.b tcc__r2
+    clc
+    adc.b tcc__r1
+    sta.b tcc__r3                   ; End of output (buffer must not wrap its bank)
+    inx
+    inx
+    inx
+    inx
+
+_lz4_token:
+    cpy.b tcc__r3
+    bcs _lz4_done
+    lda.w $0000,x                   ; Token
+    inx
+    and #$00FF
+    sta.b tcc__r4
+    lsr a
+    lsr a
+    lsr a
+    lsr a                           ; Literal count
+    beq _lz4_match
+    cmp #15
+    bne +
+    jsr _lz4_length
++   dec a                           ; MVN moves A+1 bytes
+    phb
+    jsl lz4_mvn_lit                 ; X and Y end up past the run
+    plb
+    cpy.b tcc__r3
+    bcs _lz4_done                   ; Last sequence has no match
+
+_lz4_match:
+    lda.w $0000,x                   ; Backward distance
+    inx
+    inx
+    sta.b tcc__r5
+    lda.b tcc__r4
+    and #$000F
+    cmp #15
+    bne +
+    jsr _lz4_length
++   clc
+    adc #LZ4_MIN_MATCH-1            ; MVN count = length - 1
+    stx.b tcc__r4                   ; Park the stream position
+    pha
+    tya
+    sec
+    sbc.b tcc__r5
+    tax                             ; X = match source in the output
+    pla
+    phb
+    jsl lz4_mvn_match
+    plb
+    ldx.b tcc__r4
+    bra _lz4_token
+
+_lz4_done:
+    lda.b tcc__r2
+    rts
+
+;------------------------------------------------------------------------------
+; _lz4_length — A = 15 + the extension bytes at X (255 = add and continue)
+;------------------------------------------------------------------------------
+_lz4_length:
+    .ACCU 16
+    .INDEX 16
+    sta.b tcc__r9
+-   lda.w $0000,x
+    inx
+    and #$00FF
+    sta.b tcc__r10
+    clc
+    adc.b tcc__r9
+    sta.b tcc__r9
+    lda.b tcc__r10
+    cmp #$00FF
+    beq -
+    lda.b tcc__r9
+    rts
+
+.ENDS
@@ -54,6 +54,28 @@ lzss_m6     DW      ; bit counter
 
 .ENDS
 
+;---------------------------------------------------------------------------------
+; Incremental (WRAM staging) decoder state (bank $7E)
+;
+; One stream at a time. Everything needed to resume between two
+; lzssStreamStep calls lives here; the DP scratch registers are reloaded
+; on every call.
+;---------------------------------------------------------------------------------
+.RAMSECTION ".lzss_stream_state" BANK $7E SLOT 2
+
+lzss_src        DSB 4   ; 24-bit read position in the compressed stream
+lzss_dst        DSB 4   ; 24-bit staging buffer base (WRAM)
+lzss_out        DW      ; bytes decoded so far (offset into staging buffer)
+lzss_left       DW      ; bytes still to decode
+lzss_flags      DW      ; current flag byte (low byte, shifted left per token)
+lzss_bits       DW      ; flag bits left in lzss_flags
+lzss_copy_len   DW      ; bytes left in an interrupted back-reference
+lzss_copy_dist  DW      ; its distance + 1
+lzss_vram       DW      ; VRAM word address of staging offset 0 ($FFFF = none)
+lzss_queued     DW      ; staging bytes already handed to dmaQueueVram
+
+.ENDS
+
 ;---------------------------------------------------------------------------------
 ; LZ77 decompression code (SUPERFREE — placed in any ROM bank)
 ;---------------------------------------------------------------------------------
@@ -296,3 +318,345 @@ LzssDecodeVram:
     rtl
 
 .ENDS
+
+;---------------------------------------------------------------------------------
+; Incremental LZ77 decoder (WRAM staging buffer)
+;
+; Same stream format as LzssDecodeVram, but the output goes to a WRAM
+; staging buffer and back-references are read from there, so no PPU access
+; happens on the decode side and it can run with the display on. Work is
+; split into bounded steps (lzssStreamStep(maxBytes)); after each step the
+; newly decoded bytes are handed to the VBlank DMA queue (dmaQueueVram),
+; which uploads them within the per-frame DMA budget.
+;
+; DP usage (main thread, D = 0):
+;   tcc__r0/r0h = read pointer (24-bit)
+;   tcc__r1/r1h = staging buffer base (24-bit)
+;   tcc__r2/r2h = staging base - back-reference distance (24-bit)
+;---------------------------------------------------------------------------------
+.SECTION ".lzss_stream_text" SUPERFREE
+
+;---------------------------------------------------------------------------------
+; u16 lzssStreamBegin(const u8 *source, u8 *staging, u16 vramAddr)
+;
+; Stack layout (after PHP), cc65816 left-to-right push:
+;   5-6,s   = vramAddr
+;   7-8,s   = staging LOW
+;   9,s     = staging bank byte
+;   10,s    = pad
+;   11-12,s = source LOW
+;   13,s    = source bank byte
+;   14,s    = pad
+;
+; Returns the uncompressed size, or 0 if the tag byte is not 0x1x.
+;---------------------------------------------------------------------------------
+lzssStreamBegin:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda 5,s                         ; vramAddr
+    sta.l lzss_vram
+    lda 7,s                         ; staging LOW
+    sta.l lzss_dst
+    lda 9,s                         ; staging bank byte
+    and #$00FF
+    sta.l lzss_dst+2
+    lda 11,s                        ; source LOW
+    sta tcc__r0
+    lda 13,s                        ; source bank byte
+    and #$00FF
+    sta tcc__r0h
+
+    lda #0
+    sta.l lzss_out
+    sta.l lzss_queued
+    sta.l lzss_left
+    sta.l lzss_bits
+    sta.l lzss_copy_len
+
+    sep #$20
+    .ACCU 8
+    lda [tcc__r0]                   ; Compression tag byte
+    and #$F0
+    cmp #$10                        ; 0x1x = LZ77 format
+    beq +
+    rep #$20
+    .ACCU 16
+    plp
+    lda #0                          ; Unknown format: nothing to stream
+    rtl
++
+    .ACCU 8
+    rep #$20
+    .ACCU 16
+    ldy #1
+    lda [tcc__r0],y                 ; Uncompressed length (low 16 of 24 bits)
+    sta.l lzss_left
+    lda tcc__r0
+    clc
+    adc #4                          ; Skip tag + 3-byte length
+    sta.l lzss_src
+    lda tcc__r0h
+    adc #0                          ; Carry into the bank byte
+    sta.l lzss_src+2
+
+    lda.l lzss_left
+    plp
+    rtl
+
+;---------------------------------------------------------------------------------
+; u16 lzssStreamStep(u16 maxBytes)
+;
+; Decodes at most maxBytes more bytes into the staging buffer, then queues
+; every complete (even-sized) run not yet queued for VRAM. If the DMA queue
+; is full, the run stays pending and is retried on the next call.
+;
+; Stack layout (after PHP):
+;   5-6,s = maxBytes
+;
+; Returns the work left: bytes still to decode plus bytes decoded but not
+; yet queued. 0 = the asset is entirely in the staging buffer and queued.
+;---------------------------------------------------------------------------------
+lzssStreamStep:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+
+    jsr _lzs_queue                  ; Retry what the last call left pending
+
+    ; X = min(maxBytes, left) = bytes to produce in this call
+    lda 5,s                         ; maxBytes
+    cmp.l lzss_left
+    bcc +
+    lda.l lzss_left
++   tax
+    bne +
+    jmp _lzs_result                 ; Nothing to decode
++
+    ; Load the resumable state into DP
+    lda.l lzss_src
+    sta tcc__r0
+    lda.l lzss_src+2
+    sta tcc__r0h
+    lda.l lzss_dst
+    sta tcc__r1
+    lda.l lzss_dst+2
+    sta tcc__r1h
+    lda.l lzss_out
+    tay                             ; Y = write offset
+
+    lda.l lzss_copy_len
+    beq _lzs_token
+    lda.l lzss_copy_dist
+    jsr _lzs_set_ref                ; Resume the interrupted back-reference
+    sep #$20
+    .ACCU 8
+    bra _lzs_copy
+
+_lzs_token:
+    .ACCU 16
+    sep #$20
+    .ACCU 8
+    cpx #0
+    beq _lzs_pause                  ; Step budget spent
+    lda.l lzss_bits
+    bne +
+    lda [tcc__r0]                   ; Next flag byte
+    sta.l lzss_flags
+    lda #8
+    sta.l lzss_bits
+    jsr _lzs_src_inc
++
+    lda.l lzss_bits
+    dec a
+    sta.l lzss_bits
+    lda.l lzss_flags
+    asl a                           ; 1 = back-reference, 0 = literal
+    sta.l lzss_flags
+    bcs _lzs_ref
+
+    ; Literal
+    lda [tcc__r0]
+    sta [tcc__r1],y
+    iny
+    dex
+    jsr _lzs_src_inc
+    bra _lzs_token
+
+_lzs_ref:
+    .ACCU 8
+    ; Two bytes: LLLL DDDD, DDDD DDDD (length-3, distance-1)
+    lda [tcc__r0]
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc #3
+    sta.l lzss_copy_len
+    lda #0
+    sta.l lzss_copy_len+1
+    lda [tcc__r0]
+    and #$0F
+    xba
+    jsr _lzs_src_inc
+    lda [tcc__r0]                   ; A = distance - 1 (16-bit via xba)
+    jsr _lzs_src_inc
+    rep #$20
+    .ACCU 16
+    inc a                           ; distance
+    sta.l lzss_copy_dist
+    jsr _lzs_set_ref
+    sep #$20
+    .ACCU 8
+
+_lzs_copy:
+    .ACCU 8
+    ; Byte-by-byte so overlapping references (distance < length) repeat
+    ; correctly.
+    cpx #0
+    beq _lzs_pause
+    lda [tcc__r2],y                 ; staging[Y - distance]
+    sta [tcc__r1],y
+    iny
+    dex
+    rep #$20
+    .ACCU 16
+    lda.l lzss_copy_len
+    dec a
+    sta.l lzss_copy_len
+    sep #$20
+    .ACCU 8
+    bne _lzs_copy
+    bra _lzs_token
+
+_lzs_pause:
+    .ACCU 8
+    rep #$20
+    .ACCU 16
+    ; left -= bytes produced (Y - old out); save the read position
+    tya
+    sec
+    sbc.l lzss_out
+    eor #$FFFF
+    sec
+    adc.l lzss_left
+    sta.l lzss_left
+    tya
+    sta.l lzss_out
+    lda tcc__r0
+    sta.l lzss_src
+    lda tcc__r0h
+    sta.l lzss_src+2
+    lda.l lzss_left
+    bne +
+    sta.l lzss_copy_len             ; Stream done: drop a clamped reference
++
+    jsr _lzs_queue
+
+_lzs_result:
+    .ACCU 16
+    lda.l lzss_out
+    sec
+    sbc.l lzss_queued
+    clc
+    adc.l lzss_left
+    plp
+    rtl
+
+;---------------------------------------------------------------------------------
+; _lzs_src_inc - advance the 24-bit read pointer by one (any A width)
+;---------------------------------------------------------------------------------
+_lzs_src_inc:
+    php
+    rep #$20
+    .ACCU 16
+    inc tcc__r0
+    bne +
+    inc tcc__r0h                    ; Crossed into the next bank
++   plp
+    rts
+
+;---------------------------------------------------------------------------------
+; _lzs_set_ref - tcc__r2 = staging base - A (24-bit, borrow into bank)
+;   IN: A (16-bit) = back-reference distance
+;---------------------------------------------------------------------------------
+_lzs_set_ref:
+    .ACCU 16
+    eor #$FFFF
+    sec
+    adc tcc__r1                     ; base - distance
+    sta tcc__r2
+    lda tcc__r1h
+    sbc #0
+    sta tcc__r2h
+    rts
+
+;---------------------------------------------------------------------------------
+; _lzs_queue - hand decoded-but-unqueued staging bytes to dmaQueueVram
+;   IN/OUT: A/X/Y 16-bit; X and Y are preserved
+;
+; Only even-sized runs are queued while the stream is still running, so
+; every run starts on a VRAM word boundary.
+;---------------------------------------------------------------------------------
+_lzs_queue:
+    .ACCU 16
+    .INDEX 16
+    lda.l lzss_vram
+    cmp #$FFFF                      ; LZSS_NO_VRAM: staging buffer only
+    bne +
+    lda.l lzss_out
+    sta.l lzss_queued
+    rts
++
+    ; tcc__r3 = run size. dmaQueueVram does not touch DP, so it survives
+    ; the call below.
+    lda.l lzss_out
+    sec
+    sbc.l lzss_queued               ; Bytes not yet queued
+    sta tcc__r3
+    lda.l lzss_left
+    beq +                           ; Stream finished: odd tail goes too
+    lda tcc__r3
+    and #$FFFE                      ; Mid-stream: whole words only
+    sta tcc__r3
++
+    lda tcc__r3
+    beq _lzs_queue_done
+
+    phx
+    phy
+    ; dmaQueueVram(staging + queued, vram + queued / 2, size)
+    lda.l lzss_dst+2
+    pha                             ; src bank (+ pad)
+    lda.l lzss_dst
+    clc
+    adc.l lzss_queued
+    pha                             ; src low
+    lda.l lzss_queued
+    lsr a
+    clc
+    adc.l lzss_vram
+    pha                             ; VRAM word address
+    lda tcc__r3
+    pha                             ; size
+    jsl dmaQueueVram
+    plx                             ; Pop 4 args (8 bytes)
+    plx
+    plx
+    plx
+    ply
+    plx
+    and #$00FF
+    beq _lzs_queue_done             ; Queue full: retry on the next step
+    lda.l lzss_queued
+    clc
+    adc tcc__r3
+    sta.l lzss_queued
+
+_lzs_queue_done:
+    rts
+
+.ENDS
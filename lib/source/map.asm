@@ -5,6 +5,34 @@
 ; Scrolling tilemap engine for Mode 1 backgrounds using metatiles.
 ; Provides hardware-efficient incremental VRAM updates during VBlank.
 ;
+; Up to MAP_LAYERS layers scroll independently (foreground + parallax
+; backgrounds). Each layer has its own context in bank $00; the engine
+; points the direct page at it, so the per-layer state is plain DP
+; operands. This file holds layer 0; the contexts and buffers of layers 1
+; and 2 live in map_layers.asm, which links them into the ML_NEXT list.
+; Map entries and metatile definitions are read through the context's
+; 24-bit pointers, so a layer's data may live in any bank.
+;
+; A map entry covers one 8x8 tile, or a 16x16 / 32x32 block of tiles when
+; bits 14-15 of the map header's height word say so. Big metatiles store
+; their 4 or 16 tilemap entries row by row, flips included. Columns and
+; rows are built by walking the definitions, so a column costs one map
+; read per 2 or 4 tiles.
+;
+; A chunked map (MAP_HDR_CHUNK) keeps its 8x8 entries in compressed 16x16
+; chunks. This file sets up the runs of tiles a column, row or page needs;
+; the opt-in map_chunk module copies them from its cache of decompressed
+; chunks, reached through the mapchrun / mapchlocate / mapchreset hooks
+; that mapChunkInit sets. Without it a chunked map is not recognised.
+;
+; The SC_64x32 tilemap holds the map columns [ML_VALL, ML_VALR): the view
+; and a margin of up to 31 columns, prefetched on the side the layer last
+; scrolled to with the budget mapVblank has left. Rows span the whole
+; range. A move past MAP_UPD_STEPS new columns, or a jump, builds the
+; missing columns into tilemap columns the screen does not show and sends
+; them over several VBlanks (MAP_UPD_CATCH); the scroll registers switch
+; with the last of them.
+;
 ; Based on: PVSnesLib map engine by Alekmaul
 ; Original: undisbeliever's castle_platformer
 ; License: zlib (compatible with MIT)
@@ -21,6 +49,8 @@
 .endif
 .endif
 
+.include "map_ctx.inc"
+
 ;------------------------------------------------------------------------------
 ; Constants
 ;------------------------------------------------------------------------------
@@ -32,24 +62,31 @@
 .EQU REG_BG2HOFS        $210F
 .EQU REG_BG2VOFS        $2110
 
-.DEFINE MAP_MAXROWS     256*2               ; Maximum number of rows in a map
 .DEFINE MAP_MAXMTILES   512                 ; Number of metatiles per map
 
 .DEFINE MAP_SCRLR_SCRL  128                 ; Screen position to begin scroll left & right
 .DEFINE MAP_SCRUP_SCRL  80                  ; Screen position to begin scroll up & down
 
-.DEFINE MAP_MTSIZE      8                   ; Size of metatiles (8pix)
 .DEFINE MAP_DISPW       32                  ; 256/8
 .DEFINE MAP_DISPH       28                  ; 224/8 -> default SNES screen for scrolling
+.DEFINE MAP_TMAPW       64                  ; Columns of the SC_64x32 tilemap
 
 .DEFINE MAP_UPD_HORIZ   $01
 .DEFINE MAP_UPD_POSIT   $02
+.DEFINE MAP_UPD_CATCH   $40
 .DEFINE MAP_UPD_VERT    $80
-.DEFINE MAP_UPD_WHOLE   $FF
 
 .DEFINE MAP_OPT_1WAY    $01
 .DEFINE MAP_OPT_BG2     $02
 
+.DEFINE MAP_HDR_MT      $C000               ; Height word: metatile size (0=8, 1=16, 2=32)
+.DEFINE MAP_HDR_CHUNK   $2000               ; Height word: chunked map
+
+.DEFINE MAP_RATE_1X     $0100               ; 8.8 scroll rate: follow the camera
+.DEFINE MAP_VB_BUDGET   1024                ; Default map bytes per VBlank
+.DEFINE MAP_CATCH_SLOT  MAP_UPD_STEPS * 2   ; First catch-up slot past the page's row buffers
+.DEFINE MAP_CATCH_MAX   MAP_DISPW - MAP_CATCH_SLOT + MAP_UPD_STEPS ; Columns of a partial catch-up
+
 ;------------------------------------------------------------------------------
 ; Metatile structure
 ;------------------------------------------------------------------------------
@@ -64,16 +101,26 @@ topleft                 DSW MAP_MAXMTILES*4 ; a metatile is 4 8x8 pixels max
 
 .RAMSECTION ".map_bank00" BANK 0 SLOT 1
 
-dispxofs_L1             DW                  ; X scroll offset of layer 1
-dispyofs_L1             DW                  ; Y scroll offset of layer 1
-
-bgvvramloc_L1           DW                  ; VRAM word address to store vertical buffer
-bgleftvramlocl_L1       DW                  ; VRAM word address for horizontal buffer (left tilemap)
-bgrightvramlocr_L1      DW                  ; VRAM word address for horizontal buffer (right tilemap)
-
 x_pos                   DW                  ; x Position of the screen (C-accessible)
 y_pos                   DW                  ; y Position of the screen (C-accessible)
 
+maplayers               DSB ML_SIZE         ; Layer 0 context, see ML_*
+mapratex                DSW MAP_LAYERS      ; 8.8 scroll rate of each layer against x_pos
+mapratey                DSW MAP_LAYERS      ; and against y_pos
+
+mapvbbudget             DW                  ; Map bytes per VBlank (mapSetVBlankBudget)
+mapvbleft               DW                  ; Bytes left in the current mapVblank
+mapvbsent               DW                  ; Bytes sent by the current mapVblank
+mapvbfirst              DW                  ; Context served first by the next mapVblank
+mapvbwait               DW                  ; First context deferred by this mapVblank
+mapvbdeferred           DW                  ; Layer uploads postponed by the budget
+
+; map_chunk entry points (24-bit + pad), set by mapChunkInit; 0 = not set
+mapchreset              DSB 4               ; Empties the chunk cache
+mapchrun                DSB 4               ; Copies a run of tiles (_mapChRun)
+mapchlocate             DSB 4               ; Finds a tile for lookups (mapChunkLocate)
+mapsolidreset           DSB 4               ; map_solid: drops the bitmap (set by mapSolidBuild)
+
 .ENDS
 
 ;------------------------------------------------------------------------------
@@ -86,39 +133,18 @@ metatiles INSTANCEOF metatiles_t            ; entry for each metatile definition
 
 metatilesprop           DSW MAP_MAXMTILES*2 ; tiles properties (block, spike, fire)
 
-mapwidth                DW                  ; Width of the map in pixels
-mapheight               DW                  ; Height of the map in pixels
-
-maxx_pos                DW                  ; Maximum value of x_pos
-maxy_pos                DW                  ; Maximum value of y_pos
-
+; Layer 0 copies for collision queries (mapGetMetaTile*, object engine)
 maptile_L1b             DB                  ; map layer 1 tiles bank address
 maptile_L1d             DW                  ; map layer 1 tiles data address
 
-mapadrrowlut            DSW MAP_MAXROWS     ; address of each row for fast computation
-maprowsize              DW                  ; size of 1 row regarding map
-
-bg_L1                   DSW 32*32           ; Buffer for display layer 1
-bgvertleftbuf_L1        DSW 32              ; Vertical tile update buffer
-
-mapvisibletopleftidx    DW                  ; Tile index for top left of visible display
-mapvisibletopleftxpos   DW                  ; Pixel X of mapvisibletopleftidx
-mapvisibletopleftypos   DW                  ; Pixel Y of mapvisibletopleftidx
+mapadrrowlut            DSW MAP_MAXROWS     ; address of each row of map entries
+maprowsize              DW                  ; size of 1 row of map entries
 
-mapdisplaydeltax        DW                  ; Pixel X for tile 0,0 of SNES tilemap
-mapdisplaydeltay        DW                  ; Pixel Y for tile 0,0 of SNES tilemap
-
-mapcolidx               DW                  ; Topmost tile updated in vertical buffer
-maprowidx               DW                  ; Leftmost tile updated in horizontal buffer
-mapcolmetatileofs       DW                  ; Tile offset for vertical update
-maprowmetatileofs       DW                  ; VRAM offset for horizontal update
-
-mapendloop              DW                  ; Ending position of draw loop
-
-mapupdbuf               DB                  ; State of buffer update
-mapdirty                DB                  ; 1 if map needs full redraw
-
-maptmpvalue             DW                  ; Temporary value (tile flipping, etc.)
+; Layer 0 buffers, selected by ML_BUF / ML_VBUF (map_layers has those of
+; layers 1 and 2). The first MAP_UPD_STEPS*64 words of a page double as
+; the layer's horizontal (row) buffers, one per queued row.
+mapbgbuf                DSW 32*32           ; Display buffer
+mapvertbuf              DSW 32*MAP_UPD_STEPS ; Vertical tile update buffers
 
 mapoptions              DB                  ; Map options (1-way scroll, BG2 mode)
 
@@ -159,9 +185,9 @@ mapUpdateCamera:
     lda 8,s
     sec
     sbc    #(256-MAP_SCRLR_SCRL)
-    cmp.l maxx_pos
+    cmp.l maplayers+ML_MAXX
     bcc _muc1
-    lda.l maxx_pos
+    lda.l maplayers+ML_MAXX
 _muc1:
     sta.l x_pos
     brl _muc4
@@ -196,9 +222,9 @@ _muc4:
     lda 6,s
     sec
     sbc    #(224-MAP_SCRUP_SCRL)
-    cmp.l maxy_pos
+    cmp.l maplayers+ML_MAXY
     bcc _muc5
-    lda.l maxy_pos
+    lda.l maplayers+ML_MAXY
 _muc5:
     sta.l y_pos
     brl _mucend
@@ -223,877 +249,2737 @@ _mucend:
 ;------------------------------------------------------------------------------
 ; void mapLoad(u8 *layer1map, u8 *layertiles, u8 *tilesprop)
 ;
-; A6+A7 chantier — post-A6: cproc passes 4-byte pointers (24-bit addr + pad).
-; Stack layout (after php/phb/phx/phy = 6 saves + 3-byte JSL return):
-;   SP+10..11 = tilesprop  low 16
-;   SP+12     = tilesprop  bank byte
-;   SP+13     = pad
-;   SP+14..15 = layertiles low 16
-;   SP+16     = layertiles bank byte
-;   SP+17     = pad
-;   SP+18..19 = layer1map  low 16
-;   SP+20     = layer1map  bank byte
-;   SP+21     = pad
+; Loads layer 0 (BG1 at MAP_BG1_ADR) and turns the other layers off.
+; cproc passes 4-byte pointers (24-bit addr + pad).
+; Stack layout (after php/phb/phd/phx/phy = 8 saves + 3-byte JSL return):
+;   SP+12..13 = tilesprop  low 16
+;   SP+14     = tilesprop  bank byte
+;   SP+16..17 = layertiles low 16
+;   SP+18     = layertiles bank byte
+;   SP+20..21 = layer1map  low 16
+;   SP+22     = layer1map  bank byte
 ;------------------------------------------------------------------------------
 mapLoad:
     php
     phb
-
+    phd
     phx
     phy
 
-    ; Set DB to layer1map's bank so subsequent `lda 0,x` (X = layer1map low
-    ; 16) reads from the correct bank. Also store the bank byte into
-    ; maptile_L1b for later use.
     sep #$20
     .ACCU 8
-    lda 20,s                                ; layer1map bank byte
+    lda #$7e
     pha
     plb
-    sta.l maptile_L1b
 
-    rep #$20
+    ; Metatile definitions and properties to their WRAM tables
+    rep #$30
     .ACCU 16
-    lda 18,s                                ; layer1map low 16 (param 1)
-    tax
-    lda 0,x                                 ; get mapwidth (DB:X)
-    sta.l mapwidth
-    lda 2,x                                 ; get mapheight
-    sta.l mapheight
-
-    lda #0
-    sta.l x_pos
-    sta.l y_pos
-
-    lda 18,s                                ; layer1map low 16 again
-    clc
-    adc.w #0006                             ; add width, height and size
-    sta.l maptile_L1d
+    .INDEX 16
+    lda #$8000                              ; CPU -> $2180, fixed B address
+    sta.l $4300
 
-    lda 14,s                                ; layertiles low 16 (param 2)
+    lda 16,s                                ; layertiles low 16 (param 2)
     sta.l $4302
-
     lda #MAP_MAXMTILES*4*2                  ; metatile max are 4 x 8x8
     sta.l $4305
-
     lda #metatiles.w
     sta.l $2181
 
     sep #$20
     .ACCU 8
-    lda #$7e
+    lda #:metatiles
     sta.l $2183
-
-    lda #$0
-    pha
-    plb
-
-    lda 16,s                                ; layertiles bank byte
+    lda 18,s                                ; layertiles bank byte
     sta.l $4304
-
-    ldx #$8000                              ; type of DMA
-    stx $4300
-
     lda #$01
-    sta $420B                               ; do dma for transfer
+    sta.l $420B                             ; do dma for transfer
 
-    rep	#$20
+    rep #$20
     .ACCU 16
-    lda	10,s	                            ; tilesprop low 16 (param 3)
-	sta.l	$4302
-
-    lda.w #MAP_MAXMTILES*2*2
+    lda 12,s                                ; tilesprop low 16 (param 3)
+    sta.l $4302
+    lda #MAP_MAXMTILES*2*2
     sta.l $4305
+    lda #metatilesprop.w
+    sta.l $2181
 
-    ldy #metatilesprop.w
-    sty $2181
-
-    sep	#$20
+    sep #$20
     .ACCU 8
-    lda #$7e
+    lda #:metatilesprop
     sta.l $2183
-
-    lda 12,s                                ; tilesprop bank byte
+    lda 14,s                                ; tilesprop bank byte
     sta.l $4304
+    lda #$01
+    sta.l $420B
 
-    ldx	#$8000
-	stx	$4300
+    lda #$0
+    sta mapoptions
 
-    lda #$01
-    sta $420B
+    ; Engine reset: layer 0 only, every layer back to 1:1 scrolling
+    rep #$20
+    .ACCU 16
+    stz.w x_pos
+    stz.w y_pos
+    stz.w mapvbwait
+    lda #maplayers
+    sta.w mapvbfirst
+    lda #MAP_VB_BUDGET
+    sta.w mapvbbudget
+
+    lda.w mapchreset+1                      ; map_chunk: empty the chunk cache
+    beq _mld0
+    phk
+    pea _mld0-1
+    jml [mapchreset]
+_mld0:
+    lda.w mapsolidreset+1                   ; map_solid: drop the old map's bitmap
+    beq _mld01
+    phk
+    pea _mld01-1
+    jml [mapsolidreset]
+_mld01:
+
+    lda #MAP_RATE_1X
+    ldx #(MAP_LAYERS - 1) * 2
+_mld1:
+    sta.w mapratex,x
+    sta.w mapratey,x
+    dex
+    dex
+    bpl _mld1
+    stz.w maplayers+ML_UPD                  ; clears ML_UPD and ML_ON
+    stz.w maplayers+ML_NEXT                 ; Unlinks layers 1 and 2
+
+    ; Layer 0: WRAM metatile copy, first page and column of each buffer
+    lda #maplayers
+    tcd
+    lda 20,s                                ; layer1map low 16 (param 1)
+    sta.b ML_MAP
+    lda 22,s                                ; layer1map bank byte
+    and #$00FF
+    sta.b ML_MAP+2
+    lda #metatiles.w
+    sta.b ML_DEFS
+    lda #:metatiles
+    sta.b ML_DEFS+2
+
+    ldy #2
+    lda [ML_MAP],y                          ; height word
+    and #MAP_HDR_MT
+    beq _mld11
+    lda 16,s                                ; Big metatiles: definitions in place
+    sta.b ML_DEFS                           ; (the WRAM copy holds 512 8x8 ones)
+    lda 18,s
+    and #$00FF
+    sta.b ML_DEFS+2
+
+_mld11:
+    stz.b ML_LAYER
+    lda #mapbgbuf.w
+    sta.b ML_BUF
+    lda #mapvertbuf.w
+    sta.b ML_VBUF
+    lda #MAP_BG1_ADR
+    sta.b ML_BGADR
+    stz.b ML_BGREG
+
+    jsr _mapLayerInit
+
+    ; Layer 0 copies for collision queries
+    lda.b ML_MAP
+    sta.w maptile_L1d
+    sep #$20
+    .ACCU 8
+    lda.b ML_MAP+2
+    sta.w maptile_L1b
+
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_MTROW
+    sta.w maprowsize
 
-    stz.w dispxofs_L1
-    stz.w dispyofs_L1
+    ldy #MAP_MAXROWS
+    lda #0
+    ldx #0
+_mld2:
+    sta.w mapadrrowlut,x
+    clc
+    adc.b ML_MTROW
+    inx
+    inx
+    dey
+    bne _mld2
 
-    lda #$0
-    sta.l mapupdbuf
-    sta.l mapdirty
-    sta.l mapoptions
+    ply
+    plx
+    pld
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; mapLayerInit (internal, JSL)
+; _mapLayerInit for map_layers' mapLoadLayer, which lives in another module.
+;------------------------------------------------------------------------------
+mapLayerInit:
+    .ACCU 16
+    .INDEX 16
+    jsr _mapLayerInit
+    rtl
 
-    rep #$31
+;------------------------------------------------------------------------------
+; _mapLayerInit (internal)
+; D = layer context with ML_MAP (map header), ML_DEFS, ML_BUF, ML_VBUF,
+; ML_BGADR, ML_BGREG and ML_LAYER set. DB = $7E.
+; Builds the layer's display and writes it straight to VRAM (forced blank).
+;------------------------------------------------------------------------------
+_mapLayerInit:
     .ACCU 16
     .INDEX 16
-    lda.l mapwidth
-    adc #MAP_MTSIZE - 1                     ; carry clear from REP
+    ldy #0
+    lda [ML_MAP],y                          ; get mapwidth
+    sta.b ML_WIDTH
+    ldy #2
+    lda [ML_MAP],y                          ; get mapheight
+    tax
+    and #$FFFF - MAP_HDR_MT - MAP_HDR_CHUNK
+    sta.b ML_HEIGHT
+    txa
+    and #MAP_HDR_CHUNK
+    beq _mli03
+    lda.l mapchrun+1                        ; Without mapChunkInit, not chunked
+    beq _mli03
+    lda #MAP_HDR_CHUNK
+_mli03:
+    sta.b ML_CHUNK
+
+    txa                                     ; metatile size code
+    xba
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    and #$0003
+    sta.b ML_MTSH
+    lda #1
+    ldx.b ML_MTSH
+    beq _mli0
+_mli00:
+    asl a
+    dex
+    bne _mli00
+_mli0:
+    sta.b ML_MTN
+
+    lda.b ML_MAP
+    clc
+    adc #0006                               ; add width, height and size
+    sta.b ML_MAP
+
+    lda.b ML_WIDTH
+    clc
+    adc #MAP_MTSIZE - 1
+    lsr
+    lsr
+    and #$FFFE
+    sta.b ML_ROWSIZE                        ; In 8x8 tiles: row of a 8x8 map
+
+    clc
+    adc #MAP_CHUNK_SIZE * 2 - 1
+    lsr
+    lsr
     lsr
     lsr
     and #$FFFE
-    sta.l maprowsize
+    sta.b ML_CHROW                          ; Chunked maps: 1 word per chunk
+
+    lda.b ML_ROWSIZE
+
+    ldx.b ML_MTSH                           ; Round up to whole metatiles
+    beq _mli01
+    lsr a
+_mli02:
+    inc a
+    lsr a
+    dex
+    bne _mli02
+    asl a
+_mli01:
+    sta.b ML_MTROW
 
-    lda.l mapwidth
+    lda.b ML_WIDTH
     sec
     sbc #256
-    sta.l maxx_pos
-
-    lda.l mapheight
-    cmp.w #224
-    bcs _mini1
-    lda #224
+    bcs _mli1
+    lda #0
+_mli1:
+    sta.b ML_MAXX
 
-_mini1:
+    lda.b ML_HEIGHT
     sec
     sbc #224
-    sta.l maxy_pos
-
-    lda #MAP_MAXROWS
-    tay
-    lda    #0
-    ldx    #0
-
-_mini2:
-    sta.l mapadrrowlut,x
-    clc
-    adc.l maprowsize
-    inx
-    inx
-    dey
-    bne _mini2
+    bcs _mli2
+    lda #0
+_mli2:
+    sta.b ML_MAXY
 
-    ply
-    plx
-    plb
+    lda #MAP_DISPH
+    ldy.b ML_ROWSIZE
+    jsr _mapRowOffset
+    sta.b ML_SCRH
 
-    ; mapLoad calls mapRefreshAll, then flushes VRAM directly (screen is off)
-    jsl mapRefreshAll
+    jsr _mapLayerPos
+    jsr _mapRefreshLayer
 
-    ; --- Direct VRAM flush (screen MUST be off during mapLoad) ---
-    ; DMA the entire bg_L1 buffer to VRAM immediately, so callers don't
-    ; need the mapUpdate+WaitForVBlank+mapVblank workaround.
+    ; --- Direct VRAM flush (screen MUST be off) ---
+    ; DMA the layer's page and edge column to VRAM immediately, so callers
+    ; don't need the mapUpdate+WaitForVBlank+mapVblank workaround.
     sep #$20
     .ACCU 8
     lda #$80
-    sta.l $2115                     ; VMAIN: word increment
+    sta.l $2115                             ; VMAIN: word increment
 
     rep #$20
     .ACCU 16
-    ldx #MAP_BG1_ADR
-    stx $2116                      ; VRAM destination
+    lda #$1801
+    sta.l $4300                             ; DMA mode: word write to $2118
+    lda.b ML_BGADR
+    sta.l $2116                             ; VRAM destination
+    lda.b ML_BUF
+    sta.l $4302                             ; Source address
+    lda #32 * 32 * 2                        ; 2048 bytes (left page)
+    sta.l $4305
 
-    ldx #bg_L1.w
-    stx $4302                      ; Source address
     sep #$20
     .ACCU 8
-    lda #:bg_L1
-    sta.l $4304                    ; Source bank ($7E)
+    lda #$7E
+    sta.l $4304                             ; Source bank: every layer buffer is in $7E
+    lda #$01
+    sta.l $420B                             ; Start DMA
 
-    ldx #$1801
-    stx $4300                      ; DMA mode: word write to $2118
+    ; Also flush the vertical buffer (right page edge column)
+    lda #$81                                ; VMAIN: increment by 32 (vertical)
+    sta.l $2115
 
     rep #$20
     .ACCU 16
-    ldy #32 * 32 * 2               ; 2048 bytes (left page)
-    sty $4305
+    lda.b ML_VQ
+    sta.l $2116
+    lda.b ML_VBUF
+    sta.l $4302
+    lda #32 * 2                             ; 64 bytes (one column)
+    sta.l $4305
 
     sep #$20
     .ACCU 8
+    lda #$7E
+    sta.l $4304
     lda #$01
-    sta.l $420B                    ; Start DMA
+    sta.l $420B
 
-    ; Also flush the vertical buffer (right page edge column)
-    lda #$81                        ; VMAIN: increment by 32 (vertical)
-    sta.l $2115
+    ; VRAM is already current
+    stz.b ML_UPD
+    lda #$01
+    sta.b ML_ON
 
     rep #$20
     .ACCU 16
-    ldx.w bgvvramloc_L1
-    stx $2116
+    rts
 
-    ldx #bgvertleftbuf_L1.w
-    stx $4302
+;------------------------------------------------------------------------------
+; _mapRowOffset (internal)
+; A = map row (0-255), Y = bytes per row -> A = row * Y
+;------------------------------------------------------------------------------
+_mapRowOffset:
+    .ACCU 16
+    sty.b ML_TMP2
     sep #$20
     .ACCU 8
-    lda #:bgvertleftbuf_L1
-    sta.l $4304
-
-    ldx #$1801
-    stx $4300
-
+    sta.l $4202                             ; WRMPYA = row
+    lda.b ML_TMP2
+    sta.l $4203                             ; row * row size low byte
+    nop
+    nop
+    nop
     rep #$20
     .ACCU 16
-    ldy #32 * 2                    ; 64 bytes (one column)
-    sty $4305
+    lda.l $4216
+    sta.b ML_TMP
 
     sep #$20
     .ACCU 8
-    lda #$01
-    sta.l $420B
-
-    ; Clear update flag — VRAM is already current
-    lda #$0
-    sta.l mapupdbuf
+    lda.b ML_TMP2 + 1
+    sta.l $4203                             ; row * row size high byte
+    nop
+    nop
+    nop
+    rep #$20
+    .ACCU 16
+    lda.l $4216
+    xba
+    and #$FF00
+    clc
+    adc.b ML_TMP
+    rts
 
-    plp
+;------------------------------------------------------------------------------
+; mapRowOffset (internal, JSL)
+; _mapRowOffset for map_chunk, which lives in another module.
+;------------------------------------------------------------------------------
+mapRowOffset:
+    .ACCU 16
+    jsr _mapRowOffset
     rtl
 
 ;------------------------------------------------------------------------------
-; mapRefreshAll - internal: rebuild entire visible tilemap in bg_L1
+; _mapScale (internal)
+; A = position, Y = 8.8 rate -> A = (position * rate) >> 8, low 16 bits
 ;------------------------------------------------------------------------------
-mapRefreshAll:
-    php
-    phb
+_mapScale:
+    .ACCU 16
+    cpy #MAP_RATE_1X
+    bne _msc1
+    rts                                     ; Follows the camera
+
+_msc1:
+    sta.b ML_TMP
+    sty.b ML_TMP2
 
     sep #$20
     .ACCU 8
-    lda #$7e
-    pha
-    plb
+    lda.b ML_TMP                            ; P0 = pos low * rate low
+    sta.l $4202
+    lda.b ML_TMP2
+    sta.l $4203
+    nop
+    nop
+    nop
+    rep #$20
+    .ACCU 16
+    lda.l $4216
+    xba
+    and #$00FF
+    sta.b ML_CNT                            ; P0 >> 8
 
-_mapRefreshAll1:
-    phx
-    phy
+    sep #$20
+    .ACCU 8
+    lda.b ML_TMP2 + 1                       ; P2 = pos low * rate high
+    sta.l $4203
+    nop
+    nop
+    nop
+    rep #$20
+    .ACCU 16
+    lda.l $4216
+    clc
+    adc.b ML_CNT
+    sta.b ML_CNT
 
-    rep #$30
+    sep #$20
+    .ACCU 8
+    lda.b ML_TMP + 1                        ; P1 = pos high * rate low
+    sta.l $4202
+    lda.b ML_TMP2
+    sta.l $4203
+    nop
+    nop
+    nop
+    rep #$20
+    .ACCU 16
+    lda.l $4216
+    clc
+    adc.b ML_CNT
+    sta.b ML_CNT
+
+    sep #$20
+    .ACCU 8
+    lda.b ML_TMP2 + 1                       ; P3 = pos high * rate high
+    sta.l $4203
+    nop
+    nop
+    nop
+    rep #$20
+    .ACCU 16
+    lda.l $4216
+    xba
+    and #$FF00
+    clc
+    adc.b ML_CNT
+    rts
+
+;------------------------------------------------------------------------------
+; _mapLayerPos (internal)
+; ML_XPOS / ML_YPOS = camera scaled by the layer's rates, clamped to the map
+;------------------------------------------------------------------------------
+_mapLayerPos:
+    .ACCU 16
+    ldx.b ML_LAYER                          ; _mapScale keeps X
+    lda.w x_pos
+    ldy.w mapratex,x
+    jsr _mapScale
+    cmp.b ML_MAXX
+    bcc _mlp1
+    lda.b ML_MAXX
+_mlp1:
+    sta.b ML_XPOS
+
+    lda.w y_pos
+    ldy.w mapratey,x
+    jsr _mapScale
+    cmp.b ML_MAXY
+    bcc _mlp2
+    lda.b ML_MAXY
+_mlp2:
+    sta.b ML_YPOS
+    rts
+
+;------------------------------------------------------------------------------
+; _mapRefreshLayer (internal): rebuild the layer's whole visible tilemap
+; in its page and first column buffer, for _mapLayerInit to write out
+; D = layer context, DB = $7E, A/X/Y 16-bit
+;------------------------------------------------------------------------------
+_mapRefreshLayer:
     .ACCU 16
     .INDEX 16
-    lda.l y_pos
+    lda.b ML_CHUNK
+    beq _mapDAS00
+    jsr _mapRefreshCh
+    bra _mapDAS2
+
+_mapDAS00:
+    lda.b ML_MTSH
+    beq _mapDAS0
+    jsr _mapRefreshMt
+    bra _mapDAS2
+
+_mapDAS0:
+    lda.b ML_YPOS
     lsr
     lsr
-    and #$FFFE
-    tax
+    lsr
+    ldy.b ML_ROWSIZE
+    jsr _mapRowOffset
+    sta.b ML_TMP2
 
-    lda.l x_pos
+    lda.b ML_XPOS
     lsr
     lsr
     and #$FFFE
     clc
-    adc mapadrrowlut,x
-    sta mapvisibletopleftidx
+    adc.b ML_TMP2
+    sta.b ML_TOPIDX
 
+    ; Bottom-right tile first: map row MAP_DISPH, column MAP_DISPW-1
     clc
-    adc.w mapadrrowlut+MAP_DISPH*2
+    adc.b ML_SCRH
     clc
     adc #(MAP_DISPW*2)-2
+    tay
+
+    lda.b ML_BUF
+    clc
+    adc #(MAP_DISPH+1)*1*32*2-2
     tax
 
-    lda #(MAP_DISPH+1)*1*32*2-2
+    lda #MAP_DISPH+1
+    sta.b ML_CNT
+
 _mapDAS:
-    tay
+    txa
     sec
     sbc #64
-    sta mapendloop
+    sta.b ML_END
 
 _mapDAS1:
-    phx
-    lda maptile_L1d
-    clc
-    adc 1,s
-    tax
-
-    phb
-    sep #$20
-    .ACCU 8
-    lda maptile_L1b                         ; DB = layer1map's bank (B1: was #$00,
-    pha                                     ; hardcoded bank $00; now honours the
-    plb                                     ; pointer's bank so the map can live
-    rep #$20                                ; outside bank $00)
-    .ACCU 16
-    lda 0,x
-    plb
-
-    pha
+    lda [ML_MAP],y                          ; vh----mmmmmmmmmm
+    sta.b ML_TMP
     and #$03FF
     asl a
-    tax
-    lda.l metatiles.topleft,x
-    sta.w maptmpvalue
-    pla
+    phy
+    tay
+    lda.b ML_TMP
     and #$C000
-    ora maptmpvalue
-
-    sta.w bg_L1, y
-    plx
+    ora [ML_DEFS],y
+    ply
+    sta.w $0000,x
 
-    dex
-    dex
     dey
     dey
+    dex
+    dex
 
-    cpy mapendloop
+    cpx.b ML_END
     bne _mapDAS1
 
-    txa
-    sec
-    sbc.l maprowsize
+    tya
     clc
     adc #MAP_DISPW*2
-    tax
+    sec
+    sbc.b ML_ROWSIZE
+    tay
 
-    tya
-    bmi _mapDAS2
-    brl _mapDAS
+    dec.b ML_CNT
+    bne _mapDAS
 
 _mapDAS2:
-    lda.l x_pos
+    lda.b ML_XPOS
     and.w #$FFFF - (MAP_MTSIZE - 1)
-    sta.l mapdisplaydeltax
-    sta.l mapvisibletopleftxpos
+    sta.b ML_DELTAX
+    sta.b ML_TOPX
 
-    lda.l y_pos
+    lda.b ML_YPOS
     and.w #$FFFF - (MAP_MTSIZE - 1)
-    sta.l mapdisplaydeltay
-    sta.l mapvisibletopleftypos
+    sta.b ML_DELTAY
+    sta.b ML_TOPY
 
-    lda.l x_pos
+    lda.b ML_XPOS
     and.w #(MAP_MTSIZE - 1)
-    sta.l dispxofs_L1
+    sta.b ML_DISPX
 
-	lda.l y_pos
-	and.w #(MAP_MTSIZE - 1)
-	dec a
-	sta.l dispyofs_L1
+    lda.b ML_YPOS
+    and.w #(MAP_MTSIZE - 1)
+    dec a
+    sta.b ML_DISPY
 
-    stz mapcolidx
-    stz maprowidx
-    stz mapcolmetatileofs
-    stz maprowmetatileofs
+    stz.b ML_COLIDX
+    stz.b ML_ROWIDX
+    stz.b ML_COLOFS
+    stz.b ML_ROWOFS
 
-    lda.l mapvisibletopleftidx
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    sta.b ML_VALL
+    clc
+    adc #MAP_DISPW + 1
+    sta.b ML_VALR                           ; Tilemap holds the display only
+    stz.b ML_PFDIR
+    stz.b ML_CATCH
+
+    stz.b ML_NCOL
+    stz.b ML_NROW
+    stz.b ML_NPRE
+    lda.b ML_BGADR
+    clc
+    adc #32 * 32
+    tay
+    lda.b ML_TOPIDX
     clc
     adc #(MAP_DISPW + 1) * 2
-    jsr _ProcessVerticalBuffer
-    lda #MAP_BG1_ADR + 32 * 32
-    sta.l bgvvramloc_L1
-
-    sep    #$20
-    .ACCU 8
-    lda #MAP_UPD_WHOLE
-    sta.l mapupdbuf
-
-    lda #$0
-    sta.l mapdirty
-
-    ply
-    plx
-
-    plb
-    plp
-    rtl
+    ldx #MAP_DISPW
+    jmp _mapQueueColumn
 
 ;------------------------------------------------------------------------------
 ; _ProcessHorizontalBuffer (internal)
-; A = tile index of the leftmost displayed tile
+; A = tile index of the leftmost displayed tile, X = display row
+; (0 or MAP_DISPH, used with big metatiles). Builds the row over every
+; column the tilemap holds (ML_VALL to ML_VALR), not just the display.
 ;------------------------------------------------------------------------------
 _ProcessHorizontalBuffer:
-    sta.l mapendloop
+    .ACCU 16
+    ldy.b ML_CHUNK
+    beq _phb00
+    jmp _mapChRow
+
+_phb00:
+    ldy.b ML_MTSH
+    beq _phb0
+    jmp _mapMtRow
+
+_phb0:
+    sta.b ML_TMP
+    jsr _mapRowSpan
+    pha
     clc
-    adc.w #(MAP_DISPW + 1) * 2
-    tax
-
-    lda.l maprowidx
+    adc.b ML_TMP
+    sta.b ML_END                            ; Tile index of column ML_VALL
+    lda.b ML_VALR
+    sec
+    sbc.b ML_VALL
+    asl a
+    sta.b ML_TMP
     clc
-    adc.w #(32 + 1) * 2 - 2
-    and.w #$7F
+    adc.b ML_END
     tay
 
-_phb1:
-    dex
-    dex
-    phx
-
-    lda maptile_L1d
+    pla
+    clc
+    adc.b ML_ROWIDX
+    clc
+    adc.b ML_TMP
+    dec a
+    dec a
+    and.w #$7F
     clc
-    adc 1,s
+    adc.b ML_BUF
     tax
-    phb
-    sep #$20
-    .ACCU 8
-    lda maptile_L1b                         ; DB = layer1map's bank (B1: was #$00,
-    pha                                     ; hardcoded bank $00; now honours the
-    plb                                     ; pointer's bank so the map can live
-    rep #$20                                ; outside bank $00)
-    .ACCU 16
-    lda 0,x
-    plb
 
-    pha
+_phb1:
+    dey
+    dey
+
+    lda [ML_MAP],y
+    sta.b ML_TMP
     and #$03FF
     asl a
-    tax
-    lda.l metatiles.topleft,x
-    sta.w maptmpvalue
-    pla
+    phy
+    tay
+    lda.b ML_TMP
     and #$C000
-    ora maptmpvalue
-
-    sta bg_L1, y
+    ora [ML_DEFS],y
+    ply
+    sta.w $0000,x
 
-    plx
+    cpx.b ML_BUF
+    bne _phb2
+    txa
+    clc
+    adc #64 * 2
+    tax
+_phb2:
+    dex
+    dex
 
-    dey
-    dey
-    bpl _phb2
-    ldy #64 * 2 - 2
+    cpy.b ML_END                            ; exact stop: one tile further
+    bne _phb1                               ; can leave the map's bank on row 0
 
-_phb2:
-    cpx.w mapendloop
-    bpl _phb1
+    rts
 
+;------------------------------------------------------------------------------
+; _mapRowSpan (internal)
+; A = 2 * (ML_VALL - ML_TOPX / 8): offset of the first column the tilemap
+; holds from the leftmost displayed one, in buffer bytes (0 or negative)
+;------------------------------------------------------------------------------
+_mapRowSpan:
+    .ACCU 16
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    eor #$FFFF
+    sec
+    adc.b ML_VALL
+    asl a
     rts
 
 ;------------------------------------------------------------------------------
 ; _ProcessVerticalBuffer (internal)
-; A = tile index of the topmost displayed tile
+; A = tile index of the topmost displayed tile, X = display column
+; (0 or MAP_DISPW, used with big metatiles)
 ;------------------------------------------------------------------------------
 _ProcessVerticalBuffer:
+    .ACCU 16
+    ldy.b ML_CHUNK
+    beq _pvb00
+    jmp _mapChColumn
+
+_pvb00:
+    ldy.b ML_MTSH
+    beq _pvb0
+    jmp _mapMtColumn
+
+_pvb0:
     tay
     sec
-    sbc.l maprowsize
-    sta.l mapendloop
+    sbc.b ML_ROWSIZE
+    sta.b ML_END
     tya
 
     clc
-    adc.w mapadrrowlut+MAP_DISPH * 2
+    adc.b ML_SCRH
     dec a
     dec a
-    tax
+    tay
 
-    lda.l mapcolidx
+    lda.b ML_COLIDX
     clc
     adc.w #29*2 - 2
     and.w #$3F
-    tay
+    clc
+    adc.b ML_VBUF
+    tax
 
 _pvb1:
+    lda [ML_MAP],y
+    sta.b ML_TMP
+    and #$03FF
+    asl a
+    phy
+    tay
+    lda.b ML_TMP
+    and #$C000
+    ora [ML_DEFS],y
+    sta.w $0000,x
+
+    pla
+    sec
+    sbc.b ML_ROWSIZE
+    tay
+
+    cpx.b ML_VBUF
+    bne _pvb2
+    txa
+    clc
+    adc #32 * 2
+    tax
+_pvb2:
+    dex
+    dex
+
+    cpy.b ML_END
+    bpl _pvb1
+
+    rts
+
+;------------------------------------------------------------------------------
+; _mapQueueColumn (internal)
+; A / X as for _ProcessVerticalBuffer, Y = VRAM word address of the column.
+; Builds the column in the layer's next vertical buffer and queues it.
+;------------------------------------------------------------------------------
+_mapQueueColumn:
+    .ACCU 16
+    .INDEX 16
+    sta.b ML_TMP
     phx
+    lda.b ML_NCOL
+    asl a
+    tax
+    tya
+    sta.b ML_VQ,x
+    txa
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a                                   ; Buffer offset: column * 32 words
+    pha
+    clc
+    adc.b ML_VBUF
+    sta.b ML_VBUF
+    inc.b ML_NCOL
+
+    lda 3,s
+    tax
+    lda.b ML_TMP
+    jsr _ProcessVerticalBuffer
+
+    lda.b ML_VBUF                           ; Back to the layer's first column
+    sec
+    sbc 1,s
+    sta.b ML_VBUF
+    pla
+    plx
+    rts
 
-    lda maptile_L1d
+;------------------------------------------------------------------------------
+; _mapQueueRow (internal)
+; A / X as for _ProcessHorizontalBuffer, Y = VRAM word address of the row in
+; the left tilemap. Builds the row in the layer's next horizontal buffer and
+; queues it.
+;------------------------------------------------------------------------------
+_mapQueueRow:
+    .ACCU 16
+    .INDEX 16
+    sta.b ML_TMP
+    phx
+    lda.b ML_NROW
+    asl a
+    tax
+    tya
+    sta.b ML_HQ,x
+    txa
+    xba
+    lsr a
+    lsr a                                   ; Buffer offset: row * 64 words
+    pha
     clc
-    adc 1,s
+    adc.b ML_BUF
+    sta.b ML_BUF
+    inc.b ML_NROW
+
+    lda 3,s
     tax
+    lda.b ML_TMP
+    jsr _ProcessHorizontalBuffer
+
+    lda.b ML_BUF                            ; Back to the layer's page
+    sec
+    sbc 1,s
+    sta.b ML_BUF
+    pla
+    plx
+    rts
+
+;------------------------------------------------------------------------------
+; _mapMtColumn (internal)
+; Big metatiles: X = display column (0 or MAP_DISPW). Fills the vertical
+; buffer from the tile at (ML_TOPX / 8 + X, ML_TOPY / 8) downwards.
+;------------------------------------------------------------------------------
+_mapMtColumn:
+    .ACCU 16
+    .INDEX 16
+    stx.b ML_MTX
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc.b ML_MTX
+    sta.b ML_MTX
+    lda.b ML_TOPY
+    lsr a
+    lsr a
+    lsr a
+    sta.b ML_MTY
+
+    jsr _mapMtPrep
+    lda.b ML_TMP2
+    sta.b ML_MTSUB                          ; Next metatiles: same column, top row
+
+    lda.b ML_MTN
+    dec a
+    and.b ML_MTY
+    eor #$FFFF
+    sec
+    adc.b ML_MTN
+    sta.b ML_TMP                            ; Tiles left in the first metatile
+    lda.b ML_MTN
+    asl a
+    sta.b ML_TMP2                           ; One tile down in a definition
+    lda #MAP_DISPH + 1
+    sta.b ML_CNT
+
+    lda #32 * 2                             ; Wrap inside the layer's column
+    sta.b ML_MTWRAP
+    lda.b ML_VBUF
+    clc
+    adc.w #32 * 2
+    sta.b ML_END
+    lda.b ML_COLIDX
+    and.w #$3F
+    clc
+    adc.b ML_VBUF
+    tax
+    jmp _mapMtRun
+
+;------------------------------------------------------------------------------
+; _mapMtRow (internal)
+; Big metatiles: X = display row (0 or MAP_DISPH). Fills the horizontal
+; buffer from the tile at (ML_VALL, ML_TOPY / 8 + X) rightwards.
+;------------------------------------------------------------------------------
+_mapMtRow:
+    .ACCU 16
+    .INDEX 16
+    stx.b ML_MTY
+    lda.b ML_TOPY
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc.b ML_MTY
+    sta.b ML_MTY
+    lda.b ML_VALL
+    sta.b ML_MTX
+
+    lda.b ML_VALR
+    sec
+    sbc.b ML_VALL
+    sta.b ML_CNT
+    lda #64 * 2                             ; Wrap inside the row's two pages
+    sta.b ML_MTWRAP
+    lda.b ML_BUF
+    clc
+    adc #64 * 2
+    sta.b ML_END
+    jsr _mapRowSpan
+    clc
+    adc.b ML_ROWIDX
+    and.w #$7F
+    clc
+    adc.b ML_BUF
+    ; fall through
+
+;------------------------------------------------------------------------------
+; _mapMtRowRun (internal)
+; A = buffer address of the first tile, ML_MTX / ML_MTY = its map tile,
+; ML_CNT tiles, wrapping back by ML_MTWRAP bytes at ML_END.
+;------------------------------------------------------------------------------
+_mapMtRowRun:
+    .ACCU 16
+    .INDEX 16
+    pha
+    jsr _mapMtPrep
+
+    lda.b ML_MTN
+    dec a
+    and.b ML_MTX
+    eor #$FFFF
+    sec
+    adc.b ML_MTN
+    sta.b ML_TMP                            ; Tiles left in the first metatile
+    lda #2
+    sta.b ML_TMP2                           ; One tile right in a definition
+    plx
+    ; fall through
+
+;------------------------------------------------------------------------------
+; _mapMtRun (internal)
+; Copies ML_CNT tiles of big metatiles to X, a bank $7E address in the
+; layer's page or columns. Entered with jmp: the run ends with an
+; rts to the caller of the column / row routine.
+;   ML_MIDX    map index of the first metatile
+;   ML_MTOFS   definition offset of the first tile, ML_TMP tiles left in
+;              the first metatile, ML_TMP2 definition step between tiles
+;              (2 = along a row)
+;   ML_MTSUB   definition offset of the first tile in the next metatiles
+;   ML_END     buffer offset where X wraps back by ML_MTWRAP
+;
+; The first metatile goes through a generic loop, the others through an
+; unrolled loop per size and direction with one map read per metatile.
+;------------------------------------------------------------------------------
+_mapMtRun:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_CNT                            ; Split the run at the wrap point
+    sta.b ML_CNT2
+    stx.b ML_CNT
+    lda.b ML_END
+    sec
+    sbc.b ML_CNT
+    lsr a                                   ; Tiles before the wrap
+    cmp.b ML_CNT2
+    bcc _mmr0
+    lda.b ML_CNT2
+    sta.b ML_CNT
+    stz.b ML_CNT2
+    bra _mmr01
+_mmr0:
+    sta.b ML_CNT
+    lda.b ML_CNT2
+    sec
+    sbc.b ML_CNT
+    sta.b ML_CNT2
+
+_mmr01:
+    ldy.b ML_MIDX
+    lda [ML_MAP],y                          ; ------mmmmmmmmmm
+    and #$03FF
+    asl a
+    asl a
+    asl a                                   ; 16x16: 4 entries per metatile
+    ldy.b ML_MTSH
+    cpy #2
+    bne _mmr1
+    asl a
+    asl a                                   ; 32x32: 16 entries
+_mmr1:
+    clc
+    adc.b ML_MTOFS
+    tay
+
+_mmr2:
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mmr3
+    jsr _mapMtSeg
+_mmr3:
+    dec.b ML_TMP
+    beq _mmr4
+    tya
+    clc
+    adc.b ML_TMP2
+    tay
+    bra _mmr2
+
+_mmr4:
+    ldy.b ML_MTSH
+    lda.b ML_TMP2
+    cmp #2
+    beq _mmr5
+    cpy #2
+    bne _mtc16
+    jmp _mtc32
+_mmr5:
+    cpy #2
+    bne _mtr16
+    jmp _mtr32
+
+_mtc16:                                     ; 16x16, down a column
+    lda.b ML_MIDX
+    clc
+    adc.b ML_MTROW
+    sta.b ML_MIDX
+    tay
+    lda [ML_MAP],y
+    and #$03FF
+    asl a
+    asl a
+    asl a
+    ora.b ML_MTSUB
+    tay
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtc16a
+    jsr _mapMtSeg
+_mtc16a:
+    iny
+    iny
+    iny
+    iny
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtc16
+    jsr _mapMtSeg
+    bra _mtc16
+
+_mtr16:                                     ; 16x16, along a row
+    lda.b ML_MIDX
+    inc a
+    inc a
+    sta.b ML_MIDX
+    tay
+    lda [ML_MAP],y
+    and #$03FF
+    asl a
+    asl a
+    asl a
+    ora.b ML_MTSUB
+    tay
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtr16a
+    jsr _mapMtSeg
+_mtr16a:
+    iny
+    iny
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtr16
+    jsr _mapMtSeg
+    bra _mtr16
+
+_mtc32:                                     ; 32x32, down a column
+    lda.b ML_MIDX
+    clc
+    adc.b ML_MTROW
+    sta.b ML_MIDX
+    tay
+    lda [ML_MAP],y
+    and #$03FF
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    ora.b ML_MTSUB
+    tay
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtc32a
+    jsr _mapMtSeg
+_mtc32a:
+    tya
+    clc
+    adc #4 * 2
+    tay
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtc32b
+    jsr _mapMtSeg
+_mtc32b:
+    tya
+    clc
+    adc #4 * 2
+    tay
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtc32c
+    jsr _mapMtSeg
+_mtc32c:
+    tya
+    clc
+    adc #4 * 2
+    tay
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtc32
+    jsr _mapMtSeg
+    bra _mtc32
+
+_mtr32:                                     ; 32x32, along a row
+    lda.b ML_MIDX
+    inc a
+    inc a
+    sta.b ML_MIDX
+    tay
+    lda [ML_MAP],y
+    and #$03FF
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a
+    ora.b ML_MTSUB
+    tay
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtr32a
+    jsr _mapMtSeg
+_mtr32a:
+    iny
+    iny
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtr32b
+    jsr _mapMtSeg
+_mtr32b:
+    iny
+    iny
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtr32c
+    jsr _mapMtSeg
+_mtr32c:
+    iny
+    iny
+    lda [ML_DEFS],y
+    sta.w $0000,x
+    inx
+    inx
+    dec.b ML_CNT
+    bne _mtr32
+    jsr _mapMtSeg
+    bra _mtr32
+
+;------------------------------------------------------------------------------
+; _mapMtSeg (internal)
+; Called by _mapMtRun when ML_CNT reaches 0: continues after the wrap
+; point, or drops its return address to end the run.
+;------------------------------------------------------------------------------
+_mapMtSeg:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_CNT2
+    beq _mms1
+    sta.b ML_CNT
+    stz.b ML_CNT2
+    txa
+    sec
+    sbc.b ML_MTWRAP
+    tax
+    rts
+
+_mms1:
+    pla                                     ; Run over: return from _mapMtRun
+    rts
+
+;------------------------------------------------------------------------------
+; _mapMtPrep (internal)
+; Big metatiles: for the map tile (ML_MTX, ML_MTY), ML_MIDX = map index of
+; its metatile, ML_MTOFS = definition offset of the tile, ML_MTSUB = offset
+; of its row, ML_TMP2 = offset of its column. X and Y are lost.
+;------------------------------------------------------------------------------
+_mapMtPrep:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_MTY
+    ldx.b ML_MTSH
+_mmp1:
+    lsr a
+    dex
+    bne _mmp1
+    ldy.b ML_MTROW
+    jsr _mapRowOffset
+    sta.b ML_MIDX
+
+    lda.b ML_MTX
+    ldx.b ML_MTSH
+_mmp2:
+    lsr a
+    dex
+    bne _mmp2
+    asl a
+    clc
+    adc.b ML_MIDX
+    sta.b ML_MIDX
+
+    lda.b ML_MTN
+    dec a
+    and.b ML_MTX
+    asl a
+    sta.b ML_TMP2
+
+    lda.b ML_MTN
+    dec a
+    and.b ML_MTY
+    ldx.b ML_MTSH
+_mmp3:
+    asl a
+    dex
+    bne _mmp3
+    asl a                                   ; row * side * 2
+    sta.b ML_MTSUB
+    clc
+    adc.b ML_TMP2
+    sta.b ML_MTOFS
+    rts
+
+;------------------------------------------------------------------------------
+; _mapRefreshMt (internal)
+; Big metatiles: fills the page with MAP_DISPH+1 rows of MAP_DISPW tiles
+; from the map tile at (ML_XPOS / 8, ML_YPOS / 8).
+;------------------------------------------------------------------------------
+_mapRefreshMt:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_YPOS
+    lsr a
+    lsr a
+    lsr a
+    sta.b ML_MTY
+    lda #64 * 2
+    sta.b ML_MTWRAP                         ; Never reached by a 32-tile row
+
+    lda.b ML_BUF
+_mrm1:
+    pha
+    clc
+    adc #64 * 2
+    sta.b ML_END
+    lda #MAP_DISPW
+    sta.b ML_CNT
+    lda.b ML_XPOS
+    lsr a
+    lsr a
+    lsr a
+    sta.b ML_MTX
+    lda 1,s
+    jsr _mapMtRowRun
+    inc.b ML_MTY
+
+    pla
+    clc
+    adc #32 * 2
+    pha
+    sec
+    sbc.b ML_BUF
+    cmp #(MAP_DISPH + 1) * 32 * 2
+    pla
+    bcc _mrm1
+    rts
+
+;------------------------------------------------------------------------------
+; _mapChColumn (internal)
+; Chunked maps: X = display column (0 or MAP_DISPW). Fills the vertical
+; buffer from the tile at (ML_TOPX / 8 + X, ML_TOPY / 8) downwards.
+;------------------------------------------------------------------------------
+_mapChColumn:
+    .ACCU 16
+    .INDEX 16
+    stx.b ML_CHX
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc.b ML_CHX
+    sta.b ML_CHX
+    lda.b ML_TOPY
+    lsr a
+    lsr a
+    lsr a
+    sta.b ML_CHY
+
+    lda #MAP_DISPH + 1
+    sta.b ML_CNT
+    lda #32 * 2                             ; Wrap inside the layer's column
+    sta.b ML_CHWRAP
+    sta.b ML_CHDIR
+    lda.b ML_VBUF
+    clc
+    adc.w #32 * 2
+    sta.b ML_END
+    lda.b ML_COLIDX
+    and.w #$3F
+    clc
+    adc.b ML_VBUF
+    sta.b ML_CHPOS
+    jmp _mapChRun
+
+;------------------------------------------------------------------------------
+; _mapChRow (internal)
+; Chunked maps: X = display row (0 or MAP_DISPH). Fills the horizontal
+; buffer from the tile at (ML_VALL, ML_TOPY / 8 + X) rightwards.
+;------------------------------------------------------------------------------
+_mapChRow:
+    .ACCU 16
+    .INDEX 16
+    stx.b ML_CHY
+    lda.b ML_TOPY
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc.b ML_CHY
+    sta.b ML_CHY
+    lda.b ML_VALL
+    sta.b ML_CHX
+
+    lda.b ML_VALR
+    sec
+    sbc.b ML_VALL
+    sta.b ML_CNT
+    lda #64 * 2                             ; Wrap inside the row's two pages
+    sta.b ML_CHWRAP
+    stz.b ML_CHDIR
+    lda.b ML_BUF
+    clc
+    adc #64 * 2
+    sta.b ML_END
+    jsr _mapRowSpan
+    clc
+    adc.b ML_ROWIDX
+    and.w #$7F
+    clc
+    adc.b ML_BUF
+    sta.b ML_CHPOS
+    ; fall through
+
+;------------------------------------------------------------------------------
+; _mapChRun (internal)
+; Copies ML_CNT tiles of a chunked map, from the map tile (ML_CHX, ML_CHY)
+; along a row (ML_CHDIR = 0) or down a column, to ML_CHPOS in the layer's
+; page or columns, wrapping back by ML_CHWRAP bytes at ML_END. The copy
+; and the chunk cache live in map_chunk, reached through mapchrun.
+;------------------------------------------------------------------------------
+_mapChRun:
+    .ACCU 16
+    .INDEX 16
+    phk
+    pea _mchr1-1
+    jml [mapchrun]                          ; Long indirect call
+_mchr1:
+    rts
+
+;------------------------------------------------------------------------------
+; _mapRefreshCh (internal)
+; Chunked maps: fills the page with MAP_DISPH+1 rows of MAP_DISPW tiles
+; from the map tile at (ML_XPOS / 8, ML_YPOS / 8).
+;------------------------------------------------------------------------------
+_mapRefreshCh:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_YPOS
+    lsr a
+    lsr a
+    lsr a
+    sta.b ML_CHY
+    lda #64 * 2
+    sta.b ML_CHWRAP                         ; Never reached by a 32-tile row
+    stz.b ML_CHDIR
+
+    lda.b ML_BUF
+_mrc1:
+    sta.b ML_CHPOS
+    clc
+    adc #64 * 2
+    sta.b ML_END
+    lda #MAP_DISPW
+    sta.b ML_CNT
+    lda.b ML_XPOS
+    lsr a
+    lsr a
+    lsr a
+    sta.b ML_CHX
+    jsr _mapChRun
+    inc.b ML_CHY
+
+    lda.b ML_CHPOS                          ; Next page row
+    sec
+    sbc.b ML_BUF
+    cmp #(MAP_DISPH + 1) * 32 * 2
+    lda.b ML_CHPOS
+    bcc _mrc1
+    rts
+
+;------------------------------------------------------------------------------
+; mapChunkLocate (internal, JSL)
+; Chunked maps: X = bank $7E address of the map tile (ML_CHX, ML_CHY) of
+; the layer at D, for lookups outside the display. Jumps to map_chunk
+; through mapchlocate; A, Y, ML_TMP and ML_TMP2 are lost.
+;------------------------------------------------------------------------------
+mapChunkLocate:
+    .ACCU 16
+    .INDEX 16
+    jml [mapchlocate]                       ; Its RTL returns to our caller
+
+;------------------------------------------------------------------------------
+; mapChunkFetch (internal, JSL)
+; Chunked maps: A = map entry at (ML_CHX, ML_CHY) of the layer at D.
+; For the collision queries, which live in other sections.
+;------------------------------------------------------------------------------
+mapChunkFetch:
+    .ACCU 16
+    .INDEX 16
+    jsl mapChunkLocate
+    lda.l $7E0000,x
+    rtl
+
+;------------------------------------------------------------------------------
+; void mapVblank(void)
+;
+; Uploads the pending column / row / page of each layer and writes its scroll
+; registers. Layers share one byte budget per call: mapvbbudget, capped by
+; what the NMI left of the shared VBlank budget (vblank_dma_budget -
+; vblank_dma_bytes), and charged to vblank_dma_bytes. The first upload always
+; goes. A layer that does not fit keeps its buffers and its old scroll values,
+; mapUpdate leaves it alone, and it is served first by the next call.
+;------------------------------------------------------------------------------
+mapVblank:
+    php
     phb
+    phd
+    phx
+    phy
+
+    sep #$20
+    .ACCU 8
+    lda.b #$0
+    pha
+    plb
+
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda.w vblank_dma_budget
+    sec
+    sbc.w vblank_dma_bytes
+    bcs _mapvb0
+    lda #0
+_mapvb0:
+    cmp.w mapvbbudget
+    bcc _mapvb01
+    lda.w mapvbbudget
+_mapvb01:
+    sta.w mapvbleft
+    stz.w mapvbsent
+    stz.w mapvbwait
+
+    lda #$1801
+    sta.l $4300                             ; DMA mode: word write to $2118
+
+    lda.w mapvbfirst
+    bne _mapvb1
+    lda #maplayers
+    sta.w mapvbfirst
+
+_mapvb1:
+    tcd
+    sep #$20
+    .ACCU 8
+    lda.b ML_ON
+    beq _mapvb2
+    lda.b ML_UPD
+    beq _mapvb2
+    rep #$20
+    .ACCU 16
+    jsr _mapVblankLayer
+
+_mapvb2:
+    rep #$20
+    .ACCU 16
+    lda.b ML_NEXT                           ; Round the loaded layers once
+    bne _mapvb3
+    lda #maplayers
+_mapvb3:
+    cmp.w mapvbfirst
+    bne _mapvb1
+
+    ; A layer that had to wait goes first next time
+    lda.w mapvbwait
+    bne _mapvb4
+    lda #maplayers
+_mapvb4:
+    sta.w mapvbfirst
+
+    ply
+    plx
+    pld
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; _mapVblankLayer (internal)
+; D = layer context with ML_UPD != 0, DB = $00.
+; The queued columns and rows go up together or not at all; prefetch
+; columns only with what the budget has left after them.
+;------------------------------------------------------------------------------
+_mapVblankLayer:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_UPD
+    and #MAP_UPD_CATCH
+    beq _mvl1
+    jmp _mapVblankCatch
+
+_mvl1:
+    lda.b ML_NROW
+    asl a
+    clc
+    adc.b ML_NCOL
+    sec
+    sbc.b ML_NPRE
+    xba
+    lsr a
+    lsr a                                   ; (rows * 2 + columns) * 32 * 2
+    jsr _mapVblankFits
+    bcs _mvl4
+    rts
+
+_mvl4:
+    jsr _mapVblankCharge
+
+    sep #$20
+    .ACCU 8
+    lda.b ML_UPD
+    bpl _mvl5
+
+    lda #$81                                ; VMAIN_INCREMENT_HIGH | VMAIN_INCREMENT_32
+    sta.l $2115
+
+    rep #$20
+    .ACCU 16
+    lda.b ML_NCOL
+    sec
+    sbc.b ML_NPRE
+    sta.b ML_TMP2
+    ldx #0
+    jsr _mapVblankColumns
+
+    sep #$20
+    .ACCU 8
+    lda.b ML_UPD
+
+_mvl5:
+    lsr a
+    bcc _mvl7
+    rep #$20
+    .ACCU 16
+    jsr _mapVblankRows
+
+_mvl7:
+    rep #$20
+    .ACCU 16
+    lda.b ML_NPRE                           ; After the rows, which write all
+    beq _mvl8                               ; 64 columns
+    jsr _mapVblankPrefetch
+
+_mvl8:
+    stz.b ML_NPRE
+    sep #$20
+    .ACCU 8
+    stz.b ML_UPD
+    ldx.b ML_BGREG
+    lda.b ML_DISPX
+    sta.l REG_BG1HOFS,x
+    lda.b ML_DISPX + 1
+    sta.l REG_BG1HOFS,x
+    lda.b ML_DISPY
+    sta.l REG_BG1VOFS,x
+    lda.b ML_DISPY + 1
+    sta.l REG_BG1VOFS,x
+
+    rep #$20
+    .ACCU 16
+    rts
+
+;------------------------------------------------------------------------------
+; _mapVblankRows (internal)
+; Uploads the ML_NROW queued rows, both halves of each
+;------------------------------------------------------------------------------
+_mapVblankRows:
+    .ACCU 16
+    .INDEX 16
+    sep #$20
+    .ACCU 8
+    lda #$80
+    sta.l $2115
+
+    rep #$20
+    .ACCU 16
+    ldx #0
+_mvl61:
+    txa
+    xba
+    lsr a
+    lsr a                                   ; Row * 64 words
+    clc
+    adc.b ML_BUF
+    sta.l $4302
+    lda.b ML_HQ,x
+    sta.l $2116
+    lda #2 * 32
+    sta.l $4305
+
+    sep #$20
+    .ACCU 8
+    lda #$7E
+    sta.l $4304
+    lda #$01
+    sta.l $420B
+
+    rep #$20
+    .ACCU 16
+    lda.b ML_HQ,x                           ; Source continues with the right half
+    clc
+    adc #32 * 32
+    sta.l $2116
+    lda #2 * 32
+    sta.l $4305
+
+    sep #$20
+    .ACCU 8
+    lda #$01
+    sta.l $420B
+
+    rep #$20
+    .ACCU 16
+    inx
+    inx
+    txa
+    lsr a
+    cmp.b ML_NROW
+    bcc _mvl61
+    rts
+
+;------------------------------------------------------------------------------
+; _mapVblankPrefetch (internal)
+; D = layer context with ML_NPRE != 0, DB = $00. Uploads the prefetch
+; columns the budget has room for, nearest first, and adds them to the
+; columns the tilemap holds. The others are dropped; mapUpdate queues
+; them again.
+;------------------------------------------------------------------------------
+_mapVblankPrefetch:
+    .ACCU 16
+    .INDEX 16
+    lda.w mapvbleft
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a                                   ; Columns that fit
+    cmp.b ML_NPRE
+    bcc _mvp1
+    lda.b ML_NPRE
+_mvp1:
+    cmp #0
+    beq _mvp3
+    sta.b ML_CNT
+    xba
+    lsr a
+    lsr a
+    jsr _mapVblankCharge
+
     sep #$20
     .ACCU 8
-    lda maptile_L1b                         ; DB = layer1map's bank (B1: was #$00,
-    pha                                     ; hardcoded bank $00; now honours the
-    plb                                     ; pointer's bank so the map can live
-    rep #$20                                ; outside bank $00)
-    .ACCU 16
-    lda 0,x
-    plb
+    lda #$81
+    sta.l $2115
 
+    rep #$20
+    .ACCU 16
+    lda.b ML_NCOL
+    sec
+    sbc.b ML_NPRE
     pha
-    and #$03FF
-    asl a
-    tax
-    lda.l metatiles.topleft,x
-    sta.w maptmpvalue
-    pla
-    and #$C000
-    ora maptmpvalue
-
-    sta bgvertleftbuf_L1, Y
-
+    clc
+    adc.b ML_CNT
+    sta.b ML_TMP2
     pla
-    sec
-    sbc.l maprowsize
+    asl a
     tax
-
-    dey
-    dey
-    bpl _pvb2
-    ldy #32 * 2 - 2
-
-_pvb2:
-    cpx.w mapendloop
-    bpl _pvb1
-
+    jsr _mapVblankColumns
+
+    lda.b ML_CNT
+    ldx.b ML_PFDIR
+    bne _mvp2
+    jmp _mapHoldRight
+_mvp2:
+    jmp _mapHoldLeft
+_mvp3:
     rts
 
 ;------------------------------------------------------------------------------
-; void mapVblank(void)
+; _mapVblankCatch (internal)
+; D = layer context catching up (MAP_UPD_CATCH), DB = $00. Uploads the
+; next hidden slots (tilemap columns the old view does not show), as many
+; as the budget allows. Once they are all up, in the same call if the
+; budget is left, the last slots, which the old view does show, and the
+; queued rows go up with the new scroll values.
 ;------------------------------------------------------------------------------
-mapVblank:
-    php
-    phb
+_mapVblankCatch:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_CATCH
+    cmp.b ML_CATCHN
+    bcs _mvh4
 
-    phx
-    phy
+    lda.w mapvbleft
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a                                   ; Columns that fit
+    bne _mvh1
+    lda #32 * 2                             ; None: one if it is the first upload
+    jsr _mapVblankFits
+    bcs _mvh0
+    rts
+_mvh0:
+    lda #1
+_mvh1:
+    sta.b ML_CNT
+    lda.b ML_CATCHN
+    sec
+    sbc.b ML_CATCH
+    cmp.b ML_CNT
+    bcs _mvh2
+    sta.b ML_CNT
+_mvh2:
+    lda.b ML_CNT
+    xba
+    lsr a
+    lsr a
+    jsr _mapVblankCharge
 
     sep #$20
     .ACCU 8
-    lda.b #$0
-    pha
-    plb
-
-    lda.l mapupdbuf
-    bne _mapvb1
-    brl _mapvbend
-
-_mapvb1:
-    bpl _mapvb2
-
-    lda #$81                                ; VMAIN_INCREMENT_HIGH | VMAIN_INCREMENT_32
+    lda #$81
     sta.l $2115
 
-    ldx #$1801
-    stx $4300
-
-    ldx #bgvertleftbuf_L1.w
-    stx $4302
-    lda #:bgvertleftbuf_L1
-    sta.l $4304
-
-    ldx bgvvramloc_L1
-    ldy #32*2
-    lda #$1
-
-    stx $2116
-    sty $4305
-    sta.l $420B
-
-    lda.l mapupdbuf
+    rep #$20
+    .ACCU 16
+_mvh3:
+    jsr _mapVblankSlot
+    dec.b ML_CNT
+    bne _mvh3
+    lda.b ML_CATCH
+    cmp.b ML_CATCHN
+    bcs _mvh4                               ; All hidden slots up: try to finish
+    rts
 
-_mapvb2:
-    cmp #MAP_UPD_WHOLE
-    bne _mapvb3
+_mvh4:
+    lda.b ML_NROW
+    asl a
+    clc
+    adc.b ML_CATCHF
+    sec
+    sbc.b ML_CATCHN
+    xba
+    lsr a
+    lsr a                                   ; (columns + rows * 2) * 32 * 2
+    jsr _mapVblankFits
+    bcs _mvh5
+    rts
+_mvh5:
+    jsr _mapVblankCharge
 
-    lda #$80
+    sep #$20
+    .ACCU 8
+    lda #$81
     sta.l $2115
 
-    ldx #bg_L1.w
-    stx $4302
-
-    ldx #MAP_BG1_ADR
-    stx $2116
-
-    ldy #32 * 32 * 2                       ; Transfer all 32 rows (rows 30-31 are BSS-zeroed = tile 0)
-    sty $4305
-
-    lda #$1
-    sta.l $420B
-
-    brl _mapvbend
-
-_mapvb3:
-    lsr a
-    bcs _mapvb4
-    brl _mapvbend
+    rep #$20
+    .ACCU 16
+_mvh6:
+    lda.b ML_CATCH
+    cmp.b ML_CATCHF
+    bcs _mvh7
+    jsr _mapVblankSlot
+    bra _mvh6
+
+_mvh7:
+    lda.b ML_NROW
+    beq _mvh8
+    jsr _mapVblankRows
+_mvh8:
+    jmp _mvl8
 
-_mapvb4:
-    lda #$80
-    sta.l $2115
+;------------------------------------------------------------------------------
+; _mapVblankSlot (internal)
+; Uploads catch-up slot ML_CATCH to its tilemap column and moves to the next
+;------------------------------------------------------------------------------
+_mapVblankSlot:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_CATCH
+    clc
+    adc.b ML_CATCHOFS
+    jsr _mapColumnVram
+    tay
+    lda.b ML_CATCH
+    jsr _mapCatchSlot
+    jsr _mapVblankColumn
+    inc.b ML_CATCH
+    rts
 
-    ldx #$1801
-    stx $4300
+;------------------------------------------------------------------------------
+; _mapVblankFits (internal)
+; A = bytes of an upload. Carry set if it goes (first upload of the call,
+; or within the budget left); otherwise counts a deferral, makes the layer
+; first in line for the next call and clears carry.
+;------------------------------------------------------------------------------
+_mapVblankFits:
+    .ACCU 16
+    .INDEX 16
+    ldx.w mapvbsent
+    beq _mvf2                               ; First upload always goes
+    cmp.w mapvbleft
+    beq _mvf2
+    bcc _mvf2
+
+    inc.w mapvbdeferred                     ; Does not fit: wait for next VBlank
+    lda.w mapvbwait
+    bne _mvf1
+    tdc
+    sta.w mapvbwait
+_mvf1:
+    clc
+    rts
 
-    ldx #bg_L1.w
-    stx $4302
+_mvf2:
+    sec
+    rts
 
-    lda #:bg_L1
-    sta.l $4304
+;------------------------------------------------------------------------------
+; _mapVblankCharge (internal)
+; A = bytes about to be uploaded: counts them as sent and charges them
+; to the shared VBlank budget
+;------------------------------------------------------------------------------
+_mapVblankCharge:
+    .ACCU 16
+    sta.b ML_TMP
+    clc
+    adc.w mapvbsent
+    sta.w mapvbsent
+    lda.b ML_TMP
+    clc
+    adc.w vblank_dma_bytes
+    sta.w vblank_dma_bytes                  ; Charge the shared VBlank budget
+    lda.w mapvbleft
+    sec
+    sbc.b ML_TMP
+    bcs _mvg1
+    lda #0
+_mvg1:
+    sta.w mapvbleft
+    rts
 
-    ldy #2 * 32
-    lda #$1
+;------------------------------------------------------------------------------
+; _mapVblankColumns (internal)
+; Uploads queued columns X / 2 to ML_TMP2 - 1 (VMAIN set to increment by 32)
+;------------------------------------------------------------------------------
+_mapVblankColumns:
+    .ACCU 16
+    .INDEX 16
+    ldy.b ML_VQ,x
+    txa
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a                                   ; Column * 32 words
+    clc
+    adc.b ML_VBUF
+    jsr _mapVblankColumn
 
-    ldx bgleftvramlocl_L1
-    stx $2116
-    sty $4305
-    sta.l $420B
+    inx
+    inx
+    txa
+    lsr a
+    cmp.b ML_TMP2
+    bcc _mapVblankColumns
+    rts
 
-    ldx bgrightvramlocr_L1
-    stx $2116
-    sty $4305
-    sta.l $420B
+;------------------------------------------------------------------------------
+; _mapVblankColumn (internal)
+; A = bank $7E address of a column, Y = its VRAM word address
+;------------------------------------------------------------------------------
+_mapVblankColumn:
+    .ACCU 16
+    .INDEX 16
+    sta.l $4302
+    tya
+    sta.l $2116
+    lda #32 * 2
+    sta.l $4305
 
-_mapvbend:
     sep #$20
     .ACCU 8
-    lda.l mapoptions
-    and #MAP_OPT_BG2
-    bne _mapvbbg2
-    lda.l dispxofs_L1
-    sta.l REG_BG1HOFS
-    lda.l dispxofs_L1 + 1
-    sta.l REG_BG1HOFS
-    lda.l dispyofs_L1
-    sta.l REG_BG1VOFS
-    lda.l dispyofs_L1 + 1
-    sta.l REG_BG1VOFS
-    bra _mapvbend1
-
-_mapvbbg2:
-    lda.l dispxofs_L1
-    sta.l REG_BG2HOFS
-    lda.l dispxofs_L1 + 1
-    sta.l REG_BG2HOFS
-    lda.l dispyofs_L1
-    sta.l REG_BG2VOFS
-    lda.l dispyofs_L1 + 1
-    sta.l REG_BG2VOFS
-    bra _mapvbend1
-
-_mapvbend1:
-    lda #$0
-    sta.l mapupdbuf
-
-    ply
-    plx
+    lda #$7E
+    sta.l $4304
+    lda #$01
+    sta.l $420B
 
-    plb
-    plp
-    rtl
+    rep #$20
+    .ACCU 16
+    rts
 
 ;------------------------------------------------------------------------------
 ; void mapUpdate(void)
+;
+; Runs every loaded layer. A layer whose last column / row / page is still
+; waiting for mapVblank is skipped, so its buffers stay intact.
 ;------------------------------------------------------------------------------
 mapUpdate:
     php
+    phb
+    phd
+    phx
+    phy
 
     sep #$20
     .ACCU 8
-    lda.l mapdirty
-    beq _maupd1
-    ; Runtime full refresh: push B, set bank $7E, then enter refresh
-    phb
     lda #$7e
     pha
     plb
-    jmp _mapRefreshAll1
+
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda #maplayers
+
+_maupd0:
+    tcd
+    sep #$20
+    .ACCU 8
+    lda.b ML_ON
+    beq _maupd1
+    lda.b ML_UPD
+    and #MAP_UPD_VERT | MAP_UPD_HORIZ | MAP_UPD_CATCH
+    bne _maupd1
+    rep #$20
+    .ACCU 16
+    jsr _mapUpdateLayer
 
 _maupd1:
-    phb
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_NEXT
+    bne _maupd0
 
-    lda #$7e
-    pha
+    ply
+    plx
+    pld
     plb
+    plp
+    rtl
 
-    rep #$30
+;------------------------------------------------------------------------------
+; _mapUpdateLayer (internal)
+; D = layer context, DB = $7E, A/X/Y 16-bit
+;------------------------------------------------------------------------------
+_mapUpdateLayer:
     .ACCU 16
     .INDEX 16
-    lda.l x_pos
+    jsr _mapLayerPos
+    stz.b ML_NCOL
+    stz.b ML_NROW
+    stz.b ML_NPRE
+
+    ; Up to MAP_UPD_STEPS columns the tilemap does not hold yet, then up to
+    ; MAP_UPD_STEPS rows. Up to MAP_CATCH_MAX columns are caught up over
+    ; several VBlanks, and a bigger move rebuilds the whole view that way.
+    stz.b ML_CATCHN
+    lda.b ML_YPOS
     sec
-    sbc.w mapvisibletopleftxpos
-    bcc _mappud2
-    cmp.w #MAP_MTSIZE
-    bcc _maupd41
-    cmp.w #MAP_MTSIZE * 2
-    bcc _maupd4
-    jmp _mapRefreshAll1
+    sbc.b ML_TOPY
+    bcc _mul1
+    cmp.w #MAP_MTSIZE * (MAP_UPD_STEPS + 1)
+    bcc _mul2
+    jmp _mapCatchLayer
+_mul1:
+    cmp.w #$10000 - MAP_MTSIZE * MAP_UPD_STEPS
+    bpl _mul2
+    jmp _mapCatchLayer
+
+_mul2:
+    lda.b ML_XPOS
+    lsr a
+    lsr a
+    lsr a
+    sta.b ML_TMP                            ; New leftmost displayed column
+    clc
+    adc.w #MAP_DISPW + 1
+    sec
+    sbc.b ML_VALR                           ; Columns missing on the right
+    bmi _mul3
+    cmp.w #MAP_UPD_STEPS + 1
+    bcc _mul3
+    cmp.w #MAP_CATCH_MAX + 1
+    bcc _mul21
+    jmp _mapCatchLayer
+_mul21:
+    pha
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    eor #$FFFF
+    sec
+    adc.b ML_TMP                            ; Columns moved: the new ones must
+    cmp.w #MAP_TMAPW - MAP_DISPW + 1        ; all land where the old view hides
+    pla
+    bcc _mul22
+    jmp _mapCatchLayer
+_mul22:
+    clc                                     ; Partial catch-up, slots filled
+    adc.w #MAP_CATCH_SLOT                   ; left to right from ML_VALR
+    sta.b ML_CATCHN
+    sta.b ML_CATCHF
+    lda.w #MAP_CATCH_SLOT
+    sta.b ML_CATCH
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    eor #$FFFF
+    sec
+    adc.b ML_VALR
+    bra _mul31
 
-_maupd4:
-    lda.l mapvisibletopleftxpos
-    adc.w #MAP_MTSIZE
-    sta.l mapvisibletopleftxpos
+_mul3:
+    lda.b ML_VALL
+    sec
+    sbc.b ML_TMP                            ; and on the left
+    bmi _mul4
+    cmp.w #MAP_UPD_STEPS + 1
+    bcc _mul4
+    cmp.w #MAP_CATCH_MAX + 1
+    bcc _mul30
+    jmp _mapCatchLayer
+_mul30:
+    pha
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    sec
+    sbc.b ML_TMP
+    cmp.w #MAP_TMAPW - MAP_DISPW + 1
+    pla
+    bcc _mul32
+    jmp _mapCatchLayer
+_mul32:
+    clc                                     ; Partial catch-up, slots filled
+    adc.w #MAP_CATCH_SLOT                   ; right to left from ML_VALL - 1
+    sta.b ML_CATCHN
+    sta.b ML_CATCHF
+    dec a
+    sta.b ML_CATCH
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    eor #$FFFF
+    sec
+    adc.b ML_TMP
+_mul31:
+    clc                                     ; Display column of the first slot
+    adc.b ML_COLOFS
+    sec
+    sbc.w #MAP_CATCH_SLOT
+    sta.b ML_CATCHOFS
 
-    lda.l mapvisibletopleftidx
-    inc a
-    inc a
-    sta.l mapvisibletopleftidx
+_mul4:
+    lda.b ML_XPOS
+    sec
+    sbc.b ML_TOPX
+    bcc _mapupd5
+    bra _maupd41
 
+_maupd4:
+    lda.b ML_TOPX
     clc
-    adc.w #(MAP_DISPW + 1) * 2
-    jsr _ProcessVerticalBuffer
+    adc.w #MAP_MTSIZE
+    sta.b ML_TOPX
 
-    lda.l maprowidx
+    lda.b ML_ROWIDX
     clc
     adc #1 * 2
-    sta.l maprowidx
+    sta.b ML_ROWIDX
 
-    lda.l mapcolmetatileofs
+    lda.b ML_COLOFS
     inc a
     and #$003F / 1
-    sta.l mapcolmetatileofs
+    sta.b ML_COLOFS
 
-    eor #$0020 / 1
-    bit #$0020 / 1
-    beq _maupd42
-    eor #$0420 / 1
+    lda.b ML_TOPIDX
+    inc a
+    inc a
+    sta.b ML_TOPIDX
 
-_maupd42:
+    stz.b ML_PFDIR                          ; Prefetch to the right
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
     clc
-    adc #MAP_BG1_ADR
-    sta.l bgvvramloc_L1
-
-    sep #$20
-    .ACCU 8
-    lda #MAP_UPD_VERT
-    tsb mapupdbuf
+    adc.w #MAP_DISPW
+    cmp.b ML_VALR
+    bcc _maupd43                            ; Column already in the tilemap
 
-    rep    #$20
-    .ACCU 16
+    lda.b ML_COLOFS
+    clc
+    adc.w #MAP_DISPW
+    jsr _mapColumnVram
+    tay
+    lda.b ML_TOPIDX
+    clc
+    adc.w #(MAP_DISPW + 1) * 2
+    ldx #MAP_DISPW
+    jsr _mapQueueNew
+    lda #1
+    jsr _mapHoldRight
+_maupd43:
+    lda.b ML_XPOS
+    sec
+    sbc.b ML_TOPX
 _maupd41:
+    cmp.w #MAP_MTSIZE
+    bcs _maupd4
     bra _mapupd3
 
-_mappud2:
-    cmp.w #$FFF8
-    bpl _mapupd5
-    jmp _mapRefreshAll1
-
 _mapupd5:
-    lda.l mapvisibletopleftxpos
+    lda.b ML_TOPX
     sec
     sbc #MAP_MTSIZE
-    sta.l mapvisibletopleftxpos
-
-    lda.l mapvisibletopleftidx
-    dec a
-    dec a
-    sta.l mapvisibletopleftidx
-    inc a
-    inc a
-    jsr _ProcessVerticalBuffer
+    sta.b ML_TOPX
 
-    lda.l maprowidx
+    lda.b ML_ROWIDX
     sec
     sbc #1 * 2
-    sta.l maprowidx
+    sta.b ML_ROWIDX
 
-    lda.l mapcolmetatileofs
+    lda.b ML_COLOFS
     dec a
     and #$003F / 1
-    sta.l mapcolmetatileofs
+    sta.b ML_COLOFS
 
-    bit #$0020 / 1
-    beq _mapupd51
-    EOR #$0420 / 1
-_mapupd51:
-    clc
-    adc #MAP_BG1_ADR
-    sta.l bgvvramloc_L1
+    lda.b ML_TOPIDX
+    dec a
+    dec a
+    sta.b ML_TOPIDX
 
-    sep #$20
-    .ACCU 8
-    lda #MAP_UPD_VERT
-    tsb mapupdbuf
+    lda #1
+    sta.b ML_PFDIR                          ; Prefetch to the left
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    cmp.b ML_VALL
+    bcs _mapupd51                           ; Column already in the tilemap
+
+    lda.b ML_COLOFS
+    jsr _mapColumnVram
+    tay
+    lda.b ML_TOPIDX
+    inc a
+    inc a
+    ldx #0
+    jsr _mapQueueNew
+    lda #1
+    jsr _mapHoldLeft
+_mapupd51:
+    lda.b ML_XPOS
+    sec
+    sbc.b ML_TOPX
+    bcc _mapupd5
 
-    rep #$20
-    .ACCU 16
 _mapupd3:
-    lda.l x_pos
+    lda.b ML_XPOS
     sec
-    sbc mapdisplaydeltax
-    sta.l dispxofs_L1
+    sbc.b ML_DELTAX
+    sta.b ML_DISPX
 
-    lda.l y_pos
+    lda.b ML_YPOS
     sec
-    sbc mapvisibletopleftypos
-    bcc _mapupd6
-
-    cmp #MAP_MTSIZE
-    bcc _mapUpd81
-    cmp #MAP_MTSIZE * 2
-    bcc _mapupd8
-    jmp _mapRefreshAll1
-_mapupd8:
-    lda.l mapvisibletopleftypos
-    adc.w #MAP_MTSIZE
-    sta.l mapvisibletopleftypos
+    sbc.b ML_TOPY
+    bcc _mapupda
+    bra _mapUpd81
 
-    lda.l mapvisibletopleftidx
-    clc
-    adc.l maprowsize
-    sta.l mapvisibletopleftidx
+_mapupd8:
+    lda.b ML_TOPY
     clc
-    adc.w mapadrrowlut+MAP_DISPH * 2
-    jsr _ProcessHorizontalBuffer
+    adc.w #MAP_MTSIZE
+    sta.b ML_TOPY
 
-    lda.l mapcolidx
+    lda.b ML_COLIDX
     clc
     adc.w #1 * 2
-    sta.l    mapcolidx
+    sta.b ML_COLIDX
 
-    lda.l maprowmetatileofs
+    lda.b ML_ROWOFS
     clc
     adc.w #32 * 1
-    sta.l    maprowmetatileofs
+    sta.b ML_ROWOFS
 
     clc
     adc.w #28 * 32
     and #$03FF
 
     clc
-    adc.w #MAP_BG1_ADR
-    sta.l bgleftvramlocl_L1
+    adc.b ML_BGADR
+    tay
+
+    lda.b ML_TOPIDX
+    clc
+    adc.b ML_ROWSIZE
+    sta.b ML_TOPIDX
     clc
-    adc.w #32 * 32
-    sta.l bgrightvramlocr_L1
+    adc.b ML_SCRH
+    ldx #MAP_DISPH
+    jsr _mapQueueRow
 
     sep    #$20
     .ACCU 8
     lda #MAP_UPD_HORIZ
-    tsb    mapupdbuf
+    tsb.b ML_UPD
 
     rep    #$30
     .ACCU 16
     .INDEX 16
+    lda.b ML_YPOS
+    sec
+    sbc.b ML_TOPY
 _mapUpd81:
+    cmp.w #MAP_MTSIZE
+    bcs _mapupd8
     bra _mapupd9
-_mapupd6:
-    cmp.w #$FFF8
-    bpl _mapupda
-    jmp _mapRefreshAll1
 
 _mapupda:
-    lda.l mapvisibletopleftypos
+    lda.b ML_TOPY
     sec
     sbc #MAP_MTSIZE
-    sta.l mapvisibletopleftypos
-
-    lda.l mapvisibletopleftidx
-    sec
-    sbc.l maprowsize
-    sta.l mapvisibletopleftidx
-    jsr _ProcessHorizontalBuffer
+    sta.b ML_TOPY
 
-    lda.l mapcolidx
+    lda.b ML_COLIDX
     sec
     sbc #1 * 2
-    sta.l mapcolidx
+    sta.b ML_COLIDX
 
-    lda.l maprowmetatileofs
+    lda.b ML_ROWOFS
     sec
     sbc #32 * 1
-    sta.l maprowmetatileofs
+    sta.b ML_ROWOFS
 
     and #$03FF
     clc
-    adc #MAP_BG1_ADR
-    sta.l bgleftvramlocl_L1
-    clc
-    adc #32 * 32
-    sta.l bgrightvramlocr_L1
+    adc.b ML_BGADR
+    tay
+
+    lda.b ML_TOPIDX
+    sec
+    sbc.b ML_ROWSIZE
+    sta.b ML_TOPIDX
+    ldx #0
+    jsr _mapQueueRow
 
     sep #$20
     .ACCU 8
     lda #MAP_UPD_HORIZ
-    tsb mapupdbuf
+    tsb.b ML_UPD
     rep #$20
     .ACCU 16
+    lda.b ML_YPOS
+    sec
+    sbc.b ML_TOPY
+    bcc _mapupda
 
 _mapupd9:
-	lda.l y_pos
-	clc
-	sbc.l mapdisplaydeltay
-	sta.l dispyofs_L1
+    lda.b ML_CATCHN
+    bne _mapupd91
+    jsr _mapPrefetch
+    bra _mapupd92
+_mapupd91:
+    lda.w #MAP_CATCH_SLOT                   ; Slots go up first, rows last
+    sta.b ML_CATCH
+    sep #$20
+    .ACCU 8
+    lda #MAP_UPD_CATCH
+    sta.b ML_UPD
+    rep #$20
+    .ACCU 16
+
+_mapupd92:
+    lda.b ML_YPOS
+    clc
+    sbc.b ML_DELTAY
+    sta.b ML_DISPY
 
     sep #$20
     .ACCU 8
     lda #MAP_UPD_POSIT
-    tsb mapupdbuf
+    tsb.b ML_UPD
 
-    plb
-    plp
-    rtl
+    rep #$20
+    .ACCU 16
+    rts
+
+;------------------------------------------------------------------------------
+; _mapQueueNew (internal)
+; A / X / Y as for _mapQueueColumn: a column the display needs. Queued for
+; this frame, or built in catch-up slot ML_CATCH (the next one on the
+; side the layer moves to) during a partial catch-up.
+;------------------------------------------------------------------------------
+_mapQueueNew:
+    .ACCU 16
+    .INDEX 16
+    pha
+    lda.b ML_CATCHN
+    bne _mqn1
+    pla
+    jsr _mapQueueColumn
+    sep #$20
+    .ACCU 8
+    lda #MAP_UPD_VERT
+    tsb.b ML_UPD
+    rep #$20
+    .ACCU 16
+    rts
+
+_mqn1:
+    pla
+    jsr _mapBuildSlot
+    inc.b ML_CATCH
+    lda.b ML_PFDIR
+    beq _mqn2
+    dec.b ML_CATCH
+    dec.b ML_CATCH
+_mqn2:
+    rts
+
+;------------------------------------------------------------------------------
+; _mapBuildSlot (internal)
+; A / X as for _ProcessVerticalBuffer: builds the column in catch-up slot
+; ML_CATCH
+;------------------------------------------------------------------------------
+_mapBuildSlot:
+    .ACCU 16
+    .INDEX 16
+    pha
+    lda.b ML_VBUF
+    pha
+    lda.b ML_CATCH
+    jsr _mapCatchSlot
+    sta.b ML_VBUF
+    lda 3,s
+    jsr _ProcessVerticalBuffer
+    pla
+    sta.b ML_VBUF
+    pla
+    rts
+
+;------------------------------------------------------------------------------
+; _mapCatchSlot (internal)
+; A = catch-up slot -> A = its bank $7E address: slots 0-31 are the
+; columns of the page, 32 and up the layer's column buffers
+;------------------------------------------------------------------------------
+_mapCatchSlot:
+    .ACCU 16
+    cmp #MAP_DISPW
+    bcs _mcs1
+    xba
+    lsr a
+    lsr a                                   ; Slot * 32 words
+    clc
+    adc.b ML_BUF
+    rts
+_mcs1:
+    sbc #MAP_DISPW
+    xba
+    lsr a
+    lsr a
+    clc
+    adc.b ML_VBUF
+    rts
+
+;------------------------------------------------------------------------------
+; _mapPrefetch (internal)
+; Queues columns past the ones the tilemap holds, on the side the layer
+; last scrolled to, in the column slots this frame left free. A side
+; stops at the map's edge, or when the tilemap would have to give up a
+; displayed column for it: up to 31 columns ahead. mapVblank uploads
+; them only with budget to spare.
+;------------------------------------------------------------------------------
+_mapPrefetch:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_PFDIR
+    bne _mpf3
+
+_mpf1:                                      ; Right: column ML_VALR + ML_NPRE
+    lda.b ML_NCOL
+    cmp.w #MAP_UPD_STEPS
+    bcs _mpf5
+    lda.b ML_ROWSIZE
+    lsr a
+    sta.b ML_TMP                            ; Map width in tiles
+    lda.b ML_VALR
+    clc
+    adc.b ML_NPRE
+    cmp.b ML_TMP
+    bcs _mpf5
+    sta.b ML_TMP
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    eor #$FFFF
+    sec
+    adc.b ML_TMP                            ; Display column
+    cmp.w #MAP_TMAPW
+    bcs _mpf5
+    jsr _mapQueuePrefetch
+    bra _mpf1
+
+_mpf3:                                      ; Left: column ML_VALL - ML_NPRE - 1
+    lda.b ML_NCOL
+    cmp.w #MAP_UPD_STEPS
+    bcs _mpf5
+    lda.b ML_VALL
+    clc
+    sbc.b ML_NPRE
+    bmi _mpf5
+    sta.b ML_TMP
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    eor #$FFFF
+    sec
+    adc.b ML_TMP                            ; Display column (negative)
+    cmp.w #$10000 - (MAP_TMAPW - MAP_DISPW - 1)
+    bcc _mpf5
+    jsr _mapQueuePrefetch
+    bra _mpf3
+
+_mpf5:
+    rts
+
+;------------------------------------------------------------------------------
+; _mapQueuePrefetch (internal)
+; A = display column of a prefetch column (negative: left of the display)
+;------------------------------------------------------------------------------
+_mapQueuePrefetch:
+    .ACCU 16
+    .INDEX 16
+    tax
+    clc
+    adc.b ML_COLOFS
+    jsr _mapColumnVram
+    tay
+    txa
+    inc a
+    asl a
+    clc
+    adc.b ML_TOPIDX
+    jsr _mapQueueColumn
+    inc.b ML_NPRE
+    rts
+
+;------------------------------------------------------------------------------
+; _mapColumnVram (internal)
+; A = tilemap column (any value, taken modulo 64) -> A = its VRAM word
+; address in the layer's SC_64x32 tilemap
+;------------------------------------------------------------------------------
+_mapColumnVram:
+    .ACCU 16
+    and #$003F
+    bit #$0020
+    beq _mcv1
+    eor #$0420                              ; Right-hand 32x32 screen
+_mcv1:
+    clc
+    adc.b ML_BGADR
+    rts
+
+;------------------------------------------------------------------------------
+; _mapHoldRight / _mapHoldLeft (internal)
+; A = columns just added to the right / left of those the tilemap holds.
+; The opposite side gives up what no longer fits in its 64 columns.
+;------------------------------------------------------------------------------
+_mapHoldRight:
+    .ACCU 16
+    clc
+    adc.b ML_VALR
+    sta.b ML_VALR
+    sec
+    sbc #MAP_TMAPW
+    bcc _mhr1
+    cmp.b ML_VALL
+    bcc _mhr1
+    sta.b ML_VALL
+_mhr1:
+    rts
+
+_mapHoldLeft:
+    .ACCU 16
+    eor #$FFFF
+    sec
+    adc.b ML_VALL
+    sta.b ML_VALL
+    clc
+    adc #MAP_TMAPW
+    cmp.b ML_VALR
+    bcs _mhl1
+    sta.b ML_VALR
+_mhl1:
+    rts
+
+;------------------------------------------------------------------------------
+; _mapCatchLayer (internal)
+; A move too big to stream. Builds the new view in the 31 tilemap columns
+; the old one does not show (slots 0-30) and the 2 after them, the old
+; view's first two (slots 31-32). mapVblank uploads the hidden ones over
+; as many VBlanks as its budget needs, and the layer keeps showing the
+; old view until the last two go up with the new scroll values.
+;------------------------------------------------------------------------------
+_mapCatchLayer:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_COLOFS
+    clc
+    adc.w #MAP_DISPW + 1
+    and #$003F
+    sta.b ML_COLOFS                         ; First column the old view hides
+    sta.b ML_CATCHOFS
+    asl a
+    sta.b ML_ROWIDX
+    stz.b ML_COLIDX
+    stz.b ML_ROWOFS
+
+    lda.b ML_YPOS
+    and.w #$FFFF - (MAP_MTSIZE - 1)
+    sta.b ML_TOPY
+    sta.b ML_DELTAY
+    lsr a
+    lsr a
+    lsr a
+    ldy.b ML_ROWSIZE
+    jsr _mapRowOffset
+    sta.b ML_TMP2
+
+    lda.b ML_XPOS
+    and.w #$FFFF - (MAP_MTSIZE - 1)
+    sta.b ML_TOPX
+    lsr a
+    lsr a
+    clc
+    adc.b ML_TMP2
+    sta.b ML_TOPIDX
+
+    lda.b ML_TOPX
+    lsr a
+    lsr a
+    lsr a
+    sta.b ML_VALL
+    clc
+    adc #MAP_DISPW + 1
+    sta.b ML_VALR
+
+    lda.b ML_COLOFS
+    asl a
+    asl a
+    asl a
+    eor #$FFFF
+    sec
+    adc.b ML_TOPX
+    sta.b ML_DELTAX                         ; Map pixel X of tilemap column 0
+
+    lda.b ML_XPOS
+    sec
+    sbc.b ML_DELTAX
+    sta.b ML_DISPX
+    lda.b ML_YPOS
+    clc
+    sbc.b ML_DELTAY
+    sta.b ML_DISPY
+
+    stz.b ML_CATCH
+_mct1:
+    ldx.b ML_CATCH                          ; Display column = slot
+    txa
+    inc a
+    asl a
+    clc
+    adc.b ML_TOPIDX
+    jsr _mapBuildSlot
+    inc.b ML_CATCH
+    lda.b ML_CATCH
+    cmp.w #MAP_DISPW + 1
+    bcc _mct1
+
+    stz.b ML_CATCH
+    lda.w #MAP_TMAPW - MAP_DISPW - 1
+    sta.b ML_CATCHN
+    lda.w #MAP_DISPW + 1
+    sta.b ML_CATCHF
+    stz.b ML_NCOL
+    stz.b ML_NROW
+
+    sep #$20
+    .ACCU 8
+    lda #MAP_UPD_CATCH
+    sta.b ML_UPD
+
+    rep #$20
+    .ACCU 16
+    rts
 
 .ENDS
 
@@ -1108,51 +2994,73 @@ _mapupd9:
 ;------------------------------------------------------------------------------
 mapGetMetaTile:
     php
-
+    phd
     phx
     phy
 
-    ; cproc L-to-R: ypos(p2) SP+9, xpos(p1) SP+11
+    ; cproc L-to-R: ypos(p2) SP+11, xpos(p1) SP+13
     rep #$30
     .ACCU 16
     .INDEX 16
-    lda  9,s                                ; ypos (param 2, closest)
+    lda #maplayers                          ; Layer 0 map
+    tcd
+
+    lda.b ML_CHUNK
+    beq _mgmt00
+    lda 11,s                                ; Chunked map: through the cache
     lsr
     lsr
-    and #$FFFE
-    tax
+    lsr
+    sta.b ML_CHY
+    lda 13,s
+    lsr
+    lsr
+    lsr
+    sta.b ML_CHX
+    jsl mapChunkFetch
+    bra _mgmt4
 
-    lda 11,s                                ; xpos (param 1, farthest)
+_mgmt00:
+    lda 11,s                                ; ypos (param 2, closest)
     lsr
     lsr
-    and #$FFFE
-    clc
-    adc mapadrrowlut,x
+    lsr
+    ldx.b ML_MTSH                           ; Big metatiles: rows of 16 / 32 px
+    beq _mgmt1
+_mgmt0:
+    lsr
+    dex
+    bne _mgmt0
+_mgmt1:
+    asl
     tax
+    lda.l mapadrrowlut,x
+    sta.b ML_TMP
 
-    phx
-    lda maptile_L1d
+    lda 13,s                                ; xpos (param 1, farthest)
+    lsr
+    lsr
+    lsr
+    ldx.b ML_MTSH
+    beq _mgmt3
+_mgmt2:
+    lsr
+    dex
+    bne _mgmt2
+_mgmt3:
+    asl
     clc
-    adc 1,s
-    tax
+    adc.b ML_TMP
+    tay
 
-    phb
-    sep #$20
-    .ACCU 8
-    lda maptile_L1b                         ; DB = layer1map's bank (B1: was #$00,
-    pha                                     ; hardcoded bank $00; now honours the
-    plb                                     ; pointer's bank so the map can live
-    rep #$20                                ; outside bank $00)
-    .ACCU 16
-    lda 0,x
-    plb
+    lda [ML_MAP],y
+_mgmt4:
     and #$03FF
-    plx
-
-    sta.w tcc__r0
 
     ply
     plx
+    pld
+    sta.w tcc__r0
     plp
     rtl
 
@@ -1169,55 +3077,76 @@ mapGetMetaTile:
 ;------------------------------------------------------------------------------
 mapGetMetaTilesProp:
     php
-
+    phd
     phx
     phy
 
-    ; cproc L-to-R: ypos(p2) SP+9, xpos(p1) SP+11
+    ; cproc L-to-R: ypos(p2) SP+11, xpos(p1) SP+13
     rep #$30
     .ACCU 16
     .INDEX 16
-    lda  9,s                                ; ypos (param 2, closest)
+    lda #maplayers                          ; Layer 0 map
+    tcd
+
+    lda.b ML_CHUNK
+    beq _mgmp00
+    lda 11,s                                ; Chunked map: through the cache
     lsr
     lsr
-    and #$FFFE
-    tax
+    lsr
+    sta.b ML_CHY
+    lda 13,s
+    lsr
+    lsr
+    lsr
+    sta.b ML_CHX
+    jsl mapChunkFetch
+    bra _mgmp4
 
-    lda 11,s                                ; xpos (param 1, farthest)
+_mgmp00:
+    lda 11,s                                ; ypos (param 2, closest)
     lsr
     lsr
-    and #$FFFE
-    clc
-    adc mapadrrowlut,x
+    lsr
+    ldx.b ML_MTSH                           ; Big metatiles: rows of 16 / 32 px
+    beq _mgmp1
+_mgmp0:
+    lsr
+    dex
+    bne _mgmp0
+_mgmp1:
+    asl
     tax
+    lda.l mapadrrowlut,x
+    sta.b ML_TMP
 
-    phx
-    lda maptile_L1d
+    lda 13,s                                ; xpos (param 1, farthest)
+    lsr
+    lsr
+    lsr
+    ldx.b ML_MTSH
+    beq _mgmp3
+_mgmp2:
+    lsr
+    dex
+    bne _mgmp2
+_mgmp3:
+    asl
     clc
-    adc 1,s
-    tax
+    adc.b ML_TMP
+    tay
 
-    phb
-    sep #$20
-    .ACCU 8
-    lda maptile_L1b                         ; DB = layer1map's bank (B1: was #$00,
-    pha                                     ; hardcoded bank $00; now honours the
-    plb                                     ; pointer's bank so the map can live
-    rep #$20                                ; outside bank $00)
-    .ACCU 16
-    lda 0,x
-    plb
+    lda [ML_MAP],y
+_mgmp4:
     and #$03FF
-    plx
-
     asl a
     tax
-    lda	metatilesprop, x
-
-    sta.w tcc__r0
+    lda.l metatilesprop,x
 
     ply
     plx
+    pld
+    sta.w tcc__r0
     plp
     rtl
 
@@ -1242,7 +3171,16 @@ mapSetMapOptions:
     pha
     plb
 
-    lda 6,s                                 ; get options
+    lda 6,s                                 ; optmap (param 1)
+    eor mapoptions
+    and #MAP_OPT_BG2
+    beq _msmo1
+    lda 6,s                                 ; optmap (param 1)
+    and #MAP_OPT_BG2                        ; = BG2 scroll register offset
+    sta.w maplayers+ML_BGREG                ; Layer 0 moves to BG2 or back to BG1
+
+_msmo1:
+    lda 6,s                                 ; optmap (param 1)
     sta mapoptions
 
     plb
@@ -1250,3 +3188,61 @@ mapSetMapOptions:
     rtl
 
 .ENDS
+
+;==============================================================================
+; CODE SECTION 4 - Layer rates, VBlank budget and counters
+;==============================================================================
+
+.SECTION ".maps4_text" SUPERFREE
+
+;------------------------------------------------------------------------------
+; void mapSetLayerRate(u8 layer, u16 ratex, u16 ratey)
+;------------------------------------------------------------------------------
+mapSetLayerRate:
+    php
+
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda 9,s                                 ; layer (param 1)
+    and #$00FF
+    cmp #MAP_LAYERS
+    bcs _mslr1
+
+    asl a
+    tax
+    lda 7,s                                 ; ratex (param 2)
+    sta.l mapratex,x
+    lda 5,s                                 ; ratey (param 3)
+    sta.l mapratey,x
+
+_mslr1:
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; void mapSetVBlankBudget(u16 bytes)
+;------------------------------------------------------------------------------
+mapSetVBlankBudget:
+    php
+
+    rep #$20
+    .ACCU 16
+    lda 5,s                                 ; bytes (param 1)
+    sta.l mapvbbudget
+
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 mapDeferredCount(void)
+;
+; Returns how many layer uploads mapVblank has postponed to a later VBlank.
+;------------------------------------------------------------------------------
+mapDeferredCount:
+    rep #$20
+    .ACCU 16
+    lda.l mapvbdeferred
+    rtl
+
+.ENDS
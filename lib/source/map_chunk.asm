@@ -0,0 +1,374 @@
+;==============================================================================
+; OpenSNES Chunked Map Cache
+;==============================================================================
+;
+; Reads chunked maps (MAP_HDR_CHUNK) for the map engine: their 8x8 entries
+; are cut into 16x16 chunks, each an lz4 stream. Chunks are decompressed
+; on demand into a ring of MAP_CHUNK_SLOTS WRAM slots (mapchunkbuf),
+; shared by the layers and keyed by chunk address. Tile lookups
+; (mapGetMetaTile, map_solid's build) decompress into one extra slot of
+; their own and never evict a chunk the display uses.
+;
+; Opt-in: the 4.6 KB cache, the decoder and the lz4 module cost nothing
+; to games that do not link map_chunk. mapChunkInit points map.asm's
+; mapchreset / mapchrun / mapchlocate hooks here; until then mapLoad
+; does not treat a map as chunked. Add `map_chunk` to LIB_MODULES (it
+; pulls in `map` and `lz4`).
+;
+; Author: OpenSNES Team
+; License: MIT
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+.include "map_ctx.inc"
+
+;------------------------------------------------------------------------------
+; RAM
+;------------------------------------------------------------------------------
+
+.RAMSECTION ".map_chunk_bank00" BANK 0 SLOT 1
+mapchkey                DSW MAP_CHUNK_SLOTS+1 ; Chunk cache: ROM address of each slot's chunk
+mapchbank               DSW MAP_CHUNK_SLOTS+1 ; and its bank ($FFFF = empty slot)
+mapchnext               DW                  ; Slot offset replaced by the next miss
+mapchhits               DW                  ; Chunk lookups served from the cache
+mapchmisses             DW                  ; Chunks decompressed
+.ENDS
+
+.RAMSECTION ".map_chunk_bank7e" BANK $7E SLOT 2
+mapchunkbuf             DSW (MAP_CHUNK_SLOTS+1)*MAP_CHUNK_SIZE*MAP_CHUNK_SIZE ; Decompressed chunks, display ring + lookup slot
+.ENDS
+
+.SECTION ".map_chunk_text" SUPERFREE
+
+.accu 16
+.index 16
+.16bit
+
+;------------------------------------------------------------------------------
+; void mapChunkInit(void)
+;
+; Points the map engine's chunk hooks at this module and empties the cache.
+;------------------------------------------------------------------------------
+mapChunkInit:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda #mapChunkReset
+    sta.l mapchreset
+    lda #mapChunkRun
+    sta.l mapchrun
+    lda #mapChunkLookup
+    sta.l mapchlocate
+    sep #$20
+    .ACCU 8
+    lda #:mapChunkReset
+    sta.l mapchreset+2
+    lda #:mapChunkRun
+    sta.l mapchrun+2
+    lda #:mapChunkLookup
+    sta.l mapchlocate+2
+    rep #$20
+    .ACCU 16
+    jsl mapChunkReset
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; mapChunkReset (internal, JSL through mapchreset)
+; Empties the chunk cache and its counters. Called by mapLoad, and by
+; mapSolidBuild so its lookups do not count as the game's. X is lost.
+;------------------------------------------------------------------------------
+mapChunkReset:
+    .ACCU 16
+    .INDEX 16
+    lda #0
+    sta.l mapchnext
+    sta.l mapchhits
+    sta.l mapchmisses
+    lda #$FFFF
+    ldx #MAP_CHUNK_SLOTS * 2
+_mcz1:
+    sta.l mapchbank,x
+    dex
+    dex
+    bpl _mcz1
+    rtl
+
+;------------------------------------------------------------------------------
+; mapChunkRun (internal, JSL through mapchrun)
+; _mapChRun for the map engine's columns, rows and pages.
+;------------------------------------------------------------------------------
+mapChunkRun:
+    .ACCU 16
+    .INDEX 16
+    jsr _mapChRun
+    rtl
+
+;------------------------------------------------------------------------------
+; _mapChRun (internal)
+; Copies ML_CNT tiles of a chunked map, from the map tile (ML_CHX, ML_CHY)
+; along a row (ML_CHDIR = 0) or down a column, to ML_CHPOS in the layer's
+; page or columns, wrapping back by ML_CHWRAP bytes at ML_END. The cache
+; is looked up once per chunk crossed. DB = $7E.
+;------------------------------------------------------------------------------
+_mapChRun:
+    .ACCU 16
+    .INDEX 16
+    jsr _mapChunkPtr                        ; X = first tile in mapchunkbuf
+
+    lda.b ML_CHDIR
+    bne _mcr1
+    lda.b ML_CHX
+    bra _mcr2
+_mcr1:
+    lda.b ML_CHY
+_mcr2:
+    and #MAP_CHUNK_SIZE - 1
+    eor #$FFFF
+    sec
+    adc #MAP_CHUNK_SIZE                     ; Tiles left in this chunk
+    cmp.b ML_CNT
+    bcc _mcr3
+    lda.b ML_CNT
+_mcr3:
+    sta.b ML_CHN
+    eor #$FFFF
+    sec
+    adc.b ML_CNT
+    sta.b ML_CNT                            ; Tiles left after this chunk
+
+    lda.b ML_CHDIR
+    bne _mcr4
+    lda.b ML_CHN
+    clc
+    adc.b ML_CHX
+    sta.b ML_CHX
+    lda #2                                  ; Next tile: along the chunk row
+    bra _mcr5
+_mcr4:
+    lda.b ML_CHN
+    clc
+    adc.b ML_CHY
+    sta.b ML_CHY
+    lda #MAP_CHUNK_SIZE * 2                 ; Next tile: one chunk row down
+_mcr5:
+    sta.b ML_CHSTEP
+
+_mcr6:
+    lda.w mapchunkbuf,x                     ; vh----mmmmmmmmmm
+    sta.b ML_TMP
+    and #$03FF
+    asl a
+    tay
+    lda.b ML_TMP
+    and #$C000
+    ora [ML_DEFS],y
+    ldy.b ML_CHPOS
+    sta.w $0000,y
+
+    iny
+    iny
+    cpy.b ML_END
+    bne _mcr7
+    tya
+    sec
+    sbc.b ML_CHWRAP
+    tay
+_mcr7:
+    sty.b ML_CHPOS
+    txa
+    clc
+    adc.b ML_CHSTEP
+    tax
+    dec.b ML_CHN
+    bne _mcr6
+
+    lda.b ML_CNT
+    beq _mcr8
+    jmp _mapChRun
+_mcr8:
+    rts
+
+;------------------------------------------------------------------------------
+; _mapChunkPtr (internal)
+; Chunked maps: X = offset in mapchunkbuf of the map tile (ML_CHX, ML_CHY).
+; A miss decompresses the chunk into the oldest slot of the display ring.
+; A, Y, ML_TMP and ML_TMP2 are lost. Works with any DB.
+;------------------------------------------------------------------------------
+_mapChunkPtr:
+    .ACCU 16
+    .INDEX 16
+    jsr _mapChunkFind
+    bcs _mcp4
+    lda.l mapchnext                         ; Miss: replace the oldest ring slot
+    tax
+    inc a
+    inc a
+    and #(MAP_CHUNK_SLOTS - 1) * 2
+    sta.l mapchnext
+    jsr _mapChunkLoad
+_mcp4:
+    txa
+    xba                                     ; Slot * 512
+    sta.b ML_TMP
+    lda.b ML_CHY
+    and #MAP_CHUNK_SIZE - 1
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a                                   ; Chunk row * 32 bytes
+    clc
+    adc.b ML_TMP
+    sta.b ML_TMP
+    lda.b ML_CHX
+    and #MAP_CHUNK_SIZE - 1
+    asl a
+    clc
+    adc.b ML_TMP
+    tax
+    rts
+
+;------------------------------------------------------------------------------
+; _mapChunkFind (internal)
+; Chunked maps: ML_TMP = address of the chunk holding (ML_CHX, ML_CHY), bank
+; ML_MAP+2. Carry set and X = slot * 2 if a slot holds it (the display ring
+; or the lookup slot), carry clear otherwise. Counts the hit or miss.
+;------------------------------------------------------------------------------
+_mapChunkFind:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_CHY
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    ldy.b ML_CHROW
+    jsl mapRowOffset
+    sta.b ML_TMP
+    lda.b ML_CHX
+    lsr a
+    lsr a
+    lsr a
+    and #$FFFE
+    clc
+    adc.b ML_TMP
+    tay
+    lda [ML_MAP],y                          ; Chunk offset from the table
+    clc
+    adc.b ML_MAP
+    sta.b ML_TMP                            ; Chunk address, bank ML_MAP+2
+
+    ldx #MAP_CHUNK_SLOTS * 2
+_mcf1:
+    lda.l mapchkey,x
+    cmp.b ML_TMP
+    bne _mcf2
+    lda.l mapchbank,x
+    cmp.b ML_MAP+2
+    beq _mcf3
+_mcf2:
+    dex
+    dex
+    bpl _mcf1
+
+    lda.l mapchmisses
+    inc a
+    sta.l mapchmisses
+    clc
+    rts
+
+_mcf3:
+    lda.l mapchhits
+    inc a
+    sta.l mapchhits
+    sec
+    rts
+
+;------------------------------------------------------------------------------
+; _mapChunkLoad (internal)
+; Chunked maps: decompresses the chunk at ML_TMP (bank ML_MAP+2) into slot
+; X / 2. X is kept; A and Y are lost.
+;------------------------------------------------------------------------------
+_mapChunkLoad:
+    .ACCU 16
+    .INDEX 16
+    lda.b ML_TMP
+    sta.l mapchkey,x
+    lda.b ML_MAP+2
+    sta.l mapchbank,x
+
+    phx
+    phd
+    pha                                     ; lz4Decode(chunk, slot): source bank (+ pad)
+    lda.b ML_TMP
+    pha                                     ; source low
+    lda #:mapchunkbuf
+    pha                                     ; dest bank (+ pad)
+    txa
+    xba                                     ; Slot * 512
+    clc
+    adc #mapchunkbuf.w
+    pha                                     ; dest low
+    lda #0
+    tcd                                     ; lz4Decode works with D = 0
+    jsl lz4Decode
+    pla                                     ; Pop 2 args (8 bytes)
+    pla
+    pla
+    pla
+    pld
+    plx
+    rts
+
+;------------------------------------------------------------------------------
+; mapChunkLookup (internal, JSL through mapchlocate)
+; Chunked maps: X = bank $7E address of the map tile (ML_CHX, ML_CHY) of
+; the layer at D, for lookups outside the display. A miss decompresses
+; into the lookup slot, so it never evicts a chunk a layer is drawing from.
+; A, Y, ML_TMP and ML_TMP2 are lost.
+;------------------------------------------------------------------------------
+mapChunkLookup:
+    .ACCU 16
+    .INDEX 16
+    jsr _mapChunkFind
+    bcs _mcl1
+    ldx #MAP_CHUNK_SLOTS * 2
+    jsr _mapChunkLoad
+_mcl1:
+    jsr _mcp4
+    txa
+    clc
+    adc #mapchunkbuf.w
+    tax
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 mapChunkHitCount(void)
+;------------------------------------------------------------------------------
+mapChunkHitCount:
+    rep #$20
+    .ACCU 16
+    lda.l mapchhits
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 mapChunkMissCount(void)
+;------------------------------------------------------------------------------
+mapChunkMissCount:
+    rep #$20
+    .ACCU 16
+    lda.l mapchmisses
+    rtl
+
+.ENDS
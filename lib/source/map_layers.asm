@@ -0,0 +1,157 @@
+;==============================================================================
+; OpenSNES Map Engine - Parallax Layers
+;==============================================================================
+;
+; Layers 1 and 2 of the map engine: their contexts, their display and
+; column buffers, and mapLoadLayer. The core (map.asm) only holds layer 0,
+; so a game that scrolls one layer does not pay for the others' 4.5 KB of
+; WRAM.
+;
+; mapLoadLayer links the layer's context, in layer order, into the list
+; that mapUpdate and mapVblank walk (ML_NEXT, from layer 0's context);
+; mapLoad cuts the list back to layer 0.
+;
+; Author: OpenSNES Team
+; License: MIT
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+.include "map_ctx.inc"
+
+;------------------------------------------------------------------------------
+; RAM
+;------------------------------------------------------------------------------
+
+; Contexts live in bank $00: the engine points the direct page at them
+.RAMSECTION ".map_layers_bank00" BANK 0 SLOT 1
+maplayerctx             DSB (MAP_LAYERS-1)*ML_SIZE ; Contexts of layers 1 and 2
+.ENDS
+
+.RAMSECTION ".map_layers_bank7e" BANK $7E SLOT 2
+maplayerbuf             DSW (MAP_LAYERS-1)*32*32 ; Display buffer of layers 1 and 2
+maplayervbuf            DSW (MAP_LAYERS-1)*32*MAP_UPD_STEPS ; Their vertical tile update buffers
+.ENDS
+
+.SECTION ".maplayers_text" SUPERFREE
+
+.accu 16
+.index 16
+.16bit
+
+; Context address of layers 1 and 2
+_mllCtx:
+    .word maplayerctx, maplayerctx+ML_SIZE
+
+;------------------------------------------------------------------------------
+; void mapLoadLayer(u8 layer, u8 bg, u16 vramAddr, u8 *layermap, u8 *layertiles)
+;
+; Layer 0 belongs to mapLoad: 0 and numbers past MAP_LAYERS-1 are ignored.
+; Stack layout (after php/phb/phd/phx/phy = 8 saves + 3-byte JSL return):
+;   SP+12..14 = layertiles (24-bit)
+;   SP+16..18 = layermap   (24-bit)
+;   SP+20..21 = vramAddr
+;   SP+22     = bg
+;   SP+24     = layer
+;------------------------------------------------------------------------------
+mapLoadLayer:
+    php
+    phb
+    phd
+    phx
+    phy
+
+    sep #$20
+    .ACCU 8
+    lda #$7e
+    pha
+    plb
+
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda 24,s                                ; layer (param 1)
+    and #$00FF
+    beq _mll_end
+    cmp #MAP_LAYERS
+    bcs _mll_end
+
+    dec a
+    asl a
+    tax                                     ; (layer - 1) * 2
+    lda.l _mllCtx,x
+    tcd
+    txa
+    clc
+    adc #2
+    sta.b ML_LAYER
+    txa
+    xba
+    lsr a
+    clc
+    adc #maplayervbuf.w
+    sta.b ML_VBUF                           ; (layer - 1) * 32*MAP_UPD_STEPS words
+    txa
+    xba
+    asl a
+    asl a
+    clc
+    adc #maplayerbuf.w
+    sta.b ML_BUF                            ; (layer - 1) * 32*32 words
+
+    lda 16,s                                ; layermap low 16 (param 4)
+    sta.b ML_MAP
+    lda 18,s                                ; layermap bank byte
+    and #$00FF
+    sta.b ML_MAP+2
+    lda 12,s                                ; layertiles low 16 (param 5)
+    sta.b ML_DEFS
+    lda 14,s                                ; layertiles bank byte
+    and #$00FF
+    sta.b ML_DEFS+2
+    lda 20,s                                ; vramAddr (param 3)
+    sta.b ML_BGADR
+    lda 22,s                                ; bg (param 2)
+    and #$0003
+    asl a
+    sta.b ML_BGREG
+
+    jsl mapLayerInit
+
+    tdc                                     ; Link the layer in layer order,
+    tay                                     ; unless it is in the list already
+    sty.b ML_TMP
+    ldx #maplayers
+_mll1:
+    stx.b ML_TMP2                           ; Previous context
+    lda.l ML_NEXT,x
+    tax
+    beq _mll2
+    cpx.b ML_TMP
+    beq _mll_end
+    lda.l ML_LAYER,x
+    cmp.b ML_LAYER
+    bcc _mll1
+_mll2:
+    stx.b ML_NEXT                           ; Between the previous context and X
+    ldx.b ML_TMP2
+    tya
+    sta.l ML_NEXT,x
+
+_mll_end:
+    ply
+    plx
+    pld
+    plb
+    plp
+    rtl
+
+.ENDS
@@ -0,0 +1,877 @@
+;==============================================================================
+; OpenSNES Map Solidity Bitmap
+;==============================================================================
+;
+; Packs layer 0 of the map engine into one bit per map entry (set for
+; T_SOLID) with a table of row offsets, and answers collision queries from
+; it: a point is one bit test, a span of a row tests 8 entries per byte.
+;
+; Opt-in: mapSolidBuild() walks the whole map (about 1.6M cycles for a full
+; bitmap), so it runs only when the game asks for it after mapLoad(). The
+; bitmap and its state live in this module's RAM section and cost nothing
+; to games that do not link it.
+;
+; Reads the map engine's layer 0 context (maplayers) and lookup tables;
+; chunked maps go through mapChunkLocate, the lookup slot of the chunk
+; cache.
+;
+; mapSolidBuild points the engine's mapsolidreset hook at mapSolidDrop, so
+; the next mapLoad clears mapsolidcols / mapsolidrows and the queries stop
+; answering from the old map's bitmap.
+;
+; Author: OpenSNES Team
+; License: MIT
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+.include "map_ctx.inc"
+
+;------------------------------------------------------------------------------
+; Constants
+;------------------------------------------------------------------------------
+
+.DEFINE MAP_SOLID_BYTES 4096                ; must match MAP_SOLID_BYTES in map.h
+.DEFINE MAP_SOLID_NONE  $FFFF               ; must match MAP_SOLID_NONE in map.h
+
+;------------------------------------------------------------------------------
+; RAM - Bank $7E
+;------------------------------------------------------------------------------
+
+; One bit per map entry, row by row; bit 7 of a row's first byte is its
+; leftmost entry.
+.RAMSECTION ".map_solid_bank7e" BANK $7E SLOT 2
+mapsolid                DSB MAP_SOLID_BYTES ; mapsolidstride bytes per row
+mapsolidrow             DSW MAP_MAXROWS     ; Offset of each row in mapsolid
+mapsolidcols            DW                  ; Map entries per row (0 = no bitmap)
+mapsolidrows            DW                  ; Rows of map entries (0 = no bitmap)
+mapsolidstride          DW                  ; Bytes per bitmap row (even)
+mapsolidsh              DW                  ; Pixel to map entry shift (3, 4 or 5)
+mapsolidbase            DW                  ; Query: offset of the row / column byte
+mapsolidc0              DW                  ; Query: first column (or row * 2)
+mapsolidc1              DW                  ; Query: last column (or row * 2)
+mapsolidend             DW                  ; Query: offset of the last byte / row limit
+mapsolidm1              DB                  ; Query: bit mask of the last byte
+mapsolidtmp             DW                  ; Scratch
+mapsolidr               DW                  ; Build: first row of the band
+mapsolidy               DW                  ; Build: current row
+mapsolidg               DW                  ; Build: bitmap offset of the 16 entries
+mapsolidsrc             DW                  ; Build: bank $7E address of the chunk row
+mapsolidn               DW                  ; Build: entries left in the word
+mapsolidacc             DW                  ; Build: bits of the word
+.ENDS
+
+;==============================================================================
+; CODE SECTION 0 - Build
+;==============================================================================
+
+.SECTION ".mapsolid0_text" SUPERFREE
+
+;------------------------------------------------------------------------------
+; u16 mapSolidBuild(void)
+;
+; Builds the bitmap of the map mapLoad() loaded last. Returns map entries per
+; row, 0 if there is no map or it does not fit.
+;------------------------------------------------------------------------------
+mapSolidBuild:
+    php
+    phb
+    phd
+    phx
+    phy
+
+    sep #$20
+    .ACCU 8
+    lda #$7e
+    pha
+    plb
+
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda #mapSolidDrop                       ; The next mapLoad drops the bitmap
+    sta.l mapsolidreset
+    sep #$20
+    .ACCU 8
+    lda #:mapSolidDrop
+    sta.l mapsolidreset+2
+
+    rep #$20
+    .ACCU 16
+    lda #maplayers
+    tcd
+    jsr _mapSolidBuild
+    lda.w mapsolidcols
+
+    ply
+    plx
+    pld
+    plb
+    sta.w tcc__r0
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; mapSolidDrop (internal, JSL through mapsolidreset)
+; Called by mapLoad: the bitmap described the previous map, so the queries
+; and mapSolidReady see no bitmap until mapSolidBuild runs again.
+;------------------------------------------------------------------------------
+mapSolidDrop:
+    .ACCU 16
+    lda #0
+    sta.l mapsolidcols
+    sta.l mapsolidrows
+    rtl
+
+;------------------------------------------------------------------------------
+; _mapSolidBuild (internal)
+; D = layer 0 context, DB = $7E, mapadrrowlut filled. Packs one bit per map
+; entry into mapsolid, set when the entry's tilesprop has its high byte set
+; (T_SOLID). Works 16 entries at a time, down a band of MAP_CHUNK_SIZE rows
+; before moving right, so a chunked map decompresses each chunk once. Leaves
+; no bitmap (mapsolidcols = mapsolidrows = 0) if it would not fit in
+; MAP_SOLID_BYTES.
+;------------------------------------------------------------------------------
+_mapSolidBuild:
+    .ACCU 16
+    .INDEX 16
+    stz.w mapsolidcols
+    stz.w mapsolidrows
+    lda.b ML_ON
+    and #$00FF
+    beq _msdbend                            ; No map loaded
+
+    lda.b ML_MTSH
+    clc
+    adc #3
+    sta.w mapsolidsh
+    tax
+
+    lda #MAP_MTSIZE                         ; Rows = height / entry size, rounded up
+    ldy.b ML_MTSH
+    beq _msdb1
+_msdb0:
+    asl a
+    dey
+    bne _msdb0
+_msdb1:
+    dec a
+    clc
+    adc.b ML_HEIGHT
+_msdb2:
+    lsr a
+    dex
+    bne _msdb2
+    tay
+    beq _msdbend
+    cmp #MAP_MAXROWS+1
+    bcs _msdbend
+    sta.w mapsolidrows
+
+    lda.b ML_MTROW                          ; Entries per row, padded to words
+    lsr a
+    sta.w mapsolidtmp
+    clc
+    adc #15
+    lsr a
+    lsr a
+    lsr a
+    and #$FFFE
+    sta.w mapsolidstride
+
+    lda #0                                  ; Row offsets
+    tax
+    ldy.w mapsolidrows
+_msdb3:
+    sta.w mapsolidrow,x
+    clc
+    adc.w mapsolidstride
+    cmp #MAP_SOLID_BYTES+1
+    bcs _msdbfail
+    inx
+    inx
+    dey
+    bne _msdb3
+
+    stz.w mapsolidr
+_msdb4:
+    stz.w mapsolidg
+_msdb5:
+    lda.b ML_CHUNK
+    beq _msdb6
+    lda.w mapsolidg                         ; Chunked: first entry of the band's chunk
+    asl a
+    asl a
+    asl a
+    sta.b ML_CHX
+    lda.w mapsolidr
+    sta.b ML_CHY
+    jsl mapChunkLocate
+    stx.w mapsolidsrc
+_msdb6:
+    lda.w mapsolidr
+    sta.w mapsolidy
+
+_msdb7:
+    lda #16
+    sta.w mapsolidn
+    lda.b ML_CHUNK
+    beq _msdb9
+
+    ldx.w mapsolidsrc                       ; Chunked: 16 entries of a chunk row
+_msdb8:
+    lda.l $7E0000,x
+    and #$03FF
+    asl a
+    tay
+    lda.w metatilesprop,y
+    cmp #$0100                              ; C = solid
+    rol.w mapsolidacc
+    inx
+    inx
+    dec.w mapsolidn
+    bne _msdb8
+    lda.w mapsolidsrc
+    clc
+    adc #MAP_CHUNK_SIZE*2
+    sta.w mapsolidsrc
+    bra _msdb11
+
+_msdb9:
+    lda.w mapsolidy                         ; Unchunked: 16 entries of the map row
+    asl a
+    tax
+    lda.w mapsolidg
+    asl a
+    asl a
+    asl a
+    asl a
+    clc
+    adc.w mapadrrowlut,x
+    tay
+_msdb10:
+    lda [ML_MAP],y
+    and #$03FF
+    asl a
+    tax
+    lda.w metatilesprop,x
+    cmp #$0100                              ; C = solid
+    rol.w mapsolidacc
+    iny
+    iny
+    dec.w mapsolidn
+    bne _msdb10
+
+_msdb11:
+    lda.w mapsolidy
+    asl a
+    tax
+    lda.w mapsolidrow,x
+    clc
+    adc.w mapsolidg
+    tax
+    lda.w mapsolidacc
+    xba                                     ; Leftmost entry in the first byte
+    sta.w mapsolid,x
+
+    lda.w mapsolidy                         ; Next row of the band
+    inc a
+    sta.w mapsolidy
+    cmp.w mapsolidrows
+    beq _msdb12
+    and #MAP_CHUNK_SIZE-1
+    bne _msdb7
+
+_msdb12:
+    lda.w mapsolidg                         ; Next 16 entries
+    inc a
+    inc a
+    sta.w mapsolidg
+    cmp.w mapsolidstride
+    bne _msdb5
+
+    lda.w mapsolidy                         ; Next band
+    sta.w mapsolidr
+    cmp.w mapsolidrows
+    bne _msdb4
+
+    lda.w mapsolidtmp
+    sta.w mapsolidcols
+    lda.b ML_CHUNK                          ; The build's lookups are not the game's:
+    beq _msdbend                            ; map_chunk starts its cache afresh
+    phk
+    pea _msdbend-1
+    jml [mapchreset]
+_msdbend:
+    rts
+
+_msdbfail:
+    stz.w mapsolidrows
+    rts
+
+.ENDS
+
+;==============================================================================
+; CODE SECTION 1 - Queries
+;==============================================================================
+
+.SECTION ".mapsolid1_text" SUPERFREE
+
+_msdMaskFrom:                               ; Bits of entries k..7 of a byte
+    .db $FF,$7F,$3F,$1F,$0F,$07,$03,$01
+_msdMaskTo:                                 ; Bits of entries 0..k of a byte
+    .db $80,$C0,$E0,$F0,$F8,$FC,$FE,$FF
+_msdBit:                                    ; Bit of entry k of a byte
+    .db $80,$40,$20,$10,$08,$04,$02,$01
+
+;------------------------------------------------------------------------------
+; _msdShift (internal): A = pixel -> A = map entry column / row
+; Needs a bitmap (mapsolidsh = 0 would loop 65536 times): the queries
+; check mapsolidcols first.
+;------------------------------------------------------------------------------
+_msdShift:
+    .ACCU 16
+    .INDEX 16
+    ldx.w mapsolidsh
+_msds0:
+    lsr a
+    dex
+    bne _msds0
+    rts
+
+;------------------------------------------------------------------------------
+; _msdRow (internal): A = pixel Y -> A = offset of its row in mapsolid,
+; C set if the row is outside the map.
+;------------------------------------------------------------------------------
+_msdRow:
+    .ACCU 16
+    .INDEX 16
+    jsr _msdShift
+    cmp.w mapsolidrows
+    bcs _msdrw0
+    asl a
+    tax
+    lda.w mapsolidrow,x
+_msdrw0:
+    rts
+
+;------------------------------------------------------------------------------
+; _msdFirst (internal)
+; In the row at mapsolidbase, the leftmost solid entry of columns mapsolidc0
+; to mapsolidc1 (c0 <= c1 < mapsolidcols): C clear and A = its column, or C
+; set if there is none. 8 entries per byte test.
+;------------------------------------------------------------------------------
+_msdFirst:
+    .ACCU 16
+    .INDEX 16
+    lda.w mapsolidc1
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc.w mapsolidbase
+    sta.w mapsolidend
+    lda.w mapsolidc1
+    and #7
+    tax
+    sep #$20
+    .ACCU 8
+    lda.l _msdMaskTo,x
+    sta.w mapsolidm1
+
+    rep #$20
+    .ACCU 16
+    lda.w mapsolidc0
+    and #7
+    tax
+    lda.w mapsolidc0
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc.w mapsolidbase
+    tay
+    sep #$20
+    .ACCU 8
+    lda.l _msdMaskFrom,x                    ; First byte: from c0 on
+_msdf0:
+    cpy.w mapsolidend
+    beq _msdf1
+    and.w mapsolid,y
+    bne _msdf2
+    iny
+    lda #$FF
+    bra _msdf0
+
+_msdf1:
+    and.w mapsolid,y                        ; Last byte: up to c1
+    and.w mapsolidm1
+    bne _msdf2
+    rep #$20
+    .ACCU 16
+    sec
+    rts
+
+_msdf2:
+    .ACCU 8
+    ldx #0                                  ; Leftmost set bit
+_msdf3:
+    asl a
+    bcs _msdColumn
+    inx
+    bra _msdf3
+
+; Y = byte offset, X = entry in the byte -> C clear, A = column
+_msdColumn:
+    rep #$20
+    .ACCU 16
+    stx.w mapsolidtmp
+    tya
+    sec
+    sbc.w mapsolidbase
+    asl a
+    asl a
+    asl a
+    clc
+    adc.w mapsolidtmp
+    clc
+    rts
+
+;------------------------------------------------------------------------------
+; _msdLast (internal)
+; Same as _msdFirst walking right to left: the rightmost solid entry of
+; columns mapsolidc1 to mapsolidc0 (c1 <= c0 < mapsolidcols).
+;------------------------------------------------------------------------------
+_msdLast:
+    .ACCU 16
+    .INDEX 16
+    lda.w mapsolidc1
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc.w mapsolidbase
+    sta.w mapsolidend
+    lda.w mapsolidc1
+    and #7
+    tax
+    sep #$20
+    .ACCU 8
+    lda.l _msdMaskFrom,x
+    sta.w mapsolidm1
+
+    rep #$20
+    .ACCU 16
+    lda.w mapsolidc0
+    and #7
+    tax
+    lda.w mapsolidc0
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc.w mapsolidbase
+    tay
+    sep #$20
+    .ACCU 8
+    lda.l _msdMaskTo,x                      ; First byte: up to c0
+_msdl0:
+    cpy.w mapsolidend
+    beq _msdl1
+    and.w mapsolid,y
+    bne _msdl2
+    dey
+    lda #$FF
+    bra _msdl0
+
+_msdl1:
+    and.w mapsolid,y                        ; Last byte: from c1 on
+    and.w mapsolidm1
+    bne _msdl2
+    rep #$20
+    .ACCU 16
+    sec
+    rts
+
+_msdl2:
+    .ACCU 8
+    ldx #7                                  ; Rightmost set bit
+_msdl3:
+    lsr a
+    bcs _msdColumn
+    dex
+    bra _msdl3
+
+;------------------------------------------------------------------------------
+; u16 mapSolidAt(u16 xpos, u16 ypos)
+;------------------------------------------------------------------------------
+mapSolidAt:
+    php
+    phb
+    phx
+    phy
+
+    sep #$20
+    .ACCU 8
+    lda #$7e
+    pha
+    plb
+
+    ; cproc L-to-R: ypos(p2) SP+10, xpos(p1) SP+12
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda.w mapsolidcols
+    beq _msda1                              ; No bitmap: solid
+    lda 10,s                                ; ypos
+    jsr _msdRow
+    bcs _msda1                              ; Outside the map: solid
+    sta.w mapsolidbase
+    lda 12,s                                ; xpos
+    jsr _msdShift
+    cmp.w mapsolidcols
+    bcs _msda1
+    pha
+    and #7
+    tax
+    pla
+    lsr a
+    lsr a
+    lsr a
+    clc
+    adc.w mapsolidbase
+    tay
+    sep #$20
+    .ACCU 8
+    lda.w mapsolid,y
+    and.l _msdBit,x
+    rep #$20
+    .ACCU 16
+    beq _msda2
+_msda1:
+    lda #1
+    bra _msda3
+_msda2:
+    lda #0
+_msda3:
+    ply
+    plx
+    plb
+    sta.w tcc__r0
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 mapSolidScanX(u16 ypos, u16 x0, u16 x1)
+;
+; Walks the row of ypos from the entry of x0 to the entry of x1 (either
+; direction) and returns the left pixel of the first solid entry, or
+; MAP_SOLID_NONE. Entries outside the map are solid; a negative x1 scans
+; to the left edge and hits the entry past it (pixel -entry size).
+;------------------------------------------------------------------------------
+mapSolidScanX:
+    php
+    phb
+    phx
+    phy
+
+    sep #$20
+    .ACCU 8
+    lda #$7e
+    pha
+    plb
+
+    ; cproc L-to-R: x1(p3) SP+10, x0(p2) SP+12, ypos(p1) SP+14
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda.w mapsolidcols
+    beq _msdx9                              ; No bitmap: hit at x0
+    lda 12,s                                ; x0
+    jsr _msdShift
+    sta.w mapsolidc0
+    lda 14,s                                ; ypos
+    jsr _msdRow
+    bcs _msdx4                              ; Row outside the map: hit at x0
+    sta.w mapsolidbase
+
+    lda.w mapsolidc0
+    cmp.w mapsolidcols
+    bcs _msdx4                              ; Start outside the map
+    lda 10,s                                ; x1
+    bmi _msdx8                              ; Left of the map: up to its edge
+    jsr _msdShift
+    sta.w mapsolidc1
+    lda.w mapsolidc0
+    cmp.w mapsolidc1
+    beq _msdx1
+    bcc _msdx1
+
+    jsr _msdLast                            ; Leftwards
+    bcc _msdx5
+    bra _msdx3
+
+_msdx1:
+    lda.w mapsolidc1                        ; Rightwards, up to the map's edge
+    cmp.w mapsolidcols
+    bcc _msdx2
+    lda.w mapsolidcols
+    dec a
+    sta.w mapsolidc1
+    jsr _msdFirst
+    bcc _msdx5
+    lda.w mapsolidcols                      ; Nothing before the edge: hit it
+    bra _msdx5
+
+_msdx2:
+    jsr _msdFirst
+    bcc _msdx5
+_msdx3:
+    lda #MAP_SOLID_NONE
+    bra _msdx7
+
+_msdx4:
+    lda.w mapsolidc0
+_msdx5:
+    ldx.w mapsolidsh                        ; Column -> pixel
+_msdx6:
+    asl a
+    dex
+    bne _msdx6
+_msdx7:
+    ply
+    plx
+    plb
+    sta.w tcc__r0
+    plp
+    rtl
+
+_msdx8:
+    stz.w mapsolidc1                        ; Leftwards to column 0
+    jsr _msdLast
+    bcc _msdx5
+    lda #$FFFF                              ; Nothing before the edge: hit column -1
+    bra _msdx5
+
+_msdx9:
+    lda 12,s
+    bra _msdx7
+
+;------------------------------------------------------------------------------
+; u16 mapSolidScanY(u16 xpos, u16 y0, u16 y1)
+;
+; Walks the column of xpos from the entry of y0 to the entry of y1 (either
+; direction) and returns the top pixel of the first solid entry, or
+; MAP_SOLID_NONE. Entries outside the map are solid; a negative y1 scans
+; to the top edge and hits the entry above it (pixel -entry size).
+;------------------------------------------------------------------------------
+mapSolidScanY:
+    php
+    phb
+    phx
+    phy
+
+    sep #$20
+    .ACCU 8
+    lda #$7e
+    pha
+    plb
+
+    ; cproc L-to-R: y1(p3) SP+10, y0(p2) SP+12, xpos(p1) SP+14
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda.w mapsolidcols
+    beq _msdy6                              ; No bitmap: hit at y0
+    lda 12,s                                ; y0
+    jsr _msdShift
+    asl a
+    sta.w mapsolidc0
+    lda 10,s                                ; y1
+    bpl _msdy7
+    lda #$FFFF                              ; Above the map: up to row -1
+    bra _msdy8
+_msdy7:
+    jsr _msdShift
+_msdy8:
+    asl a
+    sta.w mapsolidc1
+    lda.w mapsolidrows
+    asl a
+    sta.w mapsolidend
+
+    lda #2                                  ; Row step, in mapsolidrow words
+    ldx.w mapsolidc1
+    bmi _msdy9
+    cpx.w mapsolidc0
+    bcs _msdy0
+_msdy9:
+    lda #$FFFE
+_msdy0:
+    sta.w mapsolidtmp
+
+    ldy.w mapsolidc0
+    lda 14,s                                ; xpos
+    jsr _msdShift
+    cmp.w mapsolidcols
+    bcs _msdy3                              ; Column outside the map: hit at y0
+    pha
+    and #7
+    tax
+    pla
+    lsr a
+    lsr a
+    lsr a
+    sta.w mapsolidbase                      ; Byte of the column in a row
+    sep #$20
+    .ACCU 8
+    lda.l _msdBit,x
+    sta.w mapsolidm1
+    rep #$20
+    .ACCU 16
+
+_msdy1:
+    cpy.w mapsolidend
+    bcs _msdy3                              ; Outside the map: hit
+    lda.w mapsolidrow,y
+    clc
+    adc.w mapsolidbase
+    tax
+    sep #$20
+    .ACCU 8
+    lda.w mapsolid,x
+    and.w mapsolidm1
+    rep #$20
+    .ACCU 16
+    bne _msdy3
+    cpy.w mapsolidc1
+    beq _msdy2
+    tya
+    clc
+    adc.w mapsolidtmp
+    tay
+    bra _msdy1
+
+_msdy2:
+    lda #MAP_SOLID_NONE
+    bra _msdy5
+
+_msdy3:
+    tya                                     ; Row * 2 -> pixel
+    ldx.w mapsolidsh
+    dex
+_msdy4:
+    asl a
+    dex
+    bne _msdy4
+_msdy5:
+    ply
+    plx
+    plb
+    sta.w tcc__r0
+    plp
+    rtl
+
+_msdy6:
+    lda 12,s
+    bra _msdy5
+
+;------------------------------------------------------------------------------
+; u16 mapSolidRectFree(u16 xpos, u16 ypos, u16 w, u16 h)
+;
+; 1 if no solid entry overlaps the w x h pixel rectangle at (xpos, ypos).
+; A rectangle reaching outside the map is not free.
+;------------------------------------------------------------------------------
+mapSolidRectFree:
+    php
+    phb
+    phx
+    phy
+
+    sep #$20
+    .ACCU 8
+    lda #$7e
+    pha
+    plb
+
+    ; cproc L-to-R: h(p4) SP+10, w(p3) SP+12, ypos(p2) SP+14, xpos(p1) SP+16
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda.w mapsolidcols
+    beq _msdr3                              ; No bitmap: not free
+    lda 10,s                                ; h
+    beq _msdr2
+    lda 12,s                                ; w
+    beq _msdr2
+    dec a
+    clc
+    adc 16,s                                ; Last pixel column
+    bcs _msdr3
+    jsr _msdShift
+    cmp.w mapsolidcols
+    bcs _msdr3
+    sta.w mapsolidc1
+    lda 16,s
+    jsr _msdShift
+    sta.w mapsolidc0
+
+    lda 10,s
+    dec a
+    clc
+    adc 14,s                                ; Last pixel row
+    bcs _msdr3
+    jsr _msdShift
+    cmp.w mapsolidrows
+    bcs _msdr3
+    sta.w mapsolidr
+    lda 14,s
+    jsr _msdShift
+
+_msdr1:
+    sta.w mapsolidy
+    asl a
+    tax
+    lda.w mapsolidrow,x
+    sta.w mapsolidbase
+    jsr _msdFirst
+    bcc _msdr3
+    lda.w mapsolidy
+    cmp.w mapsolidr
+    beq _msdr2
+    inc a
+    bra _msdr1
+
+_msdr2:
+    lda #1
+    bra _msdr4
+_msdr3:
+    lda #0
+_msdr4:
+    ply
+    plx
+    plb
+    sta.w tcc__r0
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u16 mapSolidReady(void)
+;
+; Map entries per bitmap row, 0 if mapSolidBuild has not built a bitmap.
+;------------------------------------------------------------------------------
+mapSolidReady:
+    rep #$20
+    .ACCU 16
+    lda.l mapsolidcols
+    rtl
+
+.ENDS
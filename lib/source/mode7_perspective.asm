@@ -0,0 +1,683 @@
+;==============================================================================
+; Mode 7 Perspective - per-scanline matrix tables for HDMA
+; OpenSNES - MIT License
+;==============================================================================
+;
+; Builds one M7A..M7D value per scanline from a camera height, pitch and yaw,
+; for a ground plane that recedes to a horizon (racing / flying views).
+;
+; For a screen row, d is the distance (in pixels, focal length 128) from the
+; horizon measured along the view direction:
+;
+;     d = 128 * sin(pitch) + (y - 112) * cos(pitch)
+;
+; The plane scale on that row is s = height / d texels per pixel, and with
+;
+;     A = D = s * cos(yaw)      B = -s * sin(yaw)      C = s * sin(yaw)
+;
+; (the same signs as mode7SetAngle) and the matrix centre on row
+; 112 + 128 * (1 - sin(pitch)) / cos(pitch), the D * (y - centre) term gives
+; each row its exact ground distance: the perspective needs no extra tables.
+; A = D, so one table feeds both M7A and M7D; four HDMA channels read three
+; tables.
+;
+; Each coefficient is (2 * height * |trig|) / d, one CPU divide per row and
+; per coefficient. The M7A/M7B multiplier of mode7SetAngle cannot be used
+; here: HDMA rewrites those registers every line while the tables are built.
+; d is kept in 1/256 line units and rounded to whole lines for the divider,
+; and rows closer than d = 2 to the horizon are left to the sky (the scale
+; there no longer fits M7A's 8.8 range).
+;
+; Rows above the horizon get a zero matrix: they show the single texel under
+; (x, y) of mode7PerspectiveSetCamera.
+;
+; Tables are double buffered in bank $7E. mode7PerspectiveUpdate builds the
+; hidden buffer; mode7PerspectiveSetCamera (in VBlank) shows it together with
+; its matrix centre.
+;
+; Cost (devtools/cyclecount/mode7_bench.py): about 142 cycles per ground
+; row, e.g. 15.8k cycles at pitch 0 (110 ground rows), 23.0k at pitch 16
+; (162 rows) and 31.4k when the ground fills the screen. Calls with unchanged
+; height, pitch and yaw return in under 100 cycles.
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+;------------------------------------------------------------------------------
+; Constants
+;------------------------------------------------------------------------------
+
+.EQU M7P_LINES          224         ; Visible scanlines
+.EQU M7P_TABLE          460         ; 2 sky entries + 2 ground blocks + 224 rows + end
+.EQU M7P_BUF            M7P_TABLE*3 ; Offset of buffer 1 from buffer 0
+.EQU M7P_PITCH_MAX      64          ; Straight down
+.EQU M7P_D_FLOOR        $0200       ; First ground row: d >= 2 lines
+.EQU M7P_MAX_CHANNEL    3           ; Up to channels 3-6; 7 is the OAM DMA
+
+; CPU math registers, as direct page offsets while D = $4200
+.EQU DP_WRMPYA          $02
+.EQU DP_WRMPYB          $03
+.EQU DP_WRDIV           $04
+.EQU DP_WRDIVB          $06
+.EQU DP_RDDIV           $14
+.EQU DP_RDMPY           $16
+
+;------------------------------------------------------------------------------
+; RAM
+;------------------------------------------------------------------------------
+
+.RAMSECTION ".mode7_perspective" BANK $7E SLOT 2
+    ; Buffer 0, then buffer 1 at +M7P_BUF with the same layout
+    m7p_ad:         dsb M7P_TABLE   ; M7A and M7D
+    m7p_b:          dsb M7P_TABLE   ; M7B
+    m7p_c:          dsb M7P_TABLE   ; M7C
+    m7p_buf1:       dsb M7P_BUF
+
+    m7p_height:     dsb 1           ; Last built (height and pitch adjacent)
+    m7p_pitch:      dsb 1
+    m7p_yaw:        dsb 1
+    m7p_dirty:      dsb 1           ; Build on the next update
+    m7p_pending:    dsb 1           ; Hidden buffer ready to show
+    m7p_chan:       dsw 1           ; First HDMA channel
+    m7p_mask:       dsw 1           ; HDMAEN bits of the four channels
+    m7p_front:      dsw 1           ; Buffer offset shown (0 or M7P_BUF)
+    m7p_centre:     dsw 1           ; Matrix centre row of the shown buffer
+    m7p_horizon:    dsw 1           ; First ground row of the shown buffer
+    m7p_next_centre: dsw 1          ; Same, for the hidden buffer
+    m7p_next_horizon: dsw 1
+
+    ; Build state
+    m7p_sin:        dsb 1           ; sin/cos(yaw), sin/cos(pitch)
+    m7p_cos:        dsb 1
+    m7p_sp:         dsb 1
+    m7p_cp:         dsb 1
+    m7p_ka:         dsw 1           ; 2 * height * |cos yaw|
+    m7p_kb:         dsw 1           ; 2 * height * |sin yaw|
+    m7p_sa:         dsw 1           ; $FFFF if cos yaw < 0
+    m7p_sc:         dsw 1           ; $FFFF if sin yaw < 0
+    m7p_step:       dsw 1           ; d per row, 1/256 lines
+    m7p_d0:         dsw 1           ; d on row 0 (signed)
+    m7p_d:          dsb 1           ; d of the current row, whole lines
+    m7p_left:       dsw 1           ; Rows still to write
+    m7p_count:      dsw 1           ; Rows in the current entry
+    m7p_end:        dsw 1           ; Table offset past the current block
+    m7p_index:      dsw 1           ; mode7PerspectiveInit channel loop
+.ENDS
+
+.SECTION ".mode7_perspective_data" SUPERFREE
+
+; mode7PerspectiveInit: destination register and table, per channel
+m7p_channels:
+    .dw $1B, m7p_ad             ; M7A
+    .dw $1C, m7p_b              ; M7B
+    .dw $1D, m7p_c              ; M7C
+    .dw $1E, m7p_ad             ; M7D
+
+.ENDS
+
+.SECTION ".mode7_perspective_code" SUPERFREE
+
+;------------------------------------------------------------------------------
+; mode7PerspectiveInit(u8 channel) - Set up channels channel..channel+3
+; Stack after php+phb: 6-7,s = channel
+;------------------------------------------------------------------------------
+mode7PerspectiveInit:
+    php
+    phb
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+
+    lda 6,s
+    and #$00FF
+    beq @bad_channel                ; Channel 0 is the general DMA channel
+    cmp #M7P_MAX_CHANNEL+1
+    bcc @channel_ok
+@bad_channel:
+    jmp @done
+@channel_ok:
+    pea $7E7E
+    plb
+    plb
+    sta m7p_chan
+    tax
+    lda #$000F
+    cpx #0
+    beq @mask_done
+@mask:
+    asl a
+    dex
+    bne @mask
+@mask_done:
+    sta m7p_mask
+
+    ; Buffer 0 shows empty tables until the first update
+    stz m7p_front
+    stz m7p_horizon
+    lda #112
+    sta m7p_centre
+    sep #$20
+    .ACCU 8
+    stz m7p_ad
+    stz m7p_b
+    stz m7p_c
+    stz m7p_pending
+    lda #1
+    sta m7p_dirty
+    rep #$20
+    .ACCU 16
+
+    ; hdmaSetupBank(channel + i, HDMA_MODE_1REG_2X, reg, table, $7E)
+    stz m7p_index
+@setup:
+    lda m7p_index
+    clc
+    adc m7p_chan
+    pha                         ; channel
+    pea $0002                   ; mode: 2 bytes to one register
+    lda m7p_index
+    asl a
+    asl a
+    tax
+    lda.l m7p_channels,x
+    pha                         ; destReg
+    pea $007E                   ; table bank word
+    lda.l m7p_channels+2,x
+    pha                         ; table low 16
+    pea $007E                   ; bank
+    jsl hdmaSetupBank
+    tsc
+    clc
+    adc #12
+    tcs
+    inc m7p_index
+    lda m7p_index
+    cmp #4
+    bne @setup
+
+    lda m7p_mask
+    pha
+    jsl hdmaEnable
+    pla
+
+@done:
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; mode7PerspectiveStop(void) - Disable the four channels
+;------------------------------------------------------------------------------
+mode7PerspectiveStop:
+    php
+    rep #$20
+    .ACCU 16
+    lda.l m7p_mask
+    pha
+    jsl hdmaDisable
+    pla
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; mode7PerspectiveUpdate(u8 height, u8 pitch, u8 yaw) - Build the hidden buffer
+; Stack after php+phb+phd: 8,s = yaw, 10,s = pitch, 12,s = height
+;------------------------------------------------------------------------------
+mode7PerspectiveUpdate:
+    php
+    phb
+    phd
+    sep #$20
+    .ACCU 8
+    rep #$10
+    .INDEX 16
+    lda #$7E
+    pha
+    plb
+
+    lda 10,s                    ; pitch, at most straight down
+    cmp #M7P_PITCH_MAX+1
+    bcc @pitch_ok
+    lda #M7P_PITCH_MAX
+@pitch_ok:
+    xba
+    lda 12,s
+    rep #$20
+    .ACCU 16
+    tay                         ; Y = height | pitch << 8
+    cmp m7p_height
+    bne @build
+    sep #$20
+    .ACCU 8
+    lda 8,s
+    cmp m7p_yaw
+    bne @build
+    lda m7p_dirty
+    bne @build
+    jmp @done
+
+@build:
+    sep #$20
+    .ACCU 8
+    sty m7p_height
+    lda 8,s
+    sta m7p_yaw
+    stz m7p_dirty
+    pea $4200
+    pld                         ; D = CPU math registers
+
+    ; sin/cos of yaw and pitch
+    rep #$20
+    .ACCU 16
+    lda m7p_yaw
+    and #$00FF
+    tax
+    sep #$20
+    .ACCU 8
+    lda.l m7_sincos_table,x
+    sta m7p_sin
+    txa
+    clc
+    adc #64
+    tax
+    lda.l m7_sincos_table,x
+    sta m7p_cos
+    lda m7p_pitch
+    tax
+    lda.l m7_sincos_table,x
+    sta m7p_sp
+    txa
+    clc
+    adc #64
+    tax
+    lda.l m7_sincos_table,x
+    sta m7p_cp
+
+    ; Ka = 2 * height * |cos yaw|, sign mask in m7p_sa
+    lda m7p_height
+    sta.b DP_WRMPYA
+    ldx #0
+    lda m7p_cos
+    bpl @cos_pos
+    eor #$FF
+    inc a
+    ldx #$FFFF
+@cos_pos:
+    sta.b DP_WRMPYB
+    stx m7p_sa
+    rep #$20
+    .ACCU 16
+    lda.b DP_RDMPY
+    asl a
+    sta m7p_ka
+
+    ; Kb = 2 * height * |sin yaw|, sign mask in m7p_sc
+    sep #$20
+    .ACCU 8
+    lda m7p_height
+    sta.b DP_WRMPYA
+    ldx #0
+    lda m7p_sin
+    bpl @sin_pos
+    eor #$FF
+    inc a
+    ldx #$FFFF
+@sin_pos:
+    sta.b DP_WRMPYB
+    stx m7p_sc
+    rep #$20
+    .ACCU 16
+    lda.b DP_RDMPY
+    asl a
+    sta m7p_kb
+
+    ; d0 = 256 * sin(pitch) - 224 * cos(pitch) + 0.5, step = 2 * cos(pitch)
+    sep #$20
+    .ACCU 8
+    lda m7p_cp
+    sta.b DP_WRMPYA
+    lda #M7P_LINES
+    sta.b DP_WRMPYB
+    rep #$20
+    .ACCU 16
+    lda m7p_cp
+    and #$00FF
+    asl a
+    sta m7p_step
+    ldy #0
+    lda m7p_sp
+    and #$00FF
+    xba
+    sec
+    sbc.b DP_RDMPY
+    clc
+    adc #$0080
+    sta m7p_d0
+
+    ; First ground row: ceil((M7P_D_FLOOR - d0) / step), none if past 223
+    bmi @rows_above
+    cmp #M7P_D_FLOOR
+    bcs @horizon_done
+@rows_above:
+    eor #$FFFF
+    sec
+    adc #M7P_D_FLOOR            ; M7P_D_FLOOR - d0
+    clc
+    adc m7p_step
+    dec a
+    sta.b DP_WRDIV
+    sep #$20
+    .ACCU 8
+    lda m7p_step                ; Not 0: d0 is already past the floor then
+    sta.b DP_WRDIVB
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    rep #$20
+    .ACCU 16
+    lda.b DP_RDDIV
+    tay
+    cpy #M7P_LINES
+    bcc @horizon_done
+    ldy #M7P_LINES
+@horizon_done:
+    sty m7p_next_horizon
+
+    ; Matrix centre row: 112 + 128 * (127 - sin(pitch)) / cos(pitch)
+    lda #127
+    sec
+    sbc m7p_sp
+    and #$00FF
+    xba
+    lsr a
+    sta.b DP_WRDIV
+    ldx #112
+    sep #$20
+    .ACCU 8
+    lda m7p_cp
+    beq @centre_done
+    sta.b DP_WRDIVB
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    rep #$20
+    .ACCU 16
+    lda.b DP_RDDIV
+    clc
+    adc #112
+    tax
+@centre_done:
+    rep #$20
+    .ACCU 16
+    stx m7p_next_centre
+
+    ;--------------------------------------------------------------------------
+    ; Sky: zero-matrix entries of up to 127 lines
+    ;--------------------------------------------------------------------------
+    lda m7p_front
+    eor #M7P_BUF
+    tax                         ; X = hidden buffer
+    sty m7p_left
+@sky:
+    lda m7p_left
+    beq @sky_done
+    cmp #128
+    bcc @sky_count
+    lda #127
+@sky_count:
+    sta m7p_count
+    lda m7p_left
+    sec
+    sbc m7p_count
+    sta m7p_left
+    lda m7p_count
+    sep #$20
+    .ACCU 8
+    sta m7p_ad,x
+    sta m7p_b,x
+    sta m7p_c,x
+    rep #$20
+    .ACCU 16
+    stz m7p_ad+1,x
+    stz m7p_b+1,x
+    stz m7p_c+1,x
+    inx
+    inx
+    inx
+    bra @sky
+@sky_done:
+
+    ; Ground: d on the first ground row
+    lda m7p_next_horizon
+    sep #$20
+    .ACCU 8
+    sta.b DP_WRMPYA
+    lda m7p_step
+    sta.b DP_WRMPYB
+    rep #$20
+    .ACCU 16
+    lda #M7P_LINES
+    sec
+    sbc m7p_next_horizon
+    sta m7p_left
+    lda m7p_d0
+    clc
+    adc.b DP_RDMPY
+    tay                         ; Y = d, 1/256 lines
+
+    ;--------------------------------------------------------------------------
+    ; Ground: repeat blocks of up to 127 rows
+    ;--------------------------------------------------------------------------
+@block:
+    lda m7p_left
+    bne @block_rows
+    jmp @end
+@block_rows:
+    cmp #128
+    bcc @block_count
+    lda #127
+@block_count:
+    sta m7p_count
+    lda m7p_left
+    sec
+    sbc m7p_count
+    sta m7p_left
+    lda m7p_count
+    ora #$0080
+    sep #$20
+    .ACCU 8
+    sta m7p_ad,x
+    sta m7p_b,x
+    sta m7p_c,x
+    rep #$20
+    .ACCU 16
+    inx
+    lda m7p_count
+    asl a
+    stx m7p_end
+    clc
+    adc m7p_end
+    sta m7p_end
+
+@row:
+    lda m7p_ka
+    sta.b DP_WRDIV
+    tya
+    xba                         ; A low = d, whole lines
+    sep #$20
+    .ACCU 8
+    sta.b DP_WRDIVB             ; Ka / d (16 cycles)
+    sta m7p_d
+    rep #$20
+    .ACCU 16
+    tya
+    clc
+    adc m7p_step
+    tay
+    lda.b DP_RDDIV
+    eor m7p_sa
+    sec
+    sbc m7p_sa
+    sta m7p_ad,x                ; M7A = M7D = s * cos
+
+    lda m7p_kb
+    sta.b DP_WRDIV
+    sep #$20
+    .ACCU 8
+    lda m7p_d
+    sta.b DP_WRDIVB             ; Kb / d
+    rep #$20
+    .ACCU 16
+    inx
+    inx
+    nop
+    nop
+    nop
+    nop
+    nop
+    lda.b DP_RDDIV
+    eor m7p_sc
+    sec
+    sbc m7p_sc
+    sta m7p_c-2,x               ; M7C = s * sin
+    eor #$FFFF
+    inc a
+    sta m7p_b-2,x               ; M7B = -s * sin
+    cpx m7p_end
+    bne @row
+    jmp @block
+
+@end:
+    sep #$20
+    .ACCU 8
+    stz m7p_ad,x
+    stz m7p_b,x
+    stz m7p_c,x
+    lda #1
+    sta m7p_pending
+
+@done:
+    pld
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; mode7PerspectiveSetCamera(s16 x, s16 y) - Place the camera, show new tables
+; Call in VBlank. Stack after php+phb: 6-7,s = y, 8-9,s = x
+;------------------------------------------------------------------------------
+mode7PerspectiveSetCamera:
+    php
+    phb
+    sep #$20
+    .ACCU 8
+    rep #$10
+    .INDEX 16
+    lda #$7E
+    pha
+    plb
+
+    lda m7p_pending
+    beq @registers
+    stz m7p_pending
+    rep #$20
+    .ACCU 16
+    lda m7p_front
+    eor #M7P_BUF
+    sta m7p_front
+    lda m7p_next_centre
+    sta m7p_centre
+    lda m7p_next_horizon
+    sta m7p_horizon
+
+    ; Point the four channels at the new buffer ($43x2, read at frame start)
+    lda m7p_chan
+    and #$00FF
+    asl a
+    asl a
+    asl a
+    asl a
+    clc
+    adc #$4300
+    tax
+    lda m7p_front
+    clc
+    adc #m7p_ad
+    sta.l $0002,x               ; M7A
+    sta.l $0032,x               ; M7D
+    adc #M7P_TABLE
+    sta.l $0012,x               ; M7B
+    adc #M7P_TABLE
+    sta.l $0022,x               ; M7C
+
+@registers:
+    rep #$20
+    .ACCU 16
+    lda 8,s                     ; Centre = camera: M7X = x, M7HOFS = x - 128
+    sep #$20
+    .ACCU 8
+    sta.l $211F
+    xba
+    sta.l $211F
+    rep #$20
+    .ACCU 16
+    lda 8,s
+    sec
+    sbc #128
+    sep #$20
+    .ACCU 8
+    sta.l $210D
+    xba
+    sta.l $210D
+
+    rep #$20
+    .ACCU 16
+    lda 6,s                     ; M7Y = y, M7VOFS = y - centre row
+    sep #$20
+    .ACCU 8
+    sta.l $2120
+    xba
+    sta.l $2120
+    rep #$20
+    .ACCU 16
+    lda 6,s
+    sec
+    sbc m7p_centre
+    sep #$20
+    .ACCU 8
+    sta.l $210E
+    xba
+    sta.l $210E
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; mode7PerspectiveGetHorizon(void) - First ground row of the shown tables
+;------------------------------------------------------------------------------
+mode7PerspectiveGetHorizon:
+    php
+    rep #$20
+    .ACCU 16
+    lda.l m7p_horizon
+    plp
+    rtl
+
+.ENDS
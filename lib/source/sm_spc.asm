@@ -4,7 +4,7 @@
 ;
 ; Pre-compiled SNESMOD SPC700 driver
 ; Original by mukunda
-; Binary size: 5522 bytes
+; Binary size: 5613 bytes (5522 + the 3-byte transfer loop)
 ;
 ; This driver runs on the SPC700 and provides:
 ;   - Impulse Tracker module playback
@@ -13,11 +13,16 @@
 ;   - Echo/reverb effects
 ;   - Volume fading
 ;
+; Local change: the transfer routine at $050E (module, sample and effect
+; uploads) moves 3 bytes per handshake instead of 2. Its entry replaces the
+; original loop in place; the loop itself (SM_SPC_xfer3) is appended at $1992,
+; below the module area at $1A00.
+;
 ;==============================================================================
 
 .SECTION ".sm_spc" SUPERFREE
 
-.define SM_SPC_SIZE $1592
+.define SM_SPC_SIZE $15ED
 
 SM_SPC:
 	.byte $CD, $00, $E8, $00, $AF, $C8, $F0, $D0, $FB, $8F, $00, $F5, $8F, $00, $F6, $8F, $00, $F7, $8F, $00, $F1, $8F, $FF, $FB, $8F, $FF, $14, $8F, $FF, $15, $3F, $6D
@@ -28,8 +33,9 @@ SM_SPC:
 	.byte $6F, $FA, $F5, $11, $E4, $F4, $00, $64, $F4, $D0, $F6, $28, $7F, $1C, $5D, $1F, $B6, $04, $FA, $11, $F5, $6F, $CE, $04, $3C, $05, $5D, $05, $6F, $05, $80, $05
 	.byte $86, $05, $8F, $05, $9E, $05, $AB, $05, $B5, $05, $C0, $05, $C6, $05, $3F, $A3, $06, $3F, $63, $04, $3F, $0E, $05, $8F, $00, $04, $69, $F5, $11, $F0, $FB, $FA
 	.byte $F5, $11, $78, $00, $F4, $F0, $0E, $EB, $04, $60, $98, $04, $04, $3F, $F8, $04, $3F, $0E, $05, $2F, $E5, $5F, $B2, $04, $E4, $00, $D6, $00, $02, $60, $84, $F6
-	.byte $D6, $02, $02, $E4, $01, $D6, $01, $02, $84, $F7, $D6, $03, $02, $6F, $F8, $11, $8D, $00, $D8, $F5, $3E, $F5, $F0, $FC, $F8, $F5, $E4, $F6, $D7, $00, $E4, $F7
-	.byte $D8, $F5, $FC, $D7, $00, $FC, $F0, $10, $C8, $00, $D0, $E8, $CB, $02, $60, $89, $02, $00, $98, $00, $01, $D8, $11, $6F, $AB, $01, $2F, $EC, $E4, $00, $EB, $10
+	; $0500-$053F: $050E is the 3-byte transfer entry (see SM_SPC_xfer3)
+	.byte $D6, $02, $02, $E4, $01, $D6, $01, $02, $84, $F7, $D6, $03, $02, $6F, $F8, $11, $D8, $F5, $BA, $00, $DA, $02, $C5, $9D, $19, $CC, $9E, $19, $3A, $02, $BA, $02
+	.byte $C5, $A2, $19, $CC, $A3, $19, $3A, $02, $BA, $02, $C5, $A9, $19, $CC, $AA, $19, $8D, $00, $5F, $92, $19, $00, $00, $00, $00, $00, $00, $00, $E4, $00, $EB, $10
 	.byte $D6, $00, $03, $60, $84, $F6, $D6, $02, $03, $E4, $01, $D6, $01, $03, $84, $F7, $D6, $03, $03, $60, $98, $04, $10, $3F, $0E, $05, $5F, $B2, $04, $E4, $F6, $8F
 	.byte $0C, $F2, $C4, $F3, $8F, $1C, $F2, $C4, $F3, $3F, $6E, $06, $5F, $B2, $04, $3F, $A3, $06, $E4, $F7, $38, $DF, $BF, $FA, $BF, $F6, $FA, $11, $F5, $5F, $AD, $06
 	.byte $3F, $A3, $06, $5F, $B2, $04, $FA, $F7, $14, $FA, $F7, $15, $5F, $B2, $04, $18, $80, $BF, $FA, $BF, $F6, $FA, $F7, $15, $FA, $F6, $16, $5F, $B2, $04, $8F, $6C
@@ -194,6 +200,49 @@ SM_SPC:
 	.byte $F0, $28, $C5, $A8, $18, $CC, $A9, $18, $BC, $F0, $23, $C5, $AF, $18, $CC, $B0, $18, $6F, $FC, $5F, $2C, $19, $FC, $5F, $35, $19, $FC, $5F, $3E, $19, $FC, $5F
 	.byte $47, $19, $FC, $5F, $50, $19, $FC, $5F, $59, $19, $FC, $5F, $62, $19, $FC, $5F, $6B, $19
 
+	; SM_SPC_xfer3 ($1992, after the original image): 3 bytes per handshake.
+	; Entry at $050E acks the request and patches the three store
+	; operands with the destination ($00/$01, +1, +2). Ports 0, 2, 3 carry
+	; data and port 1 the sync; port 1 = 0 ends the transfer, with the last
+	; 0-2 bytes in ports 2-3 and their count in port 0.
+SM_SPC_xfer3:
+	.byte $3E, $F5                  ; loop: cmp x, $F5
+	.byte $F0, $FC                  ;       beq loop
+	.byte $F8, $F5                  ;       mov x, $F5
+	.byte $F0, $23                  ;       beq tail
+	.byte $E4, $F4                  ;       mov a, $F4
+	.byte $D6, $00, $00             ;       mov !dest+y, a     (patched)
+	.byte $E4, $F6                  ;       mov a, $F6
+	.byte $D6, $00, $00             ;       mov !dest+1+y, a   (patched)
+	.byte $E4, $F7                  ;       mov a, $F7
+	.byte $D8, $F5                  ;       mov $F5, x         (ack)
+	.byte $D6, $00, $00             ;       mov !dest+2+y, a   (patched)
+	.byte $DD, $60, $88, $03, $FD   ;       y += 3
+	.byte $90, $E0                  ;       bcc loop
+	.byte $AC, $9E, $19             ;       inc !dest+1 (page) x3
+	.byte $AC, $A3, $19
+	.byte $AC, $AA, $19
+	.byte $2F, $D5                  ;       bra loop
+	.byte $DD, $60                  ; tail: $00/$01 = dest + y
+	.byte $85, $9D, $19
+	.byte $C4, $00
+	.byte $E5, $9E, $19
+	.byte $88, $00
+	.byte $C4, $01
+	.byte $8D, $00                  ;       mov y, #0
+	.byte $E4, $F4                  ;       mov a, $F4 (count)
+	.byte $F0, $0E                  ;       beq done
+	.byte $E4, $F6, $D7, $00, $FC   ;       mov [$00]+y, $F6 ; inc y
+	.byte $7E, $F4                  ;       cmp y, $F4
+	.byte $F0, $05                  ;       beq done
+	.byte $E4, $F7, $D7, $00, $FC   ;       mov [$00]+y, $F7 ; inc y
+	.byte $D8, $F5                  ; done: mov $F5, x (ack)
+	.byte $CB, $02, $60             ;       $00/$01 += y
+	.byte $89, $02, $00
+	.byte $98, $00, $01
+	.byte $D8, $11                  ;       mov $11, x
+	.byte $6F                       ;       ret
+
 SM_SPC_end:
 
 .ENDS
@@ -79,6 +79,11 @@
 .define CMD_PAUSE       $0A
 .define CMD_RESUME      $0B
 
+; Command FIFO fill limits in bytes. Game commands stop one entry short of
+; the ring's 84, so the CMD_PLAY ending an async load always fits.
+.define SPC_FIFO_MAX    252
+.define SPC_FIFO_GAME   SPC_FIFO_MAX-3
+
 ;==============================================================================
 ; Constants
 ;==============================================================================
@@ -86,6 +91,11 @@
 .define PROCESS_TIME    5       ; Process for 5 scanlines
 .define INIT_DATACOPY   13
 .define SPC_BOOT        $0400   ; SPC entry/load address
+.define LOAD_BUDGET     384     ; Default bytes per snesmodProcess, ~7 ms
+
+.define LD_IDLE         0       ; Module load phases
+.define LD_DATA         1       ; Sending module or source data
+.define LD_NEXT         2       ; Announcing the next source
 
 ;==============================================================================
 ; Zero Page Variables ($0040-$007F reserved for SNESMOD)
@@ -122,6 +132,18 @@ digi_remain:    DSB 2
 digi_active:    DSB 1
 digi_copyrate:  DSB 1
 
+; Time-sliced module load (snesmodLoadModuleAsync)
+spc_ld_phase:   DSB 1           ; LD_IDLE / LD_DATA / LD_NEXT
+spc_ld_y:       DSB 2           ; Data pointer of the current transfer
+spc_ld_bank:    DSB 1
+spc_ld_left:    DSB 2           ; Bytes left in the current transfer
+spc_ld_list:    DSB 3           ; Next entry of the module's source list
+spc_ld_count:   DSB 2           ; Sources not announced yet
+spc_ld_rest:    DSB 2           ; Their total size in bytes
+spc_ld_budget:  DSB 2           ; Bytes per snesmodProcess call
+spc_ld_quota:   DSB 2           ; Bytes left in the current call
+spc_ld_play:    DSB 2           ; Start position when done, $FFFF = none
+
 .ENDS
 
 ;==============================================================================
@@ -130,7 +152,7 @@ digi_copyrate:  DSB 1
 
 .RAMSECTION ".snesmod_fifo" BANK 0 SLOT 1 ORGA $0600 FORCE
 
-spc_fifo:       DSB 256         ; 256-byte command queue
+spc_fifo:       DSB 256         ; 256-byte command queue (3 bytes per command)
 
 .ENDS
 
@@ -261,6 +283,14 @@ snesmodInit:
     stz digi_active
     stz digi_copyrate
 
+    stz spc_ld_phase
+    rep #$20
+    .ACCU 16
+    lda #LOAD_BUDGET
+    sta spc_ld_budget
+    sep #$20
+    .ACCU 8
+
     ; Clear FIFO (all 256 bytes)
     sep #$10            ; 8-bit X so INX wraps 255->0
     .INDEX 8
@@ -318,6 +348,14 @@ snesmodSetSoundbank:
 +:
 .endm
 
+.macro incbyte
+    iny
+    bmi +
+    inc spc_ptr+2
+    ldy #$8000
++:
+.endm
+
 ;------------------------------------------------------------------------------
 ; snesmodLoadModule - Load a module from the soundbank
 ;------------------------------------------------------------------------------
@@ -340,44 +378,211 @@ snesmodLoadModule:
     sep #$20
     .ACCU 8
 
-    phx                         ; Flush FIFO first
-    jsr xspcFlush
-    plx
+    jsr load_begin
+    jsr load_finish
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; snesmodLoadModuleAsync - Start a time-sliced module load
+;------------------------------------------------------------------------------
+; void snesmodLoadModuleAsync(u16 moduleId, u16 startPosition);
+; Stack: 6,s = startPosition, 8,s = moduleId
+;
+; snesmodProcess then sends at most spc_ld_budget bytes per call and queues
+; CMD_PLAY once the last source is in ($FFFF = don't play).
+;------------------------------------------------------------------------------
+snesmodLoadModuleAsync:
+    php
+    phb
+    sep #$20
+    .ACCU 8
+    lda #$0
+    pha
+    plb
+
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda 8,s                     ; module_id
+    tax
+    sep #$20
+    .ACCU 8
+
+    jsr load_begin
+
+    rep #$20
+    .ACCU 16
+    lda 6,s                     ; startPosition
+    sta spc_ld_play
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; snesmodLoadRemaining - Bytes left in a time-sliced load
+;------------------------------------------------------------------------------
+; u16 snesmodLoadRemaining(void);
+; Returns 0 once the load is done, never 0 while it runs.
+;------------------------------------------------------------------------------
+snesmodLoadRemaining:
+    php
+    phb
+    sep #$20
+    .ACCU 8
+    lda #$0
+    pha
+    plb
+
+    lda spc_ld_phase
+    rep #$20
+    .ACCU 16
+    beq @idle
+    lda spc_ld_rest
+    clc
+    adc spc_ld_left
+    bne @exit
+    ina                         ; Only the end message left
+    bra @exit
+@idle:
+    lda #0
+@exit:
+    sta tcc__r0
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; snesmodSetLoadBudget - Bytes sent per snesmodProcess during a load
+;------------------------------------------------------------------------------
+; void snesmodSetLoadBudget(u16 bytes);
+;------------------------------------------------------------------------------
+snesmodSetLoadBudget:
+    php
+    phb
+    sep #$20
+    .ACCU 8
+    lda #$0
+    pha
+    plb
 
+    rep #$20
+    .ACCU 16
+    lda 6,s                     ; bytes
+    cmp #3                      ; At least one handshake
+    bcs +
+    lda #3
++:  sta spc_ld_budget
+
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; load_begin - Send CMD_LOAD and set up the load state
+;------------------------------------------------------------------------------
+; X = module id. A load still in progress is completed first (without its
+; autoplay). The total size of the module's sources is summed up front so
+; snesmodLoadRemaining can report it.
+;------------------------------------------------------------------------------
+load_begin:
+    ldy #$FFFF                  ; No autoplay unless the caller sets it
+    sty spc_ld_play
     phx
+    jsr load_finish
+    jsr xspcFlush               ; Flush FIFO first
+    plx
+
     ldy #SB_MODTABLE
     sty spc2
     jsr get_address
 
     rep #$20
     .ACCU 16
-    lda [spc_ptr], y            ; X = MODULE SIZE
-    tax
+    lda [spc_ptr], y            ; Module size (words -> bytes)
+    asl
+    sta spc_ld_left
 
     incptr
 
-    lda [spc_ptr], y            ; Read SOURCE LIST SIZE
+    lda [spc_ptr], y            ; Source list size
+    sta spc_ld_count
 
     incptr
 
-    sty spc1                    ; pointer += listsize*2
+    sty spc_ld_list             ; List, then module data at list + size*2
+    sep #$20
+    .ACCU 8
+    lda spc_ptr+2
+    sta spc_ld_list+2
+    rep #$20
+    .ACCU 16
+    lda spc_ld_count
     asl
-    adc spc1
+    adc spc_ld_list
     bmi +
     ora #$8000
     inc spc_ptr+2
-+:  tay
++:  sta spc_ld_y
+    stz spc_ld_rest
+    sep #$20
+    .ACCU 8
+    lda spc_ptr+2
+    sta spc_ld_bank
+
+    ldx spc_ld_count            ; Sum the source lengths
+    beq @sized
+    ldy spc_ld_list
+    lda spc_ld_list+2
+    sta spc_ptr+2
 
+@size:
+    rep #$20
+    .ACCU 16
+    lda [spc_ptr], y            ; Source index
+    incptr
+    phy
+    phx
+    tax
     sep #$20
     .ACCU 8
-    lda spc_v                   ; Wait for SPC
+    lda spc_ptr+2
     pha
+
+    ldy #SB_SRCTABLE
+    sty spc2
+    jsr get_address
+
+    rep #$20
+    .ACCU 16
+    lda [spc_ptr], y            ; Length, rounded up to words
+    ina
+    and #$FFFE
+    clc
+    adc spc_ld_rest
+    sta spc_ld_rest
+    sep #$20
+    .ACCU 8
+
+    pla
+    sta spc_ptr+2
+    plx
+    ply
+    dex
+    bne @size
+
+@sized:
+    lda spc_v                   ; Wait for SPC
 -:  cmp REG_APUIO1
     bne -
 
     lda #CMD_LOAD               ; Send LOAD message
     sta REG_APUIO0
-    pla
+    lda spc_v
     eor #$80
     ora #$01
     sta spc_v
@@ -386,47 +591,48 @@ snesmodLoadModule:
 -:  cmp REG_APUIO1              ; Wait for SPC
     bne -
 
-    jsr do_transfer
-
-    ; Transfer sources
-    plx
-    ldy #SB_MODTABLE
-    sty spc2
-    jsr get_address
-    incptr
-
-    rep #$20
-    .ACCU 16
-    lda [spc_ptr], y            ; x = number of sources
-    tax
-
-    incptr
-
-@transfer_sources:
-    lda [spc_ptr], y            ; Read source index
-    sta spc1
-
-    incptr
+    lda #LD_DATA
+    sta spc_ld_phase
+    rts
 
-    phy                         ; Push memory pointer and counter
-    sep #$20
-    .ACCU 8
-    lda spc_ptr+2
-    pha
-    phx
+;------------------------------------------------------------------------------
+; load_finish - Run a load in progress to completion
+;------------------------------------------------------------------------------
+load_finish:
+    lda spc_ld_phase
+    beq @exit
+    ldy #$FFFF                  ; No budget
+    sty spc_ld_quota
+    jsr load_step
+    bra load_finish
+@exit:
+    rts
 
-    jsr transfer_source
+;------------------------------------------------------------------------------
+; load_step - Advance the load by up to spc_ld_quota bytes
+;------------------------------------------------------------------------------
+load_step:
+    lda spc_ld_phase
+    beq @exit
+    cmp #LD_NEXT
+    beq @next
 
-    plx                         ; Pull memory pointer and counter
-    pla
-    sta spc_ptr+2
-    ply
+    jsr load_data
+    bcs @exit                   ; Budget used up
+    lda #LD_NEXT
+    sta spc_ld_phase
+    bra load_step
 
+@next:
+    ldx spc_ld_count
+    beq @end
     dex
-    bne @transfer_sources
+    stx spc_ld_count
+    jsr load_source
+    bra load_step
 
-    ; End transfers
-    stz REG_APUIO0
+@end:
+    stz REG_APUIO0              ; End transfers
     lda spc_v
     eor #$80
     sta spc_v
@@ -436,16 +642,40 @@ snesmodLoadModule:
 
     sta spc_pr+1
     stz spc_sfx_next            ; Reset SFX counter
+    stz spc_ld_phase
 
-    plb
-    plp
-    rtl
+    ldy spc_ld_play             ; Autoplay
+    iny
+    beq @exit
+    stz spc1
+    lda spc_ld_play
+    sta spc1+1
+    lda #CMD_PLAY
+    jsr spc_queue
+
+@exit:
+    rts
 
 ;------------------------------------------------------------------------------
-; transfer_source - Transfer a single source
+; load_source - Announce the next source of the module's list
 ;------------------------------------------------------------------------------
-transfer_source:
-    ldx spc1
+load_source:
+    ldy spc_ld_list             ; Read source index
+    lda spc_ld_list+2
+    sta spc_ptr+2
+    stz spc_ptr
+    stz spc_ptr+1
+    rep #$20
+    .ACCU 16
+    lda [spc_ptr], y
+    tax
+    sep #$20
+    .ACCU 8
+    incptr
+    sty spc_ld_list
+    lda spc_ptr+2
+    sta spc_ld_list+2
+
     ldy #SB_SRCTABLE
     sty spc2
     jsr get_address
@@ -454,16 +684,23 @@ transfer_source:
     sta REG_APUIO0
     rep #$20
     .ACCU 16
-    lda [spc_ptr], y            ; x = length (bytes->words)
+    lda [spc_ptr], y            ; Length, rounded up to words
     incptr
     ina
-    lsr
-    tax
+    and #$FFFE
+    sta spc_ld_left
+    lda spc_ld_rest
+    sec
+    sbc spc_ld_left
+    sta spc_ld_rest
     lda [spc_ptr], y            ; Port2,3 = loop point
     sta REG_APUIO2
     incptr
+    sty spc_ld_y
     sep #$20
     .ACCU 8
+    lda spc_ptr+2
+    sta spc_ld_bank
 
     lda spc_v                   ; Send message
     eor #$80
@@ -474,37 +711,100 @@ transfer_source:
 -:  cmp REG_APUIO1              ; Wait for SPC
     bne -
 
-    cpx #0
-    beq end_transfer
-    bra do_transfer
+    lda #LD_DATA
+    sta spc_ld_phase
+    rts
 
 ;------------------------------------------------------------------------------
-; transfer_again / do_transfer - Data transfer loop
+; load_data - Data transfer loop
 ;------------------------------------------------------------------------------
-transfer_again:
-    eor #$80
-    sta REG_APUIO1
-    sta spc_v
-    incptr
+; Sends spc_ld_left bytes from spc_ld_bank:spc_ld_y, stopping early when
+; spc_ld_quota runs out (carry set, position saved for the next call; carry
+; clear once the transfer is done). Ports 0, 2 and 3 carry 3 bytes per
+; handshake, port 1 the sync. The last 0-2 bytes go with port 1 = 0 and
+; their count in port 0. The next 3 bytes are fetched while the SPC stores
+; the previous ones.
+;------------------------------------------------------------------------------
+load_data:
+    ldx spc_ld_left
+    ldy spc_ld_y
+    lda spc_ld_bank
+    sta spc_ptr+2
+    stz spc_ptr
+    stz spc_ptr+1
+    cpx #3
+    bcc @last
 
--:  cmp REG_APUIO1
+@next:
+    rep #$20                    ; Carry set here
+    .ACCU 16
+    lda spc_ld_quota
+    sbc #3
+    bcc @pause
+    sta spc_ld_quota
+    sep #$20
+    .ACCU 8
+
+    lda [spc_ptr], y            ; Port0 byte
+    sta spc2
+    incbyte
+    lda [spc_ptr], y            ; Port2,3 bytes
+    sta spc1
+    incbyte
+    lda [spc_ptr], y
+    sta spc1+1
+    incbyte
+
+    lda spc_v
+-:  cmp REG_APUIO1              ; Wait for the previous ack
     bne -
 
-do_transfer:
-    rep #$20                    ; Transfer 1 word
+    lda spc2
+    sta REG_APUIO0
+    rep #$20
     .ACCU 16
-    lda [spc_ptr], y
+    lda spc1
     sta REG_APUIO2
     sep #$20
     .ACCU 8
     lda spc_v
+    eor #$80
+    sta spc_v
+    sta REG_APUIO1
+
+    dex
     dex
-    bne transfer_again
+    dex
+    cpx #3
+    bcs @next
 
-    incptr
+@last:
+    cpx #0                      ; Last 0-2 bytes
+    beq @end
+    lda [spc_ptr], y
+    sta spc1
+    incbyte
+    cpx #1
+    beq @end
+    lda [spc_ptr], y
+    sta spc1+1
+    incbyte
 
-end_transfer:
-    lda #0                      ; Final word transferred
+@end:
+    lda spc_v
+-:  cmp REG_APUIO1
+    bne -
+
+    txa                         ; Port0 = byte count
+    sta REG_APUIO0
+    rep #$20
+    .ACCU 16
+    lda spc1
+    sta REG_APUIO2
+    stz spc_ld_left
+    sep #$20
+    .ACCU 8
+    lda #0                      ; Final bytes transferred
     sta REG_APUIO1              ; Write p1=0 to terminate
     sta spc_v
 
@@ -512,6 +812,17 @@ end_transfer:
     bne -
 
     sta spc_pr+1
+    clc
+    rts
+
+@pause:
+    sep #$20
+    .ACCU 8
+    stx spc_ld_left
+    sty spc_ld_y
+    lda spc_ptr+2
+    sta spc_ld_bank
+    sec
     rts
 
 ;------------------------------------------------------------------------------
@@ -569,6 +880,10 @@ snesmodLoadEffect:
     sep #$20
     .ACCU 8
 
+    phx                         ; Ports are busy until a load is done
+    jsr load_finish
+    plx
+
     ldy #SB_SRCTABLE
     sty spc2
     jsr get_address
@@ -590,16 +905,21 @@ snesmodLoadEffect:
 
     rep #$20
     .ACCU 16
-    lda [spc_ptr], y            ; x = length (bytes->words)
+    lda [spc_ptr], y            ; Length, rounded up to words
     ina
-    lsr
+    and #$FFFE
+    sta spc_ld_left
     incptr
-    tax
     incptr                      ; Skip loop
+    sty spc_ld_y
+    lda #$FFFF                  ; No budget
+    sta spc_ld_quota
     sep #$20
     .ACCU 8
+    lda spc_ptr+2
+    sta spc_ld_bank
 
-    jsr do_transfer
+    jsr load_data
 
     lda spc_sfx_next            ; Return SFX index
     inc spc_sfx_next
@@ -615,12 +935,37 @@ snesmodLoadEffect:
 ; QueueMessage - Queue a message to the SPC
 ;------------------------------------------------------------------------------
 ; A = id, spc1 = params
+;
+; Dropped when SPC_FIFO_GAME bytes are already queued (e.g. while an async
+; load holds the ports).
 ;------------------------------------------------------------------------------
 QueueMessage:
+    pha
+    lda spc_fwrite
+    sec
+    sbc spc_fread               ; Bytes queued
+    cmp #SPC_FIFO_GAME-2
+    pla
+    bcs +                       ; Full: drop the command
+    jsr spc_queue
++
+    plb
+    plp
+    rtl
+
+; Drops the command if the ring already holds SPC_FIFO_MAX bytes
+spc_queue:
     sei                         ; Disable IRQ
 
     sep #$10
     .INDEX 8
+    pha
+    lda spc_fwrite
+    sec
+    sbc spc_fread               ; Bytes queued
+    cmp #SPC_FIFO_MAX-2
+    pla
+    bcs @full
     ldx spc_fwrite
     sta.w spc_fifo, x
     inx
@@ -631,14 +976,12 @@ QueueMessage:
     sta.w spc_fifo, x
     inx
     stx spc_fwrite
+@full:
     rep #$10
     .INDEX 16
 
     cli
-
-    plb
-    plp
-    rtl
+    rts
 
 ;------------------------------------------------------------------------------
 ; snesmodFlush - Wait for command queue to empty
@@ -654,6 +997,10 @@ snesmodFlush:
     pha
     plb
 
+    rep #$10
+    .INDEX 16
+    jsr load_finish
+
 @flush_loop:
     lda spc_fread
     cmp spc_fwrite
@@ -748,6 +1095,20 @@ snesmodProcess:
     pha
     plb
 
+    lda spc_ld_phase            ; Time-sliced module load
+    beq @no_load
+    rep #$10
+    .INDEX 16
+    ldy spc_ld_budget
+    sty spc_ld_quota
+    jsr load_step
+    lda spc_ld_phase            ; The ports stay busy until it is done
+    beq @no_load
+    plb
+    plp
+    rtl
+
+@no_load:
     lda digi_active
     beq spcProcessMessages
     jsr spcProcessStream
@@ -1161,6 +1522,10 @@ snesmodAllocateSoundRegion:
     pha
     plb
 
+    rep #$10
+    .INDEX 16
+    jsr load_finish
+
     lda 6,s                     ; Size of buffer
     pha
     jsr xspcFlush
@@ -32,6 +32,10 @@
  */
 /* oamMemory[] and oam_update_flag are declared in <snes/system.h> (via <snes.h>) */
 extern u8 oam_max_id; /* Defined in crt0.asm - highest sprite ID written */
+extern u16 oam_dma_count; /* crt0.asm - sprites the NMI sends (active window) */
+extern u16 oam_dma_sent;  /* crt0.asm - window size at the last OAM DMA */
+extern u16 oam_range_over; /* crt0.asm - frames with >32 sprites on a line */
+extern u16 oam_time_over;  /* crt0.asm - frames with >34 sprite tiles on a line */
 #define oam_buffer oamMemory
 
 /* Update oam_max_id tracking (inline to avoid function call overhead) */
@@ -229,9 +233,37 @@ void oamClear(void) {
     }
 
     oam_max_id = 127;  /* Force full OAM DMA to clear all sprites */
+    oam_dma_sent = MAX_SPRITES;
     oam_update_flag = 1;
 }
 
+void oamSetActiveCount(u8 count) {
+    u16 i;
+
+    if (count > MAX_SPRITES) count = MAX_SPRITES;
+
+    /* Sprites leaving the window are hidden once; the NMI still sends the
+     * old window on the next DMA (oam_dma_sent) so the hide reaches OAM. */
+    for (i = count; i < oam_dma_count; i++) {
+        oamHide((u8)i);
+    }
+    oam_dma_count = count;
+    oam_update_flag = 1;
+}
+
+u16 oamGetRangeOverFrames(void) {
+    return oam_range_over;
+}
+
+u16 oamGetTimeOverFrames(void) {
+    return oam_time_over;
+}
+
+void oamResetOverflowCounters(void) {
+    oam_range_over = 0;
+    oam_time_over = 0;
+}
+
 /*============================================================================
  * Metasprite Functions
  *============================================================================*/
@@ -0,0 +1,417 @@
+;==============================================================================
+; OpenSNES - Depth-sorted metasprite batch
+;==============================================================================
+; oamBatchAdd() queues metasprite draw calls for the frame, each with a depth
+; key. oamBatchDraw() walks the keys from front (255) to back (0) and writes
+; every on-screen item into consecutive OAM slots in one loop, so objects in
+; front get the lower OAM IDs and are drawn on top.
+;
+; Sorting is a bucket sort: key >> 3 picks one of 32 singly linked lists, so
+; adding is O(1) and drawing visits each entry once. Inside a bucket the last
+; entry added comes first.
+;
+; The item attribute byte of a MetaspriteItem already has the OAM layout
+; (vhoopp p-), so each sprite costs a few loads and stores instead of an
+; oamSet() call. High-table bits are gathered for 4 sprites at a time and
+; written as one byte; the size bit of each entry is precomputed by
+; oamBatchAdd().
+;
+; Calling convention (cc65816, left-to-right push, 2-byte slots for u8/u16,
+; 4 bytes for pointers), see the stack layout of each function.
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+.EQU OAM_BATCH_MAX      32      ; Draw calls per frame (OAM_BATCH_MAX in sprite.h)
+.EQU OAM_BATCH_BUCKETS  32      ; key >> 3
+.EQU OAM_HIDE_Y         240     ; OBJ_HIDE_Y
+.EQU META_END           $FF80   ; metasprite_end (-128)
+
+;------------------------------------------------------------------------------
+; State (bank $00, zeroed at boot)
+;------------------------------------------------------------------------------
+.RAMSECTION ".oam_batch_bank00" BANK 0 SLOT 1
+    oam_batch_count     dsb 2   ; Queued entries * 2
+    oam_batch_first     dsb 2   ; First OAM slot * 4 (multiple of 16)
+    oam_batch_end       dsb 2   ; OAM offset after the last group written
+.ENDS
+
+;------------------------------------------------------------------------------
+; Queue (bank $7E), one word per entry in each array
+;------------------------------------------------------------------------------
+.RAMSECTION ".oam_batch_bank7e" BANK $7E SLOT 2
+    oam_batch_x         dsw OAM_BATCH_MAX   ; Origin X
+    oam_batch_y         dsw OAM_BATCH_MAX   ; Origin Y
+    oam_batch_meta      dsw OAM_BATCH_MAX   ; MetaspriteItem array, LOW
+    oam_batch_bank      dsw OAM_BATCH_MAX   ; MetaspriteItem array, bank
+    oam_batch_tile      dsw OAM_BATCH_MAX   ; Base tile
+    oam_batch_attr      dsw OAM_BATCH_MAX   ; Low: base palette << 1, high: $80 if large
+    oam_batch_next      dsw OAM_BATCH_MAX   ; Next entry * 2 in the bucket, $FFFF = end
+    oam_batch_head      dsw OAM_BATCH_BUCKETS ; First entry * 2 per bucket, $FFFF = empty
+.ENDS
+
+.SECTION ".text.oamBatch" SUPERFREE
+
+;------------------------------------------------------------------------------
+; void oamBatchBegin(u8 firstId)
+;
+; Stack layout (after PHP):
+;   5-6,s = firstId
+;
+; Empties the queue. firstId is rounded up to a multiple of 4 so the batch
+; owns whole high-table bytes.
+;------------------------------------------------------------------------------
+oamBatchBegin:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda 5,s                         ; firstId
+    and #$00FF
+    clc
+    adc #3
+    cmp #128
+    bcc +
+    lda #128
++   and #$00FC
+    asl a
+    asl a
+    sta.l oam_batch_first           ; OAM low-table offset
+
+    lda #0
+    sta.l oam_batch_count
+    lda #$FFFF
+    ldx #(OAM_BATCH_BUCKETS-1)*2
+-   sta.l oam_batch_head,x
+    dex
+    dex
+    bpl -
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u8 oamBatchAdd(s16 x, s16 y, u8 key, const MetaspriteItem *meta,
+;                u16 baseTile, u8 basePalette, u8 size)
+;
+; Stack layout (after PHP):
+;   5-6,s   = size
+;   7-8,s   = basePalette
+;   9-10,s  = baseTile
+;   11-12,s = meta LOW
+;   13,s    = meta bank byte
+;   14,s    = pad
+;   15-16,s = key
+;   17-18,s = y
+;   19-20,s = x
+;
+; Returns 1 if queued, 0 if the queue is full.
+;------------------------------------------------------------------------------
+oamBatchAdd:
+    php
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda.l oam_batch_count
+    cmp #OAM_BATCH_MAX*2
+    bcc +
+    lda #0                          ; Full
+    plp
+    rtl
++   tax                             ; X = entry * 2
+    inc a
+    inc a
+    sta.l oam_batch_count
+
+    lda 19,s                        ; x
+    sta.l oam_batch_x,x
+    lda 17,s                        ; y
+    sta.l oam_batch_y,x
+    lda 11,s                        ; meta LOW
+    sta.l oam_batch_meta,x
+    lda 13,s                        ; meta bank byte
+    and #$00FF
+    sta.l oam_batch_bank,x
+    lda 9,s                         ; baseTile
+    sta.l oam_batch_tile,x
+    lda 7,s                         ; basePalette
+    and #$0007
+    asl a                           ; OAM palette bits 1-3
+    sta.b tcc__r9
+    lda 5,s                         ; size
+    and #$00FF
+    beq +
+    lda #$8000                      ; High-table size bit, pre-shifted
++   ora.b tcc__r9
+    sta.l oam_batch_attr,x
+
+    ; Push the entry on its bucket list
+    txy
+    lda 15,s                        ; key
+    and #$00F8
+    lsr a
+    lsr a                           ; (key >> 3) * 2
+    tax
+    lda.l oam_batch_head,x
+    sta.b tcc__r9
+    tya
+    sta.l oam_batch_head,x
+    tyx
+    lda.b tcc__r9
+    sta.l oam_batch_next,x
+
+    lda #1
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; u8 oamBatchDraw(void)
+;
+; Writes the queued metasprites to OAM from the oamBatchBegin() slot on,
+; highest key first, and hides the slots the previous draw used beyond the
+; new end. Stops at sprite 127.
+;
+; Returns the number of hardware sprites written.
+;
+; DP usage (main thread, D = 0):
+;   tcc__r1  = entry X        tcc__r1h = entry Y
+;   tcc__r2  = base tile      tcc__r2h = entry attr (palette, size bit)
+;   tcc__r3  = OAM offset while X holds an entry
+;   tcc__r3h = high-table bits of the current group of 4
+;   tcc__r4  = current entry * 2          tcc__r4h = bucket * 2
+;   tcc__r5  = sprite X       tcc__r9  = sprite Y, then tile
+;   tcc__r10 = tile bit 8
+;------------------------------------------------------------------------------
+oamBatchDraw:
+    php
+    phb
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    stz.b tcc__r3h
+    lda.l oam_batch_first
+    tax                             ; X = OAM low-table offset
+    lda #(OAM_BATCH_BUCKETS-1)*2
+    sta.b tcc__r4h
+
+@bucket:
+    stx.b tcc__r3
+    ldx.b tcc__r4h
+    lda.l oam_batch_head,x
+    ldx.b tcc__r3
+
+@entry:
+    cmp #$FFFF
+    bne +
+    jmp @bucket_next                ; End of this bucket's list
++
+    stx.b tcc__r3
+    tax
+    stx.b tcc__r4
+    lda.l oam_batch_x,x
+    sta.b tcc__r1
+    lda.l oam_batch_y,x
+    sta.b tcc__r1h
+    lda.l oam_batch_tile,x
+    sta.b tcc__r2
+    lda.l oam_batch_attr,x
+    sta.b tcc__r2h
+    lda.l oam_batch_meta,x
+    tay                             ; Y = first item
+    sep #$20
+    .ACCU 8
+    lda.l oam_batch_bank,x
+    pha
+    plb                             ; DB = metasprite bank: items read with abs,y
+    rep #$20
+    .ACCU 16
+    ldx.b tcc__r3
+
+@item:
+    lda.w $0000,y                   ; dx
+    cmp #META_END
+    bne +
+    jmp @entry_done
++
+    clc
+    adc.b tcc__r1
+    sta.b tcc__r5                   ; sx
+    clc
+    adc #63
+    cmp #63+256                     ; -64 < sx < 256
+    bcc +
+    jmp @item_next
++
+    lda.w $0002,y                   ; dy
+    clc
+    adc.b tcc__r1h
+    sta.b tcc__r9                   ; sy
+    clc
+    adc #63
+    cmp #63+240                     ; -64 < sy < 240
+    bcc +
+    jmp @item_next
++   cpx #512
+    bcc +
+    jmp @full                       ; OAM full
++
+
+    sep #$20
+    .ACCU 8
+    lda.b tcc__r5
+    sta.l oamMemory,x               ; X low
+    lda.b tcc__r9
+    dec a                           ; OAM_Y = N renders from line N+1
+    sta.l oamMemory+1,x
+    rep #$20
+    .ACCU 16
+    lda.w $0004,y                   ; Tile offset
+    clc
+    adc.b tcc__r2
+    sta.b tcc__r9
+    xba
+    and #$0001
+    sta.b tcc__r10                  ; Tile bit 8 = OAM attr bit 0
+    sep #$20
+    .ACCU 8
+    lda.b tcc__r9
+    sta.l oamMemory+2,x
+    lda.w $0006,y                   ; Item attr: vhoopp p- (OAM layout)
+    and #$FE
+    bit #$0E
+    bne +
+    ora.b tcc__r2h                  ; Palette 0: use the base palette
++   ora.b tcc__r10
+    sta.l oamMemory+3,x
+
+    ; High table: shift the group down one sprite, new sprite in bits 6-7
+    lda.b tcc__r3h
+    lsr a
+    lsr a
+    ora.b tcc__r2h+1                ; Size bit ($80)
+    sta.b tcc__r3h
+    lda.b tcc__r5+1                 ; sx high byte: bit 0 = X bit 8
+    lsr a
+    bcc +
+    lda.b tcc__r3h
+    ora #$40
+    sta.b tcc__r3h
++   rep #$20
+    .ACCU 16
+    jsr _oam_batch_advance
+
+@item_next:
+    tya
+    clc
+    adc #8                          ; sizeof(MetaspriteItem)
+    tay
+    jmp @item
+
+@entry_done:
+    stx.b tcc__r3
+    ldx.b tcc__r4
+    lda.l oam_batch_next,x
+    ldx.b tcc__r3
+    jmp @entry
+
+@bucket_next:
+    lda.b tcc__r4h
+    sec
+    sbc #2
+    sta.b tcc__r4h
+    bmi @full
+    jmp @bucket
+
+@full:
+    ; Sprites written, then hide up to the end of the last group of 4
+    txa
+    sec
+    sbc.l oam_batch_first
+    lsr a
+    lsr a
+    sta.b tcc__r5
+-   txa
+    and #$000F
+    beq +
+    jsr _oam_batch_hide
+    bra -
++   stx.b tcc__r4
+
+    ; Hide what the previous draw left beyond the new end
+-   txa
+    cmp.l oam_batch_end
+    bcs +
+    jsr _oam_batch_hide
+    bra -
++   lda.b tcc__r4
+    sta.l oam_batch_end
+
+    sep #$20
+    .ACCU 8
+    lda #$01
+    sta.l oam_update_flag
+    rep #$20
+    .ACCU 16
+    lda.b tcc__r5                   ; Sprites written
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; _oam_batch_hide — write a hidden sprite (X=256, Y=240) at X, then advance
+;------------------------------------------------------------------------------
+_oam_batch_hide:
+    .ACCU 16
+    .INDEX 16
+    sep #$20
+    .ACCU 8
+    lda #0
+    sta.l oamMemory,x
+    lda #OAM_HIDE_Y
+    sta.l oamMemory+1,x
+    lda.b tcc__r3h
+    lsr a
+    lsr a
+    ora #$40                        ; X bit 8 set, small
+    sta.b tcc__r3h
+    rep #$20
+    .ACCU 16
+    ; fall through
+
+;------------------------------------------------------------------------------
+; _oam_batch_advance — next OAM slot; every 4 slots, store the high-table byte
+;------------------------------------------------------------------------------
+_oam_batch_advance:
+    .ACCU 16
+    .INDEX 16
+    inx
+    inx
+    inx
+    inx
+    txa
+    and #$000F
+    bne +
+    phx
+    txa
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    tax                             ; Group index + 1
+    sep #$20
+    .ACCU 8
+    lda.b tcc__r3h
+    sta.l oamMemory+511,x
+    rep #$20
+    .ACCU 16
+    plx
++   rts
+
+.ENDS
@@ -0,0 +1,126 @@
+;==============================================================================
+; OpenSNES Double-Buffered OAM
+;==============================================================================
+;
+; oamSetDoubleBuffer(1) points the NMI OAM DMA (oam_dma_src) at a second
+; 544-byte buffer in bank $7E, and WaitForVBlank copies the active window
+; of oamMemory into it through oam_front_hook before parking. The NMI then
+; never reads the buffer the game writes into.
+;
+; Opt-in: the front buffer and the copy live here, so games that do not
+; link sprite_double keep the 544 bytes of WRAM. Add `sprite_double` to
+; LIB_MODULES (it pulls in `sprite`).
+;
+; Author: OpenSNES Team
+; License: MIT
+;==============================================================================
+
+.ifdef SA1
+.include "memmap_sa1.inc"
+.else
+.ifdef HIROM
+.include "memmap_hirom.inc"
+.else
+.include "memmap.inc"
+.endif
+.endif
+
+;------------------------------------------------------------------------------
+; OAM front buffer: same layout as oamMemory (low table, then high table).
+;------------------------------------------------------------------------------
+.RAMSECTION ".oam_front" BANK $7E SLOT 2
+    oamFront    dsb 544
+.ENDS
+
+.SECTION ".sprite_double_text" SUPERFREE
+
+;------------------------------------------------------------------------------
+; void oamSetDoubleBuffer(u8 enable)
+;
+; Switches the NMI OAM DMA between oamFront (enable != 0) and oamMemory,
+; and schedules a full-table copy + DMA so the new source starts complete.
+;------------------------------------------------------------------------------
+oamSetDoubleBuffer:
+    php
+    rep #$20
+    .ACCU 16
+    lda #OamFrontCopy
+    sta.l oam_front_hook
+    sep #$20
+    .ACCU 8
+    lda #:OamFrontCopy
+    sta.l oam_front_hook+2
+
+    rep #$20
+    .ACCU 16
+    lda 5,s                 ; enable
+    and #$00FF
+    beq +
+    lda #oamFront
+    bra ++
++   lda #oamMemory
+++  sta.l oam_dma_src
+    lda #128
+    sta.l oam_dma_sent      ; Next copy + DMA cover the whole table
+    sep #$20
+    .ACCU 8
+    lda #1
+    sta.l oam_update_flag
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; OamFrontCopy - publish this frame's sprites to the OAM front buffer
+;------------------------------------------------------------------------------
+; Called by WaitForVBlank through oam_front_hook. Copies exactly what the
+; coming NMI DMA sends (same n as the NMI: low-table prefix + matching
+; high-table bytes) from oamMemory to oam_dma_src, both in bank $7E. MVN,
+; 7 cycles per byte: 40 sprites = 170 bytes, about 1.2 K cycles spent
+; before VBlank instead of inside it.
+;
+; KEEP: X, Y (WaitForVBlank contract)
+;------------------------------------------------------------------------------
+OamFrontCopy:
+    php
+    phb
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    phx
+    phy
+    lda.l oam_dma_count
+    cmp.l oam_dma_sent
+    bcs +
+    lda.l oam_dma_sent
++   cmp #0
+    beq @done
+    pha                     ; n
+    lda.l oam_dma_src
+    tay
+    ldx #oamMemory
+    lda 1,s
+    asl a
+    asl a
+    dec a                   ; MVN count: 4 bytes per sprite, minus one
+    mvn $7E, $7E
+
+    lda.l oam_dma_src
+    clc
+    adc #512
+    tay
+    ldx #oamMemory+512
+    pla
+    clc
+    adc #3
+    lsr a
+    lsr a
+    dec a                   ; High table: 1 byte per 4 sprites, minus one
+    mvn $7E, $7E
+@done:
+    ply
+    plx
+    plb
+    plp
+    rtl
+
+.ENDS
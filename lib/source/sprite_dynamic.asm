@@ -6,7 +6,11 @@
 ;
 ; Features:
 ;   - Per-sprite state tracking via oambuffer[]
-;   - VRAM upload queue (max 7 sprites/frame)
+;   - VRAM upload queue with a per-VBlank byte budget (oamDynamicSetVramBudget)
+;     and a priority lane at its front (oamrefresh = OAM_REFRESH_PRIORITY)
+;   - Optional VRAM slot cache (oamDynamicCacheEnable): sprites showing the
+;     same frame share one uploaded copy, least recently used slots are
+;     recycled
 ;   - Support for 32x32, 16x16, and 8x8 sprites
 ;
 ; Author: OpenSNES Team
@@ -33,7 +37,8 @@
 
 .EQU OBJ_SIZE16_L32         3           ; Size index (matches C header), NOT register value
 .EQU OBJ_QUEUELIST_SIZE     128         ; Max queue entries
-.EQU MAXSPRTRF              42          ; 7 sprites * 6 bytes per entry
+.EQU OAM_DYN_VRAM_BUDGET    2048        ; Default upload bytes per VBlank (sprite.h)
+.EQU OAM_REFRESH_PRIORITY   2           ; oamrefresh value for the priority lane
 
 ;------------------------------------------------------------------------------
 ; oambuffer structure offsets (16 bytes per entry)
@@ -44,6 +49,7 @@
 .EQU OAM_ATTRIBUTE          6           ; u8 attributes
 .EQU OAM_REFRESH            7           ; u8 refresh flag
 .EQU OAM_GRAPHICS           8           ; u24 graphics pointer (3 bytes + pad)
+.EQU OAM_CACHESLOT          11          ; u8 slot cache hint
 
 ;------------------------------------------------------------------------------
 ; Compile-time offset assertions (must match t_sprites in sprite.h)
@@ -54,6 +60,7 @@
 .ASSERT OAM_ATTRIBUTE == 6
 .ASSERT OAM_REFRESH == 7
 .ASSERT OAM_GRAPHICS == 8
+.ASSERT OAM_CACHESLOT == 11
 
 ;==============================================================================
 ; Dynamic Sprite RAM Buffer
@@ -67,6 +74,31 @@
     oambuffer       dsb 2048    ; 128 × 16 bytes
 .ENDS
 
+;==============================================================================
+; VRAM Slot Cache
+;==============================================================================
+; Two pools of up to 128 slots, one per VRAM region: pool 0 holds the slots
+; counted by oamnumberspr0 (large), pool 1 those of oamnumberspr1 (small).
+; A region only ever holds one sprite size in a given OBJSEL mode. Tables
+; are indexed by pool * 256 + slot * 2:
+;   oam_dyn_cache_src   - frame source address (low 16 bits)
+;   oam_dyn_cache_bank  - frame source bank, $FFFF = slot empty
+;   oam_dyn_cache_stamp - oam_dyn_cache_frame of the last draw using the slot
+;==============================================================================
+
+.EQU OAM_DYN_CACHE_EMPTY    $FFFF
+
+.RAMSECTION ".dynamic_sprite_cache_state" BANK 0 SLOT 1
+    oam_dyn_cache_on        dsb 1   ; Non-zero: draws take slots from the cache
+    oam_dyn_cache_frame     dsb 2   ; Frame stamp, 1..$FFFE (0 = never used)
+.ENDS
+
+.RAMSECTION ".dynamic_sprite_cache" BANK $7E SLOT 2
+    oam_dyn_cache_src       dsb 512
+    oam_dyn_cache_bank      dsb 512
+    oam_dyn_cache_stamp     dsb 512
+.ENDS
+
 ;==============================================================================
 ; Lookup Tables for OAM High Table Manipulation
 ;==============================================================================
@@ -176,6 +208,16 @@ oamInitDynamicSprite:
     rep #$20
     .ACCU 16
     stz.w oamqueuenumber            ; Reset queue position
+    stz.w oamqueueprio
+    stz.w oam_dyn_deferred
+    lda #OAM_DYN_VRAM_BUDGET
+    sta.w oam_dyn_vram_budget
+
+    sep #$20
+    .ACCU 8
+    stz.w oam_dyn_cache_on          ; Slot numbering may change: cache off
+    rep #$20
+    .ACCU 16
 
     stz.w oamnumberperframeold      ; Reset per-frame counters
     stz.w oamnumberperframe
@@ -379,6 +421,17 @@ _endframe_done:
     lda #$0000
     sta.w oamnumberperframe
 
+    ; Advance the slot cache stamp, 1..$FFFE: 0 marks a never used slot and
+    ; $FFFF is the "none yet" start of the oldest-slot search. After the
+    ; wrap back to 1 (every ~18 minutes at 60 Hz) slots last drawn before
+    ; it look newer than they are, until they are drawn again
+    lda.w oam_dyn_cache_frame
+    inc a
+    cmp #OAM_DYN_CACHE_EMPTY
+    bcc +
+    lda #1
++   sta.w oam_dyn_cache_frame
+
     ; Reset sprite slot counters
     lda.w oamnumberspr0Init
     sta.w oamnumberspr0
@@ -406,11 +459,21 @@ _endframe_done:
 ; void oamVramQueueUpdate(void)
 ;
 ; Process VRAM upload queue during VBlank.
-; Transfers up to 7 sprites per frame to VRAM.
+; Sends queue entries front to back (priority lane first) while they fit in
+; the byte budget: oam_dyn_vram_budget, bounded by what is left of the
+; shared VBlank budget (vblank_dma_budget - vblank_dma_bytes). Entries cost
+; their real size (32x32 = 512, 16x16 = 128, 8x8 = 32 bytes) and are
+; charged to vblank_dma_bytes. The first entry always goes, so a budget
+; smaller than one sprite still makes progress. What does not fit moves to
+; the front of the queue for the next VBlank and counts as deferred.
 ;==============================================================================
 
 .SECTION ".sprite_dynamic_vram" SUPERFREE
 
+; Upload size per sprite type (OBJ_SPRITE32 = 1, OBJ_SPRITE16 = 2, OBJ_SPRITE8 = 4)
+oamDynUploadBytes:
+    .word 0, 512, 128, 0, 32
+
 oamVramQueueUpdate:
     php
     phb
@@ -423,7 +486,9 @@ oamVramQueueUpdate:
     pha
     plb
 
-    ldx.w oamqueuenumber              ; Anything to transfer?
+    rep #$10
+    .INDEX 16
+    ldx.w oamqueuenumber            ; Anything to transfer?
     bne _vqu_start
     jmp _vqu_done                   ; No, exit
 
@@ -431,18 +496,19 @@ _vqu_start:
     lda #$80
     sta.l $2115                     ; VRAM increment mode
 
+    ; Bytes this VBlank: the engine budget, capped by the shared one
     rep #$20
     .ACCU 16
-    stz.w oamqueuenumber            ; Assume we'll process everything
-    txa                             ; A = bytes queued
-    cmp #MAXSPRTRF
-    bcc _vqu_process                ; Less than max, process all
-    ldx #MAXSPRTRF                  ; Limit to max
+    lda.w vblank_dma_budget
     sec
-    sbc #MAXSPRTRF
-    sta.l oamqueuenumber            ; Save remainder for next frame
+    sbc.w vblank_dma_bytes
+    bcs +
+    lda #0
++   cmp.w oam_dyn_vram_budget
+    bcc +
+    lda.w oam_dyn_vram_budget
++   sta.w oam_dyn_budget_left
 
-_vqu_process:
     ; Set up DMA channels for word transfer to VRAM
     lda #$1801
     sta.l $4310                     ; Channel 1: word increment to $2118
@@ -450,14 +516,33 @@ _vqu_process:
     sta.l $4330                     ; Channel 3
     sta.l $4340                     ; Channel 4
 
-    dex                             ; Start at last entry (will decrement more in loop)
+    ldx #0                          ; Oldest entry first
 
 _vqu_loop:
-    dex                             ; Move to next entry (6 bytes back)
-    dex
-    dex
-    dex
-    dex
+    .ACCU 16
+    lda.l oamQueueEntry+5,x         ; Sprite type (low byte)
+    and #$00FF
+    asl a
+    phx
+    tax
+    lda.l oamDynUploadBytes,x
+    plx
+    cpx #0
+    beq +                           ; First entry always goes
+    cmp.w oam_dyn_budget_left
+    beq +
+    bcc +
+    jmp _vqu_defer                  ; Does not fit: rest waits for next VBlank
++   sta.w oam_dyn_entry_bytes
+    clc
+    adc.w vblank_dma_bytes
+    sta.w vblank_dma_bytes          ; Charge the shared VBlank budget
+    lda.w oam_dyn_budget_left
+    sec
+    sbc.w oam_dyn_entry_bytes
+    bcs +
+    lda #0
++   sta.w oam_dyn_budget_left
 
     ; Check sprite size type
     sep #$20
@@ -619,29 +704,48 @@ _vqu_8x8:
     sta.l $420b
 
 _vqu_next:
-    dex
-    bmi _vqu_check_overflow
-    beq _vqu_check_overflow
+    rep #$20
+    .ACCU 16
+    txa
+    clc
+    adc #6
+    tax
+    cmp.w oamqueuenumber
+    bcs _vqu_all_sent
     jmp _vqu_loop
 
-_vqu_check_overflow:
-    ; If we hit the max, move remaining entries to front of queue
-    rep #$20
+_vqu_all_sent:
+    stz.w oamqueuenumber
+    stz.w oamqueueprio
+    bra _vqu_done
+
+_vqu_defer:
+    ; X = bytes sent. Move the unsent entries to the front of the queue.
     .ACCU 16
+    stx.w oam_dyn_entry_bytes
     lda.w oamqueuenumber
-    beq _vqu_done
+    sec
+    sbc.w oam_dyn_entry_bytes
+    sta.w oamqueuenumber            ; Bytes left (multiple of 6)
     ldy #$0000
-    ldx #MAXSPRTRF
 _vqu_shift:
-    pha
-    lda.l oamQueueEntry,x
+    lda.w oamQueueEntry,x
     sta.w oamQueueEntry,y
-    iny
     inx
-    pla
-    dea
-    bmi _vqu_done
-    jmp _vqu_shift
+    inx
+    iny
+    iny
+    cpy.w oamqueuenumber
+    bcc _vqu_shift
+
+    ; Priority entries come first, so the sent ones leave the lane first
+    lda.w oamqueueprio
+    sec
+    sbc.w oam_dyn_entry_bytes
+    bcs +
+    lda #0
++   sta.w oamqueueprio
+    inc.w oam_dyn_deferred
 
 _vqu_done:
     ply
@@ -650,6 +754,259 @@ _vqu_done:
     plp
     rtl
 
+;------------------------------------------------------------------------------
+; oamDynQueueAlloc — reserve a 6-byte VRAM upload queue entry
+;
+; IN:  A 16-bit, DB = $7E, sprit_val0 = oamrefresh value of the sprite
+; OUT: X = entry offset in oamQueueEntry, carry set if the queue is full
+;
+; Normal requests are appended. OAM_REFRESH_PRIORITY requests take the slot
+; at the end of the priority lane; the normal entries behind it move back
+; one slot, keeping their order.
+;------------------------------------------------------------------------------
+oamDynQueueAlloc:
+    .ACCU 16
+    lda.w oamqueuenumber
+    cmp #OBJ_QUEUELIST_SIZE*6
+    bcc +
+    rtl                             ; Full (carry set)
++   tax                             ; X = end of queue
+    clc
+    adc #6
+    sta.w oamqueuenumber
+    sep #$20
+    .ACCU 8
+    lda.w sprit_val0
+    cmp #OAM_REFRESH_PRIORITY
+    rep #$20
+    .ACCU 16
+    beq _dqa_prio
+    clc
+    rtl
+
+_dqa_prio:
+    phy
+    txy                             ; Y = old end of queue
+_dqa_shift:
+    tya
+    cmp.w oamqueueprio
+    beq _dqa_shifted                ; Y = end of the priority lane
+    sec
+    sbc #6
+    tax                             ; X = previous entry, moved up to Y
+    lda.w oamQueueEntry,x
+    sta.w oamQueueEntry,y
+    lda.w oamQueueEntry+2,x
+    sta.w oamQueueEntry+2,y
+    lda.w oamQueueEntry+4,x
+    sta.w oamQueueEntry+4,y
+    txy
+    bra _dqa_shift
+_dqa_shifted:
+    ply
+    ldx.w oamqueueprio
+    txa
+    clc
+    adc #6
+    sta.w oamqueueprio
+    clc
+    rtl
+
+.ENDS
+
+;==============================================================================
+; oamDynCacheReset
+;==============================================================================
+; void oamDynCacheReset(void)
+;
+; Forget every resident frame. Called by oamDynamicCacheEnable.
+;==============================================================================
+
+.SECTION ".sprite_dynamic_cache" SUPERFREE
+
+oamDynCacheReset:
+    php
+    phb
+    phx
+
+    sep #$20
+    .ACCU 8
+    lda #$7e
+    pha
+    plb
+
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    ldx #510
+-   lda #OAM_DYN_CACHE_EMPTY
+    sta.w oam_dyn_cache_bank,x
+    stz.w oam_dyn_cache_stamp,x
+    dex
+    dex
+    bpl -
+    lda #1
+    sta.w oam_dyn_cache_frame
+
+    plx
+    plb
+    plp
+    rtl
+
+;------------------------------------------------------------------------------
+; oamDynCacheSlot — find or claim the VRAM slot holding a sprite's frame
+;
+; IN:  A 16-bit = pool (0 = oamnumberspr0 slots, 1 = oamnumberspr1 slots),
+;      X 16-bit = slots in the pool for this sprite size (16, 64 or 128),
+;      Y = oambuffer offset, DB = $7E, sprit_val2 = frame source address,
+;      sprit_val0 = oamrefresh value (upload priority)
+; OUT: oamnumberspr0/1 = the slot, oamrefresh cleared.
+;      Carry set: the slot needs an upload, X = its queue entry.
+;      Carry clear, Z set: the frame is resident.
+;      Carry clear, Z clear: no slot or queue entry free (skip sprite).
+;
+; The sprite's last slot (OAM_CACHESLOT) is checked first, so a sprite
+; that keeps its frame costs one compare. Otherwise the pool is searched
+; from oamnumberspr0Init/1Init up, remembering the least recently drawn
+; slot not used this frame. When the queue is full the slot is left
+; empty and the sprite is skipped this frame; the next draw retries.
+;
+; DP usage (main thread, D = 0):
+;   tcc__r0 = pool offset   tcc__r1 = end of pool   tcc__r2 = key bank
+;   tcc__r3 = oldest stamp  tcc__r4 = oldest slot offset
+;------------------------------------------------------------------------------
+oamDynCacheSlot:
+    .ACCU 16
+    .INDEX 16
+    xba
+    sta.b tcc__r0                   ; Pool offset: 256 bytes per pool
+    txa
+    asl a
+    clc
+    adc.b tcc__r0
+    sta.b tcc__r1
+    lda.w oambuffer+OAM_GRAPHICS+2,y
+    and #$00FF
+    sta.b tcc__r2
+
+    sep #$20
+    .ACCU 8
+    lda #$00
+    sta.w oambuffer+OAM_REFRESH,y   ; The cache decides about uploads
+    rep #$20
+    .ACCU 16
+
+    ; Last slot of this sprite first
+    lda.w oambuffer+OAM_CACHESLOT,y
+    and #$00FF
+    asl a
+    clc
+    adc.b tcc__r0
+    cmp.b tcc__r1
+    bcs _dcs_search
+    tax
+    lda.w oam_dyn_cache_src,x
+    cmp.w sprit_val2
+    bne _dcs_search
+    lda.w oam_dyn_cache_bank,x
+    cmp.b tcc__r2
+    beq _dcs_hit
+
+_dcs_search:
+    lda #OAM_DYN_CACHE_EMPTY
+    sta.b tcc__r3
+    sta.b tcc__r4
+    lda.b tcc__r0
+    bne +
+    lda.w oamnumberspr0Init
+    bra _dcs_base
++   lda.w oamnumberspr1Init
+_dcs_base:
+    asl a
+    clc
+    adc.b tcc__r0
+    tax
+    cmp.b tcc__r1
+    bcs _dcs_miss
+
+_dcs_loop:
+    lda.w oam_dyn_cache_src,x
+    cmp.w sprit_val2
+    bne _dcs_lru
+    lda.w oam_dyn_cache_bank,x
+    cmp.b tcc__r2
+    beq _dcs_hit
+_dcs_lru:
+    lda.w oam_dyn_cache_stamp,x
+    cmp.w oam_dyn_cache_frame
+    beq _dcs_next                   ; Drawn this frame: not reusable
+    cmp.b tcc__r3
+    bcs _dcs_next
+    sta.b tcc__r3                   ; Oldest so far (empty slots are 0)
+    stx.b tcc__r4
+_dcs_next:
+    inx
+    inx
+    cpx.b tcc__r1
+    bcc _dcs_loop
+
+_dcs_miss:
+    ldx.b tcc__r4
+    cpx #OAM_DYN_CACHE_EMPTY
+    bne _dcs_claim
+    lda #1                          ; Pool exhausted (Z clear)
+    clc
+    rtl
+
+_dcs_hit:
+    jsr _dcs_use
+    lda #0                          ; Resident (Z set)
+    clc
+    rtl
+
+_dcs_claim:
+    lda.w sprit_val2
+    sta.w oam_dyn_cache_src,x
+    lda.b tcc__r2
+    sta.w oam_dyn_cache_bank,x
+    jsr _dcs_use
+    jsl oamDynQueueAlloc            ; X = queue entry
+    bcs +
+    sec                             ; Upload into the claimed slot
+    rtl
++   ldx.b tcc__r4                   ; Queue full: leave the slot empty
+    lda #OAM_DYN_CACHE_EMPTY
+    sta.w oam_dyn_cache_bank,x
+    lda #1                          ; Nothing to show yet: skip (Z clear)
+    clc
+    rtl
+
+;------------------------------------------------------------------------------
+; _dcs_use — stamp slot X, remember it in the sprite and point the slot
+; counter of its pool at it
+;------------------------------------------------------------------------------
+_dcs_use:
+    .ACCU 16
+    .INDEX 16
+    lda.w oam_dyn_cache_frame
+    sta.w oam_dyn_cache_stamp,x
+    txa
+    sec
+    sbc.b tcc__r0
+    lsr a                           ; Slot number
+    ldx.b tcc__r0
+    bne +
+    sta.w oamnumberspr0
+    bra _dcs_hint
++   sta.w oamnumberspr1
+_dcs_hint:
+    sep #$20
+    .ACCU 8
+    sta.w oambuffer+OAM_CACHESLOT,y
+    rep #$20
+    .ACCU 16
+    rts
+
 .ENDS
 
 ;==============================================================================
@@ -691,9 +1048,11 @@ oamDynamic32Draw:
     sep #$20
     .ACCU 8
     lda.w oambuffer+OAM_REFRESH,y
-    beq _o32d_no_refresh
-    lda #$00
-    sta.w oambuffer+OAM_REFRESH,y     ; Clear refresh flag
+    sta.w sprit_val0                ; Refresh kind, for oamDynQueueAlloc
+    ora.w oam_dyn_cache_on          ; The slot cache looks at every draw
+    bne +
+    jmp _o32d_no_refresh
++:
 
     ; Queue graphics for VRAM upload
     rep #$20
@@ -706,13 +1065,32 @@ oamDynamic32Draw:
     adc.w oambuffer+OAM_GRAPHICS,y  ; Add graphics base address
     sta.w sprit_val2                ; Save computed source address
 
+    lda.w oam_dyn_cache_on
+    and #$00FF
+    beq _o32d_queue
+    lda #0                          ; Large slot pool
+    ldx #16                         ; 32x32 slots
+    jsl oamDynCacheSlot             ; oamnumberspr0 = slot holding the frame
+    bcs _o32d_upload                ; Miss: X = queue entry
+    bne _o32d_skip                  ; No slot or queue entry free
+    jmp _o32d_no_refresh            ; Resident: no upload
+
+_o32d_skip:
+    jmp _o32d_exit
+
+_o32d_queue:
     ; Add to queue
-    lda.l oamqueuenumber
-    tax                             ; X = queue position
-    clc
-    adc #$0006
-    sta.l oamqueuenumber            ; Advance queue
+    jsl oamDynQueueAlloc            ; X = queue entry
+    bcc +
+    jmp _o32d_no_refresh            ; Queue full: keep oamrefresh, retry next frame
++   sep #$20
+    .ACCU 8
+    lda #$00
+    sta.w oambuffer+OAM_REFRESH,y   ; Clear refresh flag
+    rep #$20
+    .ACCU 16
 
+_o32d_upload:
     ; Get VRAM destination for this sprite slot
     phx
     lda.w oamnumberspr0
@@ -832,6 +1210,7 @@ _o32d_attr:
     adc #$0004                      ; Next OAM entry
     sta.w oamnumberperframe
 
+_o32d_exit:
     ply
     plx
     plb
@@ -873,9 +1252,11 @@ oamDynamic16Draw:
 
     ; Check if graphics need refresh
     lda.w oambuffer+OAM_REFRESH,y
-    beq _o16d_no_refresh
-    lda #$00
-    sta.w oambuffer+OAM_REFRESH,y
+    sta.w sprit_val0                ; Refresh kind, for oamDynQueueAlloc
+    ora.w oam_dyn_cache_on          ; The slot cache looks at every draw
+    bne +
+    jmp _o16d_no_refresh
++:
 
     ; Queue graphics for VRAM upload
     rep #$20
@@ -888,12 +1269,36 @@ oamDynamic16Draw:
     adc.w oambuffer+OAM_GRAPHICS,y
     sta.w sprit_val2
 
-    lda.l oamqueuenumber
-    tax
-    clc
-    adc #$0006
-    sta.l oamqueuenumber
+    lda.w oam_dyn_cache_on
+    and #$00FF
+    beq _o16d_queue
+    ldx.w spr16addrgfx
+    lda #1                          ; Small slot pool...
+    cpx.w spr0addrgfx
+    bne +
+    dec a                           ; ...unless 16x16 is the large size
++   ldx #64                         ; 16x16 slots
+    jsl oamDynCacheSlot             ; Slot counter = slot holding the frame
+    bcs _o16d_upload                ; Miss: X = queue entry
+    bne _o16d_skip                  ; No slot or queue entry free
+    jmp _o16d_no_refresh            ; Resident: no upload
+
+_o16d_skip:
+    jmp _o16d_exit
+
+_o16d_queue:
+    ; Add to queue
+    jsl oamDynQueueAlloc            ; X = queue entry
+    bcc +
+    jmp _o16d_no_refresh            ; Queue full: keep oamrefresh, retry next frame
++   sep #$20
+    .ACCU 8
+    lda #$00
+    sta.w oambuffer+OAM_REFRESH,y   ; Clear refresh flag
+    rep #$20
+    .ACCU 16
 
+_o16d_upload:
     ; Determine if using large or small sprite VRAM area
     phx
     lda.w spr16addrgfx
@@ -1049,6 +1454,7 @@ _o16d_inc_frame:
     adc #$0004
     sta.w oamnumberperframe
 
+_o16d_exit:
     ply
     plx
     plb
@@ -1090,9 +1496,11 @@ oamDynamic8Draw:
 
     ; Check refresh
     lda.w oambuffer+OAM_REFRESH,y
-    beq _o8d_no_refresh
-    lda #$00
-    sta.w oambuffer+OAM_REFRESH,y
+    sta.w sprit_val0                ; Refresh kind, for oamDynQueueAlloc
+    ora.w oam_dyn_cache_on          ; The slot cache looks at every draw
+    bne +
+    jmp _o8d_no_refresh
++:
 
     rep #$20
     .ACCU 16
@@ -1104,12 +1512,32 @@ oamDynamic8Draw:
     adc.w oambuffer+OAM_GRAPHICS,y
     sta.w sprit_val2
 
-    lda.l oamqueuenumber
-    tax
-    clc
-    adc #$0006
-    sta.l oamqueuenumber
+    lda.w oam_dyn_cache_on
+    and #$00FF
+    beq _o8d_queue
+    lda #1                          ; Small slot pool
+    ldx #128                        ; 8x8 slots
+    jsl oamDynCacheSlot             ; Slot counter = slot holding the frame
+    bcs _o8d_upload                 ; Miss: X = queue entry
+    bne _o8d_skip                   ; No slot or queue entry free
+    jmp _o8d_no_refresh             ; Resident: no upload
+
+_o8d_skip:
+    jmp _o8d_exit
+
+_o8d_queue:
+    ; Add to queue
+    jsl oamDynQueueAlloc            ; X = queue entry
+    bcc +
+    jmp _o8d_no_refresh             ; Queue full: keep oamrefresh, retry next frame
++   sep #$20
+    .ACCU 8
+    lda #$00
+    sta.w oambuffer+OAM_REFRESH,y   ; Clear refresh flag
+    rep #$20
+    .ACCU 16
 
+_o8d_upload:
     phx
     lda.w oamnumberspr1
     asl a
@@ -1222,6 +1650,7 @@ _o8d_attr:
     adc #$0004
     sta.w oamnumberperframe
 
+_o8d_exit:
     ply
     plx
     plb
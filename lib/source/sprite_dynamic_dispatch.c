@@ -30,12 +30,22 @@ extern void oamInitDynamicSpriteEndFrame(void);
 extern void oamDynamic8Draw(u16 id);
 extern void oamDynamic16Draw(u16 id);
 extern void oamDynamic32Draw(u16 id);
+extern void oamDynCacheReset(void);
 
 /* Counter of bytes currently in the VRAM tile upload queue (declared in
  * templates/crt0.asm). Each queued entry is 6 bytes. The NMI auto-flush
- * hook drains up to MAXSPRTRF=42 (= 7 entries) per VBlank. */
+ * hook drains up to oam_dyn_vram_budget bytes of uploads per VBlank. */
 extern volatile u16 oamqueuenumber;
 
+/* Upload budget and deferral counter (templates/crt0.asm), both reset by
+ * oamInitDynamicSprite. */
+extern u16 oam_dyn_vram_budget;
+extern volatile u16 oam_dyn_deferred;
+
+/* VRAM slot cache switch (sprite_dynamic.asm). Cleared by
+ * oamInitDynamicSprite, since a new size mode renumbers the slots. */
+extern u8 oam_dyn_cache_on;
+
 /* Init-time queue drain flag (declared in templates/crt0.asm). When
  * non-zero, oamDynamicNmiFlush skips end-of-frame "hide stale sprites"
  * to let oamDynamicDrainQueue wait for queue empty without erasing the
@@ -112,6 +122,22 @@ void oamDynamicDrainQueue(void) {
     oamInitDynamicSpriteEndFrame();
 }
 
+void oamDynamicSetVramBudget(u16 bytes) {
+    oam_dyn_vram_budget = bytes;
+}
+
+u16 oamDynamicDeferredCount(void) {
+    return oam_dyn_deferred;
+}
+
+void oamDynamicCacheEnable(u8 enable) {
+    /* Always start from an empty cache: slots filled before were assigned
+     * by draw order, not by content. */
+    oam_dyn_cache_on = 0;
+    oamDynCacheReset();
+    oam_dyn_cache_on = enable;
+}
+
 void oamDynamicDraw(u16 id) {
     u8 sz;
 
@@ -0,0 +1,138 @@
+/**
+ * @file sprite_rotate.c
+ * @brief Rotating OAM allocator (sprite multiplexing)
+ *
+ * The PPU keeps the first 32 sprites it finds on a scanline, in OAM ID
+ * order. The allocator gives the n-th requested sprite of a frame the ID
+ * firstId + ((n + start) mod run), where run is the number of sprites
+ * drawn the previous frame and start advances by the stride every frame.
+ * Objects requested in the same order every frame thus move through the
+ * ID order, and the ones past the 32nd on a crowded line change each
+ * frame. Requests past run take the following IDs in order.
+ *
+ * @author OpenSNES Team
+ * @copyright MIT License
+ */
+
+#include <snes.h>
+
+static u8 rot_first;    /* First OAM ID of the range */
+static u8 rot_size;     /* IDs in the range */
+static u8 rot_stride;   /* Start advance per frame, 0 = half the run */
+static u8 rot_run;      /* Rotation period: sprites allocated last frame */
+static u8 rot_start;    /* Rotation offset this frame, < rot_run */
+static u8 rot_count;    /* Sprites allocated this frame */
+static u8 rot_high;     /* Range slots that may still be visible */
+
+void oamRotateInit(u8 firstId, u8 count, u8 stride) {
+    u8 i;
+
+    if (firstId >= MAX_SPRITES) firstId = MAX_SPRITES - 1;
+    if (count > MAX_SPRITES - firstId) count = MAX_SPRITES - firstId;
+
+    rot_first = firstId;
+    rot_size = count;
+    rot_stride = stride;
+    rot_run = 0;
+    rot_start = 0;
+    rot_count = 0;
+    rot_high = 0;
+
+    for (i = 0; i < count; i++) {
+        oamHide(firstId + i);
+    }
+}
+
+void oamRotateBegin(void) {
+    u8 stride;
+
+    rot_run = rot_count;
+    rot_count = 0;
+    if (rot_run == 0) {
+        rot_start = 0;
+        return;
+    }
+
+    stride = rot_stride;
+    if (stride == 0) stride = (rot_run + 1) >> 1;
+    rot_start += stride;
+    while (rot_start >= rot_run) {
+        rot_start -= rot_run;
+    }
+}
+
+u8 oamRotateNext(void) {
+    u8 slot;
+
+    if (rot_count >= rot_size) return OAM_ROTATE_FULL;
+
+    slot = rot_count;
+    if (slot < rot_run) {
+        slot += rot_start;
+        if (slot >= rot_run) slot -= rot_run;
+    }
+    rot_count++;
+
+    return rot_first + slot;
+}
+
+u8 oamRotateDrawMeta(s16 x, s16 y, const MetaspriteItem *meta,
+                     u16 baseTile, u8 basePalette, u8 size) {
+    u8 drawn = 0;
+    u8 id;
+
+    while (meta->dx != metasprite_end) {
+        s16 sx = x + meta->dx;
+        s16 sy = y + meta->dy;
+
+        /* Skip sprites that are completely off-screen */
+        if (sx > -64 && sx < 256 && sy > -64 && sy < 240) {
+            u8 attr = meta->attr;
+            u8 palette = (attr >> 1) & 0x07;
+            u8 priority = (attr >> 4) & 0x03;
+            u8 flags = attr & 0xC0;
+
+            if (palette == 0) {
+                palette = basePalette;
+            }
+
+            id = oamRotateNext();
+            if (id == OAM_ROTATE_FULL) break;
+
+            oamSet(id, (u16)sx, (u8)sy, baseTile + meta->tile, palette, priority, flags);
+            oamSetSize(id, size);
+            drawn++;
+        }
+
+        meta++;
+    }
+
+    return drawn;
+}
+
+void oamRotateEnd(void) {
+    u8 i, n, high, end;
+
+    high = (rot_count > rot_run) ? rot_count : rot_run;
+    end = (high > rot_high) ? high : rot_high;
+
+    if (rot_count < rot_run) {
+        /* Unused tail of the rotated run: slots start+count .. start+run-1 */
+        i = rot_start + rot_count;
+        for (n = rot_run - rot_count; n != 0; n--) {
+            if (i >= rot_run) i -= rot_run;
+            oamHide(rot_first + i);
+            i++;
+        }
+        i = rot_run;
+    } else {
+        i = rot_count;
+    }
+
+    /* Slots past this frame's run that were used before */
+    for (; i < end; i++) {
+        oamHide(rot_first + i);
+    }
+
+    rot_high = high;
+}
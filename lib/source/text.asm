@@ -268,7 +268,7 @@ asm_textDMAFont:
 ; asm_textFillBuffer - Fill tilemapBuffer with a 16-bit value
 ;------------------------------------------------------------------------------
 ; C prototype: extern void asm_textFillBuffer(u16 value);
-; Reads buffer address from tilemap_src_addr (set by textInit).
+; Reads buffer address from shadow slot 0 (BG_SHADOW_TEXT, set by textInit).
 ; Fills 2048 bytes (1024 words).
 ;------------------------------------------------------------------------------
 asm_textFillBuffer:
@@ -277,7 +277,7 @@ asm_textFillBuffer:
     .ACCU 16
     .INDEX 16
     lda 5,s             ; Get fill value (past P + 3-byte return addr)
-    ldx.w tilemap_src_addr ; Buffer base address (bank $00)
+    ldx.w tilemap_shadow+2 ; Slot 0 buffer base address (bank $00)
     ldy #1024           ; Word count
 -   sta.l $0000,x       ; Store 16-bit value at bank $00:X
     inx
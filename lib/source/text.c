@@ -30,11 +30,6 @@ extern void tilemapFlush(void);
  * 2048 bytes = 32×32 tilemap entries × 2 bytes each. */
 u8 tilemapBuffer[2048];
 
-/* DMA control variables (defined in crt0.asm .system RAMSECTION) */
-extern volatile u8 tilemap_update_flag;
-extern u16 tilemap_vram_addr;
-extern u16 tilemap_src_addr;
-
 /* Font size constants */
 #define FONT_SIZE 1536  /* 96 chars * 16 bytes per tile */
 
@@ -89,9 +84,9 @@ void textInit(u16 tilemap_addr, u16 font_tile, u8 palette) {
     text_config.priority     = 0;
     text_config.map_width    = 32;
 
-    /* DMA target for NMI handler is the same word address. */
-    tilemap_vram_addr = tilemap_addr;
-    tilemap_src_addr  = (u16)tilemapBuffer;
+    /* NMI handler flushes tilemapBuffer to the same word address
+     * through the text shadow slot. */
+    bgShadowAttach(BG_SHADOW_TEXT, tilemapBuffer, tilemap_addr);
 
     cursor_x = 0;
     cursor_y = 0;
@@ -139,19 +134,18 @@ void textPutChar(char c) {
     /* Write tile entry to RAM buffer */
     buffer_write_entry(cursor_x, cursor_y, build_tile_entry(c));
 
+    /* Auto-flush: NMI handler will DMA this row during the next VBlank.
+     * Removes the "you must call textFlush" footgun. Only the rows
+     * touched since the last VBlank are sent (64 bytes each), so a HUD
+     * digit no longer costs a full 2 KB tilemap upload. */
+    bgShadowMarkRow(BG_SHADOW_TEXT, cursor_y);
+
     /* Advance cursor */
     cursor_x++;
     if (cursor_x >= text_config.map_width) {
         cursor_x = 0;
         cursor_y++;
     }
-
-    /* Auto-flush: NMI handler will DMA the tilemap during the next
-     * VBlank. Removes the "you must call textFlush" footgun. The flag
-     * is a single byte; setting it on every glyph is essentially free
-     * (NMI does at most one tilemap DMA per frame regardless of how
-     * many text writes piled the flag back to 1). */
-    tilemap_update_flag = 1;
 }
 
 void textPrint(const char *str) {
@@ -207,7 +201,7 @@ void textClear(void) {
     u16 entry = build_tile_entry(' ');
     /* Assembly fill loop — ~14000 cycles vs ~238000 from compiled C */
     asm_textFillBuffer(entry);
-    tilemap_update_flag = 1;   /* auto-flush */
+    bgShadowMarkAll(BG_SHADOW_TEXT);   /* auto-flush */
 }
 
 /* Fill a rectangle with character c. Internal — only `textClearRect`
@@ -230,9 +224,8 @@ static void textFillRect(u8 x, u8 y, u8 w, u8 h, char c) {
             tilemapBuffer[row_offset + 1] = hi;
             row_offset += 2;
         }
+        bgShadowMarkRow(BG_SHADOW_TEXT, y + row);   /* auto-flush */
     }
-
-    tilemap_update_flag = 1;   /* auto-flush */
 }
 
 void textClearRect(u8 x, u8 y, u8 w, u8 h) {
@@ -240,10 +233,12 @@ void textClearRect(u8 x, u8 y, u8 w, u8 h) {
 }
 
 void textFlush(void) {
-    /* Set flag for NMI handler to DMA during next VBlank.
-     * This is safe to call anytime — the actual VRAM write
-     * happens during VBlank when VRAM access is allowed. */
-    tilemap_update_flag = 1;
+    /* Flag the whole buffer for the NMI handler to DMA during next
+     * VBlank. The text API tracks the rows it touches; after a direct
+     * tilemapBuffer write we cannot know which rows changed. This is
+     * safe to call anytime — the actual VRAM write happens during
+     * VBlank when VRAM access is allowed. */
+    bgShadowMarkAll(BG_SHADOW_TEXT);
 }
 
 void textModeInit(void) {
@@ -134,13 +134,19 @@ endif
 
 _DEP_sprite          := dma sprite_oamset
 _DEP_sprite_dynamic  := sprite_dynamic_dispatch sprite_dynamic_helpers
+_DEP_sprite_rotate   := sprite
+_DEP_sprite_double   := sprite
 _DEP_text            := dma background
 _DEP_text4bpp        := dma
 _DEP_object          := map
 _DEP_map             := dma
+_DEP_map_solid       := map
+_DEP_map_layers      := map
+_DEP_map_chunk       := map lz4
 _DEP_snesmod         := console
 _DEP_superfx         := dma
 _DEP_hdma            := dma math_sqrt
+_DEP_mode7_perspective := mode7 hdma
 # math splits into the small sqrt module (math_sqrt = sqrt16 + fixSqrt
 # only) and the larger trig + arithmetic module (math = sine LUT +
 # atan_lut + fixSin/fixCos/fixDiv/fixMul/fixAbs/fixClamp/fixLerp +
@@ -150,6 +156,7 @@ _DEP_hdma            := dma math_sqrt
 # on math_sqrt — the resolver flattens this transitively.
 _DEP_math            := math_sqrt
 _DEP_asset           := dma background
+_DEP_lzss            := dma_queue
 
 _resolve_one = $(1) $(foreach m,$(1),$(_DEP_$(m)))
 _resolve_deps = $(sort $(call _resolve_one,$(call _resolve_one,$(call _resolve_one,$(1)))))
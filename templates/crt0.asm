@@ -82,7 +82,8 @@
     dynamic_flush_hook dsb 4
     ; Init-time queue drain flag. When non-zero, oamDynamicNmiFlush skips the
     ; end-frame "hide stale sprites" step and only flushes the VRAM tile
-    ; queue — used by oamDynamicDrainQueue to drain a >7-entry init queue
+    ; queue — used by oamDynamicDrainQueue to drain an init queue larger
+    ; than the per-VBlank upload budget
     ; across multiple VBlanks without the end-frame logic concluding that
     ; just-drawn sprites need hiding (see memory note on the 0/old-counter
     ; race that broke B.5 the first time around).
@@ -123,9 +124,7 @@
 .RAMSECTION ".system" BANK 0 SLOT 1
     vblank_flag     dsb 1   ; Handshake: set by WaitForVBlank, cleared by NMI
     oam_update_flag dsb 1   ; Set when OAM buffer needs transfer
-    tilemap_update_flag dsb 1 ; Set when tilemap buffer needs DMA to VRAM
-    tilemap_vram_addr dsb 2   ; VRAM word address for tilemap DMA target
-    tilemap_src_addr dsb 2    ; 16-bit RAM address of tilemap buffer (bank $00)
+    tilemap_update_flag dsb 1 ; Set when a shadow tilemap has dirty rows
     frame_count     dsb 2   ; Frame counter (incremented by NMI handler)
     frame_count_svg dsb 2   ; Saved frame count
     lag_frame_counter dsb 2 ; Lag frame detection
@@ -152,13 +151,78 @@
     mouseRequestChangeSensitivity dsb 2 ; Deferred sensitivity command per port
     sa1_status      dsb 1   ; SA-1 boot status ($A5=OK, $00=not started/failed)
     superfx_status  dsb 1   ; SuperFX GSU version (0=not detected, non-zero=chip version)
+    ; Bytes DMA'd so far in the current VBlank. Zeroed when the NMI starts
+    ; its work, bumped by every NMI-side transfer (OAM, tilemap, queue) so
+    ; later stages can stay inside the ~4 KB budget (KNOWN_LIMITATIONS.md).
+    vblank_dma_bytes dsb 2
+    vblank_dma_budget dsb 2 ; Per-VBlank byte budget (dmaSetVBlankBudget)
+    ; VBlank DMA queue drain hook (24-bit fn ptr + 1-byte padding). Same
+    ; no-op-by-default scheme as dynamic_flush_hook; dmaQueueInit repoints
+    ; it at dmaQueueNmiFlush. Lives here, not in .registers, because
+    ; .registers must end at $30 where .audio_zp is FORCE-placed.
+    dma_queue_hook  dsb 4
+    ; IRQ dispatch target (24-bit fn ptr + 1-byte padding). IrqHandler jumps
+    ; straight through it: IrqDefault (acknowledge only) until irqInit
+    ; repoints it at the raster IRQ scheduler.
+    irq_hook        dsb 4
+    ; OAM front buffer copy (24-bit fn ptr + 1-byte padding). WaitForVBlank
+    ; calls it only while oam_dma_src is not oamMemory, which takes
+    ; oamSetDoubleBuffer (sprite_double), and that repoints it at
+    ; OamFrontCopy first.
+    oam_front_hook  dsb 4
+.ENDS
+
+;------------------------------------------------------------------------------
+; Shadow Tilemaps
+;------------------------------------------------------------------------------
+; TILEMAP_SHADOW_SLOTS (4) WRAM copies of 32x32 tilemaps, each with its own
+; VRAM target and dirty-row mask (bgShadowAttach / bgShadowMarkRow). The NMI
+; flushes them slot 0 first, so lower slots win when the budget runs out.
+; Slot 0 belongs to the text module. 8 bytes per slot:
+;   +0 VRAM word address, +2 buffer address (bank $00, 0 = slot unused),
+;   +4 dirty rows (32-bit mask, bit n = row n)
+;------------------------------------------------------------------------------
+
+.RAMSECTION ".tilemap_shadow" BANK 0 SLOT 1
+    tilemap_shadow  dsb 32
+.ENDS
+
+;------------------------------------------------------------------------------
+; OAM DMA Window
+;------------------------------------------------------------------------------
+; The NMI OAM DMA sends sprites 0..n-1 of the low table plus their high-table
+; bytes, n = max(oam_dma_count, oam_dma_sent): the active count set by
+; oamSetActiveCount, or the previous one while a shrink still has to push
+; the sprites it just hid. n = 128 is the plain 544-byte transfer.
+; oam_dma_src is the bank $7E buffer the DMA reads: oamMemory, or the front
+; buffer WaitForVBlank fills in double-buffered mode (oamSetDoubleBuffer).
+;------------------------------------------------------------------------------
+
+.RAMSECTION ".oam_dma" BANK 0 SLOT 1
+    oam_dma_count   dsb 2   ; Active sprites (oamSetActiveCount, default 128)
+    oam_dma_sent    dsb 2   ; Active count at the last OAM DMA
+    oam_dma_src     dsb 2   ; DMA source offset in bank $7E
+.ENDS
+
+;------------------------------------------------------------------------------
+; Sprite Line Overflow Counters
+;------------------------------------------------------------------------------
+; Frames whose picture hit the PPU's per-scanline sprite limits, from the
+; STAT77 flags the NMI reads ($213E bit 6: more than 32 sprites on a line,
+; bit 7: more than 34 sprite tiles). Read with oamGetRangeOverFrames /
+; oamGetTimeOverFrames.
+;------------------------------------------------------------------------------
+
+.RAMSECTION ".oam_overflow" BANK 0 SLOT 1
+    oam_range_over  dsb 2   ; Frames with >32 sprites on some line
+    oam_time_over   dsb 2   ; Frames with >34 sprite tiles on some line
 .ENDS
 
 ;------------------------------------------------------------------------------
 ; Super Scope State Variables (port 2 only)
 ;------------------------------------------------------------------------------
 ; Separate RAMSECTION to avoid inflating ".system" (which must stay small
-; enough for the linker to place variables like tilemap_src_addr within
+; enough for the linker to place variables like tilemap_update_flag within
 ; 8-bit direct page addressing range).
 ;------------------------------------------------------------------------------
 
@@ -242,6 +306,13 @@
 
     ; Queue state
     oamqueuenumber          dsb 2   ; Current position in VRAM upload queue
+    oamqueueprio            dsb 2   ; Bytes of priority entries at the queue front
+
+    ; VRAM upload budget (oamDynamicSetVramBudget / oamDynamicDeferredCount)
+    oam_dyn_vram_budget     dsb 2   ; Upload bytes allowed per VBlank
+    oam_dyn_budget_left     dsb 2   ; NMI scratch: bytes left this VBlank
+    oam_dyn_entry_bytes     dsb 2   ; NMI scratch: current entry size
+    oam_dyn_deferred        dsb 2   ; VBlanks that ended with uploads queued
 
     ; Per-frame sprite tracking
     oamnumberperframe       dsb 2   ; Number of sprites drawn this frame (×4)
@@ -581,6 +652,43 @@ FastStart:
     lda #:DefaultDynamicFlush
     sta dynamic_flush_hook+2
 
+    ; The DMA queue hook shares the same no-op stub until dmaQueueInit runs.
+    rep #$20
+    .ACCU 16
+    lda #DefaultDynamicFlush
+    sta dma_queue_hook
+    lda #4096               ; DMA_VBLANK_BUDGET (dma.h)
+    sta vblank_dma_budget
+    lda #128                ; Whole OAM, straight from oamMemory
+    sta oam_dma_count
+    sta oam_dma_sent
+    lda #oamMemory
+    sta oam_dma_src
+    sep #$20
+    .ACCU 8
+    lda #:DefaultDynamicFlush
+    sta dma_queue_hook+2
+
+    ; IRQs only acknowledge until irqInit installs the scheduler
+    rep #$20
+    .ACCU 16
+    lda #IrqDefault
+    sta irq_hook
+    sep #$20
+    .ACCU 8
+    lda #:IrqDefault
+    sta irq_hook+2
+
+    ; No front buffer until oamSetDoubleBuffer links one in
+    rep #$20
+    .ACCU 16
+    lda #DefaultDynamicFlush
+    sta oam_front_hook
+    sep #$20
+    .ACCU 8
+    lda #:DefaultDynamicFlush
+    sta oam_front_hook+2
+
     ; Clear frame counters (16-bit)
     rep #$20
     .ACCU 16
@@ -817,12 +925,16 @@ CopyInitData:
 ; Execution order (PVSnesLib-aligned):
 ;   1. OAM DMA        — VBlank-critical (VRAM write)
 ;   2. Tilemap DMA    — VBlank-critical (VRAM write)
+;   2b. DMA queue     — VBlank-critical (budgeted, via dma_queue_hook)
 ;   3. BG scroll sync — VBlank-critical (PPU register write)
 ;   4. User callback  — not VBlank-critical
 ;   5. Joypad read    — not VBlank-critical ($4218/$421A readable anytime)
 ;   6. Mouse read     — not VBlank-critical ($4016/$4017 serial)
 ;   7. Super Scope    — not VBlank-critical (PPU latch + $421A)
 ;
+; Every VRAM-critical transfer adds its byte count to vblank_dma_bytes, so
+; the DMA queue (2b) only spends what is left of the per-frame budget.
+;
 ; WARNING: Do NOT use the WRAM data port ($2180-$2183) in NMI code.
 ; Main-thread code (HDMA table construction, map streaming, object updates)
 ; writes multi-byte sequences to $2180 with an address set via $2181-$2183.
@@ -883,6 +995,22 @@ FastNmi:
 @vblank_work:
     rep #$20
     .ACCU 16
+    stz.w vblank_dma_bytes          ; New VBlank: nothing DMA'd yet
+
+    ; Sprite line overflow in the frame just drawn (STAT77 flags are
+    ; cleared at the end of VBlank, so they cover exactly one frame)
+    sep #$20
+    .ACCU 8
+    lda.w $213E
+    rep #$20
+    .ACCU 16
+    bit.w #$0040
+    beq +
+    inc.w oam_range_over            ; Range over: >32 sprites on a line
++   bit.w #$0080
+    beq +
+    inc.w oam_time_over             ; Time over: >34 sprite tiles on a line
++
 
     ;==========================================================================
     ; Dynamic sprite engine: end-of-frame + VRAM tile queue flush (via hook)
@@ -920,42 +1048,98 @@ FastNmi:
     ; Uses DMA channel 7 (channel 0 reserved for main-thread dmaCopyVram).
     ; PVSnesLib reference: vblank.asm lines 670-687.
     ;
+    ; Only the active window is sent (see .oam_dma): n*4 low-table bytes and
+    ; (n+3)/4 high-table bytes, 170 bytes instead of 544 for 40 sprites.
+    ;
     ; NOTE: All system variable accesses use .w (absolute addressing) because
     ; D = tcc__nmi_registers (!= 0). Without .w, WLA-DX may emit DP-relative
     ; instructions that would read from the wrong address.
     ;--------------------------------------------------------------------------
     lda.w oam_update_flag
-    beq @oam_done
-    stz.w oam_update_flag
+    bne +
+    jmp @oam_done
++   stz.w oam_update_flag
 
-    ; Set OAM address to 0 (word register — use 16-bit A)
+    ; n = max(active count, count at the last DMA) sprites to send
     rep #$20
     .ACCU 16
+    lda.w oam_dma_count
+    cmp.w oam_dma_sent
+    bcs +
+    lda.w oam_dma_sent
++   ldx.w oam_dma_count
+    stx.w oam_dma_sent
+    sta.b 0                 ; dp scratch (D = tcc__nmi_registers)
+    beq @oam_none           ; No active sprites, nothing left to hide
+
+    ; Set OAM address to 0 (word register — use 16-bit A)
     stz.w $2102             ; OAMADDL/H = 0
 
     ; DMA channel 7: CPU→PPU, auto-increment, dest $2104 (OAMDATA)
     lda.w #$0400
     sta.w $4370             ; $4370 = mode ($00), $4371 = dest ($04)
 
-    ; Source: oamMemory ($7E:0300)
-    lda.w #oamMemory
+    ; Source: oamMemory ($7E:0300) or the double-buffer front copy
+    lda.w oam_dma_src
     sta.w $4372             ; Source address low/high
     sep #$20
     .ACCU 8
     lda.b #:oamMemory       ; Source bank ($7E)
     sta.w $4374
 
-    ; Transfer size: 544 bytes ($0220)
     rep #$20
     .ACCU 16
-    lda.w #$0220
+    lda.b 0
+    cmp.w #128
+    bne @oam_partial
+    lda.w #$0220            ; All 128 sprites: one 544-byte transfer
+    bra @oam_last
+
+@oam_partial:
+    .ACCU 16
+    asl a                   ; Low table prefix: 4 bytes per sprite
+    asl a
     sta.w $4375             ; DMA size
+    clc
+    adc.w vblank_dma_bytes
+    sta.w vblank_dma_bytes  ; Charge it to this VBlank's budget
+    sep #$20
+    .ACCU 8
+    lda.b #$80
+    sta.w $420B             ; MDMAEN: channel 7
+
+    ; High table prefix: 1 byte per 4 sprites, at OAM word $100
+    rep #$20
+    .ACCU 16
+    lda.w #$0100
+    sta.w $2102
+    lda.w oam_dma_src
+    clc
+    adc.w #512
+    sta.w $4372
+    lda.b 0
+    clc
+    adc.w #3
+    lsr a
+    lsr a
+
+@oam_last:
+    .ACCU 16
+    sta.w $4375             ; DMA size
+    clc
+    adc.w vblank_dma_bytes
+    sta.w vblank_dma_bytes  ; Charge it to this VBlank's budget
 
     ; Start DMA channel 7
     sep #$20
     .ACCU 8
     lda.b #$80
     sta.w $420B             ; MDMAEN: channel 7
+    bra @oam_done
+
+@oam_none:
+    sep #$20
+    .ACCU 8
 @oam_done:
 
     ;--------------------------------------------------------------------------
@@ -964,11 +1148,22 @@ FastNmi:
     lda.w tilemap_update_flag
     beq +
     stz.w tilemap_update_flag
-    jsl tilemapFlush
+    jsl tilemapFlushNmi
     sep #$20            ; Restore 8-bit A after C function
     .ACCU 8
 +
 
+    ;--------------------------------------------------------------------------
+    ; 2b. Drain the VBlank DMA queue (dmaQueueVram/CGram/Oam)
+    ;--------------------------------------------------------------------------
+    ; No-op stub until dmaQueueInit repoints the hook. The drain only spends
+    ; what OAM/tilemap left of the per-frame budget; the rest rolls over.
+    ;--------------------------------------------------------------------------
+    phk                             ; Push current program bank
+    pea @dma_queue_done-1           ; Push return offset (for RTL)
+    jml [dma_queue_hook]            ; Long indirect call
+@dma_queue_done:                    ; Hook preserves P (8-bit A on return)
+
     ;--------------------------------------------------------------------------
     ; 3. Sync BG scroll shadows to hardware ($210D-$2114)
     ;--------------------------------------------------------------------------
@@ -1229,11 +1424,29 @@ DefaultDynamicFlush:
 ; user code writing oamMemory[] directly must do the same. See
 ; `KNOWN_LIMITATIONS.md` (Performance traps) for the canonical pattern.
 ;
+; Double-buffered OAM (oam_dma_src != oamMemory): when the flag is set, the
+; sprites the NMI is about to send are first copied to the front buffer
+; (oam_front_hook, OamFrontCopy in sprite_double), so the NMI never reads
+; the buffer the game writes into.
+;
 ; KEEP: X, Y (documented in interrupt.h, used by video.asm)
 ;------------------------------------------------------------------------------
 WaitForVBlank:
     php
+    rep #$20
+    .ACCU 16
+    lda.l oam_dma_src
+    cmp #oamMemory
+    beq +                   ; Single buffer: the NMI reads oamMemory
     sep #$20
+    .ACCU 8
+    lda.l oam_update_flag
+    beq +
+    phk                     ; Push current program bank
+    pea @front_done-1       ; Push return offset (for RTL)
+    jml [oam_front_hook]    ; Long indirect call
+@front_done:
++   sep #$20
     .ACCU 8
     lda #$01
     sta.l vblank_flag       ; Signal: "main thread ready"
@@ -1750,9 +1963,14 @@ ReadScope:
 ; IrqHandler - Hardware IRQ (H/V counter, etc.)
 ;------------------------------------------------------------------------------
 ; Called when H/V timer IRQ fires (if enabled via $4200).
-; Must read TIMEUP ($4211) to acknowledge the interrupt.
+; Jumps through irq_hook before touching any register, so the handler it
+; points at owns the whole prologue (irqInit installs irqDispatch).
+; The handler must read TIMEUP ($4211) to acknowledge the interrupt.
 ;------------------------------------------------------------------------------
 IrqHandler:
+    jml [irq_hook]      ; Reads the pointer from bank $00
+
+IrqDefault:
     sep #$20            ; 8-bit A
     .ACCU 8
     lda $4211           ; Read TIMEUP to acknowledge IRQ
@@ -1771,17 +1989,48 @@ IrqHandler:
 ;==============================================================================
 
 ;==============================================================================
-; Tilemap Flush (DMA tilemap buffer to VRAM)
+; Tilemap Flush (DMA dirty shadow tilemap rows to VRAM)
 ;==============================================================================
-; Called during VBlank by NMI handler when tilemap_update_flag is set.
-; DMA transfers 2048 bytes from tilemapBuffer ($7E:3000) to VRAM.
-; Uses DMA channel 1 to avoid conflicting with OAM on channel 0/7.
+; Walks the shadow tilemap slots in priority order (slot 0 first). For each
+; slot, only rows flagged in its dirty mask are sent: consecutive dirty rows
+; are merged into one span and every span gets its own DMA, all in this
+; single call. A one-glyph HUD update costs 64 bytes instead of 2048. Each
+; row is 32 entries = 64 bytes of the buffer, 32 words of VRAM.
+; Uses DMA channel 1 to avoid conflicting with OAM on channel 7.
+;
+; tilemapFlushNmi — NMI entry. Never sends past the VBlank budget
+;   (vblank_dma_budget): a span is cut to the whole rows that still fit,
+;   and the rows left over, in that slot and the later ones, stay in the
+;   dirty masks with tilemap_update_flag re-armed for the next VBlank.
+; tilemapFlush    — main-thread entry for forced blank: flushes every slot,
+;   no budget.
+;
+; Not bank-critical (always reached via JSL), so it lives outside bank $00.
 ;==============================================================================
 
-.SECTION ".tilemap_flush" SEMIFREE
+.EQU TILEMAP_SHADOW_SLOTS   4   ; must match BG_SHADOW_SLOTS in background.h
+.EQU TMS_VRAM               0
+.EQU TMS_SRC                2
+.EQU TMS_DIRTY              4
+
+.SECTION ".tilemap_flush" SUPERFREE
 
 tilemapFlush:
     php
+    rep #$20
+    .ACCU 16
+    lda #$FFFF          ; Forced blank: unlimited
+    bra _tmf_start
+
+tilemapFlushNmi:
+    php
+    rep #$20
+    .ACCU 16
+    lda.l vblank_dma_budget
+
+_tmf_start:
+    .ACCU 16
+    pha                 ; 2-3,s = budget for this call (after PHB)
     phb                 ; Save current data bank
 
     ; Set DBR to $00 for hardware register access
@@ -1792,37 +2041,190 @@ tilemapFlush:
     sep #$20            ; 8-bit A
     .ACCU 8
     lda #$80
-    sta $2115           ; VMAIN: increment after high byte write
+    sta.w $2115         ; VMAIN: increment after high byte write
+    stz.w $4314         ; DMA source bank $00 (buffers always < $2000)
 
-    rep #$20            ; 16-bit A
+    rep #$30            ; 16-bit A, X/Y
     .ACCU 16
-    lda.w tilemap_vram_addr
-    sta $2116           ; VMADDL/H: VRAM word address
+    .INDEX 16
 
     ; DMA channel 1: word write mode (2 regs write once: VMDATAL+VMDATAH)
     lda #$1801          ; Mode 01 (ab), target $18 (VMDATAL)
-    sta $4310
-
-    ; Transfer size = 2048 bytes
-    lda #2048
-    sta $4315
-
-    ; Source address from tilemap_src_addr (set by textInit in C)
-    lda.w tilemap_src_addr
-    sta $4312           ; DMA source address (low word)
-
-    sep #$20            ; 8-bit A
+    sta.w $4310
+
+    lda #0
+_tmf_slot:
+    tax                 ; X = slot offset
+    lda.w tilemap_shadow+TMS_DIRTY,x
+    ora.w tilemap_shadow+TMS_DIRTY+2,x
+    beq _tmf_next_slot  ; Nothing dirty
+    lda.w tilemap_shadow+TMS_SRC,x
+    beq _tmf_drop       ; Unused slot: discard stray dirty bits
+    lda.w vblank_dma_bytes
+    cmp 2,s
+    bcc +
+    ; Out of budget: keep this slot's rows for the next VBlank
+    sep #$20
     .ACCU 8
-    lda #$00            ; Bank $00 (WRAM mirror, buffer always < $2000)
-    sta $4314           ; DMA source bank
+    lda #1
+    sta.w tilemap_update_flag
+    rep #$20
+    .ACCU 16
+    bra _tmf_next_slot
++
+    jsr _tmf_flush_slot
+    bra _tmf_next_slot
 
-    lda #$02            ; Enable DMA channel 1
-    sta $420B
+_tmf_drop:
+    stz.w tilemap_shadow+TMS_DIRTY,x
+    stz.w tilemap_shadow+TMS_DIRTY+2,x
+
+_tmf_next_slot:
+    txa
+    clc
+    adc #8
+    cmp #TILEMAP_SHADOW_SLOTS*8
+    bcc _tmf_slot
 
     plb                 ; Restore data bank
+    pla                 ; Drop budget
     plp
     rtl                 ; Return long (called with JSL)
 
+;------------------------------------------------------------------------------
+; _tmf_flush_slot - DMA the dirty spans of one slot within the budget
+;   (consumes the mask of the rows it sends)
+;   IN: X = slot offset, A/X/Y 16-bit, DB = $00, channel 1 set up,
+;       budget of the call at 4-5,s
+;   OUT: X preserved
+;------------------------------------------------------------------------------
+_tmf_flush_slot:
+    .ACCU 16
+    .INDEX 16
+    txy                 ; Y = slot offset (X = row below)
+    phx
+    ldx #0              ; X = current row
+_tmf_scan:
+    lda.w tilemap_shadow+TMS_DIRTY,y
+    ora.w tilemap_shadow+TMS_DIRTY+2,y
+    beq _tmf_slot_done  ; No dirty rows left
+    lda.w tilemap_shadow+TMS_DIRTY+2,y
+    lsr a
+    sta.w tilemap_shadow+TMS_DIRTY+2,y
+    lda.w tilemap_shadow+TMS_DIRTY,y
+    ror a
+    sta.w tilemap_shadow+TMS_DIRTY,y    ; C = row X dirty
+    bcc _tmf_next
+
+    phx                 ; 1-2,s = first row of the span
+_tmf_extend:
+    inx
+    lda.w tilemap_shadow+TMS_DIRTY+2,y
+    lsr a
+    sta.w tilemap_shadow+TMS_DIRTY+2,y
+    lda.w tilemap_shadow+TMS_DIRTY,y
+    ror a
+    sta.w tilemap_shadow+TMS_DIRTY,y
+    bcs _tmf_extend     ; Stops at the first clean row (or past row 31)
+
+    ; Span = rows (1,s)..X-1, cut to the whole rows the budget still has
+    ; room for
+    phx                 ; 1-2,s = end of the span, 3-4,s = first row
+    lda 10,s            ; Budget of this call
+    sec
+    sbc.w vblank_dma_bytes
+    bcs +
+    lda #0              ; Already spent
++   lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    lsr a               ; Rows that still fit
+    clc
+    adc 3,s             ; First row that does not fit
+    cmp 1,s
+    bcs +
+    tax                 ; Span cut short: X = first row left over
++   txa
+    sec
+    sbc 3,s             ; Row count
+    beq _tmf_cut        ; Not even one row fits
+    xba
+    lsr a
+    lsr a               ; × 64 bytes per row
+    sta.w $4315         ; DMA size
+    clc
+    adc.w vblank_dma_bytes
+    sta.w vblank_dma_bytes  ; Charge this VBlank's DMA budget
+    lda 3,s             ; First row
+    asl a
+    asl a
+    asl a
+    asl a
+    asl a               ; × 32 words per row
+    pha
+    clc
+    adc.w tilemap_shadow+TMS_VRAM,y
+    sta.w $2116         ; VMADDL/H: VRAM word address
+    pla
+    asl a               ; × 64 bytes per row
+    clc
+    adc.w tilemap_shadow+TMS_SRC,y
+    sta.w $4312         ; DMA source address (low word)
+
+    sep #$20
+    .ACCU 8
+    lda #$02            ; Enable DMA channel 1
+    sta.w $420B
+    rep #$20
+    .ACCU 16
+
+    txa
+    cmp 1,s
+    bcc _tmf_cut        ; Rows of the span left over
+    pla                 ; Drop end and first row
+    pla
+
+_tmf_next:
+    inx
+    bra _tmf_scan
+
+_tmf_slot_done:
+    plx
+    rts
+
+    ; Out of budget: rows X..end-1 and every row past the span go back
+    ; into the mask. The scan shifted end+1 bits out; shift them back in
+    ; from row end down to row 0, setting those that were not sent.
+_tmf_cut:
+    txa
+    sta 3,s             ; 3-4,s = first row left over
+    plx                 ; X = end of the span (a clean row, or 32)
+    clc                 ; Row end stays clean
+    bra _tmf_back1
+_tmf_back:
+    txa
+    cmp 1,s             ; C = row X left over
+_tmf_back1:
+    lda.w tilemap_shadow+TMS_DIRTY,y
+    rol a
+    sta.w tilemap_shadow+TMS_DIRTY,y
+    lda.w tilemap_shadow+TMS_DIRTY+2,y
+    rol a
+    sta.w tilemap_shadow+TMS_DIRTY+2,y
+    dex
+    bpl _tmf_back
+
+    pla                 ; Drop the first row left over
+    sep #$20
+    .ACCU 8
+    lda #1
+    sta.w tilemap_update_flag   ; Finish on the next VBlank
+    rep #$20
+    .ACCU 16
+    bra _tmf_slot_done
+
 .ENDS
 
 ;==============================================================================
@@ -100,6 +100,12 @@ cmdp_action_t argument_callback(cmdp_process_param_st *params)
 		}
 	}
 
+	// only one compression format at a time
+	if (gfx4snes_args.tilelzpacked && gfx4snes_args.tilelz4packed)
+	{
+		fatal("-z (lz77) and -Z (lz4) can't be used together\nconversion terminated."); // exit gfx4snes at this point
+	}
+
 	// Maps options -----------------------------------------------
 	// check tile offset for map (default is 0)
 	if ( (gfx4snes_args.tileoffset<0) || (gfx4snes_args.tileoffset>2047) )
@@ -42,6 +42,7 @@ static cmdp_command_st gfx4snes_command = {
 			{'s', "til-size", "size of image blocks in pixels {[8],16,32,64}", CMDP_TYPE_INT4, &gfx4snes_args.tilesize},
 			{'k', "til-pack", "output in packed pixel format", CMDP_TYPE_BOOL, &gfx4snes_args.tilepacked},
 			{'z', "til-lzpack", "add blank tile management (for multiple bgs)", CMDP_TYPE_BOOL, &gfx4snes_args.tilelzpacked},
+			{'Z', "til-lz4pack", "compress tiles with the fast lz4 codec (lz4Decode)", CMDP_TYPE_BOOL, &gfx4snes_args.tilelz4packed},
 			{'W', "tile-width", "width of image block in pixels", CMDP_TYPE_INT4, &gfx4snes_args.tilewidth},
 			{'H', "tile-height", "height of image block in pixels", CMDP_TYPE_INT4, &gfx4snes_args.tileheight},
 			{'S', "sprite-map", "print sprite tile number map for sheet", CMDP_TYPE_BOOL, &gfx4snes_args.spritemap},
@@ -217,7 +218,7 @@ int main(int argc, const char **argv)
 	}
 	else
 	{
-		tiles_save (gfx4snes_args.filebase, tiles_snes,nbtiles, gfx4snes_args.palettecolors, gfx4snes_args.tileblank, gfx4snes_args.tilelzpacked,gfx4snes_args.quietmode);
+		tiles_save (gfx4snes_args.filebase, tiles_snes,nbtiles, gfx4snes_args.palettecolors, gfx4snes_args.tileblank, gfx4snes_args.tilelzpacked, gfx4snes_args.tilelz4packed,gfx4snes_args.quietmode);
 	}
 
 	// save palette if needed
@@ -38,6 +38,7 @@ typedef struct
     int tileheight;
     int notilereduction;	        								    		// 1 = no tile reduction (warning !)
     int tilelzpacked;                     										// 1 = compress file with LZSS algorithm
+    int tilelz4packed;                    										// 1 = compress file with the LZ4-style fast codec
     int tilepacked;                     										// 1 = compress file with packed pixel format
     int tileoffset;                                                             // tile offset (0..2047)
     int mapscreenmode;															// screen mode for map generation (1 or 7)
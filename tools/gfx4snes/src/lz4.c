@@ -0,0 +1,221 @@
+/*---------------------------------------------------------------------------------
+
+	LZ4-style compressor for the OpenSNES lz4 module (lib/source/lz4.asm)
+
+	Byte-aligned block format designed for a fast 65816 decoder: no bit
+	flags, literal runs and matches are both copied with MVN.
+
+	Header:
+	  tag 0x40, then the uncompressed size (3 bytes, little-endian)
+
+	Sequences, until the output reaches the size:
+	  token      high nibble = literal count, low nibble = match length - 4
+	             (15 in either nibble: add the extension bytes that follow)
+	  [ext]      literal count extension, 255 means "add and continue"
+	  literals
+	  offset     2 bytes, little-endian backward distance (1..65535)
+	  [ext]      match length extension, same encoding
+
+	The last sequence may stop right after its literals. Matches can overlap
+	their own output (distance < length): the decoder copies forward.
+
+	This is not the lz4 tool's frame format, only the same token idea.
+
+	Use, distribute, and modify this code freely.
+
+***************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "lz4.h"
+
+#define CPRS_LZ4_TAG 0x40
+
+#define LZ4_MINMATCH        4                                               // shortest match worth a 2-byte offset
+#define LZ4_MAXDIST         65535                                           // offset is 16-bit
+#define LZ4_MAXSIZE         65535                                           // decoder keeps the size in 16 bits
+#define LZ4_HASHBITS        14
+#define LZ4_MAXCHAIN        256                                             // candidates checked per position
+#define NIL                 -1
+
+static int *hashhead, *hashprev;
+
+//-------------------------------------------------------------------------------------------------
+static unsigned int lz4_hash(const unsigned char *p)
+{
+	unsigned int v = p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24);
+
+	return (v * 2654435761U) >> (32 - LZ4_HASHBITS);
+}
+
+//-------------------------------------------------------------------------------------------------
+static void lz4_insert(const unsigned char *bufin, int buflen, int pos)
+{
+	unsigned int h;
+
+	if (pos + LZ4_MINMATCH > buflen)
+		return;
+	h = lz4_hash(bufin + pos);
+	hashprev[pos] = hashhead[h];
+	hashhead[h] = pos;
+}
+
+//-------------------------------------------------------------------------------------------------
+// longest match for bufin[pos..], nearest one on ties; returns its length (0 if < LZ4_MINMATCH)
+static int lz4_findmatch(const unsigned char *bufin, int buflen, int pos, int *dist)
+{
+	int cand, len, bestlen, chain, maxlen;
+
+	bestlen = 0;
+	if (pos + LZ4_MINMATCH > buflen)
+		return 0;
+
+	maxlen = buflen - pos;
+	cand = hashhead[lz4_hash(bufin + pos)];
+	for (chain = 0; (cand != NIL) && (chain < LZ4_MAXCHAIN); chain++, cand = hashprev[cand])
+	{
+		if (pos - cand > LZ4_MAXDIST)
+			break;
+		if (bufin[cand + bestlen] != bufin[pos + bestlen])
+			continue;
+		for (len = 0; (len < maxlen) && (bufin[cand + len] == bufin[pos + len]); len++);
+		if (len > bestlen)
+		{
+			bestlen = len;
+			*dist = pos - cand;
+			if (len == maxlen)
+				break;
+		}
+	}
+
+	return (bestlen >= LZ4_MINMATCH) ? bestlen : 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+static int lz4_putlength(unsigned char *bufout, int outpos, int len)
+{
+	len -= 15;
+	while (len >= 255)
+	{
+		bufout[outpos++] = 255;
+		len -= 255;
+	}
+	bufout[outpos++] = (unsigned char) len;
+
+	return outpos;
+}
+
+//-------------------------------------------------------------------------------------------------
+// writes one sequence: litlen literals from lit, then a match (matchlen 0 = literals only)
+static int lz4_putsequence(unsigned char *bufout, int outpos, const unsigned char *lit, int litlen, int matchlen, int dist)
+{
+	int token;
+
+	token = (litlen >= 15 ? 15 : litlen) << 4;
+	if (matchlen)
+		token |= (matchlen - LZ4_MINMATCH >= 15) ? 15 : matchlen - LZ4_MINMATCH;
+	bufout[outpos++] = (unsigned char) token;
+
+	if (litlen >= 15)
+		outpos = lz4_putlength(bufout, outpos, litlen);
+	memcpy(bufout + outpos, lit, litlen);
+	outpos += litlen;
+
+	if (matchlen)
+	{
+		bufout[outpos++] = LOW_BYTE(dist);
+		bufout[outpos++] = HI_BYTE(dist);
+		if (matchlen - LZ4_MINMATCH >= 15)
+			outpos = lz4_putlength(bufout, outpos, matchlen - LZ4_MINMATCH);
+	}
+
+	return outpos;
+}
+
+//-------------------------------------------------------------------------------------------------
+// bufout must hold at least LZ4_BOUND(buflen) bytes
+int Convert2PicLZ4(unsigned char *bufin, int buflen, unsigned char *bufout,int quietmode)
+{
+	int i, pos, litstart, len, dist, nextlen, nextdist, outsize;
+
+	if (buflen == 0)
+	{
+		errorcontinue("size to compress is null");
+		return 0;
+	}
+	if (buflen > LZ4_MAXSIZE)
+	{
+		errorcontinue("lz4 compression is limited to %d bytes (got %d)", LZ4_MAXSIZE, buflen);
+		return 0;
+	}
+
+	hashhead = (int *) malloc((1 << LZ4_HASHBITS) * sizeof(int));
+	hashprev = (int *) malloc(buflen * sizeof(int));
+	if ((hashhead == NULL) || (hashprev == NULL))
+	{
+		free(hashhead);
+		free(hashprev);
+		errorcontinue("can't allocate memory for lz4 compression");
+		return 0;
+	}
+	for (i = 0; i < (1 << LZ4_HASHBITS); i++)
+		hashhead[i] = NIL;
+
+	bufout[0] = CPRS_LZ4_TAG;
+	bufout[1] = (buflen >> 0) & 0xFF;
+	bufout[2] = (buflen >> 8) & 0xFF;
+	bufout[3] = (buflen >> 16) & 0xFF;
+	outsize = 4;
+
+	pos = 0;
+	litstart = 0;
+	while (pos < buflen)
+	{
+		len = lz4_findmatch(bufin, buflen, pos, &dist);
+		if (len)
+		{
+			// lazy evaluation: a longer match one byte later is worth a literal
+			lz4_insert(bufin, buflen, pos);
+			nextlen = lz4_findmatch(bufin, buflen, pos + 1, &nextdist);
+			if (nextlen > len + 1)
+			{
+				pos++;
+				len = nextlen;
+				dist = nextdist;
+			}
+			else
+			{
+				hashhead[lz4_hash(bufin + pos)] = hashprev[pos];          // re-inserted below with the match
+			}
+
+			outsize = lz4_putsequence(bufout, outsize, bufin + litstart, pos - litstart, len, dist);
+			for (i = 0; i < len; i++)
+				lz4_insert(bufin, buflen, pos + i);
+			pos += len;
+			litstart = pos;
+		}
+		else
+		{
+			lz4_insert(bufin, buflen, pos);
+			pos++;
+		}
+	}
+
+	// trailing literals end the stream
+	if (litstart < buflen)
+		outsize = lz4_putsequence(bufout, outsize, bufin + litstart, buflen - litstart, 0, 0);
+
+	free(hashhead);
+	free(hashprev);
+
+	// return an error if ratio<100
+	if (((buflen * 100) / outsize) < 100)
+	{
+		errorcontinue("ratio for compression is not good (%d%%))", ((buflen * 100) / outsize));
+		return 0;
+	}
+
+	if (!quietmode) info("compression Lz4 from %d bytes to %d bytes (ratio %d%%)", buflen, outsize, ((buflen * 100) / outsize) - 100);
+
+	return outsize;
+}
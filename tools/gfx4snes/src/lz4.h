@@ -0,0 +1,13 @@
+#ifndef _GFX4SNES_LZ4_H
+#define _GFX4SNES_LZ4_H
+
+#include "common.h"
+
+#include "errors.h"
+
+//-------------------------------------------------------------------------------------------------
+#define LZ4_BOUND(n) ((n) + ((n) / 255) + 16)                                // worst case output size
+
+extern int Convert2PicLZ4(unsigned char *bufin, int buflen, unsigned char *bufout,int quietmode);
+
+#endif
@@ -126,8 +126,9 @@ unsigned char *tiles_convertsnes (unsigned char *imgbuf, int imgwidth, int imghe
 // nbcolors = number of colors of the graphic tile buffer
 // addblank = 1 if we need to add a blank tile
 // lzcompress = 1 if we want lz77 compression
+// lz4compress = 1 if we want lz4 compression (fast decoder, exclusive with lzcompress)
 // isquiet = 0 if we want some messages in console
-void tiles_save (const char *filename, unsigned char *tiles,int nbtiles, int nbcolors, bool addblank, bool lzcompress,bool isquiet)
+void tiles_save (const char *filename, unsigned char *tiles,int nbtiles, int nbcolors, bool addblank, bool lzcompress, bool lz4compress,bool isquiet)
 {
 	char *outputname;
 	FILE *fp;
@@ -230,6 +231,28 @@ void tiles_save (const char *filename, unsigned char *tiles,int nbtiles, int nbc
 			fatal("error during lz77 compression");
         }
 	}
+	// Prepare outside buffer if lz4
+	else if (lz4compress) {
+        if (!isquiet) info("compress graphics in lz4 format...");
+	    bufsizeout = LZ4_BOUND(nbbytestowrite);
+	    buftolzout = (unsigned char *) malloc(bufsizeout);
+    	if (buftolzout == NULL)
+    	{
+			free(buftolzin);
+			free (outputname);
+			fatal("can't allocate enough memory for the tiles buffer compression");
+        }
+
+        // Compress data and save to disc
+		bufsize = Convert2PicLZ4(buftolzin, nbbytestowrite, buftolzout,isquiet);
+        if (bufsize ==0)
+        {
+			free(buftolzout);
+			free(buftolzin);
+			free (outputname);
+			fatal("error during lz4 compression");
+        }
+	}
 	// no compression, get the default values
 	else
 	{
@@ -242,7 +265,7 @@ void tiles_save (const char *filename, unsigned char *tiles,int nbtiles, int nbc
 	fp = fopen(outputname,"wb");
 	if(fp==NULL)
 	{
-		if (lzcompress) free(buftolzout);
+		if (lzcompress || lz4compress) free(buftolzout);
 		free(buftolzin);
 		errorcontinue("can't open tiles file [%s] for writing", outputname);
 		free (outputname);
@@ -255,7 +278,7 @@ void tiles_save (const char *filename, unsigned char *tiles,int nbtiles, int nbc
 
 	// close file and leave
 	fclose(fp);
-	if (lzcompress) free(buftolzout);
+	if (lzcompress || lz4compress) free(buftolzout);
 	free(buftolzin);
 	free (outputname);
 }
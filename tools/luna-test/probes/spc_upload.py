@@ -0,0 +1,79 @@
+"""Probe: SNESMOD module upload time (SPC transfer benchmark).
+
+`snesmodLoadModule` pushes the module and its samples through the APU ports.
+The transfer sends 3 bytes per handshake. Counted from the instruction
+timings (polling excluded), the SPC loop costs 53 SPC cycles per 3 bytes and
+the original loop 44 per 2 bytes. The old loop is not run: the measured upload
+must beat its computed floor, size / 2 * 44 cycles.
+
+The load is timed in frames (`frame_count`, the NMI keeps running) between two
+monotonic markers found by bisection on `-n`:
+  * start — `spc_bank` set (snesmodSetSoundbank, called just before the load)
+  * end   — `spc_fwrite` non-zero (snesmodPlay queues right after the load)
+The byte count is the SPC write pointer (ARAM $00/$01) past the module base.
+"""
+from __future__ import annotations
+
+import subprocess
+import sys
+from pathlib import Path
+
+from lib import find_luna, load_symbols, peek, peek_word, rom_path
+
+ROM = "audio/snesmod_music_large/music_large.sfc"   # 56 KB soundbank, 2 banks
+MAX_STEPS = 8_000_000
+RESOLUTION = 20_000          # instructions; well under one frame
+
+SPC_HZ = 1_024_000
+NTSC_FPS = 60.0988
+MODULE_BASE = 0x1A00         # driver's module load address
+COMPAT_CYCLES_PER_WORD = 44  # original 2-byte loop, counted, no polling
+
+
+def _first_step(luna: str, rom: Path, bank: int, off: int) -> int:
+    """Smallest -n (to RESOLUTION) at which the byte at bank:off is non-zero."""
+    lo, hi = 0, MAX_STEPS
+    if peek(luna, rom, hi, bank, off, 1)[0] == 0:
+        raise RuntimeError(f"marker {bank:02X}:{off:04X} never set")
+    while hi - lo > RESOLUTION:
+        mid = (lo + hi) // 2
+        if peek(luna, rom, mid, bank, off, 1)[0]:
+            hi = mid
+        else:
+            lo = mid
+    return hi
+
+
+def _spc_pointer(luna: str, rom: Path, steps: int) -> int:
+    out = Path("/tmp/luna-spc") / f"{rom.stem}.aram"
+    out.parent.mkdir(parents=True, exist_ok=True)
+    subprocess.run([luna, "state", "-n", str(steps), "--dump-aram", str(out),
+                    "--out", "/dev/null", str(rom)],
+                   capture_output=True, text=True, timeout=300)
+    aram = out.read_bytes()
+    return aram[0] | (aram[1] << 8)
+
+
+def run() -> tuple[bool, str]:
+    luna = find_luna()
+    rom = rom_path(ROM)
+    syms = load_symbols(rom)
+    start = _first_step(luna, rom, *syms["spc_bank"])
+    end = _first_step(luna, rom, *syms["spc_fwrite"])
+    fbank, foff = syms["frame_count"]
+    frames = peek_word(luna, rom, end, fbank, foff) - peek_word(luna, rom, start, fbank, foff)
+
+    size = _spc_pointer(luna, rom, end) - MODULE_BASE
+    compat = size / 2 * COMPAT_CYCLES_PER_WORD / SPC_HZ * NTSC_FPS
+    detail = f"{size} bytes in {frames} frames (2-byte loop floor {compat:.1f})"
+    if size <= 0:
+        return False, f"no upload seen (SPC pointer at ${size + MODULE_BASE:04X})"
+    if frames >= compat:
+        return False, "not faster than the 2-byte loop: " + detail
+    return True, detail
+
+
+if __name__ == "__main__":
+    ok, msg = run()
+    print(("PASS " if ok else "FAIL ") + "spc_upload: " + msg)
+    sys.exit(0 if ok else 1)
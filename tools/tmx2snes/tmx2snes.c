@@ -42,6 +42,10 @@
 
 #define N_METATILES 1024 // maximum tiles
 #define N_OBJECTS 64     // maximum objects
+#define N_BLOCKTILES 16  // 8x8 tiles in the biggest metatile (32x32)
+#define CHUNKSIZE 16     // map entries per chunk side (-c)
+#define CHUNKBYTES (CHUNKSIZE * CHUNKSIZE * 2)
+#define CHUNKMAXDATA 32768 // chunk table + streams must fit in a ROM bank
 
 //// M A I N   V A R I A B L E S ////////////////////////////////////////////////
 typedef struct
@@ -73,6 +77,13 @@ unsigned short tileprop
 pvsneslib_object_t objsnes[N_OBJECTS];  // to store objects in correct order
 unsigned short tilesetmap[N_METATILES]; // to have map for each tile (optimization purpose)
 
+int mtsize = 8;                                 // metatile size in pixels (8, 16 or 32)
+int mtcount = 0;                                // 16x16 / 32x32 metatiles found so far
+unsigned short mtdefs[N_METATILES][N_BLOCKTILES]; // their tilemap entries, row by row
+unsigned short mtattr[N_METATILES];             // and their attribute
+
+int chunkmode = 0;                              // 1 = chunked, compressed map (-c)
+
 //// F U N C T I O N S //////////////////////////////////////////////////////////
 
 //////////////////////////////////////////////////////////////////////////////
@@ -140,6 +151,8 @@ void PrintOptions(char *str)
         printf("\ntmx2snes: error 'The [%s] parameter is not recognized'", str);
 
     printf("\n\nMisc options:");
+    printf("\n-s [8|16|32]      Metatile size in pixels (default 8)");
+    printf("\n-c                Chunked map: compressed 16x16 chunks (8x8 metatiles)");
     printf("\n-h                Display this information");
     printf("\n-q                Quiet mode");
     printf("\n-v                Display version information");
@@ -154,6 +167,235 @@ void PrintVersion(void)
     printf("\nCopyright (c) 2022 Alekmaul\n");
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// SNES tilemap entry of a Tiled cell (0 = empty cell, drawn with tile 0)
+int TileEntry(int tileattr)
+{
+    int tile, entry;
+
+    tile = tileattr ? (tileattr - 1) & 0x03FF : 0;
+    entry = tilesetmap[tile] & 0x03FF;            // get tile number
+    entry |= tileprop[tile][1] ? 0x2000 : 0x0000; // check priority
+    entry |= (tileprop[tile][2] << 10);           // check palette
+    if (tileattr & CUTE_TILED_FLIPPED_HORIZONTALLY_FLAG)
+        entry |= (1 << 14);
+    if (tileattr & CUTE_TILED_FLIPPED_VERTICALLY_FLAG)
+        entry |= (1 << 15);
+
+    return entry;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Metatile number of the mtsize x mtsize block at (bx, by), added if new
+int BlockMetatile(int bx, int by)
+{
+    unsigned short def[N_BLOCKTILES];
+    int side, x, y, tx, ty, tileattr, attr, i;
+
+    side = mtsize / 8;
+    attr = 0;
+    for (y = 0; y < side; y++)
+    {
+        for (x = 0; x < side; x++)
+        {
+            tx = bx * side + x;
+            ty = by * side + y;
+            tileattr = 0;
+            if ((tx < map->width) && (ty < map->height))
+                tileattr = data[ty * map->width + tx];
+            def[y * side + x] = TileEntry(tileattr);
+
+            // block attribute: the first non-empty one, row by row
+            if ((attr == 0) && tileattr)
+                attr = tileprop[(tileattr - 1) & 0x03FF][0];
+        }
+    }
+
+    for (i = 0; i < mtcount; i++)
+    {
+        if ((mtattr[i] == attr) && !memcmp(mtdefs[i], def, side * side * sizeof(unsigned short)))
+            return i;
+    }
+
+    if (mtcount == N_METATILES)
+    {
+        printf("tmx2snes: error 'too much metatiles in map (%d max expected)'\n", N_METATILES);
+        exit(1);
+    }
+    memcpy(mtdefs[mtcount], def, sizeof(def));
+    mtattr[mtcount] = attr;
+
+    return mtcount++;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Length extension of the lz4 module's format: 255 means add and continue
+int PutLength(unsigned char *out, int outpos, int len)
+{
+    len -= 15;
+    while (len >= 255)
+    {
+        out[outpos++] = 255;
+        len -= 255;
+    }
+    out[outpos++] = len;
+
+    return outpos;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Compress a chunk for lz4Decode (lib/source/lz4.asm): tag 0x40, 3-byte
+// size, then token / literals / 2-byte distance sequences. Chunks are
+// small, so a greedy parse with a full search is fast enough.
+int CompressChunk(unsigned char *in, int len, unsigned char *out)
+{
+    int pos, lit, best, dist, cand, l, outpos, litlen, token;
+
+    out[0] = 0x40;
+    out[1] = LOW_BYTE(len);
+    out[2] = HI_BYTE(len);
+    out[3] = 0;
+    outpos = 4;
+
+    pos = 0;
+    lit = 0;
+    while (pos <= len)
+    {
+        best = 0;
+        dist = 0;
+        for (cand = pos - 1; (pos < len) && (cand >= 0); cand--)
+        {
+            for (l = 0; (pos + l < len) && (in[cand + l] == in[pos + l]); l++)
+                ;
+            if (l > best)
+            {
+                best = l;
+                dist = pos - cand;
+            }
+        }
+
+        // a match of 4 or more, or the trailing literals, ends a sequence
+        if (best < 4)
+            best = 0;
+        if (best || ((pos == len) && (lit < len)))
+        {
+            litlen = pos - lit;
+            token = (litlen >= 15 ? 15 : litlen) << 4;
+            if (best)
+                token |= (best - 4 >= 15) ? 15 : best - 4;
+            out[outpos++] = token;
+            if (litlen >= 15)
+                outpos = PutLength(out, outpos, litlen);
+            memcpy(out + outpos, in + lit, litlen);
+            outpos += litlen;
+            if (best)
+            {
+                out[outpos++] = LOW_BYTE(dist);
+                out[outpos++] = HI_BYTE(dist);
+                if (best - 4 >= 15)
+                    outpos = PutLength(out, outpos, best - 4);
+            }
+            pos += best;
+            lit = pos;
+        }
+        if (best == 0)
+            pos++;
+    }
+
+    return outpos;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Chunked map: header, one offset per chunk (from the table start), then
+// the compressed chunks. Identical chunks share one stream.
+void WriteChunkedMap(void)
+{
+    unsigned char chunk[CHUNKBYTES], packed[CHUNKBYTES * 2];
+    unsigned char *raw, *streams;
+    unsigned short *table, *rawofs;
+    int cw, ch, cx, cy, x, y, tx, ty, tileattr, tilesnes, nchunks, nunique, i, len, size;
+
+    cw = (map->width + CHUNKSIZE - 1) / CHUNKSIZE;
+    ch = (map->height + CHUNKSIZE - 1) / CHUNKSIZE;
+    table = (unsigned short *)malloc(cw * ch * sizeof(unsigned short));
+    rawofs = (unsigned short *)malloc(cw * ch * sizeof(unsigned short));
+    raw = (unsigned char *)malloc(cw * ch * CHUNKBYTES);
+    streams = (unsigned char *)malloc(CHUNKMAXDATA);
+    if ((table == NULL) || (rawofs == NULL) || (raw == NULL) || (streams == NULL))
+    {
+        printf("tmx2snes: error 'Can't allocate memory for chunks'\n");
+        exit(1);
+    }
+
+    nchunks = 0;
+    nunique = 0;
+    size = cw * ch * 2; // streams start after the table
+    for (cy = 0; cy < ch; cy++)
+    {
+        for (cx = 0; cx < cw; cx++)
+        {
+            // same entries as a plain 8x8 map, 0 past the map edges
+            for (y = 0; y < CHUNKSIZE; y++)
+            {
+                for (x = 0; x < CHUNKSIZE; x++)
+                {
+                    tx = cx * CHUNKSIZE + x;
+                    ty = cy * CHUNKSIZE + y;
+                    tilesnes = 0;
+                    tileattr = ((tx < map->width) && (ty < map->height)) ? data[ty * map->width + tx] : 0;
+                    if (tileattr)
+                    {
+                        tilesnes = (tileattr - 1) & 0x03FF;
+                        if (tileattr & CUTE_TILED_FLIPPED_HORIZONTALLY_FLAG)
+                            tilesnes |= (1 << 14);
+                        if (tileattr & CUTE_TILED_FLIPPED_VERTICALLY_FLAG)
+                            tilesnes |= (1 << 15);
+                    }
+                    chunk[(y * CHUNKSIZE + x) * 2] = LOW_BYTE(tilesnes);
+                    chunk[(y * CHUNKSIZE + x) * 2 + 1] = HI_BYTE(tilesnes);
+                }
+            }
+
+            for (i = 0; i < nunique; i++)
+            {
+                if (!memcmp(raw + i * CHUNKBYTES, chunk, CHUNKBYTES))
+                    break;
+            }
+            if (i == nunique)
+            {
+                len = CompressChunk(chunk, CHUNKBYTES, packed);
+                if (size + len > CHUNKMAXDATA)
+                {
+                    printf("tmx2snes: error 'chunked map is too big (max %dK)'\n", CHUNKMAXDATA / 1024);
+                    exit(1);
+                }
+                memcpy(raw + i * CHUNKBYTES, chunk, CHUNKBYTES);
+                memcpy(streams + size - cw * ch * 2, packed, len);
+                rawofs[i] = size;
+                size += len;
+                nunique++;
+            }
+            table[nchunks++] = rawofs[i];
+        }
+    }
+
+    if (quietmode == 0)
+        printf("tmx2snes:     %d chunks (%d unique), %d bytes instead of %d\n",
+               nchunks, nunique, size, map->width * map->height * 2);
+
+    PutWord(map->width * map->tilewidth, fpo);
+    PutWord((map->height * map->tileheight) | 0x2000, fpo);
+    PutWord(size, fpo);
+    for (i = 0; i < nchunks; i++)
+        PutWord(table[i], fpo);
+    fwrite(streams, size - nchunks * 2, 1, fpo);
+
+    free(streams);
+    free(raw);
+    free(rawofs);
+    free(table);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 void WriteMap(void)
 {
@@ -177,6 +419,42 @@ void WriteMap(void)
         printf("tmx2snes: error 'Can't open layer map file [%s] for writing'\n", filemapname);
         exit(1);
     }
+    data = layer->data;
+
+    // chunked map: 8x8 entries in compressed 16x16 chunks, flagged by bit
+    // 13 of the height word
+    if (chunkmode)
+    {
+        WriteChunkedMap();
+        fclose(fpo);
+        return;
+    }
+
+    // 16x16 / 32x32 metatiles: one entry per block, flips are in the
+    // metatile definitions and the height word gives the metatile size
+    // in bits 14-15 (1 = 16x16, 2 = 32x32)
+    if (mtsize != 8)
+    {
+        int side = mtsize / 8;
+        int bw = (map->width + side - 1) / side;
+        int bh = (map->height + side - 1) / side;
+        int bx, by;
+
+        PutWord(map->width * map->tilewidth, fpo);
+        PutWord((map->height * map->tileheight) | ((mtsize == 16 ? 1 : 2) << 14), fpo);
+        PutWord(bw * bh * 2, fpo);
+
+        for (by = 0; by < bh; by++)
+        {
+            for (bx = 0; bx < bw; bx++)
+            {
+                PutWord(BlockMetatile(bx, by), fpo);
+            }
+        }
+        fclose(fpo);
+        return;
+    }
+
     // Put width & height
     PutWord(map->width * map->tilewidth, fpo);
     PutWord(map->height * map->tileheight, fpo);
@@ -190,7 +468,6 @@ void WriteMap(void)
     // 		High     Low          Legend->  c: Starting character (tile) number
     // 		vhopppcc cccccccc               h: horizontal flip  v: vertical flip
     //				                        p: palette number   o: priority bit
-    data = layer->data;
     fflush(stdout);
     for (i = 0; i < layer->data_count; i++)
     {
@@ -220,16 +497,6 @@ void WriteTileset(void)
     int i, blkprop;
     char *pend;
 
-    if (quietmode == 0)
-        printf("tmx2snes: Writing tiles attribute file...\n");
-    sprintf(filemapname, "%s.b16", filebase);
-    fpo = fopen(filemapname, "wb");
-    if (fpo == NULL)
-    {
-        printf("tmx2snes: error 'Can't open tiles attribute file [%s] for writing'\n", filemapname);
-        exit(1);
-    }
-
     // Write tile properties to file
     // 2 data are currently managed : priority & block attribute
     // tiles with library is in reverse order (why ?)
@@ -241,7 +508,6 @@ void WriteTileset(void)
         printf("tmx2snes: error 'too much tiles in tileset (%d tiles, %d max expected)'\n",
                tset->tilecount,
                N_METATILES);
-        fclose(fpo);
         exit(1);
     }
 
@@ -276,6 +542,20 @@ void WriteTileset(void)
         tile = tile->next;
     }
 
+    // bigger metatiles get their attributes with their definitions (WriteMetatiles)
+    if (mtsize != 8)
+        return;
+
+    if (quietmode == 0)
+        printf("tmx2snes: Writing tiles attribute file...\n");
+    sprintf(filemapname, "%s.b16", filebase);
+    fpo = fopen(filemapname, "wb");
+    if (fpo == NULL)
+    {
+        printf("tmx2snes: error 'Can't open tiles attribute file [%s] for writing'\n", filemapname);
+        exit(1);
+    }
+
     // now write to file
     fflush(stdout);
     if (quietmode == 0)
@@ -321,6 +601,44 @@ void WriteMapTileset(void)
     fclose(fpo);
 }
 
+void WriteMetatiles(void)
+{
+    int i, j, side;
+
+    // .t16: tilemap entries of each metatile, row by row
+    side = mtsize / 8;
+    sprintf(filemapname, "%s.t16", filebase);
+    fpo = fopen(filemapname, "wb");
+    if (fpo == NULL)
+    {
+        printf("tmx2snes: error 'Can't open tiles properties file [%s] for writing'\n", filemapname);
+        exit(1);
+    }
+
+    if (quietmode == 0)
+        printf("tmx2snes:     Writing %d metatiles %dx%d to file...\n", mtcount, mtsize, mtsize);
+
+    for (i = 0; i < mtcount; i++)
+    {
+        for (j = 0; j < side * side; j++)
+            PutWord(mtdefs[i][j], fpo);
+    }
+    fclose(fpo);
+
+    // .b16: attribute of each metatile
+    sprintf(filemapname, "%s.b16", filebase);
+    fpo = fopen(filemapname, "wb");
+    if (fpo == NULL)
+    {
+        printf("tmx2snes: error 'Can't open tiles attribute file [%s] for writing'\n", filemapname);
+        exit(1);
+    }
+
+    for (i = 0; i < mtcount; i++)
+        PutWord(mtattr[i], fpo);
+    fclose(fpo);
+}
+
 void WriteEntities(void)
 {
     int i, blkprop, objidx;
@@ -433,6 +751,23 @@ int main(int argc, char **argv)
             {
                 quietmode = 1;
             }
+            else if (argv[i][1] == 'c') // chunked map
+            {
+                chunkmode = 1;
+            }
+            else if (argv[i][1] == 's') // metatile size
+            {
+                if (argv[i][2] != 0)
+                    mtsize = atoi(&argv[i][2]);
+                else if (i + 1 < argc)
+                    mtsize = atoi(argv[++i]);
+                if ((mtsize != 8) && (mtsize != 16) && (mtsize != 32))
+                {
+                    printf("\ntmx2snes: error 'metatile size must be 8, 16 or 32'");
+                    PrintOptions("");
+                    exit(1);
+                }
+            }
             else // invalid option
             {
                 PrintOptions(argv[i]);
@@ -555,15 +890,33 @@ int main(int argc, char **argv)
     }
     */
 
-    if ((map->width * map->height) > 16384)
+    if (chunkmode && (mtsize != 8))
+    {
+        printf("tmx2snes: error 'chunked maps use 8x8 metatiles (no -s with -c)'\n");
+        return 1;
+    }
+
+    // limits apply to map entries: one per metatile. Chunked maps are
+    // limited by their compressed size and the header's 13-bit height
+    i = mtsize / 8;
+    if (chunkmode)
+    {
+        if (map->height > 1023)
+        {
+            printf("tmx2snes: error 'map height is too big! (max 1023) (%d)'\n", map->height);
+            return 1;
+        }
+    }
+    else if ((((map->width + i - 1) / i) * ((map->height + i - 1) / i)) > 16384)
     {
         printf("tmx2snes: error 'map is too big (max 32K)! (%dK)'\n",
-               (map->width * map->height * 2) / 1024);
+               (((map->width + i - 1) / i) * ((map->height + i - 1) / i) * 2) / 1024);
         return 1;
     }
-    if (map->height > 256)
+    else if ((map->height + i - 1) / i > 256)
     {
-        printf("tmx2snes: error 'map height is too big! (max 256) (%d)'\n", map->height);
+        printf("tmx2snes: error 'map height is too big! (max 256 metatiles) (%d)'\n",
+               (map->height + i - 1) / i);
         return 1;
     }
     if ((map->tilewidth != 8) || (map->tileheight != 8))
@@ -616,12 +969,17 @@ int main(int argc, char **argv)
         {
             // write .m16 and .t16 files ...
             WriteMap();
-            WriteMapTileset();
+            if (mtsize == 8)
+                WriteMapTileset();
         }
 
         layer = layer->next;
     }
 
+    // 16x16 / 32x32: one metatile set for all the map layers
+    if (mtsize != 8)
+        WriteMetatiles();
+
     // free the Tiled map object
     cute_tiled_free_map(map);
 